@@ -36,6 +36,7 @@ Pvt_Conf::Pvt_Conf()
 
     dump = false;
     dump_mat = true;
+    dump_mat_compression = false;
 
     flag_nmea_tty_port = false;
 
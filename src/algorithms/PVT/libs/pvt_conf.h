@@ -42,6 +42,7 @@ public:
 
     bool dump;
     bool dump_mat;
+    bool dump_mat_compression;
     std::string dump_filename;
 
     bool flag_nmea_tty_port;
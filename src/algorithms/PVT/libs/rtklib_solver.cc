@@ -41,7 +41,6 @@
 #include "rtklib_rtkpos.h"
 #include "rtklib_solution.h"
 #include <glog/logging.h>
-#include <matio.h>
 #include <exception>
 #include <utility>
 #include <vector>
@@ -66,7 +65,7 @@ namespace errorlib = boost::system;
 #endif
 
 
-Rtklib_Solver::Rtklib_Solver(int nchannels, const std::string &dump_filename, bool flag_dump_to_file, bool flag_dump_to_mat, const rtk_t &rtk)
+Rtklib_Solver::Rtklib_Solver(int nchannels, const std::string &dump_filename, bool flag_dump_to_file, bool flag_dump_to_mat, const rtk_t &rtk, bool flag_dump_mat_compression)
 {
     // init empty ephemeris for all the available GNSS channels
     d_nchannels = nchannels;
@@ -92,6 +91,41 @@ Rtklib_Solver::Rtklib_Solver(int nchannels, const std::string &dump_filename, bo
                             LOG(WARNING) << "Exception opening RTKLIB dump file " << e.what();
                         }
                 }
+            if (d_flag_dump_mat_enabled)
+                {
+                    d_mat_writer.add_variable<uint32_t>("TOW_at_current_symbol_ms");
+                    d_mat_writer.add_variable<uint32_t>("week");
+                    d_mat_writer.add_variable<double>("RX_time");
+                    d_mat_writer.add_variable<double>("user_clk_offset");
+                    d_mat_writer.add_variable<double>("pos_x");
+                    d_mat_writer.add_variable<double>("pos_y");
+                    d_mat_writer.add_variable<double>("pos_z");
+                    d_mat_writer.add_variable<double>("vel_x");
+                    d_mat_writer.add_variable<double>("vel_y");
+                    d_mat_writer.add_variable<double>("vel_z");
+                    d_mat_writer.add_variable<double>("cov_xx");
+                    d_mat_writer.add_variable<double>("cov_yy");
+                    d_mat_writer.add_variable<double>("cov_zz");
+                    d_mat_writer.add_variable<double>("cov_xy");
+                    d_mat_writer.add_variable<double>("cov_yz");
+                    d_mat_writer.add_variable<double>("cov_zx");
+                    d_mat_writer.add_variable<double>("latitude");
+                    d_mat_writer.add_variable<double>("longitude");
+                    d_mat_writer.add_variable<double>("height");
+                    d_mat_writer.add_variable<uint8_t>("valid_sats");
+                    d_mat_writer.add_variable<uint8_t>("solution_status");
+                    d_mat_writer.add_variable<uint8_t>("solution_type");
+                    d_mat_writer.add_variable<float>("AR_ratio_factor");
+                    d_mat_writer.add_variable<float>("AR_ratio_threshold");
+                    d_mat_writer.add_variable<double>("gdop");
+                    d_mat_writer.add_variable<double>("pdop");
+                    d_mat_writer.add_variable<double>("hdop");
+                    d_mat_writer.add_variable<double>("vdop");
+                    std::string mat_filename = d_dump_filename;
+                    mat_filename.erase(mat_filename.length() - 4, 4);
+                    mat_filename.append(".mat");
+                    d_mat_writer.open(mat_filename, flag_dump_mat_compression);
+                }
         }
 }
 
@@ -116,259 +150,10 @@ Rtklib_Solver::~Rtklib_Solver()
                         {
                             std::cerr << "Problem removing temporary file " << d_dump_filename << '\n';
                         }
-                    d_flag_dump_mat_enabled = false;
-                }
-        }
-    if (d_flag_dump_mat_enabled)
-        {
-            try
-                {
-                    save_matfile();
-                }
-            catch (const std::exception &ex)
-                {
-                    LOG(WARNING) << "Exception in destructor saving the PVT .mat dump file " << ex.what();
                 }
         }
-}
-
-
-bool Rtklib_Solver::save_matfile()
-{
-    // READ DUMP FILE
-    std::string dump_filename = d_dump_filename;
-    std::ifstream::pos_type size;
-    int32_t number_of_double_vars = 21;
-    int32_t number_of_uint32_vars = 2;
-    int32_t number_of_uint8_vars = 3;
-    int32_t number_of_float_vars = 2;
-    int32_t epoch_size_bytes = sizeof(double) * number_of_double_vars +
-                               sizeof(uint32_t) * number_of_uint32_vars +
-                               sizeof(uint8_t) * number_of_uint8_vars +
-                               sizeof(float) * number_of_float_vars;
-    std::ifstream dump_file;
-    dump_file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-        {
-            dump_file.open(dump_filename.c_str(), std::ios::binary | std::ios::ate);
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem opening dump file:" << e.what() << std::endl;
-            return false;
-        }
-    // count number of epochs and rewind
-    int64_t num_epoch = 0LL;
-    if (dump_file.is_open())
-        {
-            std::cout << "Generating .mat file for " << dump_filename << std::endl;
-            size = dump_file.tellg();
-            num_epoch = static_cast<int64_t>(size) / static_cast<int64_t>(epoch_size_bytes);
-            dump_file.seekg(0, std::ios::beg);
-        }
-    else
-        {
-            return false;
-        }
-
-    auto TOW_at_current_symbol_ms = std::vector<uint32_t>(num_epoch);
-    auto week = std::vector<uint32_t>(num_epoch);
-    auto RX_time = std::vector<double>(num_epoch);
-    auto user_clk_offset = std::vector<double>(num_epoch);
-    auto pos_x = std::vector<double>(num_epoch);
-    auto pos_y = std::vector<double>(num_epoch);
-    auto pos_z = std::vector<double>(num_epoch);
-    auto vel_x = std::vector<double>(num_epoch);
-    auto vel_y = std::vector<double>(num_epoch);
-    auto vel_z = std::vector<double>(num_epoch);
-    auto cov_xx = std::vector<double>(num_epoch);
-    auto cov_yy = std::vector<double>(num_epoch);
-    auto cov_zz = std::vector<double>(num_epoch);
-    auto cov_xy = std::vector<double>(num_epoch);
-    auto cov_yz = std::vector<double>(num_epoch);
-    auto cov_zx = std::vector<double>(num_epoch);
-    auto latitude = std::vector<double>(num_epoch);
-    auto longitude = std::vector<double>(num_epoch);
-    auto height = std::vector<double>(num_epoch);
-    auto valid_sats = std::vector<uint8_t>(num_epoch);
-    auto solution_status = std::vector<uint8_t>(num_epoch);
-    auto solution_type = std::vector<uint8_t>(num_epoch);
-    auto AR_ratio_factor = std::vector<float>(num_epoch);
-    auto AR_ratio_threshold = std::vector<float>(num_epoch);
-    auto gdop = std::vector<double>(num_epoch);
-    auto pdop = std::vector<double>(num_epoch);
-    auto hdop = std::vector<double>(num_epoch);
-    auto vdop = std::vector<double>(num_epoch);
-
-    try
-        {
-            if (dump_file.is_open())
-                {
-                    for (int64_t i = 0; i < num_epoch; i++)
-                        {
-                            dump_file.read(reinterpret_cast<char *>(&TOW_at_current_symbol_ms[i]), sizeof(uint32_t));
-                            dump_file.read(reinterpret_cast<char *>(&week[i]), sizeof(uint32_t));
-                            dump_file.read(reinterpret_cast<char *>(&RX_time[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&user_clk_offset[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&pos_x[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&pos_y[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&pos_z[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&vel_x[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&vel_y[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&vel_z[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_xx[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_yy[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_zz[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_xy[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_yz[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&cov_zx[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&latitude[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&longitude[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&height[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&valid_sats[i]), sizeof(uint8_t));
-                            dump_file.read(reinterpret_cast<char *>(&solution_status[i]), sizeof(uint8_t));
-                            dump_file.read(reinterpret_cast<char *>(&solution_type[i]), sizeof(uint8_t));
-                            dump_file.read(reinterpret_cast<char *>(&AR_ratio_factor[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&AR_ratio_threshold[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&gdop[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&pdop[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&hdop[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&vdop[i]), sizeof(double));
-                        }
-                }
-            dump_file.close();
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem reading dump file:" << e.what() << std::endl;
-            return false;
-        }
-
-    // WRITE MAT FILE
-    mat_t *matfp;
-    matvar_t *matvar;
-    std::string filename = dump_filename;
-    filename.erase(filename.length() - 4, 4);
-    filename.append(".mat");
-    matfp = Mat_CreateVer(filename.c_str(), nullptr, MAT_FT_MAT73);
-    if (reinterpret_cast<int64_t *>(matfp) != nullptr)
-        {
-            std::array<size_t, 2> dims{1, static_cast<size_t>(num_epoch)};
-            matvar = Mat_VarCreate("TOW_at_current_symbol_ms", MAT_C_UINT32, MAT_T_UINT32, 2, dims.data(), TOW_at_current_symbol_ms.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("week", MAT_C_UINT32, MAT_T_UINT32, 2, dims.data(), week.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("RX_time", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), RX_time.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("user_clk_offset", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), user_clk_offset.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("pos_x", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), pos_x.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("pos_y", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), pos_y.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("pos_z", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), pos_z.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("vel_x", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), vel_x.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("vel_y", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), vel_y.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("vel_z", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), vel_z.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_xx", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_xx.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_yy", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_yy.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_zz", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_zz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_xy", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_xy.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_yz", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_yz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("cov_zx", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), cov_zx.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("latitude", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), latitude.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("longitude", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), longitude.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("height", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), height.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("valid_sats", MAT_C_UINT8, MAT_T_UINT8, 2, dims.data(), valid_sats.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("solution_status", MAT_C_UINT8, MAT_T_UINT8, 2, dims.data(), solution_status.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("solution_type", MAT_C_UINT8, MAT_T_UINT8, 2, dims.data(), solution_type.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("AR_ratio_factor", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), AR_ratio_factor.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("AR_ratio_threshold", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), AR_ratio_threshold.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("gdop", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), gdop.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("pdop", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), pdop.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("hdop", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), hdop.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("vdop", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), vdop.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-        }
-
-    Mat_Close(matfp);
-    return true;
+    // Only the last chunk of epochs is left to be written
+    d_mat_writer.close();
 }
 
 
@@ -1144,6 +929,35 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                 {
                                     LOG(WARNING) << "Exception writing RTKLIB dump file " << e.what();
                                 }
+                            if (d_mat_writer.is_open())
+                                {
+                                    size_t var = 0;
+                                    d_mat_writer.append(var++, gnss_observables_map.begin()->second.TOW_at_current_symbol_ms);
+                                    d_mat_writer.append(var++, static_cast<uint32_t>(adjgpsweek(nav_data.eph[0].week, d_pre_2009_file)));
+                                    d_mat_writer.append(var++, gnss_observables_map.begin()->second.RX_time);
+                                    d_mat_writer.append(var++, rx_position_and_time(3));
+                                    for (int i = 0; i < 6; i++)
+                                        {
+                                            d_mat_writer.append(var++, pvt_sol.rr[i]);
+                                        }
+                                    for (int i = 0; i < 6; i++)
+                                        {
+                                            d_mat_writer.append(var++, static_cast<double>(pvt_sol.qr[i]));
+                                        }
+                                    d_mat_writer.append(var++, get_latitude());
+                                    d_mat_writer.append(var++, get_longitude());
+                                    d_mat_writer.append(var++, get_height());
+                                    d_mat_writer.append(var++, pvt_sol.ns);
+                                    d_mat_writer.append(var++, pvt_sol.stat);
+                                    d_mat_writer.append(var++, pvt_sol.type);
+                                    d_mat_writer.append(var++, pvt_sol.ratio);
+                                    d_mat_writer.append(var++, pvt_sol.thres);
+                                    for (int i = 0; i < 4; i++)
+                                        {
+                                            d_mat_writer.append(var++, dop_[i]);
+                                        }
+                                    d_mat_writer.end_epoch();
+                                }
                         }
                 }
         }
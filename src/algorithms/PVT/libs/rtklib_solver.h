@@ -53,6 +53,7 @@
 #include "gps_ephemeris.h"
 #include "gps_iono.h"
 #include "gps_utc_model.h"
+#include "mat_stream_writer.h"
 #include "monitor_pvt.h"
 #include "pvt_solution.h"
 #include "rtklib.h"
@@ -68,7 +69,7 @@
 class Rtklib_Solver : public Pvt_Solution
 {
 public:
-    Rtklib_Solver(int nchannels, const std::string& dump_filename, bool flag_dump_to_file, bool flag_dump_to_mat, const rtk_t& rtk);
+    Rtklib_Solver(int nchannels, const std::string& dump_filename, bool flag_dump_to_file, bool flag_dump_to_mat, const rtk_t& rtk, bool flag_dump_mat_compression = false);
     ~Rtklib_Solver();
 
     bool get_PVT(const std::map<int, Gnss_Synchro>& gnss_observables_map, bool flag_averaging);
@@ -112,10 +113,10 @@ private:
     std::array<double, 4> dop_{};
     std::string d_dump_filename;
     std::ofstream d_dump_file;
+    Mat_Stream_Writer d_mat_writer;
     int d_nchannels;  // Number of available channels for positioning
     bool d_flag_dump_enabled;
     bool d_flag_dump_mat_enabled;
-    bool save_matfile();
 };
 
 #endif  // GNSS_SDR_RTKLIB_SOLVER_H
@@ -63,7 +63,7 @@ BeidouB1iPcpsAcquisition::BeidouB1iPcpsAcquisition(
     acquisition_ = pcps_make_acquisition(acq_parameters_);
     DLOG(INFO) << "acquisition(" << acquisition_->unique_id() << ")";
 
-    if (item_type_ == "cbyte")
+    if ((item_type_ == "cbyte") and !acq_parameters_.integer_doppler_wipeoff)
         {
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
             float_to_complex_ = gr::blocks::float_to_complex::make();
@@ -130,15 +130,25 @@ signed int BeidouB1iPcpsAcquisition::mag()
 void BeidouB1iPcpsAcquisition::init()
 {
     acquisition_->init();
+    if (acq_parameters_.prefill_code_cache)
+        {
+            acquisition_->prefill_code_cache(1, 33, [this](uint32_t prn) { return generate_local_code(prn); });
+        }
     set_local_code();
 }
 
 
 void BeidouB1iPcpsAcquisition::set_local_code()
+{
+    acquisition_->set_local_code([this](uint32_t prn) { return generate_local_code(prn); });
+}
+
+
+const std::complex<float>* BeidouB1iPcpsAcquisition::generate_local_code(uint32_t prn)
 {
     std::vector<std::complex<float>> code(code_length_);
 
-    beidou_b1i_code_gen_complex_sampled(code, gnss_synchro_->PRN, fs_in_, 0);
+    beidou_b1i_code_gen_complex_sampled(code, prn, fs_in_, 0);
 
     gsl::span<gr_complex> code_span(code_.data(), vector_length_);
     for (unsigned int i = 0; i < num_codes_; i++)
@@ -146,7 +156,7 @@ void BeidouB1iPcpsAcquisition::set_local_code()
             std::copy_n(code.data(), code_length_, code_span.subspan(i * code_length_, code_length_).data());
         }
 
-    acquisition_->set_local_code(code_.data());
+    return code_.data();
 }
 
 
@@ -168,7 +178,7 @@ void BeidouB1iPcpsAcquisition::connect(gr::top_block_sptr top_block)
         {
             // nothing to connect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to connect
         }
@@ -193,7 +203,7 @@ void BeidouB1iPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
         {
             // nothing to disconnect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to disconnect
         }
@@ -216,7 +226,7 @@ gr::basic_block_sptr BeidouB1iPcpsAcquisition::get_left_block()
         {
             return acquisition_;
         }
-    if (item_type_ == "cshort")
+    if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             return acquisition_;
         }
@@ -148,6 +148,8 @@ public:
     void set_resampler_latency(uint32_t latency_samples) override;
 
 private:
+    const std::complex<float>* generate_local_code(uint32_t prn);
+
     ConfigurationInterface* configuration_;
     pcps_acquisition_sptr acquisition_;
     Acq_Conf acq_parameters_;
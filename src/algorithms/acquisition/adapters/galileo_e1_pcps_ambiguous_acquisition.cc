@@ -63,7 +63,7 @@ GalileoE1PcpsAmbiguousAcquisition::GalileoE1PcpsAmbiguousAcquisition(
     acquisition_ = pcps_make_acquisition(acq_parameters_);
     DLOG(INFO) << "acquisition(" << acquisition_->unique_id() << ")";
 
-    if (item_type_ == "cbyte")
+    if ((item_type_ == "cbyte") and !acq_parameters_.integer_doppler_wipeoff)
         {
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
             float_to_complex_ = gr::blocks::float_to_complex::make();
@@ -122,6 +122,18 @@ void GalileoE1PcpsAmbiguousAcquisition::set_doppler_center(int doppler_center)
 }
 
 
+void GalileoE1PcpsAmbiguousAcquisition::set_doppler_window(unsigned int doppler_window)
+{
+    acquisition_->set_doppler_window(doppler_window);
+}
+
+
+void GalileoE1PcpsAmbiguousAcquisition::set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, unsigned int code_window)
+{
+    acquisition_->set_code_phase_window(sample_stamp, code_delay_samples, code_period_samples, code_window);
+}
+
+
 void GalileoE1PcpsAmbiguousAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
 {
     gnss_synchro_ = gnss_synchro;
@@ -139,10 +151,20 @@ signed int GalileoE1PcpsAmbiguousAcquisition::mag()
 void GalileoE1PcpsAmbiguousAcquisition::init()
 {
     acquisition_->init();
+    if (acq_parameters_.prefill_code_cache)
+        {
+            acquisition_->prefill_code_cache(1, 36, [this](uint32_t prn) { return generate_local_code(prn); }, code_variant());
+        }
 }
 
 
 void GalileoE1PcpsAmbiguousAcquisition::set_local_code()
+{
+    acquisition_->set_local_code([this](uint32_t prn) { return generate_local_code(prn); }, code_variant());
+}
+
+
+const std::complex<float>* GalileoE1PcpsAmbiguousAcquisition::generate_local_code(uint32_t prn)
 {
     bool cboc = configuration_->property(
         "Acquisition" + std::to_string(channel_) + ".cboc", false);
@@ -156,12 +178,12 @@ void GalileoE1PcpsAmbiguousAcquisition::set_local_code()
             if (acq_parameters_.use_automatic_resampler)
                 {
                     galileo_e1_code_gen_complex_sampled(code, pilot_signal,
-                        cboc, gnss_synchro_->PRN, acq_parameters_.resampled_fs, 0, false);
+                        cboc, prn, acq_parameters_.resampled_fs, 0, false);
                 }
             else
                 {
                     galileo_e1_code_gen_complex_sampled(code, pilot_signal,
-                        cboc, gnss_synchro_->PRN, fs_in_, 0, false);
+                        cboc, prn, fs_in_, 0, false);
                 }
         }
     else
@@ -173,12 +195,12 @@ void GalileoE1PcpsAmbiguousAcquisition::set_local_code()
             if (acq_parameters_.use_automatic_resampler)
                 {
                     galileo_e1_code_gen_complex_sampled(code, Signal_,
-                        cboc, gnss_synchro_->PRN, acq_parameters_.resampled_fs, 0, false);
+                        cboc, prn, acq_parameters_.resampled_fs, 0, false);
                 }
             else
                 {
                     galileo_e1_code_gen_complex_sampled(code, Signal_,
-                        cboc, gnss_synchro_->PRN, fs_in_, 0, false);
+                        cboc, prn, fs_in_, 0, false);
                 }
         }
 
@@ -188,7 +210,21 @@ void GalileoE1PcpsAmbiguousAcquisition::set_local_code()
             std::copy_n(code.data(), code_length_, code__span.subspan(i * code_length_, code_length_).data());
         }
 
-    acquisition_->set_local_code(code_.data());
+    return code_.data();
+}
+
+
+std::string GalileoE1PcpsAmbiguousAcquisition::code_variant() const
+{
+    bool cboc = configuration_->property(
+        "Acquisition" + std::to_string(channel_) + ".cboc", false);
+
+    std::string variant(acquire_pilot_ ? "pilot" : "data");
+    if (cboc)
+        {
+            variant += "_cboc";
+        }
+    return variant;
 }
 
 
@@ -210,7 +246,7 @@ void GalileoE1PcpsAmbiguousAcquisition::connect(gr::top_block_sptr top_block)
         {
             // nothing to connect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to connect
         }
@@ -235,7 +271,7 @@ void GalileoE1PcpsAmbiguousAcquisition::disconnect(gr::top_block_sptr top_block)
         {
             // nothing to disconnect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to disconnect
         }
@@ -258,7 +294,7 @@ gr::basic_block_sptr GalileoE1PcpsAmbiguousAcquisition::get_left_block()
         {
             return acquisition_;
         }
-    if (item_type_ == "cshort")
+    if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             return acquisition_;
         }
@@ -119,6 +119,18 @@ void GalileoE5aPcpsAcquisition::set_doppler_center(int doppler_center)
 }
 
 
+void GalileoE5aPcpsAcquisition::set_doppler_window(unsigned int doppler_window)
+{
+    acquisition_->set_doppler_window(doppler_window);
+}
+
+
+void GalileoE5aPcpsAcquisition::set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, unsigned int code_window)
+{
+    acquisition_->set_code_phase_window(sample_stamp, code_delay_samples, code_period_samples, code_window);
+}
+
+
 void GalileoE5aPcpsAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
 {
     gnss_synchro_ = gnss_synchro;
@@ -135,10 +147,20 @@ signed int GalileoE5aPcpsAcquisition::mag()
 void GalileoE5aPcpsAcquisition::init()
 {
     acquisition_->init();
+    if (acq_parameters_.prefill_code_cache)
+        {
+            acquisition_->prefill_code_cache(1, 36, [this](uint32_t prn) { return generate_local_code(prn); }, code_variant());
+        }
 }
 
 
 void GalileoE5aPcpsAcquisition::set_local_code()
+{
+    acquisition_->set_local_code([this](uint32_t prn) { return generate_local_code(prn); }, code_variant());
+}
+
+
+const std::complex<float>* GalileoE5aPcpsAcquisition::generate_local_code(uint32_t prn)
 {
     std::vector<std::complex<float>> code(code_length_);
     std::array<char, 3> signal_{};
@@ -160,11 +182,11 @@ void GalileoE5aPcpsAcquisition::set_local_code()
 
     if (acq_parameters_.use_automatic_resampler)
         {
-            galileo_e5_a_code_gen_complex_sampled(code, signal_, gnss_synchro_->PRN, acq_parameters_.resampled_fs, 0);
+            galileo_e5_a_code_gen_complex_sampled(code, signal_, prn, acq_parameters_.resampled_fs, 0);
         }
     else
         {
-            galileo_e5_a_code_gen_complex_sampled(code, signal_, gnss_synchro_->PRN, fs_in_, 0);
+            galileo_e5_a_code_gen_complex_sampled(code, signal_, prn, fs_in_, 0);
         }
     gsl::span<gr_complex> code_span(code_.data(), vector_length_);
     for (unsigned int i = 0; i < sampled_ms_; i++)
@@ -172,7 +194,21 @@ void GalileoE5aPcpsAcquisition::set_local_code()
             std::copy_n(code.data(), code_length_, code_span.subspan(i * code_length_, code_length_).data());
         }
 
-    acquisition_->set_local_code(code_.data());
+    return code_.data();
+}
+
+
+std::string GalileoE5aPcpsAcquisition::code_variant() const
+{
+    if (acq_iq_)
+        {
+            return "X";
+        }
+    if (acq_pilot_)
+        {
+            return "Q";
+        }
+    return "I";
 }
 
 
@@ -62,7 +62,7 @@ GlonassL2CaPcpsAcquisition::GlonassL2CaPcpsAcquisition(
     acquisition_ = pcps_make_acquisition(acq_parameters_);
     DLOG(INFO) << "acquisition(" << acquisition_->unique_id() << ")";
 
-    if (item_type_ == "cbyte")
+    if ((item_type_ == "cbyte") and !acq_parameters_.integer_doppler_wipeoff)
         {
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
             float_to_complex_ = gr::blocks::float_to_complex::make();
@@ -169,7 +169,7 @@ void GlonassL2CaPcpsAcquisition::connect(gr::top_block_sptr top_block)
         {
             // nothing to connect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to connect
         }
@@ -194,7 +194,7 @@ void GlonassL2CaPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
         {
             // nothing to disconnect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to disconnect
         }
@@ -217,7 +217,7 @@ gr::basic_block_sptr GlonassL2CaPcpsAcquisition::get_left_block()
         {
             return acquisition_;
         }
-    if (item_type_ == "cshort")
+    if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             return acquisition_;
         }
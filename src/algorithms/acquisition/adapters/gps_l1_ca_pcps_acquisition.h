@@ -31,6 +31,7 @@
 #include "gnss_synchro.h"
 #include "pcps_acquisition.h"
 #include <gnuradio/blocks/float_to_complex.h>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -120,6 +121,16 @@ public:
      */
     void set_doppler_center(int doppler_center) override;
 
+    /*!
+     * \brief Restrict the Doppler search to a window around the Doppler center
+     */
+    void set_doppler_window(unsigned int doppler_window) override;
+
+    /*!
+     * \brief Restrict the code phase search to a window around a predicted code delay
+     */
+    void set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, unsigned int code_window) override;
+
     /*!
      * \brief Initializes acquisition algorithm.
      */
@@ -156,6 +167,8 @@ public:
     void set_resampler_latency(uint32_t latency_samples) override;
 
 private:
+    const std::complex<float>* generate_local_code(uint32_t prn);
+
     ConfigurationInterface* configuration_;
     pcps_acquisition_sptr acquisition_;
     Acq_Conf acq_parameters_;
@@ -64,7 +64,7 @@ GpsL5iPcpsAcquisition::GpsL5iPcpsAcquisition(
     acquisition_ = pcps_make_acquisition(acq_parameters_);
     DLOG(INFO) << "acquisition(" << acquisition_->unique_id() << ")";
 
-    if (item_type_ == "cbyte")
+    if ((item_type_ == "cbyte") and !acq_parameters_.integer_doppler_wipeoff)
         {
             cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
             float_to_complex_ = gr::blocks::float_to_complex::make();
@@ -125,6 +125,18 @@ void GpsL5iPcpsAcquisition::set_doppler_center(int doppler_center)
 }
 
 
+void GpsL5iPcpsAcquisition::set_doppler_window(unsigned int doppler_window)
+{
+    acquisition_->set_doppler_window(doppler_window);
+}
+
+
+void GpsL5iPcpsAcquisition::set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, unsigned int code_window)
+{
+    acquisition_->set_code_phase_window(sample_stamp, code_delay_samples, code_period_samples, code_window);
+}
+
+
 void GpsL5iPcpsAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
 {
     gnss_synchro_ = gnss_synchro;
@@ -142,20 +154,30 @@ signed int GpsL5iPcpsAcquisition::mag()
 void GpsL5iPcpsAcquisition::init()
 {
     acquisition_->init();
+    if (acq_parameters_.prefill_code_cache)
+        {
+            acquisition_->prefill_code_cache(1, 32, [this](uint32_t prn) { return generate_local_code(prn); });
+        }
 }
 
 
 void GpsL5iPcpsAcquisition::set_local_code()
+{
+    acquisition_->set_local_code([this](uint32_t prn) { return generate_local_code(prn); });
+}
+
+
+const std::complex<float>* GpsL5iPcpsAcquisition::generate_local_code(uint32_t prn)
 {
     std::vector<std::complex<float>> code(code_length_);
 
     if (acq_parameters_.use_automatic_resampler)
         {
-            gps_l5i_code_gen_complex_sampled(code, gnss_synchro_->PRN, acq_parameters_.resampled_fs);
+            gps_l5i_code_gen_complex_sampled(code, prn, acq_parameters_.resampled_fs);
         }
     else
         {
-            gps_l5i_code_gen_complex_sampled(code, gnss_synchro_->PRN, fs_in_);
+            gps_l5i_code_gen_complex_sampled(code, prn, fs_in_);
         }
 
     gsl::span<gr_complex> code_span(code_.data(), vector_length_);
@@ -164,7 +186,7 @@ void GpsL5iPcpsAcquisition::set_local_code()
             std::copy_n(code.data(), code_length_, code_span.subspan(i * code_length_, code_length_).data());
         }
 
-    acquisition_->set_local_code(code_.data());
+    return code_.data();
 }
 
 
@@ -186,7 +208,7 @@ void GpsL5iPcpsAcquisition::connect(gr::top_block_sptr top_block)
         {
             // nothing to connect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to connect
         }
@@ -211,7 +233,7 @@ void GpsL5iPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
         {
             // nothing to disconnect
         }
-    else if (item_type_ == "cshort")
+    else if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             // nothing to disconnect
         }
@@ -234,7 +256,7 @@ gr::basic_block_sptr GpsL5iPcpsAcquisition::get_left_block()
         {
             return acquisition_;
         }
-    if (item_type_ == "cshort")
+    if ((item_type_ == "cshort") or acq_parameters_.integer_doppler_wipeoff)
         {
             return acquisition_;
         }
@@ -46,10 +46,19 @@
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include <algorithm>  // for fill_n, min
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>    // for floor, fmod, rint, ceil
+#include <condition_variable>
 #include <cstring>  // for memcpy
+#include <exception>
 #include <iostream>
+#include <iterator>  // for distance
 #include <map>
+#include <mutex>
+#include <numeric>  // for accumulate
+#include <thread>
+#include <utility>  // for move, swap
 
 #if HAS_STD_FILESYSTEM
 #if HAS_STD_FILESYSTEM_EXPERIMENTAL
@@ -62,6 +71,59 @@ namespace fs = boost::filesystem;
 #endif
 
 
+namespace
+{
+// Best time of a forward and an inverse FFT of the given length, in seconds
+double time_fft(uint32_t fft_size)
+{
+    gr::fft::fft_complex fft_if(fft_size, true);
+    gr::fft::fft_complex ifft(fft_size, false);
+    std::fill_n(fft_if.get_inbuf(), fft_size, gr_complex(1.0, 0.0));
+    fft_if.execute();
+    double best_time = 0.0;
+    for (int round = 0; round < 3; round++)
+        {
+            const int repetitions = 10;
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repetitions; i++)
+                {
+                    fft_if.execute();
+                    memcpy(ifft.get_inbuf(), fft_if.get_outbuf(), sizeof(gr_complex) * fft_size);
+                    ifft.execute();
+                }
+            const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repetitions;
+            best_time = (round == 0 ? time : std::min(best_time, time));
+        }
+    return best_time;
+}
+
+
+// Clears the flag of the job queued in the acquisition executor when the job
+// ends, also through an exception, so that neither the channel nor the
+// destructor of the block wait for it forever. The lock is taken again if
+// the job released it.
+class Worker_Active_Guard
+{
+public:
+    Worker_Active_Guard(bool& worker_active, gr::thread::scoped_lock& lock) : d_worker_active(worker_active), d_lock(lock) {}
+    ~Worker_Active_Guard()
+    {
+        if (!d_lock.owns_lock())
+            {
+                d_lock.lock();
+            }
+        d_worker_active = false;
+    }
+    Worker_Active_Guard(const Worker_Active_Guard&) = delete;
+    Worker_Active_Guard& operator=(const Worker_Active_Guard&) = delete;
+
+private:
+    bool& d_worker_active;
+    gr::thread::scoped_lock& d_lock;
+};
+}  // namespace
+
+
 pcps_acquisition_sptr pcps_make_acquisition(const Acq_Conf& conf_)
 {
     return pcps_acquisition_sptr(new pcps_acquisition(conf_));
@@ -81,6 +143,7 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
     d_state = 0;
     d_doppler_bias = 0;
     d_num_noncoherent_integrations_counter = 0U;
+    d_num_previous_dwells = 0U;
     d_consumed_samples = acq_parameters.sampled_ms * acq_parameters.samples_per_ms * (acq_parameters.bit_transition_flag ? 2 : 1);
     if (acq_parameters.sampled_ms == acq_parameters.ms_per_code)
         {
@@ -90,7 +153,20 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
         {
             d_fft_size = d_consumed_samples * 2;
         }
-    // d_fft_size = next power of two?  ////
+    d_correlation_size = d_fft_size;
+    if (acq_parameters.fft_autotune)
+        {
+            // Further zero padding does not change the correlation lags already
+            // searched only if both the local code and the input are zero padded
+            if (acq_parameters.bit_transition_flag or (acq_parameters.sampled_ms == acq_parameters.ms_per_code))
+                {
+                    LOG(INFO) << "FFT length autotuning requires sampled_ms different from ms_per_code and bit_transition_flag=false. Using FFTs of " << d_fft_size << " samples";
+                }
+            else
+                {
+                    d_fft_size = Acq_Fft_Planner::instance().fft_size(d_correlation_size, acq_parameters.fft_wisdom_file, time_fft);
+                }
+        }
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0U;
@@ -108,6 +184,31 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
         {
             d_cshort = true;
         }
+    // cbyte samples are widened to 16 bits as they are captured, and then
+    // follow the cshort datapath
+    d_cbyte = (conf_.it_size == sizeof(lv_8sc_t));
+    d_integer_wipeoff = false;
+    d_integer_carrier_amplitude = 1.0;
+    d_integer_input_max = 0;
+    d_clamp_integer_input = false;
+    d_integer_input_clamped = false;
+    if (acq_parameters.integer_doppler_wipeoff)
+        {
+            if (d_cshort)
+                {
+                    // Largest carrier amplitude for which the 16-bit products with
+                    // samples of integer_input_bits bits cannot overflow
+                    d_integer_wipeoff = true;
+                    d_integer_carrier_amplitude = std::floor(32767.0F / static_cast<float>(1U << acq_parameters.integer_input_bits));
+                    // Samples wider than that are clamped as they are captured
+                    d_integer_input_max = static_cast<int16_t>((1 << (acq_parameters.integer_input_bits - 1U)) - 1);
+                    d_clamp_integer_input = acq_parameters.integer_input_bits < (d_cbyte ? 8U : 16U);
+                }
+            else
+                {
+                    LOG(WARNING) << "The integer Doppler wipeoff requires cshort or cbyte input samples. Using the floating point datapath";
+                }
+        }
 
     // COD:
     // Experimenting with the overlap/save technique for handling bit trannsitions
@@ -126,7 +227,7 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
     // }
 
     d_tmp_buffer = volk_gnsssdr::vector<float>(d_fft_size);
-    d_fft_codes = volk_gnsssdr::vector<std::complex<float>>(d_fft_size);
+    d_fft_codes = std::make_shared<Acq_Code_Spectra_Cache::Spectrum>(d_fft_size);
     d_input_signal = volk_gnsssdr::vector<std::complex<float>>(d_fft_size);
 
     // Direct FFT
@@ -137,15 +238,69 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
 
     d_gnss_synchro = nullptr;
     d_worker_active = false;
-    d_data_buffer = volk_gnsssdr::vector<std::complex<float>>(d_consumed_samples);
+    if (!acq_parameters.blocking or (acq_parameters.doppler_bin_workers > 1))
+        {
+            // Dwells (or slices of the Doppler grid) are processed by the process-wide pool of acquisition workers
+            d_executor = Acq_Executor::get_instance(acq_parameters.executor_workers, acq_parameters.executor_queue_size, acq_parameters.executor_cpu_affinity);
+        }
+    // Each additional Doppler search slice uses its own FFT plans and scratch buffer
+    for (uint32_t i = 1; i < acq_parameters.doppler_bin_workers; i++)
+        {
+            d_worker_fft_if.push_back(std::make_shared<gr::fft::fft_complex>(d_fft_size, true));
+            d_worker_ifft.push_back(std::make_shared<gr::fft::fft_complex>(d_fft_size, false));
+            d_worker_tmp_buffer.emplace_back(d_fft_size);
+            if (d_integer_wipeoff)
+                {
+                    d_worker_wipeoff_buffer_sc.emplace_back(d_fft_size);
+                }
+        }
     if (d_cshort)
         {
             d_data_buffer_sc = volk_gnsssdr::vector<lv_16sc_t>(d_consumed_samples);
         }
+    else
+        {
+            d_data_buffer = volk_gnsssdr::vector<std::complex<float>>(d_consumed_samples);
+        }
+    d_pipelined_dwells = false;
+    if (acq_parameters.dwell_buffers > 1)
+        {
+            if (acq_parameters.blocking)
+                {
+                    LOG(WARNING) << "Capturing a dwell while the previous one is processed requires blocking=false. Using a single dwell buffer";
+                }
+            else
+                {
+                    // The capture buffer plus dwell_buffers - 1 buffers for dwells waiting to be processed
+                    d_pipelined_dwells = true;
+                    for (uint32_t i = 1; i < acq_parameters.dwell_buffers; i++)
+                        {
+                            Captured_Dwell dwell;
+                            dwell.samples = volk_gnsssdr::vector<std::complex<float>>(d_data_buffer.size());
+                            dwell.samples_sc = volk_gnsssdr::vector<lv_16sc_t>(d_data_buffer_sc.size());
+                            d_free_dwells.push_back(std::move(dwell));
+                        }
+                }
+        }
+    if (d_integer_wipeoff)
+        {
+            d_input_signal_sc = volk_gnsssdr::vector<lv_16sc_t>(d_fft_size);
+            d_wipeoff_buffer_sc = volk_gnsssdr::vector<lv_16sc_t>(d_fft_size);
+        }
     grid_ = arma::fmat();
     narrow_grid_ = arma::fmat();
     d_step_two = false;
     d_num_doppler_bins_step2 = acq_parameters.num_doppler_bins_step2;
+    d_doppler_window = 0U;
+    d_first_doppler_bin = 0U;
+    d_last_doppler_bin = 0U;
+    d_noise_doppler_bin = 0U;
+    d_code_window = 0U;
+    d_code_window_first = 0U;
+    d_code_window_size = 0U;
+    d_code_window_stamp = 0ULL;
+    d_code_window_delay = 0.0;
+    d_code_window_period = 0.0;
 
     d_samplesPerChip = acq_parameters.samples_per_chip;
     d_buffer_count = 0U;
@@ -153,6 +308,43 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
     d_dump_number = 0LL;
     d_dump_channel = acq_parameters.dump_channel;
     d_dump = acq_parameters.dump;
+    d_streaming_statistics = false;
+    if (acq_parameters.streaming_statistics)
+        {
+            if (d_dump)
+                {
+                    LOG(INFO) << "The full magnitude grid is stored because the acquisition dump is enabled";
+                }
+            else if (acq_parameters.max_dwells > 1 and (acq_parameters.frequency_domain_doppler or acq_parameters.shared_input_spectra))
+                {
+                    LOG(WARNING) << "The non-coherent integration of several dwells with Doppler-shifted input spectra requires the full magnitude grid. Statistics will not be computed on the fly";
+                }
+            else
+                {
+                    d_streaming_statistics = true;
+                }
+        }
+    // With several dwells, the earlier dwells of the non-coherent integration
+    // are kept in a rolling buffer of input samples, instead of their grids
+    d_rolling_dwells = d_streaming_statistics and acq_parameters.max_dwells > 1;
+    if (d_rolling_dwells)
+        {
+            d_previous_dwells = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(acq_parameters.max_dwells - 1, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
+            if (d_integer_wipeoff)
+                {
+                    d_previous_dwells_sc = volk_gnsssdr::vector<volk_gnsssdr::vector<lv_16sc_t>>(acq_parameters.max_dwells - 1, volk_gnsssdr::vector<lv_16sc_t>(d_fft_size));
+                }
+        }
+    // One running peak search per slice of the Doppler grid
+    d_peak_searches = std::vector<Peak_Search>(acq_parameters.doppler_bin_workers);
+    if (d_streaming_statistics)
+        {
+            for (auto& peak_search : d_peak_searches)
+                {
+                    peak_search.peak_bin = volk_gnsssdr::vector<float>(d_fft_size);
+                }
+            d_noise_peak_search.peak_bin = volk_gnsssdr::vector<float>(d_fft_size);
+        }
     d_dump_filename = acq_parameters.dump_filename;
     if (d_dump)
         {
@@ -188,6 +380,23 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
 }
 
 
+pcps_acquisition::~pcps_acquisition()
+{
+    // Wait for the dwell that could still be queued in, or processed by, the acquisition executor
+    while (true)
+        {
+            {
+                gr::thread::scoped_lock lock(d_setlock);
+                if (!d_worker_active)
+                    {
+                        break;
+                    }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+}
+
+
 void pcps_acquisition::set_resampler_latency(uint32_t latency_samples)
 {
     gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
@@ -195,18 +404,104 @@ void pcps_acquisition::set_resampler_latency(uint32_t latency_samples)
 }
 
 
-void pcps_acquisition::set_local_code(std::complex<float>* code)
+void pcps_acquisition::set_doppler_window(uint32_t doppler_window)
+{
+    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    d_doppler_window = doppler_window;
+    update_doppler_window_bins();
+    calculate_threshold();
+}
+
+
+void pcps_acquisition::set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, uint32_t code_window)
+{
+    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    d_code_window = (code_period_samples > 0.0 ? code_window : 0U);
+    d_code_window_stamp = sample_stamp;
+    d_code_window_delay = code_delay_samples;
+    d_code_window_period = code_period_samples;
+    d_code_window_size = 0U;
+    if (d_code_window > 0U)
+        {
+            DLOG(INFO) << "Code phase assistance for Channel: " << d_channel << " => delay: " << code_delay_samples
+                       << " samples at sample stamp " << sample_stamp << ", window: +/-" << code_window << " samples";
+        }
+    calculate_threshold();
+}
+
+
+void pcps_acquisition::set_local_code(const std::complex<float>* code)
 {
     // This will check if it's fdma, if yes will update the intermediate frequency and the doppler grid
     if (is_fdma())
         {
             update_grid_doppler_wipeoffs();
         }
+    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    d_fft_codes = compute_code_spectrum(code);
+}
+
+
+void pcps_acquisition::set_local_code(const Code_Generator& generate_code, const std::string& code_variant)
+{
+    if (!acq_parameters.code_spectra_cache)
+        {
+            set_local_code(generate_code(d_gnss_synchro->PRN));
+            return;
+        }
+    if (is_fdma())
+        {
+            update_grid_doppler_wipeoffs();
+        }
+    const std::string key = code_spectrum_key(d_gnss_synchro->PRN, code_variant);
+    std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> spectrum = Acq_Code_Spectra_Cache::instance().find(key);
+    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    if (spectrum == nullptr)
+        {
+            spectrum = Acq_Code_Spectra_Cache::instance().insert(key, compute_code_spectrum(generate_code(d_gnss_synchro->PRN)));
+        }
+    d_fft_codes = std::move(spectrum);
+}
+
+
+void pcps_acquisition::prefill_code_cache(uint32_t first_prn, uint32_t last_prn, const Code_Generator& generate_code, const std::string& code_variant)
+{
+    if (!acq_parameters.code_spectra_cache)
+        {
+            return;
+        }
+    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    for (uint32_t prn = first_prn; prn <= last_prn; prn++)
+        {
+            const std::string key = code_spectrum_key(prn, code_variant);
+            if (Acq_Code_Spectra_Cache::instance().find(key) == nullptr)
+                {
+                    Acq_Code_Spectra_Cache::instance().insert(key, compute_code_spectrum(generate_code(prn)));
+                }
+        }
+}
+
+
+std::string pcps_acquisition::code_spectrum_key(uint32_t prn, const std::string& code_variant) const
+{
+    std::string key(1, d_gnss_synchro->System);
+    key.append(d_gnss_synchro->Signal, 2);
+    key.append("_" + code_variant);
+    key.append("_" + std::to_string(prn));
+    key.append("_" + std::to_string(acq_parameters.use_automatic_resampler ? acq_parameters.resampled_fs : acq_parameters.fs_in));
+    key.append("_" + std::to_string(d_consumed_samples));
+    key.append("_" + std::to_string(d_fft_size));
+    key.append(acq_parameters.bit_transition_flag ? "_bt" : "");
+    return key;
+}
+
+
+std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> pcps_acquisition::compute_code_spectrum(const std::complex<float>* code)
+{
     // COD
     // Here we want to create a buffer that looks like this:
     // [ 0 0 0 ... 0 c_0 c_1 ... c_L]
     // where c_i is the local code and there are L zeros and L chips
-    gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
     if (acq_parameters.bit_transition_flag)
         {
             int32_t offset = d_fft_size / 2;
@@ -227,7 +522,9 @@ void pcps_acquisition::set_local_code(std::complex<float>* code)
         }
 
     d_fft_if->execute();  // We need the FFT of local code
-    volk_32fc_conjugate_32fc(d_fft_codes.data(), d_fft_if->get_outbuf(), d_fft_size);
+    auto fft_codes = std::make_shared<Acq_Code_Spectra_Cache::Spectrum>(d_fft_size);
+    volk_32fc_conjugate_32fc(fft_codes->data(), d_fft_if->get_outbuf(), d_fft_size);
+    return fft_codes;
 }
 
 
@@ -268,6 +565,105 @@ void pcps_acquisition::update_local_carrier(gsl::span<gr_complex> carrier_vector
 }
 
 
+void pcps_acquisition::update_local_carrier_sc(gsl::span<lv_16sc_t> carrier_vector, float freq)
+{
+    volk_gnsssdr::vector<gr_complex> carrier(carrier_vector.size());
+    update_local_carrier(carrier, freq);
+    volk_32f_s32f_multiply_32f(reinterpret_cast<float*>(carrier.data()), reinterpret_cast<const float*>(carrier.data()), d_integer_carrier_amplitude, 2 * carrier.size());
+    volk_gnsssdr_32fc_convert_16ic(carrier_vector.data(), carrier.data(), carrier.size());
+}
+
+
+std::string pcps_acquisition::doppler_wipeoff_key(int32_t freq_hz) const
+{
+    std::string key(std::to_string(acq_parameters.use_automatic_resampler ? acq_parameters.resampled_fs : acq_parameters.fs_in));
+    key.append("_" + std::to_string(d_fft_size));
+    key.append("_" + std::to_string(freq_hz));
+    key.append(d_integer_wipeoff ? "_int" + std::to_string(acq_parameters.integer_input_bits) : "");
+    return key;
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier> pcps_acquisition::doppler_wipeoff(int32_t freq_hz)
+{
+    std::string key;
+    if (acq_parameters.shared_doppler_wipeoffs)
+        {
+            key = doppler_wipeoff_key(freq_hz);
+            auto carrier = Acq_Doppler_Wipeoffs::instance().find(key);
+            if (carrier != nullptr)
+                {
+                    return carrier;
+                }
+        }
+    auto carrier = std::make_shared<Acq_Doppler_Wipeoffs::Carrier>(d_fft_size);
+    update_local_carrier(*carrier, static_cast<float>(freq_hz));
+    if (acq_parameters.shared_doppler_wipeoffs)
+        {
+            return Acq_Doppler_Wipeoffs::instance().insert(key, std::move(carrier));
+        }
+    return carrier;
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier_Sc> pcps_acquisition::doppler_wipeoff_sc(int32_t freq_hz)
+{
+    std::string key;
+    if (acq_parameters.shared_doppler_wipeoffs)
+        {
+            key = doppler_wipeoff_key(freq_hz);
+            auto carrier = Acq_Doppler_Wipeoffs::instance().find_sc(key);
+            if (carrier != nullptr)
+                {
+                    return carrier;
+                }
+        }
+    auto carrier = std::make_shared<Acq_Doppler_Wipeoffs::Carrier_Sc>(d_fft_size);
+    update_local_carrier_sc(*carrier, static_cast<float>(freq_hz));
+    if (acq_parameters.shared_doppler_wipeoffs)
+        {
+            return Acq_Doppler_Wipeoffs::instance().insert_sc(key, std::move(carrier));
+        }
+    return carrier;
+}
+
+
+void pcps_acquisition::integer_doppler_wipeoff(const lv_16sc_t* input, const lv_16sc_t* carrier, gr_complex* fft_input, lv_16sc_t* wipeoff_buffer)
+{
+    // Remove Doppler with 16-bit samples, and widen them to float only at the FFT input
+    volk_gnsssdr_16ic_x2_multiply_16ic(wipeoff_buffer, input, carrier, d_fft_size);
+    volk_gnsssdr_16ic_convert_32fc(fft_input, wipeoff_buffer, d_fft_size);
+}
+
+
+// The carrier amplitude of the integer Doppler wipeoff only avoids the
+// overflow of samples within integer_input_bits bits, so wider ones are
+// clamped to that range
+void pcps_acquisition::clamp_integer_input(lv_16sc_t* samples, uint32_t length)
+{
+    const int16_t max_value = d_integer_input_max;
+    const auto min_value = static_cast<int16_t>(-max_value - 1);
+    const auto clamp = [max_value, min_value](int16_t value) { return std::max(min_value, std::min(max_value, value)); };
+    bool clamped = false;
+    for (uint32_t i = 0; i < length; i++)
+        {
+            const int16_t real = samples[i].real();
+            const int16_t imag = samples[i].imag();
+            if (real > max_value or real < min_value or imag > max_value or imag < min_value)
+                {
+                    samples[i] = lv_16sc_t(clamp(real), clamp(imag));
+                    clamped = true;
+                }
+        }
+    if (clamped and !d_integer_input_clamped)
+        {
+            d_integer_input_clamped = true;
+            LOG(WARNING) << "Input samples of acquisition channel " << d_channel << " exceed integer_input_bits=" << acq_parameters.integer_input_bits
+                         << " bits and are clamped. Set it to the number of bits of the front-end samples";
+        }
+}
+
+
 void pcps_acquisition::init()
 {
     d_gnss_synchro->Flag_valid_acquisition = false;
@@ -282,25 +678,30 @@ void pcps_acquisition::init()
     d_input_power = 0.0;
 
     d_num_doppler_bins = static_cast<uint32_t>(std::ceil(static_cast<double>(static_cast<int32_t>(acq_parameters.doppler_max) - static_cast<int32_t>(-acq_parameters.doppler_max)) / static_cast<double>(d_doppler_step)));
+    update_doppler_window_bins();
 
     // Create the carrier Doppler wipeoff signals
-    if (d_grid_doppler_wipeoffs.empty())
-        {
-            d_grid_doppler_wipeoffs = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
-        }
     if (acq_parameters.make_2_steps && (d_grid_doppler_wipeoffs_step_two.empty()))
         {
             d_grid_doppler_wipeoffs_step_two = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins_step2, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
         }
 
-    if (d_magnitude_grid.empty())
+    if (d_streaming_statistics)
         {
-            d_magnitude_grid = volk_gnsssdr::vector<volk_gnsssdr::vector<float>>(d_num_doppler_bins, volk_gnsssdr::vector<float>(d_fft_size));
+            // Only the peak and the power of each Doppler bin are kept
+            d_bin_power = std::vector<double>(d_num_doppler_bins, 0.0);
         }
-
-    for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+    else
         {
-            std::fill(d_magnitude_grid[doppler_index].begin(), d_magnitude_grid[doppler_index].end(), 0.0);
+            if (d_magnitude_grid.empty())
+                {
+                    d_magnitude_grid = volk_gnsssdr::vector<volk_gnsssdr::vector<float>>(d_num_doppler_bins, volk_gnsssdr::vector<float>(d_fft_size));
+                }
+
+            for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    std::fill(d_magnitude_grid[doppler_index].begin(), d_magnitude_grid[doppler_index].end(), 0.0);
+                }
         }
 
     update_grid_doppler_wipeoffs();
@@ -308,7 +709,7 @@ void pcps_acquisition::init()
 
     if (d_dump)
         {
-            uint32_t effective_fft_size = (acq_parameters.bit_transition_flag ? (d_fft_size / 2) : d_fft_size);
+            uint32_t effective_fft_size = (acq_parameters.bit_transition_flag ? (d_correlation_size / 2) : d_correlation_size);
             grid_ = arma::fmat(effective_fft_size, d_num_doppler_bins, arma::fill::zeros);
             narrow_grid_ = arma::fmat(effective_fft_size, d_num_doppler_bins_step2, arma::fill::zeros);
         }
@@ -317,14 +718,169 @@ void pcps_acquisition::init()
 
 void pcps_acquisition::update_grid_doppler_wipeoffs()
 {
-    for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+    if (acq_parameters.frequency_domain_doppler)
         {
-            int32_t doppler = -static_cast<int32_t>(acq_parameters.doppler_max) + d_doppler_center + d_doppler_step * doppler_index;
-            update_local_carrier(d_grid_doppler_wipeoffs[doppler_index], d_doppler_bias + doppler);
+            update_frequency_domain_doppler_grid();
+        }
+    else
+        {
+            // Moving the grid center by a multiple of the Doppler step only
+            // creates the carriers entering the grid, the rest are reused. The
+            // previous grid is kept alive until the new one is complete.
+            const auto previous_wipeoffs = d_grid_doppler_wipeoffs;
+            const auto previous_wipeoffs_sc = d_grid_doppler_wipeoffs_sc;
+            if (d_integer_wipeoff)
+                {
+                    d_grid_doppler_wipeoffs_sc.resize(d_num_doppler_bins);
+                }
+            else
+                {
+                    d_grid_doppler_wipeoffs.resize(d_num_doppler_bins);
+                }
+            for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    int32_t doppler = -static_cast<int32_t>(acq_parameters.doppler_max) + d_doppler_center + d_doppler_step * doppler_index;
+                    if (d_integer_wipeoff)
+                        {
+                            d_grid_doppler_wipeoffs_sc[doppler_index] = doppler_wipeoff_sc(d_doppler_bias + doppler);
+                        }
+                    else
+                        {
+                            d_grid_doppler_wipeoffs[doppler_index] = doppler_wipeoff(d_doppler_bias + doppler);
+                        }
+                }
+        }
+    if (acq_parameters.shared_input_spectra and d_num_doppler_bins > 0 and d_gnss_synchro != nullptr)
+        {
+            // The grid has changed, so the spectra must be shared with the channels using the new grid
+            d_spectra_server = Acq_Shared_Spectra::get_instance(shared_spectra_key());
         }
 }
 
 
+void pcps_acquisition::update_doppler_window_bins()
+{
+    d_first_doppler_bin = 0U;
+    d_last_doppler_bin = d_num_doppler_bins;
+    d_noise_doppler_bin = d_num_doppler_bins;
+    if (d_doppler_window > 0U and d_doppler_window < acq_parameters.doppler_max and d_doppler_step > 0U)
+        {
+            // Bin i is centered at -doppler_max + i * doppler_step Hz from the Doppler
+            // center, so only the bins overlapping the assisted window are searched
+            const double doppler_max = static_cast<double>(acq_parameters.doppler_max);
+            const double doppler_window = static_cast<double>(d_doppler_window);
+            const double doppler_step = static_cast<double>(d_doppler_step);
+            d_first_doppler_bin = static_cast<uint32_t>(std::floor((doppler_max - doppler_window) / doppler_step));
+            d_last_doppler_bin = std::min(static_cast<uint32_t>(std::ceil((doppler_max + doppler_window) / doppler_step)) + 1U, d_num_doppler_bins);
+            if (d_first_doppler_bin >= d_last_doppler_bin)
+                {
+                    d_first_doppler_bin = 0U;
+                    d_last_doppler_bin = d_num_doppler_bins;
+                }
+            else if (2U * (d_last_doppler_bin - d_first_doppler_bin) <= d_num_doppler_bins)
+                {
+                    // The searched bins are all close to the signal, so the noise power
+                    // is measured in an extra bin half the full grid away from them
+                    const uint32_t center_bin = (d_first_doppler_bin + d_last_doppler_bin) / 2U;
+                    d_noise_doppler_bin = (center_bin + d_num_doppler_bins / 2U) % d_num_doppler_bins;
+                }
+        }
+}
+
+
+uint32_t pcps_acquisition::code_phase_window_size() const
+{
+    if (d_code_window == 0U)
+        {
+            return 0U;
+        }
+    // The window is given in input samples, which are resampled before the search if required
+    const double scale = (acq_parameters.use_automatic_resampler ? 1.0 / static_cast<double>(acq_parameters.resampler_ratio) : 1.0);
+    const double window_size = 2.0 * static_cast<double>(d_code_window) * scale + 1.0;
+    if (window_size >= static_cast<double>(acq_parameters.samples_per_code))
+        {
+            return 0U;
+        }
+    return static_cast<uint32_t>(std::ceil(window_size)) + 1U;
+}
+
+
+void pcps_acquisition::update_code_phase_window(uint64_t samp_count)
+{
+    d_code_window_size = 0U;
+    const uint32_t window_size = code_phase_window_size();
+    if (window_size == 0U)
+        {
+            return;
+        }
+    const double scale = (acq_parameters.use_automatic_resampler ? 1.0 / static_cast<double>(acq_parameters.resampler_ratio) : 1.0);
+    const double samples_per_code = static_cast<double>(acq_parameters.samples_per_code);
+    const double code_window = static_cast<double>(d_code_window) * scale;
+    const double period = d_code_window_period * scale;
+
+    // A code epoch arrives every received code period, so the delay from the
+    // first sample of the dwell to the next epoch decreases as the dwell moves forward
+    const double elapsed = static_cast<double>(samp_count) - static_cast<double>(d_code_window_stamp) * scale;
+    double delay = std::fmod(d_code_window_delay * scale - elapsed, period);
+    if (delay < 0.0)
+        {
+            delay += period;
+        }
+    double first = std::fmod(std::floor(delay - code_window), samples_per_code);
+    if (first < 0.0)
+        {
+            first += samples_per_code;
+        }
+    d_code_window_first = static_cast<uint32_t>(first);
+    d_code_window_size = window_size;
+}
+
+
+uint32_t pcps_acquisition::code_phase_index_max(const float* magnitude, uint32_t num_samples) const
+{
+    uint32_t index = 0U;
+    if (d_code_window_size == 0U or d_code_window_size >= num_samples or d_code_window_first >= num_samples)
+        {
+            volk_gnsssdr_32f_index_max_32u(&index, magnitude, num_samples);
+            return index;
+        }
+
+    // Search only the assisted code delays, which may wrap around the end of the bin
+    const uint32_t first_size = std::min(d_code_window_size, num_samples - d_code_window_first);
+    volk_gnsssdr_32f_index_max_32u(&index, magnitude + d_code_window_first, first_size);
+    index += d_code_window_first;
+    if (first_size < d_code_window_size)
+        {
+            uint32_t wrapped_index = 0U;
+            volk_gnsssdr_32f_index_max_32u(&wrapped_index, magnitude, d_code_window_size - first_size);
+            if (magnitude[wrapped_index] > magnitude[index])
+                {
+                    index = wrapped_index;
+                }
+        }
+    return index;
+}
+
+
+std::string pcps_acquisition::shared_spectra_key() const
+{
+    // Channels can share their input spectra only if they process the same
+    // signal band with exactly the same FFT size and Doppler grid
+    std::string key(d_gnss_synchro->Signal, 2);
+    key.append("_" + acq_parameters.item_type);
+    key.append("_" + std::to_string(acq_parameters.use_automatic_resampler ? acq_parameters.resampled_fs : acq_parameters.fs_in));
+    key.append("_" + std::to_string(d_consumed_samples));
+    key.append("_" + std::to_string(d_fft_size));
+    key.append(acq_parameters.frequency_domain_doppler ? "_fd" : "_td");
+    key.append(d_integer_wipeoff ? "_int" + std::to_string(acq_parameters.integer_input_bits) : "");
+    key.append("_" + std::to_string(d_doppler_bias + d_doppler_center));
+    key.append("_" + std::to_string(acq_parameters.doppler_max));
+    key.append("_" + std::to_string(d_doppler_step));
+    key.append("_" + std::to_string(d_num_doppler_bins));
+    return key;
+}
+
+
 void pcps_acquisition::update_grid_doppler_wipeoffs_step2()
 {
     for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins_step2; doppler_index++)
@@ -335,6 +891,120 @@ void pcps_acquisition::update_grid_doppler_wipeoffs_step2()
 }
 
 
+void pcps_acquisition::update_frequency_domain_doppler_grid()
+{
+    // A Doppler shift of f Hz is a circular shift of f / (fs / d_fft_size) bins
+    // of the input spectrum. The integer part of the shift is applied as an index
+    // offset, and the fractional part as a time-domain wipeoff shared by all the
+    // bins with the same residual. Hence, only one forward FFT per distinct
+    // residual is required (just one if the Doppler step is a multiple of the bin width).
+    const double fs = acq_parameters.use_automatic_resampler ? static_cast<double>(acq_parameters.resampled_fs) : static_cast<double>(acq_parameters.fs_in);
+    const double bin_width_hz = fs / static_cast<double>(d_fft_size);
+    const auto fft_size = static_cast<int64_t>(d_fft_size);
+    std::vector<double> fractions;
+    d_doppler_bin_shift.resize(d_num_doppler_bins);
+    d_doppler_bin_fraction.resize(d_num_doppler_bins);
+    for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            int32_t doppler = -static_cast<int32_t>(acq_parameters.doppler_max) + d_doppler_center + d_doppler_step * doppler_index;
+            const double shift = static_cast<double>(d_doppler_bias + doppler) / bin_width_hz;
+            const double integer_shift = std::round(shift);
+            const double fraction = shift - integer_shift;
+            auto it = std::find_if(fractions.begin(), fractions.end(), [fraction](double f) { return std::abs(f - fraction) < 1e-3; });
+            if (it == fractions.end())
+                {
+                    it = fractions.insert(fractions.end(), fraction);
+                }
+            d_doppler_bin_fraction[doppler_index] = static_cast<uint32_t>(std::distance(fractions.begin(), it));
+            d_doppler_bin_shift[doppler_index] = static_cast<uint32_t>(((static_cast<int64_t>(integer_shift) % fft_size) + fft_size) % fft_size);
+        }
+
+    if (d_integer_wipeoff)
+        {
+            if (d_fractional_bin_wipeoffs_sc.size() != fractions.size())
+                {
+                    d_fractional_bin_wipeoffs_sc = volk_gnsssdr::vector<volk_gnsssdr::vector<lv_16sc_t>>(fractions.size(), volk_gnsssdr::vector<lv_16sc_t>(d_fft_size));
+                }
+            for (size_t i = 0; i < fractions.size(); i++)
+                {
+                    update_local_carrier_sc(d_fractional_bin_wipeoffs_sc[i], static_cast<float>(fractions[i] * bin_width_hz));
+                }
+        }
+    else
+        {
+            if (d_fractional_bin_wipeoffs.size() != fractions.size())
+                {
+                    d_fractional_bin_wipeoffs = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(fractions.size(), volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
+                }
+            for (size_t i = 0; i < fractions.size(); i++)
+                {
+                    update_local_carrier(d_fractional_bin_wipeoffs[i], static_cast<float>(fractions[i] * bin_width_hz));
+                }
+        }
+}
+
+
+void pcps_acquisition::compute_input_spectra(const gr_complex* in, Acq_Shared_Spectra::Spectra& spectra)
+{
+    // One spectrum per fractional bin offset in the frequency-domain search, one per Doppler bin otherwise
+    std::vector<const gr_complex*> wipeoffs;
+    std::vector<const lv_16sc_t*> wipeoffs_sc;
+    if (acq_parameters.frequency_domain_doppler)
+        {
+            for (const auto& wipeoff : d_fractional_bin_wipeoffs)
+                {
+                    wipeoffs.push_back(wipeoff.data());
+                }
+            for (const auto& wipeoff : d_fractional_bin_wipeoffs_sc)
+                {
+                    wipeoffs_sc.push_back(wipeoff.data());
+                }
+        }
+    else
+        {
+            for (const auto& wipeoff : d_grid_doppler_wipeoffs)
+                {
+                    wipeoffs.push_back(wipeoff->data());
+                }
+            for (const auto& wipeoff : d_grid_doppler_wipeoffs_sc)
+                {
+                    wipeoffs_sc.push_back(wipeoff->data());
+                }
+        }
+    const size_t num_spectra = (d_integer_wipeoff ? wipeoffs_sc.size() : wipeoffs.size());
+    if (spectra.size() != num_spectra)
+        {
+            spectra = Acq_Shared_Spectra::Spectra(num_spectra, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
+        }
+    for (size_t i = 0; i < num_spectra; i++)
+        {
+            if (d_integer_wipeoff)
+                {
+                    integer_doppler_wipeoff(d_input_signal_sc.data(), wipeoffs_sc[i], d_fft_if->get_inbuf(), d_wipeoff_buffer_sc.data());
+                }
+            else
+                {
+                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, wipeoffs[i], d_fft_size);
+                }
+            d_fft_if->execute();
+            memcpy(spectra[i].data(), d_fft_if->get_outbuf(), sizeof(gr_complex) * d_fft_size);
+        }
+}
+
+
+void pcps_acquisition::multiply_shifted_spectrum(uint32_t doppler_index, const Acq_Shared_Spectra::Spectra& spectra, gr_complex* out)
+{
+    // out[k] = X[(k + shift) mod N] * C[k]
+    const uint32_t shift = d_doppler_bin_shift[doppler_index];
+    const gr_complex* spectrum = spectra[d_doppler_bin_fraction[doppler_index]].data();
+    volk_32fc_x2_multiply_32fc(out, spectrum + shift, d_fft_codes->data(), d_fft_size - shift);
+    if (shift > 0)
+        {
+            volk_32fc_x2_multiply_32fc(out + d_fft_size - shift, spectrum, d_fft_codes->data() + d_fft_size - shift, shift);
+        }
+}
+
+
 void pcps_acquisition::set_state(int32_t state)
 {
     gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
@@ -510,28 +1180,60 @@ void pcps_acquisition::dump_results(int32_t effective_fft_size)
 
 float pcps_acquisition::max_to_input_power_statistic(uint32_t& indext, int32_t& doppler, uint32_t num_doppler_bins, int32_t doppler_max, int32_t doppler_step)
 {
+    // Only the assisted Doppler window is searched in the first step
+    const uint32_t first_bin = (d_step_two ? 0U : d_first_doppler_bin);
+    const uint32_t last_bin = (d_step_two ? num_doppler_bins : d_last_doppler_bin);
     float grid_maximum = 0.0;
-    uint32_t index_doppler = 0U;
+    uint32_t index_doppler = first_bin;
     uint32_t tmp_intex_t = 0U;
     uint32_t index_time = 0U;
-    int32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_fft_size / 2 : d_fft_size);
+    int32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_correlation_size / 2 : d_correlation_size);
 
     // Find the correlation peak and the carrier frequency
-    for (uint32_t i = 0; i < num_doppler_bins; i++)
+    if (d_streaming_statistics)
         {
-            volk_gnsssdr_32f_index_max_32u(&tmp_intex_t, d_magnitude_grid[i].data(), effective_fft_size);
-            if (d_magnitude_grid[i][tmp_intex_t] > grid_maximum)
+            grid_maximum = d_peak_searches[0].peak;
+            index_doppler = d_peak_searches[0].doppler_index;
+            index_time = d_peak_searches[0].delay_index;
+        }
+    else
+        {
+            for (uint32_t i = first_bin; i < last_bin; i++)
                 {
-                    grid_maximum = d_magnitude_grid[i][tmp_intex_t];
-                    index_doppler = i;
-                    index_time = tmp_intex_t;
+                    tmp_intex_t = code_phase_index_max(d_magnitude_grid[i].data(), effective_fft_size);
+                    if (d_magnitude_grid[i][tmp_intex_t] > grid_maximum)
+                        {
+                            grid_maximum = d_magnitude_grid[i][tmp_intex_t];
+                            index_doppler = i;
+                            index_time = tmp_intex_t;
+                        }
                 }
         }
     indext = index_time;
     if (!d_step_two)
         {
-            int index_opp = (index_doppler + d_num_doppler_bins / 2) % d_num_doppler_bins;
-            d_input_power = std::accumulate(d_magnitude_grid[index_opp].data(), d_magnitude_grid[index_opp].data() + effective_fft_size, 0.0) / effective_fft_size / 2.0 / d_num_noncoherent_integrations_counter;
+            // The noise power is measured in a bin far from the peak
+            const uint32_t searched_bins = last_bin - first_bin;
+            uint32_t index_opp = first_bin + (index_doppler - first_bin + searched_bins / 2) % searched_bins;
+            if (d_noise_doppler_bin < d_num_doppler_bins)
+                {
+                    index_opp = d_noise_doppler_bin;
+                }
+            if (d_streaming_statistics)
+                {
+                    d_input_power = d_bin_power[index_opp] / effective_fft_size / 2.0 / d_num_noncoherent_integrations_counter;
+                }
+            else
+                {
+                    d_input_power = std::accumulate(d_magnitude_grid[index_opp].data(), d_magnitude_grid[index_opp].data() + effective_fft_size, 0.0) / effective_fft_size / 2.0 / d_num_noncoherent_integrations_counter;
+                }
+            if (d_integer_wipeoff)
+                {
+                    // Express the power in the units of the floating point datapath, used in step two
+                    const float grid_scale = d_integer_carrier_amplitude * d_integer_carrier_amplitude;
+                    grid_maximum /= grid_scale;
+                    d_input_power /= grid_scale;
+                }
             doppler = -static_cast<int32_t>(doppler_max) + d_doppler_center + doppler_step * static_cast<int32_t>(index_doppler);
         }
     else
@@ -549,20 +1251,32 @@ float pcps_acquisition::first_vs_second_peak_statistic(uint32_t& indext, int32_t
     // Find the highest peak and compare it to the second highest peak
     // The second peak is chosen not closer than 1 chip to the highest peak
 
+    // Only the assisted Doppler window is searched in the first step
+    const uint32_t first_bin = (d_step_two ? 0U : d_first_doppler_bin);
+    const uint32_t last_bin = (d_step_two ? num_doppler_bins : d_last_doppler_bin);
     float firstPeak = 0.0;
-    uint32_t index_doppler = 0U;
+    uint32_t index_doppler = first_bin;
     uint32_t tmp_intex_t = 0U;
     uint32_t index_time = 0U;
 
     // Find the correlation peak and the carrier frequency
-    for (uint32_t i = 0; i < num_doppler_bins; i++)
+    if (d_streaming_statistics)
+        {
+            firstPeak = d_peak_searches[0].peak;
+            index_doppler = d_peak_searches[0].doppler_index;
+            index_time = d_peak_searches[0].delay_index;
+        }
+    else
         {
-            volk_gnsssdr_32f_index_max_32u(&tmp_intex_t, d_magnitude_grid[i].data(), d_fft_size);
-            if (d_magnitude_grid[i][tmp_intex_t] > firstPeak)
+            for (uint32_t i = first_bin; i < last_bin; i++)
                 {
-                    firstPeak = d_magnitude_grid[i][tmp_intex_t];
-                    index_doppler = i;
-                    index_time = tmp_intex_t;
+                    tmp_intex_t = code_phase_index_max(d_magnitude_grid[i].data(), d_correlation_size);
+                    if (d_magnitude_grid[i][tmp_intex_t] > firstPeak)
+                        {
+                            firstPeak = d_magnitude_grid[i][tmp_intex_t];
+                            index_doppler = i;
+                            index_time = tmp_intex_t;
+                        }
                 }
         }
     indext = index_time;
@@ -583,20 +1297,29 @@ float pcps_acquisition::first_vs_second_peak_statistic(uint32_t& indext, int32_t
     // Correct code phase exclude range if the range includes array boundaries
     if (excludeRangeIndex1 < 0)
         {
-            excludeRangeIndex1 = d_fft_size + excludeRangeIndex1;
+            excludeRangeIndex1 = d_correlation_size + excludeRangeIndex1;
         }
-    else if (excludeRangeIndex2 >= static_cast<int32_t>(d_fft_size))
+    else if (excludeRangeIndex2 >= static_cast<int32_t>(d_correlation_size))
         {
-            excludeRangeIndex2 = excludeRangeIndex2 - d_fft_size;
+            excludeRangeIndex2 = excludeRangeIndex2 - d_correlation_size;
         }
 
     int32_t idx = excludeRangeIndex1;
-    memcpy(d_tmp_buffer.data(), d_magnitude_grid[index_doppler].data(), d_fft_size);
+    float* peak_bin = d_tmp_buffer.data();
+    if (d_streaming_statistics)
+        {
+            // The running peak search kept a copy of the bin, which is not needed anymore
+            peak_bin = d_peak_searches[0].peak_bin.data();
+        }
+    else
+        {
+            memcpy(d_tmp_buffer.data(), d_magnitude_grid[index_doppler].data(), d_correlation_size);
+        }
     do
         {
-            d_tmp_buffer[idx] = 0.0;
+            peak_bin[idx] = 0.0;
             idx++;
-            if (idx == static_cast<int32_t>(d_fft_size))
+            if (idx == static_cast<int32_t>(d_correlation_size))
                 {
                     idx = 0;
                 }
@@ -604,38 +1327,293 @@ float pcps_acquisition::first_vs_second_peak_statistic(uint32_t& indext, int32_t
     while (idx != excludeRangeIndex2);
 
     // Find the second highest correlation peak in the same freq. bin ---
-    volk_gnsssdr_32f_index_max_32u(&tmp_intex_t, d_tmp_buffer.data(), d_fft_size);
-    float secondPeak = d_tmp_buffer[tmp_intex_t];
+    volk_gnsssdr_32f_index_max_32u(&tmp_intex_t, peak_bin, d_correlation_size);
+    float secondPeak = peak_bin[tmp_intex_t];
 
     // Compute the test statistics and compare to the threshold
     return firstPeak / secondPeak;
 }
 
 
-void pcps_acquisition::acquisition_core(uint64_t samp_count)
+void pcps_acquisition::process_doppler_bin(uint32_t doppler_index, const gr_complex* in, gr::fft::fft_complex* fft_if, gr::fft::fft_complex* ifft, float* tmp_buffer, lv_16sc_t* wipeoff_buffer, Peak_Search& peak_search)
+{
+    const int32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_correlation_size / 2 : d_correlation_size);
+    if (acq_parameters.frequency_domain_doppler)
+        {
+            // Remove Doppler by shifting the input spectrum, and multiply it with the local FFT'd code reference
+            multiply_shifted_spectrum(doppler_index, acq_parameters.shared_input_spectra ? *d_shared_spectra : d_input_spectra, ifft->get_inbuf());
+        }
+    else if (acq_parameters.shared_input_spectra)
+        {
+            // Multiply the shared carrier wiped--off, Fourier transformed incoming signal with the local FFT'd code reference
+            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), (*d_shared_spectra)[doppler_index].data(), d_fft_codes->data(), d_fft_size);
+        }
+    else
+        {
+            // Remove Doppler
+            if (d_integer_wipeoff)
+                {
+                    integer_doppler_wipeoff(d_input_signal_sc.data(), d_grid_doppler_wipeoffs_sc[doppler_index]->data(), fft_if->get_inbuf(), wipeoff_buffer);
+                }
+            else
+                {
+                    volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs[doppler_index]->data(), d_fft_size);
+                }
+
+            // Perform the FFT-based convolution  (parallel time search)
+            // Compute the FFT of the carrier wiped--off incoming signal
+            fft_if->execute();
+
+            // Multiply carrier wiped--off, Fourier transformed incoming signal with the local FFT'd code reference
+            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), fft_if->get_outbuf(), d_fft_codes->data(), d_fft_size);
+        }
+
+    // Compute the inverse FFT
+    ifft->execute();
+
+    // Compute squared magnitude (and accumulate in case of non-coherent integration)
+    size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
+    if (d_streaming_statistics)
+        {
+            // Fold the bin into the running statistics, there is no grid to store it
+            volk_32fc_magnitude_squared_32f(tmp_buffer, ifft->get_outbuf() + offset, effective_fft_size);
+            accumulate_previous_dwells(doppler_index, fft_if, ifft, tmp_buffer, wipeoff_buffer);
+            fold_doppler_bin(doppler_index, tmp_buffer, peak_search);
+            return;
+        }
+    if (d_num_noncoherent_integrations_counter == 1)
+        {
+            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), ifft->get_outbuf() + offset, effective_fft_size);
+        }
+    else
+        {
+            volk_32fc_magnitude_squared_32f(tmp_buffer, ifft->get_outbuf() + offset, effective_fft_size);
+            volk_32f_x2_add_32f(d_magnitude_grid[doppler_index].data(), d_magnitude_grid[doppler_index].data(), tmp_buffer, effective_fft_size);
+        }
+    // Record results to file if required
+    if (d_dump and d_channel == d_dump_channel)
+        {
+            memcpy(grid_.colptr(doppler_index), d_magnitude_grid[doppler_index].data(), sizeof(float) * effective_fft_size);
+        }
+}
+
+
+void pcps_acquisition::fold_doppler_bin(uint32_t doppler_index, const float* magnitude, Peak_Search& peak_search)
+{
+    const uint32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_correlation_size / 2 : d_correlation_size);
+    const uint32_t index_time = code_phase_index_max(magnitude, effective_fft_size);
+    if (magnitude[index_time] > peak_search.peak)
+        {
+            peak_search.peak = magnitude[index_time];
+            peak_search.doppler_index = doppler_index;
+            peak_search.delay_index = index_time;
+            memcpy(peak_search.peak_bin.data(), magnitude, sizeof(float) * effective_fft_size);
+        }
+    if (!d_step_two)
+        {
+            d_bin_power[doppler_index] = std::accumulate(magnitude, magnitude + effective_fft_size, 0.0);
+        }
+}
+
+
+void pcps_acquisition::accumulate_previous_dwells(uint32_t doppler_index, gr::fft::fft_complex* fft_if, gr::fft::fft_complex* ifft, float* magnitude, lv_16sc_t* wipeoff_buffer)
+{
+    // Non-coherent integration without a grid: the bin is correlated again
+    // with each earlier dwell of the rolling buffer and the magnitudes added up
+    const uint32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_correlation_size / 2 : d_correlation_size);
+    const size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
+    for (uint32_t dwell = 0; dwell < d_num_previous_dwells; dwell++)
+        {
+            if (d_step_two)
+                {
+                    volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), d_previous_dwells[dwell].data(), d_grid_doppler_wipeoffs_step_two[doppler_index].data(), d_fft_size);
+                }
+            else if (d_integer_wipeoff)
+                {
+                    integer_doppler_wipeoff(d_previous_dwells_sc[dwell].data(), d_grid_doppler_wipeoffs_sc[doppler_index]->data(), fft_if->get_inbuf(), wipeoff_buffer);
+                }
+            else
+                {
+                    volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), d_previous_dwells[dwell].data(), d_grid_doppler_wipeoffs[doppler_index]->data(), d_fft_size);
+                }
+            fft_if->execute();
+            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), fft_if->get_outbuf(), d_fft_codes->data(), d_fft_size);
+            ifft->execute();
+            const gr_complex* correlation = ifft->get_outbuf() + offset;
+            for (uint32_t i = 0; i < effective_fft_size; i++)
+                {
+                    magnitude[i] += std::norm(correlation[i]);
+                }
+        }
+}
+
+
+void pcps_acquisition::store_dwell()
+{
+    // Keep the input of this dwell for the next ones of the same non-coherent integration
+    if (d_num_previous_dwells >= d_previous_dwells.size())
+        {
+            return;
+        }
+    if (d_integer_wipeoff and !d_step_two)
+        {
+            memcpy(d_previous_dwells_sc[d_num_previous_dwells].data(), d_input_signal_sc.data(), d_fft_size * sizeof(lv_16sc_t));
+        }
+    else
+        {
+            memcpy(d_previous_dwells[d_num_previous_dwells].data(), d_input_signal.data(), d_fft_size * sizeof(gr_complex));
+        }
+    d_num_previous_dwells++;
+}
+
+
+void pcps_acquisition::reset_peak_searches()
+{
+    for (auto& peak_search : d_peak_searches)
+        {
+            peak_search.peak = 0.0;
+            peak_search.doppler_index = (d_step_two ? 0U : d_first_doppler_bin);
+            peak_search.delay_index = 0U;
+        }
+    d_noise_peak_search.peak = 0.0;
+}
+
+
+void pcps_acquisition::merge_peak_searches()
+{
+    // Slices cover consecutive ranges of Doppler bins, so keeping the first
+    // strictly greater peak gives the same result as the serial search
+    for (size_t i = 1; i < d_peak_searches.size(); i++)
+        {
+            if (d_peak_searches[i].peak > d_peak_searches[0].peak)
+                {
+                    std::swap(d_peak_searches[0], d_peak_searches[i]);
+                }
+        }
+}
+
+
+void pcps_acquisition::parallel_doppler_search(const gr_complex* in)
+{
+    // The Doppler grid is split in contiguous slices, each one processed with
+    // its own FFT plans and scratch buffer. Slices are claimed from a shared
+    // counter both by this thread and by helper jobs queued in the acquisition
+    // executor, so the search completes even if no worker is available. Every
+    // bin is computed exactly as in the serial search and the peak and CFAR
+    // statistics are obtained afterwards from the full grid, so the result is
+    // identical to that of the serial path.
+    struct Slices
+    {
+        std::atomic<uint32_t> next{0};
+        uint32_t done{0};
+        std::exception_ptr error;  // first exception thrown by a slice
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    const auto num_slices = static_cast<uint32_t>(d_worker_fft_if.size() + 1);
+    auto slices = std::make_shared<Slices>();
+    auto run_slices = [this, in, slices, num_slices]() {
+        uint32_t slice;
+        while ((slice = slices->next++) < num_slices)
+            {
+                gr::fft::fft_complex* fft_if = (slice == 0 ? d_fft_if.get() : d_worker_fft_if[slice - 1].get());
+                gr::fft::fft_complex* ifft = (slice == 0 ? d_ifft.get() : d_worker_ifft[slice - 1].get());
+                float* tmp_buffer = (slice == 0 ? d_tmp_buffer.data() : d_worker_tmp_buffer[slice - 1].data());
+                lv_16sc_t* wipeoff_buffer = nullptr;
+                if (d_integer_wipeoff)
+                    {
+                        wipeoff_buffer = (slice == 0 ? d_wipeoff_buffer_sc.data() : d_worker_wipeoff_buffer_sc[slice - 1].data());
+                    }
+                const uint32_t searched_bins = d_last_doppler_bin - d_first_doppler_bin;
+                const uint32_t first_bin = d_first_doppler_bin + slice * searched_bins / num_slices;
+                const uint32_t last_bin = d_first_doppler_bin + (slice + 1) * searched_bins / num_slices;
+                std::exception_ptr error;
+                try
+                    {
+                        for (uint32_t doppler_index = first_bin; doppler_index < last_bin; doppler_index++)
+                            {
+                                process_doppler_bin(doppler_index, in, fft_if, ifft, tmp_buffer, wipeoff_buffer, d_peak_searches[slice]);
+                            }
+                    }
+                catch (...)
+                    {
+                        // A slice processed in the executor must still be counted as done
+                        error = std::current_exception();
+                    }
+                std::lock_guard<std::mutex> lock(slices->mutex);
+                if (error and !slices->error)
+                    {
+                        slices->error = error;
+                    }
+                if (++slices->done == num_slices)
+                    {
+                        slices->finished.notify_all();
+                    }
+            }
+    };
+
+    for (uint32_t i = 1; i < num_slices; i++)
+        {
+            if (!d_executor->submit(run_slices))
+                {
+                    break;
+                }
+        }
+    run_slices();
+    std::unique_lock<std::mutex> lock(slices->mutex);
+    slices->finished.wait(lock, [&slices, num_slices] { return slices->done == num_slices; });
+    if (slices->error)
+        {
+            std::rethrow_exception(slices->error);
+        }
+}
+
+
+void pcps_acquisition::acquisition_core(uint64_t samp_count, const gr_complex* samples, const lv_16sc_t* samples_sc)
 {
     gr::thread::scoped_lock lk(d_setlock);
 
     // Initialize acquisition algorithm
     int32_t doppler = 0;
     uint32_t indext = 0U;
-    int32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_fft_size / 2 : d_fft_size);
-    if (d_cshort)
+    int32_t effective_fft_size = (acq_parameters.bit_transition_flag ? d_correlation_size / 2 : d_correlation_size);
+    if (d_integer_wipeoff)
         {
-            volk_gnsssdr_16ic_convert_32fc(d_data_buffer.data(), d_data_buffer_sc.data(), d_consumed_samples);
+            // Keep the samples in 16 bits. The zero padding of d_input_signal_sc is never overwritten
+            memcpy(d_input_signal_sc.data(), samples_sc, d_consumed_samples * sizeof(lv_16sc_t));
         }
-    memcpy(d_input_signal.data(), d_data_buffer.data(), d_consumed_samples * sizeof(gr_complex));
-    if (d_fft_size > d_consumed_samples)
+    if (!d_integer_wipeoff or d_step_two)
         {
-            for (uint32_t i = d_consumed_samples; i < d_fft_size; i++)
+            if (d_cshort)
+                {
+                    volk_gnsssdr_16ic_convert_32fc(d_input_signal.data(), samples_sc, d_consumed_samples);
+                }
+            else
+                {
+                    memcpy(d_input_signal.data(), samples, d_consumed_samples * sizeof(gr_complex));
+                }
+            if (d_fft_size > d_consumed_samples)
                 {
-                    d_input_signal[i] = gr_complex(0.0, 0.0);
+                    for (uint32_t i = d_consumed_samples; i < d_fft_size; i++)
+                        {
+                            d_input_signal[i] = gr_complex(0.0, 0.0);
+                        }
                 }
         }
     const gr_complex* in = d_input_signal.data();  // Get the input samples pointer
 
     d_mag = 0.0;
     d_num_noncoherent_integrations_counter++;
+    if (d_num_noncoherent_integrations_counter == 1)
+        {
+            // A new non-coherent integration starts with this dwell
+            d_num_previous_dwells = 0U;
+        }
+    update_code_phase_window(samp_count);
+    if (d_streaming_statistics)
+        {
+            reset_peak_searches();
+        }
 
     DLOG(INFO) << "Channel: " << d_channel
                << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
@@ -649,38 +1627,37 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
     // Doppler frequency grid loop
     if (!d_step_two)
         {
-            for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+            if (acq_parameters.shared_input_spectra)
                 {
-                    // Remove Doppler
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs[doppler_index].data(), d_fft_size);
-
-                    // Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal with the local FFT'd code reference
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
-
-                    // Compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Compute squared magnitude (and accumulate in case of non-coherent integration)
-                    size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
-                    if (d_num_noncoherent_integrations_counter == 1)
-                        {
-                            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), d_ifft->get_outbuf() + offset, effective_fft_size);
-                        }
-                    else
+                    // Get the Doppler-wiped input spectra of this dwell, computed only by the first channel asking for them
+                    d_shared_spectra = d_spectra_server->get_spectra(samp_count, [this, in](Acq_Shared_Spectra::Spectra& spectra) { compute_input_spectra(in, spectra); });
+                }
+            else if (acq_parameters.frequency_domain_doppler)
+                {
+                    // Compute the FFT of the incoming signal only once per fractional bin offset
+                    compute_input_spectra(in, d_input_spectra);
+                }
+            if (d_worker_fft_if.empty())
+                {
+                    for (uint32_t doppler_index = d_first_doppler_bin; doppler_index < d_last_doppler_bin; doppler_index++)
                         {
-                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), d_ifft->get_outbuf() + offset, effective_fft_size);
-                            volk_32f_x2_add_32f(d_magnitude_grid[doppler_index].data(), d_magnitude_grid[doppler_index].data(), d_tmp_buffer.data(), effective_fft_size);
+                            process_doppler_bin(doppler_index, in, d_fft_if.get(), d_ifft.get(), d_tmp_buffer.data(), d_wipeoff_buffer_sc.data(), d_peak_searches[0]);
                         }
-                    // Record results to file if required
-                    if (d_dump and d_channel == d_dump_channel)
+                }
+            else
+                {
+                    parallel_doppler_search(in);
+                    if (d_streaming_statistics)
                         {
-                            memcpy(grid_.colptr(doppler_index), d_magnitude_grid[doppler_index].data(), sizeof(float) * effective_fft_size);
+                            merge_peak_searches();
                         }
                 }
+            if (d_use_CFAR_algorithm_flag and d_noise_doppler_bin < d_num_doppler_bins)
+                {
+                    // Not a candidate for the peak, it only measures the noise power
+                    process_doppler_bin(d_noise_doppler_bin, in, d_fft_if.get(), d_ifft.get(), d_tmp_buffer.data(), d_wipeoff_buffer_sc.data(), d_noise_peak_search);
+                }
+            d_shared_spectra.reset();
 
             // Compute the test statistic
             if (d_use_CFAR_algorithm_flag)
@@ -718,13 +1695,19 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
 
                     // Multiply carrier wiped--off, Fourier transformed incoming signal
                     // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
+                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes->data(), d_fft_size);
 
                     // compute the inverse FFT
                     d_ifft->execute();
 
                     size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
-                    if (d_num_noncoherent_integrations_counter == 1)
+                    if (d_streaming_statistics)
+                        {
+                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), d_ifft->get_outbuf() + offset, effective_fft_size);
+                            accumulate_previous_dwells(doppler_index, d_fft_if.get(), d_ifft.get(), d_tmp_buffer.data(), d_wipeoff_buffer_sc.data());
+                            fold_doppler_bin(doppler_index, d_tmp_buffer.data(), d_peak_searches[0]);
+                        }
+                    else if (d_num_noncoherent_integrations_counter == 1)
                         {
                             volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), d_ifft->get_outbuf() + offset, effective_fft_size);
                         }
@@ -767,6 +1750,11 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
                 }
         }
 
+    if (d_rolling_dwells)
+        {
+            store_dwell();
+        }
+
     lk.lock();
     if (!acq_parameters.bit_transition_flag)
         {
@@ -784,6 +1772,7 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
                             else
                                 {
                                     d_step_two = true;  // Clear input buffer and make small grid acquisition
+                                    release_captured_dwells();
                                     d_num_noncoherent_integrations_counter = 0;
                                     d_positive_acq = 0;
                                     d_state = 0;
@@ -796,8 +1785,9 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
                             d_state = 0;  // Positive acquisition
                         }
                 }
-            else
+            else if (!d_pipelined_dwells)
                 {
+                    // Capture the next dwell. With pipelined dwells, it is already being captured
                     d_buffer_count = 0;
                     d_state = 1;
                 }
@@ -834,6 +1824,7 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
                             else
                                 {
                                     d_step_two = true;  // Clear input buffer and make small grid acquisition
+                                    release_captured_dwells();
                                     d_num_noncoherent_integrations_counter = 0U;
                                     d_state = 0;
                                 }
@@ -857,7 +1848,6 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
                     send_negative_acquisition();
                 }
         }
-    d_worker_active = false;
 
     if ((d_num_noncoherent_integrations_counter == acq_parameters.max_dwells) or (d_positive_acq == 1))
         {
@@ -869,17 +1859,113 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
             d_num_noncoherent_integrations_counter = 0U;
             d_positive_acq = 0;
             // Reset grid
-            for (uint32_t i = 0; i < d_num_doppler_bins; i++)
+            if (!d_streaming_statistics)
+                {
+                    for (uint32_t i = 0; i < d_num_doppler_bins; i++)
+                        {
+                            for (uint32_t k = 0; k < d_fft_size; k++)
+                                {
+                                    d_magnitude_grid[i][k] = 0.0;
+                                }
+                        }
+                }
+        }
+}
+
+
+// Job of the acquisition executor for one dwell, without pipelined dwells
+void pcps_acquisition::process_dwell(uint64_t samp_count)
+{
+    gr::thread::scoped_lock lk(d_setlock, boost::defer_lock);
+    const Worker_Active_Guard worker_active_guard(d_worker_active, lk);
+    std::string failure;
+    try
+        {
+            acquisition_core(samp_count, d_data_buffer.data(), d_data_buffer_sc.data());
+        }
+    catch (const std::exception& e)
+        {
+            failure = e.what();
+        }
+    catch (...)
+        {
+            failure = "unknown exception";
+        }
+    if (!failure.empty())
+        {
+            lk.lock();
+            abort_acquisition(failure);
+        }
+}
+
+
+void pcps_acquisition::process_captured_dwells()
+{
+    // Process the captured dwells in order, while general_work keeps capturing the next ones
+    gr::thread::scoped_lock lk(d_setlock);
+    const Worker_Active_Guard worker_active_guard(d_worker_active, lk);  // cleared when no captured dwell is left
+    while (!d_captured_dwells.empty())
+        {
+            Captured_Dwell dwell = std::move(d_captured_dwells.front());
+            d_captured_dwells.pop_front();
+            if (d_active)
                 {
-                    for (uint32_t k = 0; k < d_fft_size; k++)
+                    lk.unlock();
+                    std::string failure;
+                    try
+                        {
+                            acquisition_core(dwell.sample_stamp, dwell.samples.data(), dwell.samples_sc.data());
+                        }
+                    catch (const std::exception& e)
+                        {
+                            failure = e.what();
+                        }
+                    catch (...)
+                        {
+                            failure = "unknown exception";
+                        }
+                    lk.lock();
+                    if (!failure.empty())
                         {
-                            d_magnitude_grid[i][k] = 0.0;
+                            abort_acquisition(failure);
                         }
                 }
+            // Once the acquisition has finished, the remaining dwells are just released
+            d_free_dwells.push_back(std::move(dwell));
         }
 }
 
 
+// The dwells captured for the first step are not valid for the verification
+// of the second step, nor after a restart, so their buffers are released and
+// fresh samples are captured. Called with d_setlock held
+void pcps_acquisition::release_captured_dwells()
+{
+    while (!d_captured_dwells.empty())
+        {
+            d_free_dwells.push_back(std::move(d_captured_dwells.front()));
+            d_captured_dwells.pop_front();
+        }
+}
+
+
+void pcps_acquisition::abort_acquisition(const std::string& failure)
+{
+    LOG(ERROR) << "Exception in the acquisition of channel " << d_channel << ": " << failure;
+    // The search is reported as negative, so that the channel can move on
+    release_captured_dwells();
+    d_active = false;
+    d_state = 0;
+    d_num_noncoherent_integrations_counter = 0U;
+    if (d_step_two)
+        {
+            d_step_two = false;
+            calculate_threshold();
+        }
+    send_negative_acquisition();
+}
+
+
 // Called by gnuradio to enable drivers, etc for i/o devices.
 bool pcps_acquisition::start()
 {
@@ -898,10 +1984,22 @@ void pcps_acquisition::calculate_threshold()
             return;
         }
 
-    int effective_fft_size = (acq_parameters.bit_transition_flag ? (d_fft_size / 2) : d_fft_size);
-    int num_doppler_bins = (d_step_two ? d_num_doppler_bins_step2 : d_num_doppler_bins);
+    int effective_fft_size = (acq_parameters.bit_transition_flag ? (d_correlation_size / 2) : d_correlation_size);
+    int num_doppler_bins = (d_step_two ? d_num_doppler_bins_step2 : static_cast<int>(d_last_doppler_bin - d_first_doppler_bin));
 
-    int num_bins = effective_fft_size * num_doppler_bins;
+    // Only the cells of the assisted windows are searched in the first step,
+    // so the false alarms can only happen there
+    int num_code_delays = effective_fft_size;
+    const auto code_window_size = static_cast<int>(code_phase_window_size());
+    if (!d_step_two and code_window_size > 0 and code_window_size < effective_fft_size)
+        {
+            num_code_delays = code_window_size;
+        }
+    int num_bins = num_code_delays * num_doppler_bins;
+    if (num_bins <= 0)
+        {
+            return;
+        }
 
     d_threshold = 2.0 * boost::math::gamma_p_inv(2.0 * acq_parameters.max_dwells, std::pow(1.0 - pfa, 1.0 / static_cast<float>(num_bins)));
 }
@@ -923,7 +2021,7 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
      * 6. Declare positive or negative acquisition using a message port
      */
     gr::thread::scoped_lock lk(d_setlock);
-    if (!d_active or d_worker_active)
+    if (!d_active or (d_worker_active and !d_pipelined_dwells))
         {
             if (!acq_parameters.blocking_on_standby)
                 {
@@ -952,6 +2050,8 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
                 d_mag = 0.0;
                 d_state = 1;
                 d_buffer_count = 0U;
+                // Dwells captured before the restart are not processed
+                release_captured_dwells();
                 if (!acq_parameters.blocking_on_standby)
                     {
                         d_sample_counter += static_cast<uint64_t>(ninput_items[0]);  // sample counter
@@ -961,8 +2061,41 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
             }
         case 1:
             {
+                if (acq_parameters.shared_input_spectra and !d_step_two and (d_buffer_count == 0))
+                    {
+                        // Start the dwell at a multiple of the dwell length, so all the
+                        // channels searching this band at once can share their input spectra
+                        const auto misalignment = static_cast<uint32_t>(d_sample_counter % d_consumed_samples);
+                        if (misalignment != 0)
+                            {
+                                const uint32_t skip = std::min(d_consumed_samples - misalignment, static_cast<uint32_t>(ninput_items[0]));
+                                d_sample_counter += static_cast<uint64_t>(skip);
+                                consume_each(skip);
+                                break;
+                            }
+                    }
                 uint32_t buff_increment;
-                if (d_cshort)
+                if (d_cbyte)
+                    {
+                        const auto* in = reinterpret_cast<const lv_8sc_t*>(input_items[0]);  // Get the input samples pointer
+                        if ((ninput_items[0] + d_buffer_count) <= d_consumed_samples)
+                            {
+                                buff_increment = ninput_items[0];
+                            }
+                        else
+                            {
+                                buff_increment = d_consumed_samples - d_buffer_count;
+                            }
+                        for (uint32_t i = 0; i < buff_increment; i++)
+                            {
+                                d_data_buffer_sc[d_buffer_count + i] = lv_16sc_t(in[i].real(), in[i].imag());
+                            }
+                        if (d_clamp_integer_input)
+                            {
+                                clamp_integer_input(&d_data_buffer_sc[d_buffer_count], buff_increment);
+                            }
+                    }
+                else if (d_cshort)
                     {
                         const auto* in = reinterpret_cast<const lv_16sc_t*>(input_items[0]);  // Get the input samples pointer
                         if ((ninput_items[0] + d_buffer_count) <= d_consumed_samples)
@@ -974,6 +2107,10 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
                                 buff_increment = d_consumed_samples - d_buffer_count;
                             }
                         memcpy(&d_data_buffer_sc[d_buffer_count], in, sizeof(lv_16sc_t) * buff_increment);
+                        if (d_clamp_integer_input)
+                            {
+                                clamp_integer_input(&d_data_buffer_sc[d_buffer_count], buff_increment);
+                            }
                     }
                 else
                     {
@@ -1002,15 +2139,52 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
         case 2:
             {
                 // Copy the data to the core and let it know that new data is available
+                if (d_pipelined_dwells)
+                    {
+                        // Hand the full buffer over to the worker and keep capturing in a free one
+                        consume_each(0);
+                        d_buffer_count = 0U;
+                        d_state = 1;
+                        if (d_free_dwells.empty())
+                            {
+                                // All the buffers are waiting to be processed, so this dwell is dropped
+                                DLOG(INFO) << "No free dwell buffer in channel " << d_channel << ", dropping the dwell at sample stamp " << d_sample_counter;
+                                break;
+                            }
+                        Captured_Dwell dwell = std::move(d_free_dwells.back());
+                        d_free_dwells.pop_back();
+                        std::swap(dwell.samples, d_data_buffer);
+                        std::swap(dwell.samples_sc, d_data_buffer_sc);
+                        dwell.sample_stamp = d_sample_counter;
+                        d_captured_dwells.push_back(std::move(dwell));
+                        if (!d_worker_active)
+                            {
+                                d_worker_active = true;
+                                if (!d_executor->submit([this]() { process_captured_dwells(); }))
+                                    {
+                                        LOG(WARNING) << "Acquisition executor queue full, processing the dwell of channel " << d_channel << " in the scheduler thread";
+                                        lk.unlock();
+                                        process_captured_dwells();
+                                    }
+                            }
+                        break;
+                    }
                 if (acq_parameters.blocking)
                     {
                         lk.unlock();
-                        acquisition_core(d_sample_counter);
+                        acquisition_core(d_sample_counter, d_data_buffer.data(), d_data_buffer_sc.data());
                     }
                 else
                     {
-                        gr::thread::thread d_worker(&pcps_acquisition::acquisition_core, this, d_sample_counter);
+                        const uint64_t samp_count = d_sample_counter;
                         d_worker_active = true;
+                        if (!d_executor->submit([this, samp_count]() { process_dwell(samp_count); }))
+                            {
+                                // The queue of the acquisition executor is full, so process this dwell right here
+                                LOG(WARNING) << "Acquisition executor queue full, processing the dwell of channel " << d_channel << " in the scheduler thread";
+                                lk.unlock();
+                                process_dwell(samp_count);
+                            }
                     }
                 consume_each(0);
                 d_buffer_count = 0U;
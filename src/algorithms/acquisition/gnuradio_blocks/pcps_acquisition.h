@@ -5,7 +5,9 @@
  *  Acquisition strategy (Kay Borre book + CFAR threshold).
  *  <ol>
  *  <li> Compute the input signal power estimation
- *  <li> Doppler serial search loop
+ *  <li> Doppler serial search loop (optionally performed in the frequency
+ *  domain, as circular shifts of a single FFT of the input signal, and
+ *  optionally sharing the input spectra among channels of the same band)
  *  <li> Perform the FFT-based circular convolution (parallel time search)
  *  <li> Record the maximum peak and the associated synchronization parameters
  *  <li> Compute the test statistics and compare to the threshold
@@ -45,7 +47,12 @@
 #define ARMA_NO_DEBUG 1
 #endif
 
+#include "acq_code_spectra_cache.h"
 #include "acq_conf.h"
+#include "acq_doppler_wipeoffs.h"
+#include "acq_executor.h"
+#include "acq_fft_planner.h"
+#include "acq_shared_spectra.h"
 #include "channel_fsm.h"
 #include <armadillo>
 #include <glog/logging.h>
@@ -55,13 +62,16 @@
 #include <gnuradio/thread/thread.h>           // for scoped_lock
 #include <gnuradio/types.h>                   // for gr_vector_const_void_star
 #include <gsl/gsl>                            // for Guidelines Support Library
-#include <volk/volk_complex.h>                // for lv_16sc_t
+#include <volk/volk_complex.h>                // for lv_16sc_t, lv_8sc_t
 #include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
 #include <complex>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #if GNURADIO_USES_STD_POINTERS
 #else
 #include <boost/shared_ptr.hpp>
@@ -87,7 +97,12 @@ pcps_acquisition_sptr pcps_make_acquisition(const Acq_Conf& conf_);
 class pcps_acquisition : public gr::block
 {
 public:
-    ~pcps_acquisition() = default;
+    /*!
+     * \brief Function returning the sampled local code of a given PRN.
+     */
+    using Code_Generator = std::function<const std::complex<float>*(uint32_t prn)>;
+
+    ~pcps_acquisition();
 
     /*!
      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
@@ -117,7 +132,23 @@ public:
      * \brief Sets local code for PCPS acquisition algorithm.
      * \param code - Pointer to the PRN code.
      */
-    void set_local_code(std::complex<float>* code);
+    void set_local_code(const std::complex<float>* code);
+
+    /*!
+     * \brief Sets the local code of the current satellite. If the cache of code
+     * spectra is enabled, the code is only generated and transformed if its
+     * spectrum is not in the cache yet.
+     * \param generate_code - Function returning the sampled code of a given PRN.
+     * \param code_variant - Distinguishes different codes of the same signal
+     * and PRN (e.g., data and pilot components).
+     */
+    void set_local_code(const Code_Generator& generate_code, const std::string& code_variant = std::string());
+
+    /*!
+     * \brief Stores the code spectra of PRNs first_prn to last_prn in the
+     * cache of code spectra, if it is enabled.
+     */
+    void prefill_code_cache(uint32_t first_prn, uint32_t last_prn, const Code_Generator& generate_code, const std::string& code_variant = std::string());
 
     /*!
      * \brief Starts acquisition algorithm, turning from standby mode to
@@ -200,6 +231,26 @@ public:
             }
     }
 
+    /*!
+     * \brief Restricts the Doppler search to the bins of the grid within
+     * doppler_window Hz of the Doppler center, for assisted acquisitions.
+     * \param doppler_window - Half width of the searched Doppler range [Hz].
+     * If 0, the whole grid is searched.
+     */
+    void set_doppler_window(uint32_t doppler_window);
+
+    /*!
+     * \brief Restricts the peak search to the code delays predicted for the
+     * next dwells, for assisted acquisitions. The prediction is extrapolated
+     * to the first sample of each dwell.
+     * \param sample_stamp - Sample counter at which the code delay was predicted.
+     * \param code_delay_samples - Predicted code delay at sample_stamp [samples].
+     * \param code_period_samples - Period of the received code [samples].
+     * \param code_window - Half width of the searched code delay range [samples].
+     * If 0, all the code delays are searched.
+     */
+    void set_code_phase_window(uint64_t sample_stamp, double code_delay_samples, double code_period_samples, uint32_t code_window);
+
     void set_resampler_latency(uint32_t latency_samples);
 
     /*!
@@ -212,9 +263,35 @@ public:
 private:
     friend pcps_acquisition_sptr pcps_make_acquisition(const Acq_Conf& conf_);
     explicit pcps_acquisition(const Acq_Conf& conf_);
+
+    // Running peak search over the Doppler bins of a dwell, used instead of the
+    // full magnitude grid when the statistics are computed on the fly
+    struct Peak_Search
+    {
+        float peak{0.0};
+        uint32_t doppler_index{0U};
+        uint32_t delay_index{0U};
+        volk_gnsssdr::vector<float> peak_bin;  // magnitudes of the Doppler bin containing the peak
+    };
+
+    // Samples of a dwell waiting to be processed while the next one is captured
+    struct Captured_Dwell
+    {
+        volk_gnsssdr::vector<std::complex<float>> samples;
+        volk_gnsssdr::vector<lv_16sc_t> samples_sc;
+        uint64_t sample_stamp{0ULL};
+    };
+
     bool d_active;
     bool d_worker_active;
     bool d_cshort;
+    bool d_cbyte;
+    bool d_integer_wipeoff;
+    bool d_clamp_integer_input;
+    bool d_integer_input_clamped;
+    bool d_streaming_statistics;
+    bool d_rolling_dwells;
+    bool d_pipelined_dwells;
     bool d_step_two;
     bool d_use_CFAR_algorithm_flag;
     bool d_dump;
@@ -226,39 +303,102 @@ private:
     int32_t d_doppler_center;
     int32_t d_doppler_bias;
     uint32_t d_num_noncoherent_integrations_counter;
+    uint32_t d_num_previous_dwells;  // dwells of the rolling buffer accumulated with the current one
     uint32_t d_fft_size;
+    uint32_t d_correlation_size;  // correlation lags searched, d_fft_size minus the extra zero padding
     uint32_t d_consumed_samples;
     uint32_t d_num_doppler_bins;
     uint32_t d_num_doppler_bins_step2;
+    uint32_t d_doppler_window;
+    uint32_t d_first_doppler_bin;
+    uint32_t d_last_doppler_bin;
+    uint32_t d_noise_doppler_bin;  // bin out of the assisted window measuring the noise power, d_num_doppler_bins if none
+    uint32_t d_code_window;
+    uint32_t d_code_window_first;
+    uint32_t d_code_window_size;
     uint32_t d_dump_channel;
     uint32_t d_buffer_count;
     uint64_t d_sample_counter;
+    uint64_t d_code_window_stamp;
     int64_t d_dump_number;
     float d_threshold;
     float d_mag;
     float d_input_power;
     float d_test_statistics;
     float d_doppler_center_step_two;
+    float d_integer_carrier_amplitude;
+    int16_t d_integer_input_max;  // largest sample component of integer_input_bits bits
+    double d_code_window_delay;
+    double d_code_window_period;
     std::string d_dump_filename;
     volk_gnsssdr::vector<volk_gnsssdr::vector<float>> d_magnitude_grid;
+    std::vector<Peak_Search> d_peak_searches;
+    Peak_Search d_noise_peak_search;
+    std::vector<double> d_bin_power;
     volk_gnsssdr::vector<float> d_tmp_buffer;
     volk_gnsssdr::vector<std::complex<float>> d_input_signal;
-    volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>> d_grid_doppler_wipeoffs;
+    std::vector<std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier>> d_grid_doppler_wipeoffs;
     volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>> d_grid_doppler_wipeoffs_step_two;
-    volk_gnsssdr::vector<std::complex<float>> d_fft_codes;
+    volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>> d_fractional_bin_wipeoffs;
+    std::vector<std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier_Sc>> d_grid_doppler_wipeoffs_sc;
+    volk_gnsssdr::vector<volk_gnsssdr::vector<lv_16sc_t>> d_fractional_bin_wipeoffs_sc;
+    Acq_Shared_Spectra::Spectra d_input_spectra;
+    std::vector<uint32_t> d_doppler_bin_shift;
+    std::vector<uint32_t> d_doppler_bin_fraction;
+    std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> d_fft_codes;
     volk_gnsssdr::vector<std::complex<float>> d_data_buffer;
     volk_gnsssdr::vector<lv_16sc_t> d_data_buffer_sc;
+    std::deque<Captured_Dwell> d_captured_dwells;
+    std::vector<Captured_Dwell> d_free_dwells;
+    volk_gnsssdr::vector<lv_16sc_t> d_input_signal_sc;
+    volk_gnsssdr::vector<lv_16sc_t> d_wipeoff_buffer_sc;
+    volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>> d_previous_dwells;
+    volk_gnsssdr::vector<volk_gnsssdr::vector<lv_16sc_t>> d_previous_dwells_sc;
     std::shared_ptr<gr::fft::fft_complex> d_fft_if;
     std::shared_ptr<gr::fft::fft_complex> d_ifft;
+    std::shared_ptr<Acq_Shared_Spectra> d_spectra_server;
+    std::shared_ptr<Acq_Executor> d_executor;
+    std::vector<std::shared_ptr<gr::fft::fft_complex>> d_worker_fft_if;
+    std::vector<std::shared_ptr<gr::fft::fft_complex>> d_worker_ifft;
+    std::vector<volk_gnsssdr::vector<float>> d_worker_tmp_buffer;
+    std::vector<volk_gnsssdr::vector<lv_16sc_t>> d_worker_wipeoff_buffer_sc;
+    std::shared_ptr<const Acq_Shared_Spectra::Spectra> d_shared_spectra;
     std::weak_ptr<ChannelFsm> d_channel_fsm;
     Acq_Conf acq_parameters;
     Gnss_Synchro* d_gnss_synchro;
     arma::fmat grid_;
     arma::fmat narrow_grid_;
+    std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> compute_code_spectrum(const std::complex<float>* code);
+    std::string code_spectrum_key(uint32_t prn, const std::string& code_variant) const;
     void update_local_carrier(gsl::span<gr_complex> carrier_vector, float freq);
+    void update_local_carrier_sc(gsl::span<lv_16sc_t> carrier_vector, float freq);
+    std::string doppler_wipeoff_key(int32_t freq_hz) const;
+    std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier> doppler_wipeoff(int32_t freq_hz);
+    std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier_Sc> doppler_wipeoff_sc(int32_t freq_hz);
+    void integer_doppler_wipeoff(const lv_16sc_t* input, const lv_16sc_t* carrier, gr_complex* fft_input, lv_16sc_t* wipeoff_buffer);
+    void clamp_integer_input(lv_16sc_t* samples, uint32_t length);
     void update_grid_doppler_wipeoffs();
     void update_grid_doppler_wipeoffs_step2();
-    void acquisition_core(uint64_t samp_count);
+    void update_frequency_domain_doppler_grid();
+    void update_doppler_window_bins();
+    void update_code_phase_window(uint64_t samp_count);
+    uint32_t code_phase_window_size() const;
+    uint32_t code_phase_index_max(const float* magnitude, uint32_t num_samples) const;
+    void compute_input_spectra(const gr_complex* in, Acq_Shared_Spectra::Spectra& spectra);
+    void multiply_shifted_spectrum(uint32_t doppler_index, const Acq_Shared_Spectra::Spectra& spectra, gr_complex* out);
+    void process_doppler_bin(uint32_t doppler_index, const gr_complex* in, gr::fft::fft_complex* fft_if, gr::fft::fft_complex* ifft, float* tmp_buffer, lv_16sc_t* wipeoff_buffer, Peak_Search& peak_search);
+    void fold_doppler_bin(uint32_t doppler_index, const float* magnitude, Peak_Search& peak_search);
+    void accumulate_previous_dwells(uint32_t doppler_index, gr::fft::fft_complex* fft_if, gr::fft::fft_complex* ifft, float* magnitude, lv_16sc_t* wipeoff_buffer);
+    void store_dwell();
+    void reset_peak_searches();
+    void merge_peak_searches();
+    void parallel_doppler_search(const gr_complex* in);
+    std::string shared_spectra_key() const;
+    void acquisition_core(uint64_t samp_count, const gr_complex* samples, const lv_16sc_t* samples_sc);
+    void process_dwell(uint64_t samp_count);
+    void process_captured_dwells();
+    void release_captured_dwells();
+    void abort_acquisition(const std::string& failure);
     void send_negative_acquisition();
     void send_positive_acquisition();
     void dump_results(int32_t effective_fft_size);
@@ -0,0 +1,88 @@
+/*!
+ * \file acq_code_spectra_cache.cc
+ * \brief Process-wide cache of the conjugated spectra of the local codes used
+ * by the PCPS acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_code_spectra_cache.h"
+#include <utility>
+
+
+Acq_Code_Spectra_Cache& Acq_Code_Spectra_Cache::instance()
+{
+    static Acq_Code_Spectra_Cache cache;
+    return cache;
+}
+
+
+std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> Acq_Code_Spectra_Cache::find(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    auto it = d_spectra.find(key);
+    if (it == d_spectra.end())
+        {
+            d_misses++;
+            return nullptr;
+        }
+    d_hits++;
+    return it->second;
+}
+
+
+std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> Acq_Code_Spectra_Cache::insert(const std::string& key, std::shared_ptr<const Spectrum> spectrum)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    auto result = d_spectra.emplace(key, std::move(spectrum));
+    return result.first->second;
+}
+
+
+void Acq_Code_Spectra_Cache::release_unused()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (auto it = d_spectra.begin(); it != d_spectra.end();)
+        {
+            if (it->second.use_count() == 1)
+                {
+                    it = d_spectra.erase(it);
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+}
+
+
+size_t Acq_Code_Spectra_Cache::size() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_spectra.size();
+}
+
+
+uint64_t Acq_Code_Spectra_Cache::hits() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_hits;
+}
+
+
+uint64_t Acq_Code_Spectra_Cache::misses() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_misses;
+}
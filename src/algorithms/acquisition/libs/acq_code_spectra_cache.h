@@ -0,0 +1,77 @@
+/*!
+ * \file acq_code_spectra_cache.h
+ * \brief Process-wide cache of the conjugated spectra of the local codes used
+ * by the PCPS acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQ_CODE_SPECTRA_CACHE_H
+#define GNSS_SDR_ACQ_CODE_SPECTRA_CACHE_H
+
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*!
+ * \brief Thread-safe cache of conjugated local code spectra, keyed by signal,
+ * PRN, sampling rate and FFT size.
+ *
+ * Spectra are immutable and reference-counted, so assigning a new satellite to
+ * an acquisition channel whose code spectrum is already cached is just a
+ * pointer swap.
+ */
+class Acq_Code_Spectra_Cache
+{
+public:
+    using Spectrum = volk_gnsssdr::vector<std::complex<float>>;
+
+    /*!
+     * \brief Returns the cache shared by all the acquisition blocks.
+     */
+    static Acq_Code_Spectra_Cache& instance();
+
+    /*!
+     * \brief Returns the spectrum stored with the given key, or nullptr if it is not cached.
+     */
+    std::shared_ptr<const Spectrum> find(const std::string& key);
+
+    /*!
+     * \brief Stores a spectrum and returns the cached one. If another thread
+     * already stored a spectrum with the same key, that one is returned instead.
+     */
+    std::shared_ptr<const Spectrum> insert(const std::string& key, std::shared_ptr<const Spectrum> spectrum);
+
+    /*!
+     * \brief Removes the spectra not used by any acquisition block.
+     */
+    void release_unused();
+
+    size_t size() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+private:
+    std::map<std::string, std::shared_ptr<const Spectrum>> d_spectra;
+    mutable std::mutex d_mutex;
+    uint64_t d_hits{0};
+    uint64_t d_misses{0};
+};
+
+#endif  // GNSS_SDR_ACQ_CODE_SPECTRA_CACHE_H
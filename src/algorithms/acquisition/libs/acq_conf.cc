@@ -23,6 +23,7 @@
 #include <glog/logging.h>
 #include <gnuradio/gr_complex.h>
 #include <cmath>
+#include <sstream>
 
 Acq_Conf::Acq_Conf()
 {
@@ -47,6 +48,15 @@ Acq_Conf::Acq_Conf()
     dump = false;
     blocking = true;
     make_2_steps = false;
+    frequency_domain_doppler = false;
+    shared_input_spectra = false;
+    code_spectra_cache = false;
+    shared_doppler_wipeoffs = true;
+    fft_autotune = false;
+    fft_wisdom_file = "./acq_fft_wisdom.txt";
+    prefill_code_cache = false;
+    integer_doppler_wipeoff = false;
+    streaming_statistics = false;
     dump_filename = "";
     dump_channel = 0U;
     it_size = sizeof(gr_complex);
@@ -56,6 +66,11 @@ Acq_Conf::Acq_Conf()
     resampler_ratio = 1.0;
     resampled_fs = 0LL;
     resampler_latency_samples = 0U;
+    doppler_bin_workers = 1U;
+    dwell_buffers = 1U;
+    integer_input_bits = 8U;
+    executor_workers = 0U;
+    executor_queue_size = 64U;
 }
 
 
@@ -83,6 +98,20 @@ void Acq_Conf::SetFromConfiguration(ConfigurationInterface *configuration,
 
     use_automatic_resampler = configuration->property("GNSS-SDR.use_acquisition_resampler", use_automatic_resampler);
 
+    // Process-wide pool of workers for non-blocking acquisition
+    executor_workers = configuration->property("GNSS-SDR.acquisition_workers", executor_workers);
+    executor_queue_size = configuration->property("GNSS-SDR.acquisition_queue_size", executor_queue_size);
+    std::stringstream cpu_list(configuration->property("GNSS-SDR.acquisition_cpu_affinity", std::string("")));
+    std::string cpu;
+    executor_cpu_affinity.clear();
+    while (std::getline(cpu_list, cpu, ','))
+        {
+            if (!cpu.empty())
+                {
+                    executor_cpu_affinity.push_back(std::stoi(cpu));
+                }
+        }
+
     if ((sampled_ms % ms_per_code) != 0)
         {
             LOG(WARNING) << "Parameter coherent_integration_time_ms should be a multiple of "
@@ -114,6 +143,38 @@ void Acq_Conf::SetFromConfiguration(ConfigurationInterface *configuration,
         }
     make_2_steps = configuration->property(role + ".make_two_steps", make_2_steps);
     blocking_on_standby = configuration->property(role + ".blocking_on_standby", blocking_on_standby);
+    frequency_domain_doppler = configuration->property(role + ".frequency_domain_doppler", frequency_domain_doppler);
+    shared_input_spectra = configuration->property(role + ".shared_input_spectra", shared_input_spectra);
+    doppler_bin_workers = configuration->property(role + ".doppler_bin_workers", doppler_bin_workers);
+    code_spectra_cache = configuration->property(role + ".code_spectra_cache", code_spectra_cache);
+    shared_doppler_wipeoffs = configuration->property(role + ".shared_doppler_wipeoffs", shared_doppler_wipeoffs);
+    fft_autotune = configuration->property(role + ".fft_autotune", fft_autotune);
+    fft_wisdom_file = configuration->property(role + ".fft_wisdom_file", fft_wisdom_file);
+    prefill_code_cache = configuration->property(role + ".prefill_code_cache", prefill_code_cache);
+    if (doppler_bin_workers == 0)
+        {
+            LOG(WARNING) << "Parameter doppler_bin_workers should be at least 1. Setting it to 1";
+            doppler_bin_workers = 1;
+        }
+    integer_doppler_wipeoff = configuration->property(role + ".integer_doppler_wipeoff", integer_doppler_wipeoff);
+    integer_input_bits = configuration->property(role + ".integer_input_bits", integer_input_bits);
+    streaming_statistics = configuration->property(role + ".streaming_statistics", streaming_statistics);
+    dwell_buffers = configuration->property(role + ".dwell_buffers", dwell_buffers);
+    if (dwell_buffers == 0)
+        {
+            LOG(WARNING) << "Parameter dwell_buffers should be at least 1. Setting it to 1";
+            dwell_buffers = 1;
+        }
+    if ((integer_input_bits == 0) or (integer_input_bits > 12))
+        {
+            LOG(WARNING) << "Parameter integer_input_bits should be between 1 and 12. Setting it to 8";
+            integer_input_bits = 8;
+        }
+    if ((item_type == "cbyte") and !integer_doppler_wipeoff)
+        {
+            // The adapters convert the cbyte samples to gr_complex
+            it_size = sizeof(gr_complex);
+        }
 
     if (pfa <= 0.0)
         {
@@ -24,6 +24,7 @@
 #include "configuration_interface.h"
 #include <cstdint>
 #include <string>
+#include <vector>
 
 class Acq_Conf
 {
@@ -54,10 +55,25 @@ public:
     bool blocking;
     bool blocking_on_standby;  // enable it only for unit testing to avoid sample consume on idle status
     bool make_2_steps;
+    bool frequency_domain_doppler;
+    bool shared_input_spectra;
+    bool code_spectra_cache;
+    bool shared_doppler_wipeoffs;
+    bool fft_autotune;
+    bool prefill_code_cache;
+    bool integer_doppler_wipeoff;
+    bool streaming_statistics;
     bool use_automatic_resampler;
     float resampler_ratio;
     int64_t resampled_fs;
     uint32_t resampler_latency_samples;
+    uint32_t doppler_bin_workers;
+    uint32_t dwell_buffers;
+    uint32_t integer_input_bits;  // of the cshort or cbyte samples, wider ones are clamped
+    uint32_t executor_workers;
+    uint32_t executor_queue_size;
+    std::vector<int> executor_cpu_affinity;
+    std::string fft_wisdom_file;
     std::string dump_filename;
     uint32_t dump_channel;
     size_t it_size;
@@ -0,0 +1,135 @@
+/*!
+ * \file acq_doppler_wipeoffs.cc
+ * \brief Process-wide store of the Doppler wipeoff carriers used by the PCPS
+ * acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_doppler_wipeoffs.h"
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+template <typename T>
+std::shared_ptr<const T> find_carrier(std::map<std::string, std::weak_ptr<const T>>& carriers, const std::string& key)
+{
+    auto it = carriers.find(key);
+    if (it == carriers.end())
+        {
+            return nullptr;
+        }
+    return it->second.lock();
+}
+
+
+template <typename T>
+std::shared_ptr<const T> insert_carrier(std::map<std::string, std::weak_ptr<const T>>& carriers, const std::string& key, std::shared_ptr<const T> carrier)
+{
+    auto& stored = carriers[key];
+    auto current = stored.lock();
+    if (current != nullptr)
+        {
+            return current;
+        }
+    stored = carrier;
+    return carrier;
+}
+
+
+template <typename T>
+size_t erase_expired(std::map<std::string, std::weak_ptr<const T>>& carriers)
+{
+    for (auto it = carriers.begin(); it != carriers.end();)
+        {
+            if (it->second.expired())
+                {
+                    it = carriers.erase(it);
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+    return carriers.size();
+}
+}  // namespace
+
+
+Acq_Doppler_Wipeoffs& Acq_Doppler_Wipeoffs::instance()
+{
+    static Acq_Doppler_Wipeoffs store;
+    return store;
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier> Acq_Doppler_Wipeoffs::find(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return find_carrier(d_carriers, key);
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier_Sc> Acq_Doppler_Wipeoffs::find_sc(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return find_carrier(d_carriers_sc, key);
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier> Acq_Doppler_Wipeoffs::insert(const std::string& key, std::shared_ptr<const Carrier> carrier)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    purge_expired();
+    return insert_carrier(d_carriers, key, std::move(carrier));
+}
+
+
+std::shared_ptr<const Acq_Doppler_Wipeoffs::Carrier_Sc> Acq_Doppler_Wipeoffs::insert_sc(const std::string& key, std::shared_ptr<const Carrier_Sc> carrier)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    purge_expired();
+    return insert_carrier(d_carriers_sc, key, std::move(carrier));
+}
+
+
+size_t Acq_Doppler_Wipeoffs::size() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    size_t in_use = 0;
+    for (const auto& carrier : d_carriers)
+        {
+            in_use += carrier.second.expired() ? 0 : 1;
+        }
+    for (const auto& carrier : d_carriers_sc)
+        {
+            in_use += carrier.second.expired() ? 0 : 1;
+        }
+    return in_use;
+}
+
+
+void Acq_Doppler_Wipeoffs::purge_expired()
+{
+    // Expired entries are only removed once the map has doubled its size
+    // since the last sweep, so the cost of the sweeps is amortized
+    if (d_carriers.size() + d_carriers_sc.size() < d_purge_size)
+        {
+            return;
+        }
+    const size_t remaining = erase_expired(d_carriers) + erase_expired(d_carriers_sc);
+    d_purge_size = std::max<size_t>(64, 2 * remaining);
+}
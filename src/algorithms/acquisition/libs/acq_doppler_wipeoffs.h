@@ -0,0 +1,83 @@
+/*!
+ * \file acq_doppler_wipeoffs.h
+ * \brief Process-wide store of the Doppler wipeoff carriers used by the PCPS
+ * acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQ_DOPPLER_WIPEOFFS_H
+#define GNSS_SDR_ACQ_DOPPLER_WIPEOFFS_H
+
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>    // for volk_gnsssdr::vector
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>  // for lv_16sc_t
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*!
+ * \brief Thread-safe store of immutable Doppler wipeoff carriers, keyed by
+ * sampling rate, length and frequency (and amplitude, for the integer ones).
+ *
+ * A Doppler grid is a list of pointers to carriers of this store, so all the
+ * acquisition channels searching the same signal share the same tables, and
+ * moving the grid center by a multiple of the Doppler step reuses all the
+ * carriers that remain in the grid. Only the carriers of grids centered at
+ * arbitrary frequencies are specific to a channel.
+ *
+ * The store does not own the carriers: they are released when the last grid
+ * using them is destroyed or moved.
+ */
+class Acq_Doppler_Wipeoffs
+{
+public:
+    using Carrier = volk_gnsssdr::vector<std::complex<float>>;
+    using Carrier_Sc = volk_gnsssdr::vector<lv_16sc_t>;
+
+    /*!
+     * \brief Returns the store shared by all the acquisition blocks.
+     */
+    static Acq_Doppler_Wipeoffs& instance();
+
+    /*!
+     * \brief Returns the carrier stored with the given key, or nullptr if it is not in use.
+     */
+    std::shared_ptr<const Carrier> find(const std::string& key);
+    std::shared_ptr<const Carrier_Sc> find_sc(const std::string& key);
+
+    /*!
+     * \brief Stores a carrier and returns the stored one. If another thread
+     * already stored a carrier with the same key, that one is returned instead.
+     */
+    std::shared_ptr<const Carrier> insert(const std::string& key, std::shared_ptr<const Carrier> carrier);
+    std::shared_ptr<const Carrier_Sc> insert_sc(const std::string& key, std::shared_ptr<const Carrier_Sc> carrier);
+
+    /*!
+     * \brief Returns the number of carriers in use by any acquisition block.
+     */
+    size_t size() const;
+
+private:
+    void purge_expired();
+
+    std::map<std::string, std::weak_ptr<const Carrier>> d_carriers;
+    std::map<std::string, std::weak_ptr<const Carrier_Sc>> d_carriers_sc;
+    mutable std::mutex d_mutex;
+    size_t d_purge_size{64};
+};
+
+#endif  // GNSS_SDR_ACQ_DOPPLER_WIPEOFFS_H
@@ -0,0 +1,185 @@
+/*!
+ * \file acq_executor.cc
+ * \brief Process-wide pool of worker threads running the dwells of the
+ * non-blocking acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_executor.h"
+#include <glog/logging.h>
+#include <gnuradio/thread/thread.h>  // for thread_bind_to_processor
+#include <algorithm>                 // for max
+#include <exception>
+#include <utility>
+
+
+std::shared_ptr<Acq_Executor> Acq_Executor::get_instance(uint32_t num_workers, uint32_t queue_size, const std::vector<int>& cpu_affinity)
+{
+    static std::mutex instance_mutex;
+    static std::weak_ptr<Acq_Executor> instance;
+
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    std::shared_ptr<Acq_Executor> executor = instance.lock();
+    if (!executor)
+        {
+            executor = std::make_shared<Acq_Executor>(num_workers, queue_size, cpu_affinity);
+            instance = executor;
+        }
+    return executor;
+}
+
+
+Acq_Executor::Acq_Executor(uint32_t num_workers, uint32_t queue_size, const std::vector<int>& cpu_affinity) : d_queue_size(std::max(queue_size, 1U)),
+                                                                                                               d_max_queue_depth(0),
+                                                                                                               d_jobs_completed(0ULL),
+                                                                                                               d_jobs_rejected(0ULL),
+                                                                                                               d_total_latency_us(0.0),
+                                                                                                               d_max_latency_us(0.0),
+                                                                                                               d_stop(false)
+{
+    if (num_workers == 0)
+        {
+            num_workers = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+    d_workers.reserve(num_workers);
+    for (uint32_t i = 0; i < num_workers; i++)
+        {
+            d_workers.emplace_back(&Acq_Executor::run_worker, this);
+            if (!cpu_affinity.empty())
+                {
+                    gr::thread::thread_bind_to_processor(d_workers.back().native_handle(), cpu_affinity[i % cpu_affinity.size()]);
+                }
+        }
+    LOG(INFO) << "Acquisition executor started with " << num_workers << " workers and a queue of " << d_queue_size << " jobs";
+}
+
+
+Acq_Executor::~Acq_Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_condition.notify_all();
+    for (auto& worker : d_workers)
+        {
+            if (worker.joinable())
+                {
+                    worker.join();
+                }
+        }
+    LOG(INFO) << "Acquisition executor stopped. Jobs completed: " << d_jobs_completed
+              << ", jobs rejected: " << d_jobs_rejected
+              << ", max queue depth: " << d_max_queue_depth
+              << ", mean latency: " << (d_jobs_completed > 0 ? d_total_latency_us / static_cast<double>(d_jobs_completed) : 0.0) << " us"
+              << ", max latency: " << d_max_latency_us << " us";
+}
+
+
+bool Acq_Executor::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        if (d_stop or d_queue.size() >= d_queue_size)
+            {
+                d_jobs_rejected++;
+                return false;
+            }
+        d_queue.push_back(Job{std::move(job), std::chrono::steady_clock::now()});
+        d_max_queue_depth = std::max(d_max_queue_depth, d_queue.size());
+    }
+    d_condition.notify_one();
+    return true;
+}
+
+
+void Acq_Executor::run_worker()
+{
+    while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(d_mutex);
+                d_condition.wait(lock, [this] { return d_stop or !d_queue.empty(); });
+                if (d_queue.empty())
+                    {
+                        return;  // stopped and nothing left to do
+                    }
+                job = std::move(d_queue.front());
+                d_queue.pop_front();
+            }
+
+            try
+                {
+                    job.work();
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(ERROR) << "Exception in acquisition job: " << e.what();
+                }
+            catch (...)
+                {
+                    LOG(ERROR) << "Unknown exception in acquisition job";
+                }
+
+            const double latency_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - job.submitted).count();
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_jobs_completed++;
+            d_total_latency_us += latency_us;
+            d_max_latency_us = std::max(d_max_latency_us, latency_us);
+        }
+}
+
+
+size_t Acq_Executor::queue_depth() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_queue.size();
+}
+
+
+size_t Acq_Executor::max_queue_depth() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_max_queue_depth;
+}
+
+
+uint64_t Acq_Executor::jobs_completed() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_jobs_completed;
+}
+
+
+uint64_t Acq_Executor::jobs_rejected() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_jobs_rejected;
+}
+
+
+double Acq_Executor::mean_latency_us() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return (d_jobs_completed > 0 ? d_total_latency_us / static_cast<double>(d_jobs_completed) : 0.0);
+}
+
+
+double Acq_Executor::max_latency_us() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_max_latency_us;
+}
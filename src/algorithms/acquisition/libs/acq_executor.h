@@ -0,0 +1,93 @@
+/*!
+ * \file acq_executor.h
+ * \brief Process-wide pool of worker threads running the dwells of the
+ * non-blocking acquisition blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQ_EXECUTOR_H
+#define GNSS_SDR_ACQ_EXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief Fixed-size pool of worker threads with a bounded job queue.
+ *
+ * Instead of spawning a new thread per dwell, non-blocking acquisition blocks
+ * submit their dwells to this executor. The number of workers bounds the
+ * number of dwells processed concurrently, and the workers can be pinned to
+ * a set of CPUs.
+ */
+class Acq_Executor
+{
+public:
+    /*!
+     * \brief Returns the process-wide executor, creating it with the given
+     * parameters if it does not exist yet.
+     * \param num_workers - Number of worker threads. If 0, one per available CPU.
+     * \param queue_size - Maximum number of jobs waiting for a worker.
+     * \param cpu_affinity - CPUs where the workers are pinned (worker i runs
+     * on cpu_affinity[i % cpu_affinity.size()]). If empty, no affinity is set.
+     */
+    static std::shared_ptr<Acq_Executor> get_instance(uint32_t num_workers, uint32_t queue_size, const std::vector<int>& cpu_affinity);
+
+    Acq_Executor(uint32_t num_workers, uint32_t queue_size, const std::vector<int>& cpu_affinity);
+    ~Acq_Executor();
+
+    /*!
+     * \brief Queues a job. Returns false, without queuing it, if the queue is full.
+     */
+    bool submit(std::function<void()> job);
+
+    uint32_t num_workers() const { return static_cast<uint32_t>(d_workers.size()); }
+    size_t queue_depth() const;      //!< Jobs currently waiting for a worker
+    size_t max_queue_depth() const;  //!< Maximum number of jobs that have been waiting at once
+    uint64_t jobs_completed() const;
+    uint64_t jobs_rejected() const;
+    double mean_latency_us() const;  //!< Mean time from submission to completion of a job [us]
+    double max_latency_us() const;   //!< Maximum time from submission to completion of a job [us]
+
+private:
+    struct Job
+    {
+        std::function<void()> work;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void run_worker();
+
+    std::deque<Job> d_queue;
+    std::vector<std::thread> d_workers;
+    mutable std::mutex d_mutex;
+    std::condition_variable d_condition;
+    size_t d_queue_size;
+    size_t d_max_queue_depth;
+    uint64_t d_jobs_completed;
+    uint64_t d_jobs_rejected;
+    double d_total_latency_us;
+    double d_max_latency_us;
+    bool d_stop;
+};
+
+#endif  // GNSS_SDR_ACQ_EXECUTOR_H
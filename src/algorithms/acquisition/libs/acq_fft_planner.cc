@@ -0,0 +1,154 @@
+/*!
+ * \file acq_fft_planner.cc
+ * \brief Selection of the fastest FFT length for the PCPS acquisition, with
+ * the results stored in a wisdom file.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_fft_planner.h"
+#include <glog/logging.h>
+#include <fstream>
+#include <sstream>
+
+
+Acq_Fft_Planner& Acq_Fft_Planner::instance()
+{
+    static Acq_Fft_Planner planner;
+    return planner;
+}
+
+
+bool Acq_Fft_Planner::is_smooth(uint32_t n)
+{
+    if (n == 0U)
+        {
+            return false;
+        }
+    for (const uint32_t factor : {2U, 3U, 5U, 7U})
+        {
+            while (n % factor == 0U)
+                {
+                    n /= factor;
+                }
+        }
+    return n == 1U;
+}
+
+
+std::vector<uint32_t> Acq_Fft_Planner::candidate_sizes(uint32_t required_size, uint32_t max_candidates)
+{
+    std::vector<uint32_t> candidates;
+    if (required_size == 0U)
+        {
+            return candidates;
+        }
+    uint32_t power_of_two = 1U;
+    while (power_of_two < required_size)
+        {
+            power_of_two <<= 1U;
+        }
+    candidates.push_back(required_size);
+    uint32_t smooth_candidates = (is_smooth(required_size) ? 1U : 0U);
+    for (uint32_t n = required_size + 1U; n < power_of_two and smooth_candidates < max_candidates; n++)
+        {
+            if (is_smooth(n))
+                {
+                    candidates.push_back(n);
+                    smooth_candidates++;
+                }
+        }
+    if (power_of_two != required_size)
+        {
+            candidates.push_back(power_of_two);
+        }
+    return candidates;
+}
+
+
+uint32_t Acq_Fft_Planner::fft_size(uint32_t required_size, const std::string& wisdom_file, const Fft_Timer& timer)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (!wisdom_file.empty())
+        {
+            load(wisdom_file);
+        }
+    const auto known = d_fft_sizes.find(required_size);
+    if (known != d_fft_sizes.end())
+        {
+            return known->second;
+        }
+
+    uint32_t best_size = required_size;
+    double best_time = 0.0;
+    for (const uint32_t candidate : candidate_sizes(required_size, 8U))
+        {
+            const double time = timer(candidate);
+            DLOG(INFO) << "FFT length " << candidate << ": " << time * 1e6 << " us";
+            if (candidate == required_size or time < best_time)
+                {
+                    best_size = candidate;
+                    best_time = time;
+                }
+        }
+    LOG(INFO) << "Correlations of " << required_size << " samples will use FFTs of " << best_size << " samples";
+    d_fft_sizes[required_size] = best_size;
+    if (!wisdom_file.empty())
+        {
+            save(wisdom_file);
+        }
+    return best_size;
+}
+
+
+void Acq_Fft_Planner::load(const std::string& wisdom_file)
+{
+    if (!d_loaded_files.insert(wisdom_file).second)
+        {
+            return;
+        }
+    std::ifstream file(wisdom_file);
+    std::string line;
+    while (std::getline(file, line))
+        {
+            if (line.empty() or line[0] == '#')
+                {
+                    continue;
+                }
+            std::istringstream fields(line);
+            uint32_t required_size = 0U;
+            uint32_t fft_size = 0U;
+            // Discard invalid entries, so they are timed again
+            if ((fields >> required_size >> fft_size) and (fft_size == required_size or (fft_size > required_size and is_smooth(fft_size))))
+                {
+                    d_fft_sizes.emplace(required_size, fft_size);
+                }
+        }
+}
+
+
+void Acq_Fft_Planner::save(const std::string& wisdom_file) const
+{
+    std::ofstream file(wisdom_file, std::ios::trunc);
+    if (!file.is_open())
+        {
+            LOG(WARNING) << "Unable to write the acquisition FFT wisdom file " << wisdom_file;
+            return;
+        }
+    file << "# GNSS-SDR acquisition FFT lengths: required_length fft_length\n";
+    for (const auto& fft_size : d_fft_sizes)
+        {
+            file << fft_size.first << " " << fft_size.second << "\n";
+        }
+}
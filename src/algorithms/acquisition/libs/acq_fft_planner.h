@@ -0,0 +1,84 @@
+/*!
+ * \file acq_fft_planner.h
+ * \brief Selection of the fastest FFT length for the PCPS acquisition, with
+ * the results stored in a wisdom file.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQ_FFT_PLANNER_H
+#define GNSS_SDR_ACQ_FFT_PLANNER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Chooses the FFT length used to compute a zero-padded correlation of
+ * a given length.
+ *
+ * The FFT performance drops sharply for lengths with large prime factors,
+ * which are common at sampling rates such as 6.5 or 20.46 Msps. The planner
+ * times the required length and the next lengths with no prime factor
+ * greater than 7, up to the next power of two, and keeps the fastest one. The
+ * choices are stored in a text file, one "required_length fft_length" pair per
+ * line, so they are timed only once per machine.
+ */
+class Acq_Fft_Planner
+{
+public:
+    /*!
+     * \brief Returns the time spent by a forward and an inverse FFT of the given length.
+     */
+    using Fft_Timer = std::function<double(uint32_t)>;
+
+    /*!
+     * \brief Returns the planner shared by all the acquisition blocks.
+     */
+    static Acq_Fft_Planner& instance();
+
+    /*!
+     * \brief Returns true if n has no prime factor greater than 7.
+     */
+    static bool is_smooth(uint32_t n);
+
+    /*!
+     * \brief Returns the FFT lengths worth timing for a correlation of the
+     * given length: itself, and up to max_candidates smooth lengths not
+     * shorter than it, always including the next power of two.
+     */
+    static std::vector<uint32_t> candidate_sizes(uint32_t required_size, uint32_t max_candidates);
+
+    /*!
+     * \brief Returns the fastest FFT length not shorter than required_size.
+     * The candidates are timed only if neither this process nor the wisdom
+     * file already have a choice for that length. An empty wisdom_file
+     * disables the persistence.
+     */
+    uint32_t fft_size(uint32_t required_size, const std::string& wisdom_file, const Fft_Timer& timer);
+
+private:
+    void load(const std::string& wisdom_file);
+    void save(const std::string& wisdom_file) const;
+
+    std::map<uint32_t, uint32_t> d_fft_sizes;
+    std::set<std::string> d_loaded_files;
+    std::mutex d_mutex;
+};
+
+#endif  // GNSS_SDR_ACQ_FFT_PLANNER_H
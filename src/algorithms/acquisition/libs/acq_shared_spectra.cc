@@ -0,0 +1,98 @@
+/*!
+ * \file acq_shared_spectra.cc
+ * \brief Process-wide store of Doppler-wiped input spectra, shared by all the
+ * PCPS acquisition channels searching the same signal band.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_shared_spectra.h"
+#include <exception>
+
+
+std::shared_ptr<Acq_Shared_Spectra> Acq_Shared_Spectra::get_instance(const std::string& key)
+{
+    static std::mutex registry_mutex;
+    static std::map<std::string, std::weak_ptr<Acq_Shared_Spectra>> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::shared_ptr<Acq_Shared_Spectra> instance = registry[key].lock();
+    if (!instance)
+        {
+            instance = std::make_shared<Acq_Shared_Spectra>();
+            registry[key] = instance;
+        }
+    return instance;
+}
+
+
+Acq_Shared_Spectra::Acq_Shared_Spectra(size_t max_entries) : d_max_entries(max_entries),
+                                                             d_hits(0ULL),
+                                                             d_misses(0ULL)
+{
+}
+
+
+std::shared_ptr<const Acq_Shared_Spectra::Spectra> Acq_Shared_Spectra::get_spectra(uint64_t sample_stamp, const std::function<void(Spectra&)>& compute)
+{
+    std::promise<std::shared_ptr<const Spectra>> promise;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    auto it = d_entries.find(sample_stamp);
+    if (it != d_entries.end())
+        {
+            // Another channel already computed (or is computing) these spectra
+            d_hits++;
+            std::shared_future<std::shared_ptr<const Spectra>> future = it->second;
+            lock.unlock();
+            return future.get();
+        }
+    d_misses++;
+    d_entries[sample_stamp] = promise.get_future().share();
+    // Forget the oldest dwells. Channels still using them keep their own reference.
+    while (d_entries.size() > d_max_entries)
+        {
+            d_entries.erase(d_entries.begin());
+        }
+    lock.unlock();
+
+    auto spectra = std::make_shared<Spectra>();
+    try
+        {
+            compute(*spectra);
+        }
+    catch (...)
+        {
+            lock.lock();
+            d_entries.erase(sample_stamp);
+            lock.unlock();
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    promise.set_value(spectra);
+    return spectra;
+}
+
+
+uint64_t Acq_Shared_Spectra::hits() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_hits;
+}
+
+
+uint64_t Acq_Shared_Spectra::misses() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_misses;
+}
@@ -0,0 +1,82 @@
+/*!
+ * \file acq_shared_spectra.h
+ * \brief Process-wide store of Doppler-wiped input spectra, shared by all the
+ * PCPS acquisition channels searching the same signal band.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQ_SHARED_SPECTRA_H
+#define GNSS_SDR_ACQ_SHARED_SPECTRA_H
+
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*!
+ * \brief Stores the forward FFTs of the Doppler-wiped input signal of the
+ * latest dwells of a given signal band and Doppler grid.
+ *
+ * All the acquisition channels searching the same band at the same sample
+ * stamp read the same input samples and apply the same Doppler wipeoffs, so
+ * the resulting spectra are identical. The first channel requesting the
+ * spectra of a given sample stamp computes them, and the rest of channels just
+ * wait for the result and correlate it against their own local code spectrum.
+ */
+class Acq_Shared_Spectra
+{
+public:
+    using Spectra = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>;
+
+    /*!
+     * \brief Returns the instance associated to a given key (signal band and
+     * Doppler grid parameters), creating it if it does not exist yet.
+     */
+    static std::shared_ptr<Acq_Shared_Spectra> get_instance(const std::string& key);
+
+    explicit Acq_Shared_Spectra(size_t max_entries = 4);
+
+    /*!
+     * \brief Returns the spectra of the dwell ending at sample_stamp. If they
+     * are not available, they are computed by calling compute in the caller
+     * thread.
+     */
+    std::shared_ptr<const Spectra> get_spectra(uint64_t sample_stamp, const std::function<void(Spectra&)>& compute);
+
+    /*!
+     * \brief Number of requests served without computing the spectra.
+     */
+    uint64_t hits() const;
+
+    /*!
+     * \brief Number of requests that required computing the spectra.
+     */
+    uint64_t misses() const;
+
+private:
+    std::map<uint64_t, std::shared_future<std::shared_ptr<const Spectra>>> d_entries;
+    mutable std::mutex d_mutex;
+    size_t d_max_entries;
+    uint64_t d_hits;
+    uint64_t d_misses;
+};
+
+#endif  // GNSS_SDR_ACQ_SHARED_SPECTRA_H
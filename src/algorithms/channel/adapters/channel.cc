@@ -26,6 +26,7 @@
 #include "telemetry_decoder_interface.h"
 #include "tracking_interface.h"
 #include <glog/logging.h>
+#include <cmath>    // for std::ceil
 #include <utility>  // for std::move
 
 
@@ -227,6 +228,13 @@ void Channel::assist_acquisition_doppler(double Carrier_Doppler_hz)
 }
 
 
+void Channel::assist_acquisition_window(double doppler_window_hz, uint64_t sample_stamp, double code_delay_samples, double code_period_samples, double code_window_samples)
+{
+    acq_->set_doppler_window(static_cast<unsigned int>(std::ceil(doppler_window_hz)));
+    acq_->set_code_phase_window(sample_stamp, code_delay_samples, code_period_samples, static_cast<unsigned int>(std::ceil(code_window_samples)));
+}
+
+
 void Channel::start_acquisition()
 {
     std::lock_guard<std::mutex> lk(mx);
@@ -78,6 +78,13 @@ public:
 
     void assist_acquisition_doppler(double Carrier_Doppler_hz) override;
 
+    /*!
+     * \brief Restricts the next acquisitions to the Doppler and code delay
+     * windows predicted by the acquisition assistance. A null window disables
+     * the restriction.
+     */
+    void assist_acquisition_window(double doppler_window_hz, uint64_t sample_stamp, double code_delay_samples, double code_period_samples, double code_window_samples) override;
+
     inline std::shared_ptr<AcquisitionInterface> acquisition() { return acq_; }
     inline std::shared_ptr<TrackingInterface> tracking() { return trk_; }
     inline std::shared_ptr<TelemetryDecoderInterface> telemetry() { return nav_; }
@@ -147,6 +147,21 @@ bool ChannelFsm::Event_failed_tracking_standby()
 }
 
 
+bool ChannelFsm::Event_tracking_reacquisition()
+{
+    std::lock_guard<std::mutex> lk(mx);
+    if (d_state != 2)
+        {
+            return false;
+        }
+    // The channel keeps the satellite, but the telemetry decoder must
+    // synchronize again with the navigation message
+    reset_telemetry();
+    DLOG(INFO) << "CH = " << channel_ << ". Ev tracking reacquisition";
+    return true;
+}
+
+
 void ChannelFsm::set_acquisition(std::shared_ptr<AcquisitionInterface> acquisition)
 {
     std::lock_guard<std::mutex> lk(mx);
@@ -218,3 +233,9 @@ void ChannelFsm::notify_stop_tracking()
 {
     queue_->push(pmt::make_any(channel_event_make(channel_, 2)));
 }
+
+
+void ChannelFsm::reset_telemetry()
+{
+    nav_->reset();
+}
@@ -56,6 +56,7 @@ public:
     virtual bool Event_failed_acquisition_repeat();
     virtual bool Event_failed_acquisition_no_repeat();
     bool Event_failed_tracking_standby();
+    bool Event_tracking_reacquisition();
 
 private:
     void start_tracking();
@@ -63,6 +64,7 @@ private:
     void stop_tracking();
     void request_satellite();
     void notify_stop_tracking();
+    void reset_telemetry();
 
     std::shared_ptr<AcquisitionInterface> acq_;
     std::shared_ptr<TrackingInterface> trk_;
@@ -70,6 +70,9 @@ void channel_msg_receiver_cc::msg_handler_events(pmt::pmt_t msg)
                 case 3:  // tracking loss of lock event
                     result = d_channel_fsm->Event_failed_tracking_standby();
                     break;
+                case 4:  // tracking reacquisition, the telemetry must be resynchronized
+                    result = d_channel_fsm->Event_tracking_reacquisition();
+                    break;
                 default:
                     LOG(WARNING) << "Default case, invalid message.";
                     break;
@@ -0,0 +1,379 @@
+/*!
+ * \file dump_writer.cc
+ * \brief Binary dump files written to disk by a shared background thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "dump_writer.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+
+Dump_File::Dump_File(Backpressure policy, size_t block_size, size_t num_blocks) : d_published(0),
+                                                                                 d_consumed(0),
+                                                                                 d_exceptions(std::ios_base::goodbit),
+                                                                                 d_policy(policy),
+                                                                                 d_block_size(block_size),
+                                                                                 d_num_blocks(num_blocks == 0 ? 1 : num_blocks),
+                                                                                 d_offset(0),
+                                                                                 d_position(0),
+                                                                                 d_dropped(0),
+                                                                                 d_failed(false),
+                                                                                 d_open(false)
+{
+}
+
+
+Dump_File::~Dump_File()
+{
+    try
+        {
+            close();
+        }
+    catch (const std::exception& ex)
+        {
+            LOG(WARNING) << "Exception closing a dump file: " << ex.what();
+        }
+}
+
+
+void Dump_File::exceptions(std::ios_base::iostate except)
+{
+    d_exceptions = except;
+    d_stream.exceptions(except);
+}
+
+
+void Dump_File::open(const std::string& filename, std::ios_base::openmode mode)
+{
+    if (d_open)
+        {
+            return;
+        }
+    d_stream.open(filename.c_str(), mode);  // throws if requested by exceptions()
+    if (!d_stream.is_open())
+        {
+            return;
+        }
+    // The ring only exists while the file is open
+    d_blocks.assign(d_num_blocks, std::vector<char>(d_block_size));
+    d_block_fill.assign(d_num_blocks, 0);
+    d_published = 0;
+    d_consumed = 0;
+    d_offset = 0;
+    d_position = 0;
+    d_dropped = 0;
+    d_failed = false;
+    d_open = true;
+    d_writer = Dump_Writer::get_instance();
+    d_writer->add(this);
+}
+
+
+bool Dump_File::is_open() const
+{
+    return d_open;
+}
+
+
+Dump_File& Dump_File::write(const char* data, std::streamsize size)
+{
+    if (!d_open)
+        {
+            if (d_exceptions & std::ios_base::badbit)
+                {
+                    throw std::ios_base::failure("Writing to a dump file that is not open");
+                }
+            return *this;
+        }
+    auto bytes = static_cast<size_t>(size);
+    // Start a new block if the record does not fit in the current one
+    if (d_offset > 0 and d_offset + bytes > d_block_size)
+        {
+            publish();
+        }
+    while (bytes > 0)
+        {
+            if (d_offset == 0 and !acquire_block())
+                {
+                    d_dropped += bytes;
+                    return *this;
+                }
+            const size_t chunk = std::min(bytes, d_block_size - d_offset);
+            std::memcpy(d_blocks[d_published.load(std::memory_order_relaxed) % d_blocks.size()].data() + d_offset, data, chunk);
+            d_offset += chunk;
+            d_position += chunk;
+            data += chunk;
+            bytes -= chunk;
+            if (d_offset == d_block_size)
+                {
+                    publish();
+                }
+        }
+    return *this;
+}
+
+
+std::streamoff Dump_File::tellp() const
+{
+    return static_cast<std::streamoff>(d_position);
+}
+
+
+uint64_t Dump_File::dropped_bytes() const
+{
+    return d_dropped;
+}
+
+
+void Dump_File::flush()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    if (d_offset > 0)
+        {
+            publish();
+        }
+    d_writer->wait(this, d_published.load(std::memory_order_relaxed));
+}
+
+
+void Dump_File::close()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    flush();
+    d_writer->remove(this);
+    d_writer.reset();
+    d_open = false;
+    if (d_dropped > 0)
+        {
+            LOG(WARNING) << d_dropped << " bytes of dump records were dropped because the disk could not keep up";
+        }
+    d_stream.close();
+    std::vector<std::vector<char>>().swap(d_blocks);
+    std::vector<size_t>().swap(d_block_fill);
+}
+
+
+// Waits for the current block to be free, or reports that the record must be dropped
+bool Dump_File::acquire_block()
+{
+    const uint64_t published = d_published.load(std::memory_order_relaxed);
+    if (published - d_consumed.load(std::memory_order_acquire) < d_blocks.size())
+        {
+            return true;
+        }
+    if (d_policy == Backpressure::Drop)
+        {
+            d_writer->notify();
+            return false;
+        }
+    d_writer->wait(this, published - d_blocks.size() + 1);
+    return true;
+}
+
+
+void Dump_File::publish()
+{
+    const uint64_t published = d_published.load(std::memory_order_relaxed);
+    d_block_fill[published % d_blocks.size()] = d_offset;
+    d_published.store(published + 1, std::memory_order_release);
+    d_offset = 0;
+    d_writer->notify();
+}
+
+
+bool Dump_File::write_pending()
+{
+    const uint64_t published = d_published.load(std::memory_order_acquire);
+    uint64_t consumed = d_consumed.load(std::memory_order_relaxed);
+    if (consumed == published)
+        {
+            return false;
+        }
+    for (; consumed < published; consumed++)
+        {
+            const size_t index = consumed % d_blocks.size();
+            if (!d_failed)
+                {
+                    try
+                        {
+                            d_stream.write(d_blocks[index].data(), static_cast<std::streamsize>(d_block_fill[index]));
+                            d_failed = !d_stream.good();
+                        }
+                    catch (const std::ios_base::failure& e)
+                        {
+                            LOG(WARNING) << "Exception writing a dump file: " << e.what();
+                            d_failed = true;
+                        }
+                }
+            d_consumed.store(consumed + 1, std::memory_order_release);
+        }
+    return true;
+}
+
+
+std::shared_ptr<Dump_Writer> Dump_Writer::get_instance()
+{
+    static std::mutex instance_mutex;
+    static std::weak_ptr<Dump_Writer> instance;
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    std::shared_ptr<Dump_Writer> writer = instance.lock();
+    if (!writer)
+        {
+            writer = std::make_shared<Dump_Writer>();
+            instance = writer;
+        }
+    return writer;
+}
+
+
+Dump_Writer::Dump_Writer() : d_tasks_posted(0),
+                             d_tasks_done(0),
+                             d_passes(0),
+                             d_busy(false),
+                             d_stop(false)
+{
+    d_thread = std::thread(&Dump_Writer::run, this);
+}
+
+
+Dump_Writer::~Dump_Writer()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_wakeup.notify_one();
+    d_thread.join();
+}
+
+
+void Dump_Writer::add(Dump_File* file)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_files.push_back(file);
+}
+
+
+void Dump_Writer::remove(Dump_File* file)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_files.erase(std::remove(d_files.begin(), d_files.end(), file), d_files.end());
+    // The current pass may still be writing the file
+    const uint64_t pass = d_passes;
+    while (d_busy and d_passes == pass)
+        {
+            d_progress.wait(lock);
+        }
+}
+
+
+void Dump_Writer::notify()
+{
+    // Not synchronized with the writer thread: a missed notification only
+    // delays the blocks until its next periodic pass
+    d_wakeup.notify_one();
+}
+
+
+void Dump_Writer::wait(const Dump_File* file, uint64_t consumed_blocks)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (file->d_consumed.load(std::memory_order_acquire) < consumed_blocks)
+        {
+            d_wakeup.notify_one();
+            d_progress.wait_for(lock, std::chrono::milliseconds(10));
+        }
+}
+
+
+uint64_t Dump_Writer::post(std::function<void()> task)
+{
+    uint64_t posted;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_tasks.push_back(std::move(task));
+        posted = ++d_tasks_posted;
+    }
+    d_wakeup.notify_one();
+    return posted;
+}
+
+
+void Dump_Writer::wait_task(uint64_t task)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_progress.wait(lock, [this, task]() { return d_tasks_done >= task; });
+}
+
+
+void Dump_Writer::run()
+{
+    std::vector<Dump_File*> files;
+    std::deque<std::function<void()>> tasks;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (!d_stop)
+        {
+            // The disk writes are done without the lock, so the processing
+            // threads never wait for them to add, remove or wait for a file
+            files = d_files;
+            tasks.swap(d_tasks);
+            d_busy = true;
+            lock.unlock();
+            bool written = !tasks.empty();
+            for (auto* file : files)
+                {
+                    written = file->write_pending() or written;
+                }
+            for (auto& task : tasks)
+                {
+                    try
+                        {
+                            task();
+                        }
+                    catch (const std::exception& e)
+                        {
+                            LOG(WARNING) << "Exception in a file writing task: " << e.what();
+                        }
+                }
+            lock.lock();
+            d_tasks_done += tasks.size();
+            tasks.clear();
+            d_busy = false;
+            d_passes++;
+            d_progress.notify_all();
+            if (written)
+                {
+                    // Let the waiting threads in before the next pass
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+            else
+                {
+                    d_wakeup.wait_for(lock, std::chrono::milliseconds(50), [this]() { return d_stop or !d_tasks.empty(); });
+                }
+        }
+}
@@ -0,0 +1,195 @@
+/*!
+ * \file dump_writer.h
+ * \brief Binary dump files written to disk by a shared background thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_DUMP_WRITER_H
+#define GNSS_SDR_DUMP_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class Dump_Writer;
+
+/*!
+ * \brief Binary dump file whose disk writes are done by a background thread.
+ *
+ * It offers the subset of the std::ofstream interface used by the
+ * processing blocks, so the records keep their layout, but a write() only
+ * copies the bytes into the current block of a ring of large memory blocks.
+ * Full blocks are handed off to the Dump_Writer thread shared by all the
+ * dump files through an atomic counter, without locks in the writing thread,
+ * and written to disk in one call each. The ring is allocated when the file
+ * is opened and released when it is closed.
+ *
+ * When all the blocks are waiting to be written, the backpressure policy
+ * decides whether write() waits for the writer thread (Block, the default,
+ * no data is lost) or discards the record (Drop, the caller never waits).
+ * Records are never split between blocks, so a dropped record does not
+ * break the layout of the file.
+ *
+ * The size and number of blocks are set by the constructor. The default
+ * ring, of CHANNEL_NUM_BLOCKS blocks of CHANNEL_BLOCK_SIZE bytes, suits the
+ * dump files of a single channel, which exist for every channel of the
+ * receiver. A file written at a higher rate, such as the one of the
+ * observables, asks for the RECEIVER_NUM_BLOCKS blocks of
+ * RECEIVER_BLOCK_SIZE bytes.
+ */
+class Dump_File
+{
+public:
+    enum class Backpressure
+    {
+        Block,
+        Drop
+    };
+
+    static constexpr size_t CHANNEL_BLOCK_SIZE = 16384;   //!< Default block size, for the per-channel dump files
+    static constexpr size_t CHANNEL_NUM_BLOCKS = 8;       //!< Default number of blocks, for the per-channel dump files
+    static constexpr size_t RECEIVER_BLOCK_SIZE = 65536;  //!< Block size for the dump files of the whole receiver
+    static constexpr size_t RECEIVER_NUM_BLOCKS = 16;     //!< Number of blocks for the dump files of the whole receiver
+
+    explicit Dump_File(Backpressure policy = Backpressure::Block, size_t block_size = CHANNEL_BLOCK_SIZE, size_t num_blocks = CHANNEL_NUM_BLOCKS);
+    ~Dump_File();
+    Dump_File(const Dump_File&) = delete;
+    Dump_File& operator=(const Dump_File&) = delete;
+
+    /*!
+     * \brief Sets the states of the underlying stream that throw a
+     * std::ios_base::failure, as in std::ofstream. Writing errors of the
+     * background thread are logged and the rest of the file is discarded.
+     */
+    void exceptions(std::ios_base::iostate except);
+
+    void open(const std::string& filename, std::ios_base::openmode mode = std::ios::out | std::ios::binary);
+    bool is_open() const;
+
+    /*!
+     * \brief Copies a record to the current block. Records are expected to be
+     * smaller than the block size.
+     */
+    Dump_File& write(const char* data, std::streamsize size);
+
+    /*!
+     * \brief Writes a trivially copyable record struct.
+     */
+    template <typename T>
+    Dump_File& write_record(const T& record)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Dump records must be trivially copyable");
+        return write(reinterpret_cast<const char*>(&record), sizeof(T));
+    }
+
+    std::streamoff tellp() const;  //!< Bytes accepted so far
+    uint64_t dropped_bytes() const;
+
+    /*!
+     * \brief Hands off the current block and waits until everything is on disk.
+     */
+    void flush();
+    void close();
+
+private:
+    friend class Dump_Writer;
+
+    bool acquire_block();
+    void publish();
+    bool write_pending();  // called by the writer thread
+
+    std::vector<std::vector<char>> d_blocks;
+    std::vector<size_t> d_block_fill;
+    std::atomic<uint64_t> d_published;  // blocks handed off to the writer thread
+    std::atomic<uint64_t> d_consumed;   // blocks written by the writer thread
+    std::ofstream d_stream;
+    std::shared_ptr<Dump_Writer> d_writer;
+    std::ios_base::iostate d_exceptions;
+    Backpressure d_policy;
+    size_t d_block_size;
+    size_t d_num_blocks;
+    size_t d_offset;
+    uint64_t d_position;
+    uint64_t d_dropped;
+    bool d_failed;
+    bool d_open;
+};
+
+
+/*!
+ * \brief Background thread that writes the blocks of all the open Dump_File
+ * objects, and runs the file writing tasks posted by other writers. It
+ * exists while at least one of them holds it.
+ */
+class Dump_Writer
+{
+public:
+    static std::shared_ptr<Dump_Writer> get_instance();
+
+    Dump_Writer();
+    ~Dump_Writer();
+
+    void add(Dump_File* file);
+
+    /*!
+     * \brief Stops writing a file. Returns once the writer thread no longer uses it.
+     */
+    void remove(Dump_File* file);
+    void notify();
+
+    /*!
+     * \brief Waits until the writer thread has written the given number of blocks of a file.
+     */
+    void wait(const Dump_File* file, uint64_t consumed_blocks);
+
+    /*!
+     * \brief Runs a task in the writer thread, after the tasks posted before
+     * it. Returns the number to pass to wait_task().
+     */
+    uint64_t post(std::function<void()> task);
+
+    /*!
+     * \brief Waits until a posted task, and the ones before it, have been run.
+     */
+    void wait_task(uint64_t task);
+
+private:
+    void run();
+
+    std::vector<Dump_File*> d_files;
+    std::deque<std::function<void()>> d_tasks;
+    std::mutex d_mutex;
+    std::condition_variable d_wakeup;
+    std::condition_variable d_progress;
+    uint64_t d_tasks_posted;
+    uint64_t d_tasks_done;
+    uint64_t d_passes;  // completed writing passes
+    bool d_busy;        // a pass is writing the files without the lock
+    bool d_stop;
+    std::thread d_thread;
+};
+
+#endif  // GNSS_SDR_DUMP_WRITER_H
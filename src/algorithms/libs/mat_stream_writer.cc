@@ -0,0 +1,283 @@
+/*!
+ * \file mat_stream_writer.cc
+ * \brief Writes MAT v7.3 files incrementally, in chunks of epochs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mat_stream_writer.h"
+#include <glog/logging.h>
+#include <matio.h>
+#include <array>
+#include <cstdio>   // for remove
+#include <memory>   // for make_shared
+#include <utility>  // for move
+
+// Mat_VarWriteAppend is available since matio 1.5.13
+#if MATIO_MAJOR_VERSION > 1 || (MATIO_MAJOR_VERSION == 1 && (MATIO_MINOR_VERSION > 5 || (MATIO_MINOR_VERSION == 5 && MATIO_RELEASE_LEVEL >= 13)))
+#define MAT_STREAM_WRITER_APPEND 1
+#else
+#define MAT_STREAM_WRITER_APPEND 0
+#endif
+
+
+Mat_Stream_Writer::Mat_Stream_Writer(size_t chunk_epochs) : d_failed(false),
+                                                            d_last_task(0),
+                                                            d_chunk_epochs(chunk_epochs == 0 ? 1 : chunk_epochs),
+                                                            d_buffered_epochs(0),
+                                                            d_epochs(0),
+                                                            d_compression(false),
+                                                            d_open(false)
+{
+}
+
+
+Mat_Stream_Writer::~Mat_Stream_Writer()
+{
+    close();
+}
+
+
+bool Mat_Stream_Writer::open(const std::string& filename, bool compression)
+{
+    if (d_open)
+        {
+            return true;
+        }
+    d_filename = filename;
+    d_compression = compression;
+    d_buffered_epochs = 0;
+    d_epochs = 0;
+    d_failed = false;
+    d_writer = Dump_Writer::get_instance();
+    // Create an empty file, the variables are created by the first chunk
+    d_last_task = d_writer->post([this, filename]() {
+        if (!create_file(filename))
+            {
+                d_failed = true;
+            }
+    });
+    d_open = true;
+    return true;
+}
+
+
+bool Mat_Stream_Writer::is_open() const
+{
+    return d_open;
+}
+
+
+size_t Mat_Stream_Writer::add_variable(const std::string& name, Mat_Class mat_class, size_t element_size, size_t rows)
+{
+    Variable variable;
+    variable.name = name;
+    variable.mat_class = mat_class;
+    variable.element_size = element_size;
+    variable.rows = rows;
+    variable.buffer.reserve(element_size * rows * d_chunk_epochs);
+    d_variables.push_back(std::move(variable));
+    return d_variables.size() - 1;
+}
+
+
+void Mat_Stream_Writer::end_epoch()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    d_buffered_epochs++;
+    d_epochs++;
+    for (const auto& variable : d_variables)
+        {
+            if (!d_failed and variable.buffer.size() != variable.element_size * variable.rows * d_buffered_epochs)
+                {
+                    LOG(ERROR) << "Wrong number of rows of the variable " << variable.name << " in epoch " << d_epochs
+                               << " of the .mat file " << d_filename << ". No more epochs are written to it";
+                    d_failed = true;
+                }
+        }
+    if (MAT_STREAM_WRITER_APPEND and d_buffered_epochs >= d_chunk_epochs)
+        {
+            if (d_failed)
+                {
+                    close();
+                    return;
+                }
+            post_buffered_epochs();
+        }
+}
+
+
+uint64_t Mat_Stream_Writer::epochs() const
+{
+    return d_epochs;
+}
+
+
+void Mat_Stream_Writer::close()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    post_buffered_epochs();
+    d_writer->wait_task(d_last_task);
+    d_writer.reset();
+    d_open = false;
+    if (d_epochs == 0)
+        {
+            std::remove(d_filename.c_str());
+        }
+    for (auto& variable : d_variables)
+        {
+            variable.buffer.clear();
+            variable.buffer.shrink_to_fit();
+        }
+}
+
+
+// A value appended with a type other than the one of its variable would
+// corrupt the file, so the epochs from this one on are not written
+void Mat_Stream_Writer::wrong_variable(size_t variable, size_t element_size)
+{
+    if (d_failed)
+        {
+            return;
+        }
+    if (variable >= d_variables.size())
+        {
+            LOG(ERROR) << "Unknown variable " << variable << " appended to the .mat file " << d_filename << ". No more epochs are written to it";
+        }
+    else
+        {
+            LOG(ERROR) << "Value of " << element_size << " bytes appended to the variable " << d_variables[variable].name << " of "
+                       << d_variables[variable].element_size << " bytes, or of another class, in the .mat file " << d_filename << ". No more epochs are written to it";
+        }
+    d_failed = true;
+}
+
+
+// Hands off the buffered columns to the writer thread
+void Mat_Stream_Writer::post_buffered_epochs()
+{
+    if (d_buffered_epochs == 0)
+        {
+            return;
+        }
+    auto chunk = std::make_shared<std::vector<Variable>>();
+    chunk->reserve(d_variables.size());
+    for (auto& variable : d_variables)
+        {
+            Variable columns;
+            columns.name = variable.name;
+            columns.mat_class = variable.mat_class;
+            columns.element_size = variable.element_size;
+            columns.rows = variable.rows;
+            columns.buffer.swap(variable.buffer);
+            variable.buffer.reserve(columns.buffer.capacity());
+            chunk->push_back(std::move(columns));
+        }
+    const size_t epochs = d_buffered_epochs;
+    const std::string filename = d_filename;
+    const bool compression = d_compression;
+    d_buffered_epochs = 0;
+    d_last_task = d_writer->post([this, chunk, filename, epochs, compression]() {
+        if (!d_failed and !write_chunk(filename, *chunk, epochs, compression))
+            {
+                d_failed = true;
+            }
+    });
+}
+
+
+bool Mat_Stream_Writer::create_file(const std::string& filename)
+{
+    mat_t* matfp = Mat_CreateVer(filename.c_str(), nullptr, MAT_FT_MAT73);
+    if (matfp == nullptr)
+        {
+            LOG(WARNING) << "Unable to create the .mat file " << filename;
+            return false;
+        }
+    Mat_Close(matfp);
+    return true;
+}
+
+
+bool Mat_Stream_Writer::write_chunk(const std::string& filename, std::vector<Variable>& chunk, size_t epochs, bool compression)
+{
+    mat_t* matfp = Mat_Open(filename.c_str(), MAT_ACC_RDWR);
+    if (matfp == nullptr)
+        {
+            LOG(WARNING) << "Unable to open the .mat file " << filename;
+            return false;
+        }
+    const matio_compression compression_type = compression ? MAT_COMPRESSION_ZLIB : MAT_COMPRESSION_NONE;
+    bool success = true;
+    for (auto& variable : chunk)
+        {
+            matio_classes class_type;
+            matio_types data_type;
+            switch (variable.mat_class)
+                {
+                case Mat_Class::Single:
+                    class_type = MAT_C_SINGLE;
+                    data_type = MAT_T_SINGLE;
+                    break;
+                case Mat_Class::Double:
+                    class_type = MAT_C_DOUBLE;
+                    data_type = MAT_T_DOUBLE;
+                    break;
+                case Mat_Class::Int8:
+                    class_type = MAT_C_INT8;
+                    data_type = MAT_T_INT8;
+                    break;
+                case Mat_Class::UInt8:
+                    class_type = MAT_C_UINT8;
+                    data_type = MAT_T_UINT8;
+                    break;
+                case Mat_Class::Int32:
+                    class_type = MAT_C_INT32;
+                    data_type = MAT_T_INT32;
+                    break;
+                case Mat_Class::UInt32:
+                    class_type = MAT_C_UINT32;
+                    data_type = MAT_T_UINT32;
+                    break;
+                case Mat_Class::Int64:
+                    class_type = MAT_C_INT64;
+                    data_type = MAT_T_INT64;
+                    break;
+                default:
+                    class_type = MAT_C_UINT64;
+                    data_type = MAT_T_UINT64;
+                }
+            std::array<size_t, 2> dims{variable.rows, epochs};
+            matvar_t* matvar = Mat_VarCreate(variable.name.c_str(), class_type, data_type, 2, dims.data(), variable.buffer.data(), MAT_F_DONT_COPY_DATA);
+#if MAT_STREAM_WRITER_APPEND
+            // Chunked dataset, grown along the epochs dimension
+            success = Mat_VarWriteAppend(matfp, matvar, compression_type, 2) == 0 and success;
+#else
+            success = Mat_VarWrite(matfp, matvar, compression_type) == 0 and success;
+#endif
+            Mat_VarFree(matvar);
+        }
+    Mat_Close(matfp);
+    if (!success)
+        {
+            LOG(WARNING) << "Error writing the .mat file " << filename;
+        }
+    return success;
+}
@@ -0,0 +1,160 @@
+/*!
+ * \file mat_stream_writer.h
+ * \brief Writes MAT v7.3 files incrementally, in chunks of epochs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MAT_STREAM_WRITER_H
+#define GNSS_SDR_MAT_STREAM_WRITER_H
+
+#include "dump_writer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Builds a MAT v7.3 file while the receiver runs, instead of
+ * converting the binary dump file at the end of the run.
+ *
+ * Each variable is a matrix of rows x epochs elements. The values of every
+ * epoch are appended to the variables and, each chunk_epochs epochs, the
+ * buffered columns are handed off to the Dump_Writer thread, which appends
+ * them to the chunked HDF5 datasets of the file. The calling thread never
+ * waits for the disk, except in close(). The file is closed again between
+ * chunks so it can be read while the receiver is running. Memory use does
+ * not depend on the length of the run, and closing the file only writes the
+ * last chunk. All the matio calls are done by the writer thread.
+ *
+ * With matio versions older than 1.5.13, which cannot append to variables,
+ * the epochs are kept in memory and written when the file is closed.
+ */
+class Mat_Stream_Writer
+{
+public:
+    explicit Mat_Stream_Writer(size_t chunk_epochs = 1000);
+    ~Mat_Stream_Writer();
+    Mat_Stream_Writer(const Mat_Stream_Writer&) = delete;
+    Mat_Stream_Writer& operator=(const Mat_Stream_Writer&) = delete;
+
+    /*!
+     * \brief Starts a file. It is created by the writer thread, which logs
+     * any error and then discards the epochs. The variables are compressed
+     * with zlib if compression is true.
+     */
+    bool open(const std::string& filename, bool compression = false);
+    bool is_open() const;
+
+    /*!
+     * \brief Declares a variable with the given number of rows, before the first epoch.
+     * Returns its index for append().
+     */
+    template <typename T>
+    size_t add_variable(const std::string& name, size_t rows = 1)
+    {
+        return add_variable(name, class_of(T()), sizeof(T), rows);
+    }
+
+    /*!
+     * \brief Appends the next row of a variable in the current epoch. T must
+     * be the type the variable was declared with. Otherwise, or with an
+     * unknown index, the value is not appended, an error is logged and no
+     * more epochs are written to the file. Returns false if the value was
+     * not appended.
+     */
+    template <typename T>
+    bool append(size_t variable, T value)
+    {
+        if (!d_open)
+            {
+                return false;
+            }
+        if (variable >= d_variables.size() or class_of(value) != d_variables[variable].mat_class or sizeof(T) != d_variables[variable].element_size)
+            {
+                wrong_variable(variable, sizeof(T));
+                return false;
+            }
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        d_variables[variable].buffer.insert(d_variables[variable].buffer.end(), bytes, bytes + sizeof(T));
+        return true;
+    }
+
+    /*!
+     * \brief Completes an epoch. All the rows of all the variables must have
+     * been appended, otherwise an error is logged and no more epochs are
+     * written to the file.
+     */
+    void end_epoch();
+
+    uint64_t epochs() const;  //!< Epochs written to the file or buffered
+
+    /*!
+     * \brief Writes the buffered epochs and waits until the file is complete.
+     * The file is removed if no epoch was written.
+     */
+    void close();
+
+private:
+    enum class Mat_Class
+    {
+        Single,
+        Double,
+        Int8,
+        UInt8,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64
+    };
+
+    struct Variable
+    {
+        std::string name;
+        Mat_Class mat_class;
+        size_t element_size;
+        size_t rows;
+        std::vector<uint8_t> buffer;
+    };
+
+    static Mat_Class class_of(float) { return Mat_Class::Single; }
+    static Mat_Class class_of(double) { return Mat_Class::Double; }
+    static Mat_Class class_of(int8_t) { return Mat_Class::Int8; }
+    static Mat_Class class_of(uint8_t) { return Mat_Class::UInt8; }
+    static Mat_Class class_of(int32_t) { return Mat_Class::Int32; }
+    static Mat_Class class_of(uint32_t) { return Mat_Class::UInt32; }
+    static Mat_Class class_of(int64_t) { return Mat_Class::Int64; }
+    static Mat_Class class_of(uint64_t) { return Mat_Class::UInt64; }
+
+    size_t add_variable(const std::string& name, Mat_Class mat_class, size_t element_size, size_t rows);
+    void wrong_variable(size_t variable, size_t element_size);
+    void post_buffered_epochs();
+    static bool create_file(const std::string& filename);
+    static bool write_chunk(const std::string& filename, std::vector<Variable>& chunk, size_t epochs, bool compression);
+
+    std::vector<Variable> d_variables;
+    std::string d_filename;
+    std::shared_ptr<Dump_Writer> d_writer;
+    std::atomic<bool> d_failed;  // set by the writer thread
+    uint64_t d_last_task;
+    size_t d_chunk_epochs;
+    size_t d_buffered_epochs;
+    uint64_t d_epochs;
+    bool d_compression;
+    bool d_open;
+};
+
+#endif  // GNSS_SDR_MAT_STREAM_WRITER_H
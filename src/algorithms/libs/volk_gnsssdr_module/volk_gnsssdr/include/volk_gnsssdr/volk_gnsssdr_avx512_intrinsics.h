@@ -0,0 +1,55 @@
+/*!
+ * \file volk_gnsssdr_avx512_intrinsics.h
+ * \brief This file is intended to hold AVX-512 intrinsics of intrinsics.
+ * They should be used in VOLK kernels to avoid copy-paste.
+ *
+ * Copyright (C) 2010-2020 (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software-defined Global Navigation Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+#ifndef INCLUDED_VOLK_VOLK_AVX512_INTRINSICS_H
+#define INCLUDED_VOLK_VOLK_AVX512_INTRINSICS_H
+#include <immintrin.h>
+
+static inline __m512
+_mm512_complexmul_ps(__m512 x, __m512 y)
+{
+    __m512 yl, yh, tmp2;
+    yl = _mm512_moveldup_ps(y);            // Load yl with cr,cr,dr,dr ...
+    yh = _mm512_movehdup_ps(y);            // Load yh with ci,ci,di,di ...
+    tmp2 = _mm512_permute_ps(x, 0xB1);     // Re-arrange x to be ai,ar,bi,br ...
+    tmp2 = _mm512_mul_ps(tmp2, yh);        // tmp2 = ai*ci,ar*ci,bi*di,br*di ...
+    return _mm512_fmaddsub_ps(x, yl, tmp2);  // ar*cr-ai*ci, ai*cr+ar*ci, br*dr-bi*di, bi*dr+br*di ...
+}
+
+static inline __m512
+_mm512_complexnormalise_ps(__m512 z)
+{
+    __m512 tmp1 = _mm512_mul_ps(z, z);                         // ar*ar,ai*ai,br*br,bi*bi ...
+    tmp1 = _mm512_add_ps(tmp1, _mm512_permute_ps(tmp1, 0xB1));  // |a|^2,|a|^2,|b|^2,|b|^2 ...
+    return _mm512_div_ps(z, _mm512_sqrt_ps(tmp1));
+}
+
+static inline __m512
+_mm512_duplicate_lo_ps(__m512 x)
+{
+    // t0|t0|t1|t1| ... |t7|t7
+    const __m512i idx = _mm512_set_epi32(7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+    return _mm512_permutexvar_ps(idx, x);
+}
+
+static inline __m512
+_mm512_duplicate_hi_ps(__m512 x)
+{
+    // t8|t8|t9|t9| ... |t15|t15
+    const __m512i idx = _mm512_set_epi32(15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8, 8);
+    return _mm512_permutexvar_ps(idx, x);
+}
+
+#endif /* INCLUDED_VOLK_VOLK_AVX512_INTRINSICS_H */
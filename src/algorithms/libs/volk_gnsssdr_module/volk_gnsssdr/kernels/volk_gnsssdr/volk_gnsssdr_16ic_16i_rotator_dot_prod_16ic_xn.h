@@ -787,4 +787,259 @@ static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn_u_avx2(lv_16sc
 }
 #endif /* LV_HAVE_AVX2 */
 
+#ifdef LV_HAVE_AVX512BW
+#include <volk_gnsssdr/volk_gnsssdr_avx512_intrinsics.h>
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn_a_avx512bw(lv_16sc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int avx512_iters = num_points / 16;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+
+    __VOLK_ATTR_ALIGNED(64)
+    lv_16sc_t dotProductVector[16];
+    lv_16sc_t dotProduct = lv_cmake(0, 0);
+
+    __m512i* cacc = (__m512i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m512i), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm512_setzero_si512();
+        }
+
+    // Set up the complex rotator: samples 0-7 in z0 and 8-15 in z1
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t phase_vec[16];
+    lv_32fc_t _phase = *phase;
+    for (n = 0; n < 16; n++)
+        {
+            phase_vec[n] = _phase;
+            _phase *= phase_inc;
+        }
+    __m512 z0 = _mm512_load_ps((float*)phase_vec);
+    __m512 z1 = _mm512_load_ps((float*)(phase_vec + 8));
+
+    lv_32fc_t dz = phase_inc;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;  // dz = phase_inc^16;
+    for (n = 0; n < 8; n++)
+        {
+            phase_vec[n] = dz;
+        }
+    __m512 dz_reg = _mm512_load_ps((float*)phase_vec);
+    dz_reg = _mm512_complexnormalise_ps(dz_reg);
+
+    // packs_epi32 interleaves the 128-bit lanes of both halves, this restores the sample order
+    const __m512i perm_idx = _mm512_set_epi32(15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0);
+    // Each code value is used for both the real and the imaginary parts
+    const __m512i dup_idx = _mm512_set_epi16(15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8, 8,
+        7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+
+    __m512i ain, c1, c2, b2, a2, c;
+    __m512 a, b;
+
+    for (number = 0; number < avx512_iters; number++)
+        {
+            ain = _mm512_load_si512((const __m512i*)_in_common);
+
+            a = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(ain)));
+            b = _mm512_complexmul_ps(a, z0);
+            c1 = _mm512_cvtps_epi32(b);  // convert from 32fc to 32ic
+
+            a = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(ain, 1)));
+            b = _mm512_complexmul_ps(a, z1);
+            c2 = _mm512_cvtps_epi32(b);
+
+            z0 = _mm512_complexmul_ps(z0, dz_reg);
+            z1 = _mm512_complexmul_ps(z1, dz_reg);
+
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 32);
+
+            // Convert 32ic to 16ic with saturation
+            b2 = _mm512_permutexvar_epi32(perm_idx, _mm512_packs_epi32(c1, c2));
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a2 = _mm512_castsi256_si512(_mm256_load_si256((const __m256i*)&(in_a[n_vec][number * 16])));
+                    a2 = _mm512_permutexvar_epi16(dup_idx, a2);
+                    c = _mm512_mullo_epi16(a2, b2);
+                    cacc[n_vec] = _mm512_adds_epi16(cacc[n_vec], c);
+                }
+
+            // Regenerate phase
+            if ((number % 64) == 0)
+                {
+                    z0 = _mm512_complexnormalise_ps(z0);
+                    z1 = _mm512_complexnormalise_ps(z1);
+                }
+            _in_common += 16;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm512_store_si512((__m512i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0, 0);
+            for (n = 0; n < 16; ++n)
+                {
+                    dotProduct = lv_cmake(sat_adds16i(lv_creal(dotProduct), lv_creal(dotProductVector[n])),
+                        sat_adds16i(lv_cimag(dotProduct), lv_cimag(dotProductVector[n])));
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(cacc);
+
+    _mm512_store_ps((float*)phase_vec, z0);
+    (*phase) = phase_vec[0];
+
+    for (n = avx512_iters * 16; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp16 = lv_cmake((int16_t)rintf(lv_creal(tmp32)), (int16_t)rintf(lv_cimag(tmp32)));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    lv_16sc_t tmp = tmp16 * in_a[n_vec][n];
+                    result[n_vec] = lv_cmake(sat_adds16i(lv_creal(result[n_vec]), lv_creal(tmp)),
+                        sat_adds16i(lv_cimag(result[n_vec]), lv_cimag(tmp)));
+                }
+        }
+}
+#endif /* LV_HAVE_AVX512BW */
+
+
+#ifdef LV_HAVE_AVX512BW
+#include <volk_gnsssdr/volk_gnsssdr_avx512_intrinsics.h>
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn_u_avx512bw(lv_16sc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int avx512_iters = num_points / 16;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+
+    __VOLK_ATTR_ALIGNED(64)
+    lv_16sc_t dotProductVector[16];
+    lv_16sc_t dotProduct = lv_cmake(0, 0);
+
+    __m512i* cacc = (__m512i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m512i), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm512_setzero_si512();
+        }
+
+    // Set up the complex rotator: samples 0-7 in z0 and 8-15 in z1
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t phase_vec[16];
+    lv_32fc_t _phase = *phase;
+    for (n = 0; n < 16; n++)
+        {
+            phase_vec[n] = _phase;
+            _phase *= phase_inc;
+        }
+    __m512 z0 = _mm512_load_ps((float*)phase_vec);
+    __m512 z1 = _mm512_load_ps((float*)(phase_vec + 8));
+
+    lv_32fc_t dz = phase_inc;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;  // dz = phase_inc^16;
+    for (n = 0; n < 8; n++)
+        {
+            phase_vec[n] = dz;
+        }
+    __m512 dz_reg = _mm512_load_ps((float*)phase_vec);
+    dz_reg = _mm512_complexnormalise_ps(dz_reg);
+
+    // packs_epi32 interleaves the 128-bit lanes of both halves, this restores the sample order
+    const __m512i perm_idx = _mm512_set_epi32(15, 14, 11, 10, 7, 6, 3, 2, 13, 12, 9, 8, 5, 4, 1, 0);
+    // Each code value is used for both the real and the imaginary parts
+    const __m512i dup_idx = _mm512_set_epi16(15, 15, 14, 14, 13, 13, 12, 12, 11, 11, 10, 10, 9, 9, 8, 8,
+        7, 7, 6, 6, 5, 5, 4, 4, 3, 3, 2, 2, 1, 1, 0, 0);
+
+    __m512i ain, c1, c2, b2, a2, c;
+    __m512 a, b;
+
+    for (number = 0; number < avx512_iters; number++)
+        {
+            ain = _mm512_loadu_si512((const __m512i*)_in_common);
+
+            a = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(ain)));
+            b = _mm512_complexmul_ps(a, z0);
+            c1 = _mm512_cvtps_epi32(b);  // convert from 32fc to 32ic
+
+            a = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(ain, 1)));
+            b = _mm512_complexmul_ps(a, z1);
+            c2 = _mm512_cvtps_epi32(b);
+
+            z0 = _mm512_complexmul_ps(z0, dz_reg);
+            z1 = _mm512_complexmul_ps(z1, dz_reg);
+
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 32);
+
+            // Convert 32ic to 16ic with saturation
+            b2 = _mm512_permutexvar_epi32(perm_idx, _mm512_packs_epi32(c1, c2));
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a2 = _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i*)&(in_a[n_vec][number * 16])));
+                    a2 = _mm512_permutexvar_epi16(dup_idx, a2);
+                    c = _mm512_mullo_epi16(a2, b2);
+                    cacc[n_vec] = _mm512_adds_epi16(cacc[n_vec], c);
+                }
+
+            // Regenerate phase
+            if ((number % 64) == 0)
+                {
+                    z0 = _mm512_complexnormalise_ps(z0);
+                    z1 = _mm512_complexnormalise_ps(z1);
+                }
+            _in_common += 16;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm512_store_si512((__m512i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0, 0);
+            for (n = 0; n < 16; ++n)
+                {
+                    dotProduct = lv_cmake(sat_adds16i(lv_creal(dotProduct), lv_creal(dotProductVector[n])),
+                        sat_adds16i(lv_cimag(dotProduct), lv_cimag(dotProductVector[n])));
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(cacc);
+
+    _mm512_store_ps((float*)phase_vec, z0);
+    (*phase) = phase_vec[0];
+
+    for (n = avx512_iters * 16; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp16 = lv_cmake((int16_t)rintf(lv_creal(tmp32)), (int16_t)rintf(lv_cimag(tmp32)));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    lv_16sc_t tmp = tmp16 * in_a[n_vec][n];
+                    result[n_vec] = lv_cmake(sat_adds16i(lv_creal(result[n_vec]), lv_creal(tmp)),
+                        sat_adds16i(lv_cimag(result[n_vec]), lv_cimag(tmp)));
+                }
+        }
+}
+#endif /* LV_HAVE_AVX512BW */
+
 #endif /* INCLUDED_volk_gnsssdr_16ic_16i_dot_prod_16ic_xn_H */
@@ -0,0 +1,597 @@
+/*!
+ * \file volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn.h
+ * \brief VOLK_GNSSSDR kernel: multiplies N 16 bits vectors by a common vector
+ * phase rotated and accumulates the results in 32 bits integers.
+ *
+ * VOLK_GNSSSDR kernel that multiplies N 16 bits vectors by a common vector, which is
+ * phase-rotated by phase offset and phase increment, and accumulates the results
+ * in 32 bits integers, returned as N 32 bits float complex outputs. Unlike
+ * volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn, the accumulators do not
+ * saturate with strong inputs or long integration windows.
+ * It is optimized to perform the N tap correlation process in GNSS receivers.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn
+ *
+ * \b Overview
+ *
+ * Rotates and multiplies the reference complex vector with an arbitrary number of other real vectors,
+ * accumulates the results and stores them in the output vector.
+ * The rotation is done at a fixed rate per sample, from an initial \p phase offset.
+ * The rotated samples are rounded to integers, as in volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn,
+ * but the products are accumulated in 32 bits integers. With +/-1 valued \p in_a vectors and
+ * \p in_common samples of magnitude up to 32767, the sums are exact for \p num_points up to 2^17.
+ * This function can be used for Doppler wipe-off and multiple correlator.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li in_common:     Pointer to one of the vectors to be rotated, multiplied and accumulated (reference vector).
+ * \li phase_inc:     Phase increment = lv_cmake(cos(phase_step_rad), sin(phase_step_rad))
+ * \li phase:         Initial phase = lv_cmake(cos(initial_phase_rad), sin(initial_phase_rad))
+ * \li in_a:          Pointer to an array of pointers to multiple vectors to be multiplied and accumulated.
+ * \li num_a_vectors: Number of vectors to be multiplied by the reference vector and accumulated.
+ * \li num_points:    Number of complex values to be multiplied together, accumulated and stored into \p result.
+ *
+ * \b Outputs
+ * \li phase:         Final phase.
+ * \li result:        Vector of \p num_a_vectors components with the multiple vectors of \p in_a rotated, multiplied by \p in_common and accumulated.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_H
+#define INCLUDED_volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_H
+
+
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <math.h>
+#include <stdint.h>
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_generic(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+    int32_t tmp_r;
+    int32_t tmp_i;
+    int n_vec;
+    unsigned int n;
+    int64_t* acc = (int64_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64_t), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < 2 * num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = 0;
+        }
+    for (n = 0; n < num_points; n++)
+        {
+            tmp16 = *in_common++;
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp_r = (int32_t)rintf(lv_creal(tmp32));
+            tmp_i = (int32_t)rintf(lv_cimag(tmp32));
+
+            // Regenerate phase
+            if (n % 256 == 0)
+                {
+#ifdef __cplusplus
+                    (*phase) /= std::abs((*phase));
+#else
+                    (*phase) /= hypotf(lv_creal(*phase), lv_cimag(*phase));
+#endif
+                }
+
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    acc[2 * n_vec] += tmp_r * in_a[n_vec][n];
+                    acc[2 * n_vec + 1] += tmp_i * in_a[n_vec][n];
+                }
+        }
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake((float)acc[2 * n_vec], (float)acc[2 * n_vec + 1]);
+        }
+    volk_gnsssdr_free(acc);
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE4_1
+#include <volk_gnsssdr/volk_gnsssdr_sse3_intrinsics.h>
+#include <smmintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_a_sse4_1(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 4;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+    int32_t tmp_r;
+    int32_t tmp_i;
+
+    __VOLK_ATTR_ALIGNED(16)
+    int32_t dotProductVector[4];
+
+    int64_t* acc = (int64_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64_t), volk_gnsssdr_get_alignment());
+    __m128i* cacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm_setzero_si128();
+        }
+
+    __m128i a128, c1, c2, ain;
+    __m128 pa, tmp1, tmp2, two_phase_acc_reg, two_phase_inc_reg;
+
+    __VOLK_ATTR_ALIGNED(16)
+    lv_32fc_t two_phase_inc[2];
+    two_phase_inc[0] = phase_inc * phase_inc;
+    two_phase_inc[1] = phase_inc * phase_inc;
+    two_phase_inc_reg = _mm_load_ps((float*)two_phase_inc);
+    __VOLK_ATTR_ALIGNED(16)
+    lv_32fc_t two_phase_acc[2];
+    two_phase_acc[0] = (*phase);
+    two_phase_acc[1] = (*phase) * phase_inc;
+    two_phase_acc_reg = _mm_load_ps((float*)two_phase_acc);
+
+    for (number = 0; number < sse_iters; number++)
+        {
+            a128 = _mm_load_si128((__m128i*)_in_common);  // load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+
+            // rotate the first two samples and convert them to 32ic
+            pa = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(a128));
+            c1 = _mm_cvtps_epi32(_mm_complexmul_ps(pa, two_phase_acc_reg));
+            two_phase_acc_reg = _mm_complexmul_ps(two_phase_inc_reg, two_phase_acc_reg);
+
+            // next two samples
+            pa = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(a128, 8)));
+            c2 = _mm_cvtps_epi32(_mm_complexmul_ps(pa, two_phase_acc_reg));
+            two_phase_acc_reg = _mm_complexmul_ps(two_phase_inc_reg, two_phase_acc_reg);
+
+            _in_common += 4;
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 8);
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    ain = _mm_loadl_epi64((__m128i*)&(in_a[n_vec][number * 4]));
+                    ain = _mm_unpacklo_epi16(ain, ain);  // a0, a0, a1, a1, a2, a2, a3, a3
+
+                    cacc[n_vec] = _mm_add_epi32(cacc[n_vec], _mm_mullo_epi32(c1, _mm_cvtepi16_epi32(ain)));
+                    cacc[n_vec] = _mm_add_epi32(cacc[n_vec], _mm_mullo_epi32(c2, _mm_cvtepi16_epi32(_mm_srli_si128(ain, 8))));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    tmp1 = _mm_mul_ps(two_phase_acc_reg, two_phase_acc_reg);
+                    tmp2 = _mm_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm_sqrt_ps(tmp1);
+                    two_phase_acc_reg = _mm_div_ps(two_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm_store_si128((__m128i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            acc[2 * n_vec] = (int64_t)dotProductVector[0] + dotProductVector[2];
+            acc[2 * n_vec + 1] = (int64_t)dotProductVector[1] + dotProductVector[3];
+        }
+    volk_gnsssdr_free(cacc);
+
+    tmp1 = _mm_mul_ps(two_phase_acc_reg, two_phase_acc_reg);
+    tmp2 = _mm_hadd_ps(tmp1, tmp1);
+    tmp1 = _mm_shuffle_ps(tmp2, tmp2, 0xD8);
+    tmp2 = _mm_sqrt_ps(tmp1);
+    two_phase_acc_reg = _mm_div_ps(two_phase_acc_reg, tmp2);
+
+    _mm_store_ps((float*)two_phase_acc, two_phase_acc_reg);
+    (*phase) = two_phase_acc[0];
+
+    for (n = sse_iters * 4; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp_r = (int32_t)rintf(lv_creal(tmp32));
+            tmp_i = (int32_t)rintf(lv_cimag(tmp32));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    acc[2 * n_vec] += tmp_r * in_a[n_vec][n];
+                    acc[2 * n_vec + 1] += tmp_i * in_a[n_vec][n];
+                }
+        }
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake((float)acc[2 * n_vec], (float)acc[2 * n_vec + 1]);
+        }
+    volk_gnsssdr_free(acc);
+}
+
+#endif /* LV_HAVE_SSE4_1 */
+
+
+#ifdef LV_HAVE_SSE4_1
+#include <volk_gnsssdr/volk_gnsssdr_sse3_intrinsics.h>
+#include <smmintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_u_sse4_1(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 4;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+    int32_t tmp_r;
+    int32_t tmp_i;
+
+    __VOLK_ATTR_ALIGNED(16)
+    int32_t dotProductVector[4];
+
+    int64_t* acc = (int64_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64_t), volk_gnsssdr_get_alignment());
+    __m128i* cacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm_setzero_si128();
+        }
+
+    __m128i a128, c1, c2, ain;
+    __m128 pa, tmp1, tmp2, two_phase_acc_reg, two_phase_inc_reg;
+
+    __VOLK_ATTR_ALIGNED(16)
+    lv_32fc_t two_phase_inc[2];
+    two_phase_inc[0] = phase_inc * phase_inc;
+    two_phase_inc[1] = phase_inc * phase_inc;
+    two_phase_inc_reg = _mm_load_ps((float*)two_phase_inc);
+    __VOLK_ATTR_ALIGNED(16)
+    lv_32fc_t two_phase_acc[2];
+    two_phase_acc[0] = (*phase);
+    two_phase_acc[1] = (*phase) * phase_inc;
+    two_phase_acc_reg = _mm_load_ps((float*)two_phase_acc);
+
+    for (number = 0; number < sse_iters; number++)
+        {
+            a128 = _mm_loadu_si128((__m128i*)_in_common);  // load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+
+            // rotate the first two samples and convert them to 32ic
+            pa = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(a128));
+            c1 = _mm_cvtps_epi32(_mm_complexmul_ps(pa, two_phase_acc_reg));
+            two_phase_acc_reg = _mm_complexmul_ps(two_phase_inc_reg, two_phase_acc_reg);
+
+            // next two samples
+            pa = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(a128, 8)));
+            c2 = _mm_cvtps_epi32(_mm_complexmul_ps(pa, two_phase_acc_reg));
+            two_phase_acc_reg = _mm_complexmul_ps(two_phase_inc_reg, two_phase_acc_reg);
+
+            _in_common += 4;
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 8);
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    ain = _mm_loadl_epi64((__m128i*)&(in_a[n_vec][number * 4]));
+                    ain = _mm_unpacklo_epi16(ain, ain);  // a0, a0, a1, a1, a2, a2, a3, a3
+
+                    cacc[n_vec] = _mm_add_epi32(cacc[n_vec], _mm_mullo_epi32(c1, _mm_cvtepi16_epi32(ain)));
+                    cacc[n_vec] = _mm_add_epi32(cacc[n_vec], _mm_mullo_epi32(c2, _mm_cvtepi16_epi32(_mm_srli_si128(ain, 8))));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    tmp1 = _mm_mul_ps(two_phase_acc_reg, two_phase_acc_reg);
+                    tmp2 = _mm_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm_sqrt_ps(tmp1);
+                    two_phase_acc_reg = _mm_div_ps(two_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm_store_si128((__m128i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            acc[2 * n_vec] = (int64_t)dotProductVector[0] + dotProductVector[2];
+            acc[2 * n_vec + 1] = (int64_t)dotProductVector[1] + dotProductVector[3];
+        }
+    volk_gnsssdr_free(cacc);
+
+    tmp1 = _mm_mul_ps(two_phase_acc_reg, two_phase_acc_reg);
+    tmp2 = _mm_hadd_ps(tmp1, tmp1);
+    tmp1 = _mm_shuffle_ps(tmp2, tmp2, 0xD8);
+    tmp2 = _mm_sqrt_ps(tmp1);
+    two_phase_acc_reg = _mm_div_ps(two_phase_acc_reg, tmp2);
+
+    _mm_store_ps((float*)two_phase_acc, two_phase_acc_reg);
+    (*phase) = two_phase_acc[0];
+
+    for (n = sse_iters * 4; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp_r = (int32_t)rintf(lv_creal(tmp32));
+            tmp_i = (int32_t)rintf(lv_cimag(tmp32));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    acc[2 * n_vec] += tmp_r * in_a[n_vec][n];
+                    acc[2 * n_vec + 1] += tmp_i * in_a[n_vec][n];
+                }
+        }
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake((float)acc[2 * n_vec], (float)acc[2 * n_vec + 1]);
+        }
+    volk_gnsssdr_free(acc);
+}
+
+#endif /* LV_HAVE_SSE4_1 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <volk_gnsssdr/volk_gnsssdr_avx_intrinsics.h>
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_a_avx2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int avx2_iters = num_points / 8;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+    int32_t tmp_r;
+    int32_t tmp_i;
+
+    __VOLK_ATTR_ALIGNED(32)
+    int32_t dotProductVector[8];
+
+    int64_t* acc = (int64_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64_t), volk_gnsssdr_get_alignment());
+    __m256i* cacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm256_setzero_si256();
+        }
+
+    __m128i a128, ain_128;
+    __m256i c1, c2;
+    __m256 a, four_phase_acc_reg, four_phase_inc_reg;
+
+    lv_32fc_t _phase_inc = phase_inc * phase_inc * phase_inc * phase_inc;
+
+    // Normalise the 4*phase increment
+#ifdef __cplusplus
+    _phase_inc /= std::abs(_phase_inc);
+#else
+    _phase_inc /= hypotf(lv_creal(_phase_inc), lv_cimag(_phase_inc));
+#endif
+
+    __VOLK_ATTR_ALIGNED(32)
+    lv_32fc_t four_phase_inc[4];
+    __VOLK_ATTR_ALIGNED(32)
+    lv_32fc_t four_phase_acc[4];
+    for (n = 0; n < 4; ++n)
+        {
+            four_phase_inc[n] = _phase_inc;
+            four_phase_acc[n] = *phase;
+            *phase *= phase_inc;
+        }
+    four_phase_acc_reg = _mm256_load_ps((float*)four_phase_acc);
+    four_phase_inc_reg = _mm256_load_ps((float*)four_phase_inc);
+
+    for (number = 0; number < avx2_iters; number++)
+        {
+            // rotate four samples and convert them to 32ic
+            a128 = _mm_load_si128((__m128i*)_in_common);
+            a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a128));
+            c1 = _mm256_cvtps_epi32(_mm256_complexmul_ps(a, four_phase_acc_reg));
+            four_phase_acc_reg = _mm256_complexmul_ps(four_phase_inc_reg, four_phase_acc_reg);
+
+            // next four samples
+            _in_common += 4;
+            a128 = _mm_load_si128((__m128i*)_in_common);
+            a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a128));
+            c2 = _mm256_cvtps_epi32(_mm256_complexmul_ps(a, four_phase_acc_reg));
+            four_phase_acc_reg = _mm256_complexmul_ps(four_phase_inc_reg, four_phase_acc_reg);
+
+            _in_common += 4;
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 8);
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    ain_128 = _mm_load_si128((__m128i*)&(in_a[n_vec][number * 8]));
+
+                    // a0, a0, a1, a1, a2, a2, a3, a3 and a4, a4, ..., a7, a7 as 32 bits integers
+                    cacc[n_vec] = _mm256_add_epi32(cacc[n_vec], _mm256_mullo_epi32(c1, _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(ain_128, ain_128))));
+                    cacc[n_vec] = _mm256_add_epi32(cacc[n_vec], _mm256_mullo_epi32(c2, _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(ain_128, ain_128))));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    four_phase_acc_reg = _mm256_complexnormalise_ps(four_phase_acc_reg);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_si256((__m256i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            acc[2 * n_vec] = (int64_t)dotProductVector[0] + dotProductVector[2] + dotProductVector[4] + dotProductVector[6];
+            acc[2 * n_vec + 1] = (int64_t)dotProductVector[1] + dotProductVector[3] + dotProductVector[5] + dotProductVector[7];
+        }
+    volk_gnsssdr_free(cacc);
+
+    four_phase_acc_reg = _mm256_complexnormalise_ps(four_phase_acc_reg);
+    _mm256_store_ps((float*)four_phase_acc, four_phase_acc_reg);
+    _mm256_zeroupper();
+    (*phase) = four_phase_acc[0];
+
+    for (n = avx2_iters * 8; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp_r = (int32_t)rintf(lv_creal(tmp32));
+            tmp_i = (int32_t)rintf(lv_cimag(tmp32));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    acc[2 * n_vec] += tmp_r * in_a[n_vec][n];
+                    acc[2 * n_vec + 1] += tmp_i * in_a[n_vec][n];
+                }
+        }
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake((float)acc[2 * n_vec], (float)acc[2 * n_vec + 1]);
+        }
+    volk_gnsssdr_free(acc);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <volk_gnsssdr/volk_gnsssdr_avx_intrinsics.h>
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_u_avx2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const int16_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int avx2_iters = num_points / 8;
+    const lv_16sc_t* _in_common = in_common;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    lv_16sc_t tmp16;
+    lv_32fc_t tmp32;
+    int32_t tmp_r;
+    int32_t tmp_i;
+
+    __VOLK_ATTR_ALIGNED(32)
+    int32_t dotProductVector[8];
+
+    int64_t* acc = (int64_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64_t), volk_gnsssdr_get_alignment());
+    __m256i* cacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            cacc[n_vec] = _mm256_setzero_si256();
+        }
+
+    __m128i a128, ain_128;
+    __m256i c1, c2;
+    __m256 a, four_phase_acc_reg, four_phase_inc_reg;
+
+    lv_32fc_t _phase_inc = phase_inc * phase_inc * phase_inc * phase_inc;
+
+    // Normalise the 4*phase increment
+#ifdef __cplusplus
+    _phase_inc /= std::abs(_phase_inc);
+#else
+    _phase_inc /= hypotf(lv_creal(_phase_inc), lv_cimag(_phase_inc));
+#endif
+
+    __VOLK_ATTR_ALIGNED(32)
+    lv_32fc_t four_phase_inc[4];
+    __VOLK_ATTR_ALIGNED(32)
+    lv_32fc_t four_phase_acc[4];
+    for (n = 0; n < 4; ++n)
+        {
+            four_phase_inc[n] = _phase_inc;
+            four_phase_acc[n] = *phase;
+            *phase *= phase_inc;
+        }
+    four_phase_acc_reg = _mm256_load_ps((float*)four_phase_acc);
+    four_phase_inc_reg = _mm256_load_ps((float*)four_phase_inc);
+
+    for (number = 0; number < avx2_iters; number++)
+        {
+            // rotate four samples and convert them to 32ic
+            a128 = _mm_loadu_si128((__m128i*)_in_common);
+            a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a128));
+            c1 = _mm256_cvtps_epi32(_mm256_complexmul_ps(a, four_phase_acc_reg));
+            four_phase_acc_reg = _mm256_complexmul_ps(four_phase_inc_reg, four_phase_acc_reg);
+
+            // next four samples
+            _in_common += 4;
+            a128 = _mm_loadu_si128((__m128i*)_in_common);
+            a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a128));
+            c2 = _mm256_cvtps_epi32(_mm256_complexmul_ps(a, four_phase_acc_reg));
+            four_phase_acc_reg = _mm256_complexmul_ps(four_phase_inc_reg, four_phase_acc_reg);
+
+            _in_common += 4;
+            __VOLK_GNSSSDR_PREFETCH(_in_common + 8);
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    ain_128 = _mm_loadu_si128((__m128i*)&(in_a[n_vec][number * 8]));
+
+                    // a0, a0, a1, a1, a2, a2, a3, a3 and a4, a4, ..., a7, a7 as 32 bits integers
+                    cacc[n_vec] = _mm256_add_epi32(cacc[n_vec], _mm256_mullo_epi32(c1, _mm256_cvtepi16_epi32(_mm_unpacklo_epi16(ain_128, ain_128))));
+                    cacc[n_vec] = _mm256_add_epi32(cacc[n_vec], _mm256_mullo_epi32(c2, _mm256_cvtepi16_epi32(_mm_unpackhi_epi16(ain_128, ain_128))));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    four_phase_acc_reg = _mm256_complexnormalise_ps(four_phase_acc_reg);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_si256((__m256i*)dotProductVector, cacc[n_vec]);  // Store the results back into the dot product vector
+            acc[2 * n_vec] = (int64_t)dotProductVector[0] + dotProductVector[2] + dotProductVector[4] + dotProductVector[6];
+            acc[2 * n_vec + 1] = (int64_t)dotProductVector[1] + dotProductVector[3] + dotProductVector[5] + dotProductVector[7];
+        }
+    volk_gnsssdr_free(cacc);
+
+    four_phase_acc_reg = _mm256_complexnormalise_ps(four_phase_acc_reg);
+    _mm256_store_ps((float*)four_phase_acc, four_phase_acc_reg);
+    _mm256_zeroupper();
+    (*phase) = four_phase_acc[0];
+
+    for (n = avx2_iters * 8; n < num_points; n++)
+        {
+            tmp16 = in_common[n];
+            tmp32 = lv_cmake((float)lv_creal(tmp16), (float)lv_cimag(tmp16)) * (*phase);
+            tmp_r = (int32_t)rintf(lv_creal(tmp32));
+            tmp_i = (int32_t)rintf(lv_cimag(tmp32));
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    acc[2 * n_vec] += tmp_r * in_a[n_vec][n];
+                    acc[2 * n_vec + 1] += tmp_i * in_a[n_vec][n];
+                }
+        }
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake((float)acc[2 * n_vec], (float)acc[2 * n_vec + 1]);
+        }
+    volk_gnsssdr_free(acc);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+#endif /* INCLUDED_volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn_H */
@@ -143,4 +143,322 @@ static inline void volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn_g
 }
 #endif
 
+
+#ifdef LV_HAVE_AVX512F
+#include <volk_gnsssdr/volk_gnsssdr_avx512_intrinsics.h>
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn_u_avx512f(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, const lv_32fc_t phase_inc_rate, lv_32fc_t* phase, const float** in_a, int num_a_vectors, unsigned int num_points)
+{
+    unsigned int number = 0;
+    int vec_ind = 0;
+    unsigned int i = 0;
+    const unsigned int sixteenthPoints = num_points / 16;
+    const float arga = cargf(phase_inc_rate);
+    double theta;
+
+    const float* aPtr = (float*)in_common;
+    const float* bPtr[num_a_vectors];
+    for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+        {
+            bPtr[vec_ind] = in_a[vec_ind];
+            result[vec_ind] = lv_cmake(0.0f, 0.0f);
+        }
+
+    lv_32fc_t phase_doppler = (*phase);  // phase * phase_inc^n
+    phase_doppler /= hypotf(lv_creal(phase_doppler), lv_cimag(phase_doppler));
+    lv_32fc_t _phase;
+    lv_32fc_t wo;
+
+    __m512 a0Val, a1Val, xVal;
+    __m512 dotProdVal[num_a_vectors];
+
+    for (vec_ind = 0; vec_ind < num_a_vectors; vec_ind++)
+        {
+            dotProdVal[vec_ind] = _mm512_setzero_ps();
+        }
+
+    // Set up the complex rotators. The sample n > 0 is rotated by
+    // phase * phase_inc^n * phase_inc_rate^((n - 1)^2), so each lane advances by
+    // dz = phase_inc^16 * phase_inc_rate^(32 * (n - 1) + 256) per iteration,
+    // and dz advances by phase_inc_rate^512.
+    __m512 z0, z1, dz0, dz1;
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t phase_vec[16];
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t dz_vec[16];
+
+    lv_32fc_t dz = phase_inc;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;  // dz = phase_inc^16;
+    dz /= hypotf(lv_creal(dz), lv_cimag(dz));
+
+    _phase = phase_doppler;
+    for (vec_ind = 0; vec_ind < 16; ++vec_ind)
+        {
+            theta = (double)(vec_ind - 1) * (double)(vec_ind - 1) * (double)arga;
+            phase_vec[vec_ind] = _phase * lv_cmake((float)cos(theta), (float)sin(theta));
+            theta = (32.0 * (double)(vec_ind - 1) + 256.0) * (double)arga;
+            dz_vec[vec_ind] = dz * lv_cmake((float)cos(theta), (float)sin(theta));
+            _phase *= phase_inc;
+        }
+
+    z0 = _mm512_load_ps((float*)phase_vec);
+    z1 = _mm512_load_ps((float*)(phase_vec + 8));
+    dz0 = _mm512_load_ps((float*)dz_vec);
+    dz1 = _mm512_load_ps((float*)(dz_vec + 8));
+
+    theta = 512.0 * (double)arga;
+    for (vec_ind = 0; vec_ind < 8; ++vec_ind)
+        {
+            dz_vec[vec_ind] = lv_cmake((float)cos(theta), (float)sin(theta));
+        }
+    const __m512 dzz_reg = _mm512_load_ps((float*)dz_vec);
+
+    if (sixteenthPoints > 0)
+        {
+            // The first sample is rotated by phase only, but the loop below
+            // applies phase * phase_inc_rate^1 to it. Compensate the difference.
+            wo = in_common[0] * (phase_doppler - phase_vec[0]);
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    result[vec_ind] += wo * in_a[vec_ind][0];
+                }
+        }
+
+    for (; number < sixteenthPoints; number++)
+        {
+            a0Val = _mm512_loadu_ps(aPtr);
+            a1Val = _mm512_loadu_ps(aPtr + 16);
+
+            a0Val = _mm512_complexmul_ps(a0Val, z0);
+            a1Val = _mm512_complexmul_ps(a1Val, z1);
+
+            z0 = _mm512_complexmul_ps(z0, dz0);
+            z1 = _mm512_complexmul_ps(z1, dz1);
+            dz0 = _mm512_complexmul_ps(dz0, dzz_reg);
+            dz1 = _mm512_complexmul_ps(dz1, dzz_reg);
+
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    xVal = _mm512_loadu_ps(bPtr[vec_ind]);  // t0|t1| ... |t15
+                    dotProdVal[vec_ind] = _mm512_fmadd_ps(a0Val, _mm512_duplicate_lo_ps(xVal), dotProdVal[vec_ind]);
+                    dotProdVal[vec_ind] = _mm512_fmadd_ps(a1Val, _mm512_duplicate_hi_ps(xVal), dotProdVal[vec_ind]);
+                    bPtr[vec_ind] += 16;
+                }
+
+            // Force the rotators back onto the unit circle
+            if ((number % 64) == 0)
+                {
+                    z0 = _mm512_complexnormalise_ps(z0);
+                    z1 = _mm512_complexnormalise_ps(z1);
+                    dz0 = _mm512_complexnormalise_ps(dz0);
+                    dz1 = _mm512_complexnormalise_ps(dz1);
+                    phase_doppler /= hypotf(lv_creal(phase_doppler), lv_cimag(phase_doppler));
+                }
+
+            phase_doppler *= dz;
+            aPtr += 32;
+        }
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t dotProductVector[8];
+
+    for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+        {
+            _mm512_store_ps((float*)dotProductVector, dotProdVal[vec_ind]);  // Store the results back into the dot product vector
+
+            for (i = 0; i < 8; ++i)
+                {
+                    result[vec_ind] += dotProductVector[i];
+                }
+        }
+    _mm256_zeroupper();
+
+    number = sixteenthPoints * 16;
+    for (; number < num_points; number++)
+        {
+            _phase = phase_doppler;
+            if (number > 0)
+                {
+                    theta = (double)(number - 1) * (double)(number - 1) * (double)arga;
+                    _phase *= lv_cmake((float)cos(theta), (float)sin(theta));
+                }
+            wo = in_common[number] * _phase;
+            phase_doppler *= phase_inc;
+
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    result[vec_ind] += wo * in_a[vec_ind][number];
+                }
+        }
+
+    if (num_points > 0)
+        {
+            theta = (double)(num_points - 1) * (double)(num_points - 1) * (double)arga;
+            *phase = phase_doppler * lv_cmake((float)cos(theta), (float)sin(theta));
+        }
+}
+
+#endif /* LV_HAVE_AVX512F */
+
+
+#ifdef LV_HAVE_AVX512F
+#include <volk_gnsssdr/volk_gnsssdr_avx512_intrinsics.h>
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn_a_avx512f(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, const lv_32fc_t phase_inc_rate, lv_32fc_t* phase, const float** in_a, int num_a_vectors, unsigned int num_points)
+{
+    unsigned int number = 0;
+    int vec_ind = 0;
+    unsigned int i = 0;
+    const unsigned int sixteenthPoints = num_points / 16;
+    const float arga = cargf(phase_inc_rate);
+    double theta;
+
+    const float* aPtr = (float*)in_common;
+    const float* bPtr[num_a_vectors];
+    for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+        {
+            bPtr[vec_ind] = in_a[vec_ind];
+            result[vec_ind] = lv_cmake(0.0f, 0.0f);
+        }
+
+    lv_32fc_t phase_doppler = (*phase);  // phase * phase_inc^n
+    phase_doppler /= hypotf(lv_creal(phase_doppler), lv_cimag(phase_doppler));
+    lv_32fc_t _phase;
+    lv_32fc_t wo;
+
+    __m512 a0Val, a1Val, xVal;
+    __m512 dotProdVal[num_a_vectors];
+
+    for (vec_ind = 0; vec_ind < num_a_vectors; vec_ind++)
+        {
+            dotProdVal[vec_ind] = _mm512_setzero_ps();
+        }
+
+    // Set up the complex rotators. The sample n > 0 is rotated by
+    // phase * phase_inc^n * phase_inc_rate^((n - 1)^2), so each lane advances by
+    // dz = phase_inc^16 * phase_inc_rate^(32 * (n - 1) + 256) per iteration,
+    // and dz advances by phase_inc_rate^512.
+    __m512 z0, z1, dz0, dz1;
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t phase_vec[16];
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t dz_vec[16];
+
+    lv_32fc_t dz = phase_inc;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;
+    dz *= dz;  // dz = phase_inc^16;
+    dz /= hypotf(lv_creal(dz), lv_cimag(dz));
+
+    _phase = phase_doppler;
+    for (vec_ind = 0; vec_ind < 16; ++vec_ind)
+        {
+            theta = (double)(vec_ind - 1) * (double)(vec_ind - 1) * (double)arga;
+            phase_vec[vec_ind] = _phase * lv_cmake((float)cos(theta), (float)sin(theta));
+            theta = (32.0 * (double)(vec_ind - 1) + 256.0) * (double)arga;
+            dz_vec[vec_ind] = dz * lv_cmake((float)cos(theta), (float)sin(theta));
+            _phase *= phase_inc;
+        }
+
+    z0 = _mm512_load_ps((float*)phase_vec);
+    z1 = _mm512_load_ps((float*)(phase_vec + 8));
+    dz0 = _mm512_load_ps((float*)dz_vec);
+    dz1 = _mm512_load_ps((float*)(dz_vec + 8));
+
+    theta = 512.0 * (double)arga;
+    for (vec_ind = 0; vec_ind < 8; ++vec_ind)
+        {
+            dz_vec[vec_ind] = lv_cmake((float)cos(theta), (float)sin(theta));
+        }
+    const __m512 dzz_reg = _mm512_load_ps((float*)dz_vec);
+
+    if (sixteenthPoints > 0)
+        {
+            // The first sample is rotated by phase only, but the loop below
+            // applies phase * phase_inc_rate^1 to it. Compensate the difference.
+            wo = in_common[0] * (phase_doppler - phase_vec[0]);
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    result[vec_ind] += wo * in_a[vec_ind][0];
+                }
+        }
+
+    for (; number < sixteenthPoints; number++)
+        {
+            a0Val = _mm512_load_ps(aPtr);
+            a1Val = _mm512_load_ps(aPtr + 16);
+
+            a0Val = _mm512_complexmul_ps(a0Val, z0);
+            a1Val = _mm512_complexmul_ps(a1Val, z1);
+
+            z0 = _mm512_complexmul_ps(z0, dz0);
+            z1 = _mm512_complexmul_ps(z1, dz1);
+            dz0 = _mm512_complexmul_ps(dz0, dzz_reg);
+            dz1 = _mm512_complexmul_ps(dz1, dzz_reg);
+
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    xVal = _mm512_loadu_ps(bPtr[vec_ind]);  // t0|t1| ... |t15
+                    dotProdVal[vec_ind] = _mm512_fmadd_ps(a0Val, _mm512_duplicate_lo_ps(xVal), dotProdVal[vec_ind]);
+                    dotProdVal[vec_ind] = _mm512_fmadd_ps(a1Val, _mm512_duplicate_hi_ps(xVal), dotProdVal[vec_ind]);
+                    bPtr[vec_ind] += 16;
+                }
+
+            // Force the rotators back onto the unit circle
+            if ((number % 64) == 0)
+                {
+                    z0 = _mm512_complexnormalise_ps(z0);
+                    z1 = _mm512_complexnormalise_ps(z1);
+                    dz0 = _mm512_complexnormalise_ps(dz0);
+                    dz1 = _mm512_complexnormalise_ps(dz1);
+                    phase_doppler /= hypotf(lv_creal(phase_doppler), lv_cimag(phase_doppler));
+                }
+
+            phase_doppler *= dz;
+            aPtr += 32;
+        }
+    __VOLK_ATTR_ALIGNED(64)
+    lv_32fc_t dotProductVector[8];
+
+    for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+        {
+            _mm512_store_ps((float*)dotProductVector, dotProdVal[vec_ind]);  // Store the results back into the dot product vector
+
+            for (i = 0; i < 8; ++i)
+                {
+                    result[vec_ind] += dotProductVector[i];
+                }
+        }
+    _mm256_zeroupper();
+
+    number = sixteenthPoints * 16;
+    for (; number < num_points; number++)
+        {
+            _phase = phase_doppler;
+            if (number > 0)
+                {
+                    theta = (double)(number - 1) * (double)(number - 1) * (double)arga;
+                    _phase *= lv_cmake((float)cos(theta), (float)sin(theta));
+                }
+            wo = in_common[number] * _phase;
+            phase_doppler *= phase_inc;
+
+            for (vec_ind = 0; vec_ind < num_a_vectors; ++vec_ind)
+                {
+                    result[vec_ind] += wo * in_a[vec_ind][number];
+                }
+        }
+
+    if (num_points > 0)
+        {
+            theta = (double)(num_points - 1) * (double)(num_points - 1) * (double)arga;
+            *phase = phase_doppler * lv_cmake((float)cos(theta), (float)sin(theta));
+        }
+}
+
+#endif /* LV_HAVE_AVX512F */
+
 #endif /* INCLUDED_volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn_H */
@@ -405,6 +405,160 @@ static inline void volk_gnsssdr_8ic_x2_dot_prod_8ic_a_sse4_1(lv_8sc_t* result, c
 #endif /*LV_HAVE_SSE4_1*/
 
 
+#ifdef LV_HAVE_AVX512BW
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_x2_dot_prod_8ic_u_avx512bw(lv_8sc_t* result, const lv_8sc_t* in_a, const lv_8sc_t* in_b, unsigned int num_points)
+{
+    lv_8sc_t dotProduct;
+    memset(&dotProduct, 0x0, 2 * sizeof(char));
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* a = in_a;
+    const lv_8sc_t* b = in_b;
+
+    const unsigned int avx512_iters = num_points / 32;
+
+    if (avx512_iters > 0)
+        {
+            __m512i x, y, mult1, realx, imagx, realy, imagy, realx_mult_realy, imagx_mult_imagy, realx_mult_imagy, imagx_mult_realy, realc, imagc, totalc, realcacc, imagcacc;
+
+            mult1 = _mm512_set1_epi16(0x00FF);
+            realcacc = _mm512_setzero_si512();
+            imagcacc = _mm512_setzero_si512();
+
+            for (number = 0; number < avx512_iters; number++)
+                {
+                    x = _mm512_loadu_si512((const __m512i*)a);
+                    y = _mm512_loadu_si512((const __m512i*)b);
+
+                    imagx = _mm512_bsrli_epi128(x, 1);
+                    imagx = _mm512_and_si512(imagx, mult1);
+                    realx = _mm512_and_si512(x, mult1);
+
+                    imagy = _mm512_bsrli_epi128(y, 1);
+                    imagy = _mm512_and_si512(imagy, mult1);
+                    realy = _mm512_and_si512(y, mult1);
+
+                    realx_mult_realy = _mm512_mullo_epi16(realx, realy);
+                    imagx_mult_imagy = _mm512_mullo_epi16(imagx, imagy);
+                    realx_mult_imagy = _mm512_mullo_epi16(realx, imagy);
+                    imagx_mult_realy = _mm512_mullo_epi16(imagx, realy);
+
+                    realc = _mm512_sub_epi16(realx_mult_realy, imagx_mult_imagy);
+                    imagc = _mm512_add_epi16(realx_mult_imagy, imagx_mult_realy);
+
+                    realcacc = _mm512_add_epi16(realcacc, realc);
+                    imagcacc = _mm512_add_epi16(imagcacc, imagc);
+
+                    a += 32;
+                    b += 32;
+                }
+
+            imagcacc = _mm512_bslli_epi128(imagcacc, 1);
+
+            // Real parts in the even bytes, imaginary parts in the odd ones
+            totalc = _mm512_mask_blend_epi8(0x5555555555555555ULL, imagcacc, realcacc);
+
+            __VOLK_ATTR_ALIGNED(64)
+            lv_8sc_t dotProductVector[32];
+
+            _mm512_store_si512((__m512i*)dotProductVector, totalc);  // Store the results back into the dot product vector
+
+            for (i = 0; i < 32; ++i)
+                {
+                    dotProduct += dotProductVector[i];
+                }
+        }
+
+    for (i = avx512_iters * 32; i < num_points; ++i)
+        {
+            dotProduct += (*a++) * (*b++);
+        }
+
+    *result = dotProduct;
+}
+
+#endif /*LV_HAVE_AVX512BW*/
+
+
+#ifdef LV_HAVE_AVX512BW
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_x2_dot_prod_8ic_a_avx512bw(lv_8sc_t* result, const lv_8sc_t* in_a, const lv_8sc_t* in_b, unsigned int num_points)
+{
+    lv_8sc_t dotProduct;
+    memset(&dotProduct, 0x0, 2 * sizeof(char));
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* a = in_a;
+    const lv_8sc_t* b = in_b;
+
+    const unsigned int avx512_iters = num_points / 32;
+
+    if (avx512_iters > 0)
+        {
+            __m512i x, y, mult1, realx, imagx, realy, imagy, realx_mult_realy, imagx_mult_imagy, realx_mult_imagy, imagx_mult_realy, realc, imagc, totalc, realcacc, imagcacc;
+
+            mult1 = _mm512_set1_epi16(0x00FF);
+            realcacc = _mm512_setzero_si512();
+            imagcacc = _mm512_setzero_si512();
+
+            for (number = 0; number < avx512_iters; number++)
+                {
+                    x = _mm512_load_si512((const __m512i*)a);
+                    y = _mm512_load_si512((const __m512i*)b);
+
+                    imagx = _mm512_bsrli_epi128(x, 1);
+                    imagx = _mm512_and_si512(imagx, mult1);
+                    realx = _mm512_and_si512(x, mult1);
+
+                    imagy = _mm512_bsrli_epi128(y, 1);
+                    imagy = _mm512_and_si512(imagy, mult1);
+                    realy = _mm512_and_si512(y, mult1);
+
+                    realx_mult_realy = _mm512_mullo_epi16(realx, realy);
+                    imagx_mult_imagy = _mm512_mullo_epi16(imagx, imagy);
+                    realx_mult_imagy = _mm512_mullo_epi16(realx, imagy);
+                    imagx_mult_realy = _mm512_mullo_epi16(imagx, realy);
+
+                    realc = _mm512_sub_epi16(realx_mult_realy, imagx_mult_imagy);
+                    imagc = _mm512_add_epi16(realx_mult_imagy, imagx_mult_realy);
+
+                    realcacc = _mm512_add_epi16(realcacc, realc);
+                    imagcacc = _mm512_add_epi16(imagcacc, imagc);
+
+                    a += 32;
+                    b += 32;
+                }
+
+            imagcacc = _mm512_bslli_epi128(imagcacc, 1);
+
+            // Real parts in the even bytes, imaginary parts in the odd ones
+            totalc = _mm512_mask_blend_epi8(0x5555555555555555ULL, imagcacc, realcacc);
+
+            __VOLK_ATTR_ALIGNED(64)
+            lv_8sc_t dotProductVector[32];
+
+            _mm512_store_si512((__m512i*)dotProductVector, totalc);  // Store the results back into the dot product vector
+
+            for (i = 0; i < 32; ++i)
+                {
+                    dotProduct += dotProductVector[i];
+                }
+        }
+
+    for (i = avx512_iters * 32; i < num_points; ++i)
+        {
+            dotProduct += (*a++) * (*b++);
+        }
+
+    *result = dotProduct;
+}
+
+#endif /*LV_HAVE_AVX512BW*/
+
+
 #ifdef LV_HAVE_ORC
 
 extern void volk_gnsssdr_8ic_x2_dot_prod_8ic_a_orc_impl(short* resRealShort, short* resImagShort, const lv_8sc_t* in_a, const lv_8sc_t* in_b, unsigned int num_points);
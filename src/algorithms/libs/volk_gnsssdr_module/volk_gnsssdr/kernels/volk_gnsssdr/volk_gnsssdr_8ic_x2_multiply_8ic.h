@@ -290,6 +290,118 @@ static inline void volk_gnsssdr_8ic_x2_multiply_8ic_a_sse4_1(lv_8sc_t* cVector,
 #endif /* LV_HAVE_SSE4_1 */
 
 
+#ifdef LV_HAVE_AVX512BW
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_x2_multiply_8ic_u_avx512bw(lv_8sc_t* cVector, const lv_8sc_t* aVector, const lv_8sc_t* bVector, unsigned int num_points)
+{
+    const unsigned int avx512_iters = num_points / 32;
+    unsigned int number;
+    unsigned int i;
+    __m512i x, y, mult1, realx, imagx, realy, imagy, realx_mult_realy, imagx_mult_imagy, realx_mult_imagy, imagx_mult_realy, realc, imagc, totalc;
+    lv_8sc_t* c = cVector;
+    const lv_8sc_t* a = aVector;
+    const lv_8sc_t* b = bVector;
+
+    mult1 = _mm512_set1_epi16(0x00FF);
+
+    for (number = 0; number < avx512_iters; number++)
+        {
+            x = _mm512_loadu_si512((const __m512i*)a);
+            y = _mm512_loadu_si512((const __m512i*)b);
+
+            imagx = _mm512_bsrli_epi128(x, 1);
+            imagx = _mm512_and_si512(imagx, mult1);
+            realx = _mm512_and_si512(x, mult1);
+
+            imagy = _mm512_bsrli_epi128(y, 1);
+            imagy = _mm512_and_si512(imagy, mult1);
+            realy = _mm512_and_si512(y, mult1);
+
+            realx_mult_realy = _mm512_mullo_epi16(realx, realy);
+            imagx_mult_imagy = _mm512_mullo_epi16(imagx, imagy);
+            realx_mult_imagy = _mm512_mullo_epi16(realx, imagy);
+            imagx_mult_realy = _mm512_mullo_epi16(imagx, realy);
+
+            realc = _mm512_sub_epi16(realx_mult_realy, imagx_mult_imagy);
+            realc = _mm512_and_si512(realc, mult1);
+            imagc = _mm512_add_epi16(realx_mult_imagy, imagx_mult_realy);
+            imagc = _mm512_and_si512(imagc, mult1);
+            imagc = _mm512_bslli_epi128(imagc, 1);
+
+            totalc = _mm512_or_si512(realc, imagc);
+
+            _mm512_storeu_si512((__m512i*)c, totalc);
+
+            a += 32;
+            b += 32;
+            c += 32;
+        }
+
+    for (i = avx512_iters * 32; i < num_points; ++i)
+        {
+            *c++ = (*a++) * (*b++);
+        }
+}
+#endif /* LV_HAVE_AVX512BW */
+
+
+#ifdef LV_HAVE_AVX512BW
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_x2_multiply_8ic_a_avx512bw(lv_8sc_t* cVector, const lv_8sc_t* aVector, const lv_8sc_t* bVector, unsigned int num_points)
+{
+    const unsigned int avx512_iters = num_points / 32;
+    unsigned int number;
+    unsigned int i;
+    __m512i x, y, mult1, realx, imagx, realy, imagy, realx_mult_realy, imagx_mult_imagy, realx_mult_imagy, imagx_mult_realy, realc, imagc, totalc;
+    lv_8sc_t* c = cVector;
+    const lv_8sc_t* a = aVector;
+    const lv_8sc_t* b = bVector;
+
+    mult1 = _mm512_set1_epi16(0x00FF);
+
+    for (number = 0; number < avx512_iters; number++)
+        {
+            x = _mm512_load_si512((const __m512i*)a);
+            y = _mm512_load_si512((const __m512i*)b);
+
+            imagx = _mm512_bsrli_epi128(x, 1);
+            imagx = _mm512_and_si512(imagx, mult1);
+            realx = _mm512_and_si512(x, mult1);
+
+            imagy = _mm512_bsrli_epi128(y, 1);
+            imagy = _mm512_and_si512(imagy, mult1);
+            realy = _mm512_and_si512(y, mult1);
+
+            realx_mult_realy = _mm512_mullo_epi16(realx, realy);
+            imagx_mult_imagy = _mm512_mullo_epi16(imagx, imagy);
+            realx_mult_imagy = _mm512_mullo_epi16(realx, imagy);
+            imagx_mult_realy = _mm512_mullo_epi16(imagx, realy);
+
+            realc = _mm512_sub_epi16(realx_mult_realy, imagx_mult_imagy);
+            realc = _mm512_and_si512(realc, mult1);
+            imagc = _mm512_add_epi16(realx_mult_imagy, imagx_mult_realy);
+            imagc = _mm512_and_si512(imagc, mult1);
+            imagc = _mm512_bslli_epi128(imagc, 1);
+
+            totalc = _mm512_or_si512(realc, imagc);
+
+            _mm512_store_si512((__m512i*)c, totalc);
+
+            a += 32;
+            b += 32;
+            c += 32;
+        }
+
+    for (i = avx512_iters * 32; i < num_points; ++i)
+        {
+            *c++ = (*a++) * (*b++);
+        }
+}
+#endif /* LV_HAVE_AVX512BW */
+
+
 #ifdef LV_HAVE_ORC
 
 extern void volk_gnsssdr_8ic_x2_multiply_8ic_a_orc_impl(lv_8sc_t* cVector, const lv_8sc_t* aVector, const lv_8sc_t* bVector, unsigned int num_points);
@@ -38,6 +38,7 @@ HybridObservables::HybridObservables(ConfigurationInterface* configuration,
 
     conf.dump = dump_;
     conf.dump_mat = dump_mat_;
+    conf.dump_mat_compression = configuration->property(role + ".dump_mat_compression", conf.dump_mat_compression);
     conf.dump_filename = dump_filename_;
     conf.nchannels_in = in_streams_;
     conf.nchannels_out = out_streams_;
@@ -26,11 +26,10 @@
 #include "gnss_synchro.h"
 #include <glog/logging.h>
 #include <gnuradio/io_signature.h>
-#include <matio.h>
-#include <array>
 #include <cmath>      // for round
 #include <cstdlib>    // for size_t, llabs
 #include <exception>  // for exception
+#include <fstream>    // for ifstream
 #include <iostream>   // for cerr, cout
 #include <limits>     // for numeric_limits
 #include <utility>    // for move
@@ -63,7 +62,8 @@ hybrid_observables_gs_sptr hybrid_observables_gs_make(const Obs_Conf &conf_)
 
 hybrid_observables_gs::hybrid_observables_gs(const Obs_Conf &conf_) : gr::block("hybrid_observables_gs",
                                                                           gr::io_signature::make(conf_.nchannels_in, conf_.nchannels_in, sizeof(Gnss_Synchro)),
-                                                                          gr::io_signature::make(conf_.nchannels_out, conf_.nchannels_out, sizeof(Gnss_Synchro)))
+                                                                          gr::io_signature::make(conf_.nchannels_out, conf_.nchannels_out, sizeof(Gnss_Synchro))),
+                                                                      d_dump_file(Dump_File::Backpressure::Block, Dump_File::RECEIVER_BLOCK_SIZE, Dump_File::RECEIVER_NUM_BLOCKS)
 {
     // PVT input message port
     this->message_port_register_in(pmt::mp("pvt_to_observables"));
@@ -123,6 +123,19 @@ hybrid_observables_gs::hybrid_observables_gs(const Obs_Conf &conf_) : gr::block(
                     d_dump = false;
                 }
         }
+    if (d_dump and d_dump_mat)
+        {
+            d_mat_writer.add_variable<double>("RX_time", d_nchannels_out);
+            d_mat_writer.add_variable<double>("TOW_at_current_symbol_s", d_nchannels_out);
+            d_mat_writer.add_variable<double>("Carrier_Doppler_hz", d_nchannels_out);
+            d_mat_writer.add_variable<double>("Carrier_phase_cycles", d_nchannels_out);
+            d_mat_writer.add_variable<double>("Pseudorange_m", d_nchannels_out);
+            d_mat_writer.add_variable<double>("PRN", d_nchannels_out);
+            d_mat_writer.add_variable<double>("Flag_valid_pseudorange", d_nchannels_out);
+            std::string mat_filename = d_dump_filename;
+            mat_filename.replace(mat_filename.length() - 4, 4, ".mat");
+            d_mat_writer.open(mat_filename, conf_.dump_mat_compression);
+        }
     T_rx_TOW_ms = 0U;
     T_rx_step_ms = 20;  // read from config at the adapter GNSS-SDR.observable_interval_ms!!
     T_rx_TOW_set = false;
@@ -159,20 +172,10 @@ hybrid_observables_gs::~hybrid_observables_gs()
                         {
                             std::cerr << "Problem removing temporary file " << d_dump_filename << '\n';
                         }
-                    d_dump_mat = false;
-                }
-        }
-    if (d_dump_mat)
-        {
-            try
-                {
-                    save_matfile();
-                }
-            catch (const std::exception &ex)
-                {
-                    LOG(WARNING) << "Error saving the .mat file: " << ex.what();
                 }
         }
+    // Only the last chunk of epochs is left to be written
+    d_mat_writer.close();
 }
 
 
@@ -207,143 +210,6 @@ void hybrid_observables_gs::msg_handler_pvt_to_observables(const pmt::pmt_t &msg
 }
 
 
-int32_t hybrid_observables_gs::save_matfile()
-{
-    // READ DUMP FILE
-    std::string dump_filename = d_dump_filename;
-    std::ifstream::pos_type size;
-    int32_t number_of_double_vars = 7;
-    int32_t epoch_size_bytes = sizeof(double) * number_of_double_vars * d_nchannels_out;
-    std::ifstream dump_file;
-    std::cout << "Generating .mat file for " << dump_filename << std::endl;
-    dump_file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-        {
-            dump_file.open(dump_filename.c_str(), std::ios::binary | std::ios::ate);
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem opening dump file:" << e.what() << std::endl;
-            return 1;
-        }
-    // count number of epochs and rewind
-    int64_t num_epoch = 0LL;
-    if (dump_file.is_open())
-        {
-            size = dump_file.tellg();
-            num_epoch = static_cast<int64_t>(size) / static_cast<int64_t>(epoch_size_bytes);
-            dump_file.seekg(0, std::ios::beg);
-        }
-    else
-        {
-            return 1;
-        }
-
-    auto RX_time = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto TOW_at_current_symbol_s = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto Carrier_Doppler_hz = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto Carrier_phase_cycles = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto Pseudorange_m = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto PRN = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-    auto Flag_valid_pseudorange = std::vector<std::vector<double>>(d_nchannels_out, std::vector<double>(num_epoch));
-
-    try
-        {
-            if (dump_file.is_open())
-                {
-                    for (int64_t i = 0; i < num_epoch; i++)
-                        {
-                            for (uint32_t chan = 0; chan < d_nchannels_out; chan++)
-                                {
-                                    dump_file.read(reinterpret_cast<char *>(&RX_time[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&TOW_at_current_symbol_s[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&Carrier_Doppler_hz[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&Carrier_phase_cycles[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&Pseudorange_m[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&PRN[chan][i]), sizeof(double));
-                                    dump_file.read(reinterpret_cast<char *>(&Flag_valid_pseudorange[chan][i]), sizeof(double));
-                                }
-                        }
-                }
-            dump_file.close();
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem reading dump file:" << e.what() << std::endl;
-            return 1;
-        }
-
-    auto RX_time_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto TOW_at_current_symbol_s_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto Carrier_Doppler_hz_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto Carrier_phase_cycles_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto Pseudorange_m_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto PRN_aux = std::vector<double>(d_nchannels_out * num_epoch);
-    auto Flag_valid_pseudorange_aux = std::vector<double>(d_nchannels_out * num_epoch);
-
-    uint32_t k = 0U;
-    for (int64_t j = 0; j < num_epoch; j++)
-        {
-            for (uint32_t i = 0; i < d_nchannels_out; i++)
-                {
-                    RX_time_aux[k] = RX_time[i][j];
-                    TOW_at_current_symbol_s_aux[k] = TOW_at_current_symbol_s[i][j];
-                    Carrier_Doppler_hz_aux[k] = Carrier_Doppler_hz[i][j];
-                    Carrier_phase_cycles_aux[k] = Carrier_phase_cycles[i][j];
-                    Pseudorange_m_aux[k] = Pseudorange_m[i][j];
-                    PRN_aux[k] = PRN[i][j];
-                    Flag_valid_pseudorange_aux[k] = Flag_valid_pseudorange[i][j];
-                    k++;
-                }
-        }
-
-    // WRITE MAT FILE
-    mat_t *matfp;
-    matvar_t *matvar;
-    std::string filename = d_dump_filename;
-    if (filename.size() > 4)
-        {
-            filename.erase(filename.end() - 4, filename.end());
-        }
-    filename.append(".mat");
-    matfp = Mat_CreateVer(filename.c_str(), nullptr, MAT_FT_MAT73);
-    if (reinterpret_cast<int64_t *>(matfp) != nullptr)
-        {
-            std::array<size_t, 2> dims{static_cast<size_t>(d_nchannels_out), static_cast<size_t>(num_epoch)};
-            matvar = Mat_VarCreate("RX_time", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), RX_time_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("TOW_at_current_symbol_s", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), TOW_at_current_symbol_s_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Carrier_Doppler_hz", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), Carrier_Doppler_hz_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Carrier_phase_cycles", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), Carrier_phase_cycles_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Pseudorange_m", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), Pseudorange_m_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("PRN", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), PRN_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Flag_valid_pseudorange", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), Flag_valid_pseudorange_aux.data(), MAT_F_DONT_COPY_DATA);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-        }
-    Mat_Close(matfp);
-
-    return 0;
-}
-
-
 double hybrid_observables_gs::compute_T_rx_s(const Gnss_Synchro &a)
 {
     return ((static_cast<double>(a.Tracking_sample_counter) + a.Code_phase_samples) / static_cast<double>(a.fs));
@@ -725,6 +591,21 @@ int hybrid_observables_gs::general_work(int noutput_items __attribute__((unused)
                                     tmp_double = static_cast<double>(out[i][0].Flag_valid_pseudorange);
                                     d_dump_file.write(reinterpret_cast<char *>(&tmp_double), sizeof(double));
                                 }
+                            if (d_mat_writer.is_open())
+                                {
+                                    // One row per channel
+                                    for (uint32_t i = 0; i < d_nchannels_out; i++)
+                                        {
+                                            d_mat_writer.append(0, out[i][0].RX_time);
+                                            d_mat_writer.append(1, out[i][0].interp_TOW_ms / 1000.0);
+                                            d_mat_writer.append(2, out[i][0].Carrier_Doppler_hz);
+                                            d_mat_writer.append(3, out[i][0].Carrier_phase_rads / GPS_TWO_PI);
+                                            d_mat_writer.append(4, out[i][0].Pseudorange_m);
+                                            d_mat_writer.append(5, static_cast<double>(out[i][0].PRN));
+                                            d_mat_writer.append(6, static_cast<double>(out[i][0].Flag_valid_pseudorange));
+                                        }
+                                    d_mat_writer.end_epoch();
+                                }
                         }
                     catch (const std::ifstream::failure &e)
                         {
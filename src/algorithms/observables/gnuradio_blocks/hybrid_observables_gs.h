@@ -23,12 +23,13 @@
 #ifndef GNSS_SDR_HYBRID_OBSERVABLES_GS_H
 #define GNSS_SDR_HYBRID_OBSERVABLES_GS_H
 
+#include "dump_writer.h"
+#include "mat_stream_writer.h"
 #include "obs_conf.h"
 #include <boost/circular_buffer.hpp>  // for boost::circular_buffer
 #include <gnuradio/block.h>           // for block
 #include <gnuradio/types.h>           // for gr_vector_int
 #include <cstdint>                    // for int32_t
-#include <fstream>                    // for std::ofstream
 #include <map>                        // for std::map
 #include <memory>                     // for std:shared_ptr
 #include <string>                     // for std::string
@@ -102,7 +103,8 @@ private:
     uint32_t d_nchannels_in;
     uint32_t d_nchannels_out;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
+    Mat_Stream_Writer d_mat_writer;
     boost::circular_buffer<uint64_t> d_Rx_clock_buffer;                         // time history
     std::shared_ptr<Gnss_circular_deque<Gnss_Synchro>> d_gnss_synchro_history;  // Tracking observable history
     void msg_handler_pvt_to_observables(const pmt::pmt_t& msg);
@@ -110,7 +112,6 @@ private:
     bool interp_trk_obs(Gnss_Synchro& interpolated_obs, const uint32_t& ch, const uint64_t& rx_clock);
     void update_TOW(const std::vector<Gnss_Synchro>& data);
     void compute_pranges(std::vector<Gnss_Synchro>& data);
-    int32_t save_matfile();
 };
 
 #endif  // GNSS_SDR_HYBRID_OBSERVABLES_GS_H
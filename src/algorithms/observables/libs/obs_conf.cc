@@ -29,5 +29,6 @@ Obs_Conf::Obs_Conf()
     nchannels_out = 0;
     dump = false;
     dump_mat = false;
+    dump_mat_compression = false;
     dump_filename = "obs_dump.dat";
 }
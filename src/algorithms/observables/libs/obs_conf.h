@@ -33,6 +33,7 @@ public:
     uint32_t nchannels_out;
     bool dump;
     bool dump_mat;
+    bool dump_mat_compression;
     std::string dump_filename;
 
     Obs_Conf();
@@ -33,6 +33,7 @@
 #include <pmt/pmt_sugar.h>  // for mp
 #include <cstdlib>          // for abs
 #include <exception>        // for exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for cout
 #include <memory>           // for shared_ptr, make_shared
 
@@ -21,13 +21,13 @@
 #define GNSS_SDR_BEIDOU_B3I_TELEMETRY_DECODER_GS_H
 
 #include "beidou_dnav_navigation_message.h"
+#include "dump_writer.h"
 #include "gnss_satellite.h"
 #include <boost/circular_buffer.hpp>
 #include <gnuradio/block.h>  // for block
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <array>
 #include <cstdint>
-#include <fstream>
 #include <string>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>
@@ -116,7 +116,7 @@ private:
     int32_t d_channel;
     bool d_dump;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 };
 
 #endif  // GNSS_SDR_BEIDOU_B3I_TELEMETRY_DECODER_GS_H
@@ -35,6 +35,7 @@
 #include <cmath>            // for fmod
 #include <cstdlib>          // for abs
 #include <exception>        // for exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for cout
 #include <memory>           // for make_shared
 
@@ -22,6 +22,7 @@
 #define GNSS_SDR_GALILEO_TELEMETRY_DECODER_GS_H
 
 
+#include "dump_writer.h"
 #include "galileo_fnav_message.h"
 #include "galileo_navigation_message.h"
 #include "gnss_satellite.h"
@@ -30,7 +31,6 @@
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <array>
 #include <cstdint>
-#include <fstream>
 #include <string>
 #include <vector>
 #if GNURADIO_USES_STD_POINTERS
@@ -126,7 +126,7 @@ private:
     double delta_t;  // GPS-GALILEO time offset
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 
     // vars for Viterbi decoder
     std::vector<int32_t> out0;
@@ -30,6 +30,7 @@
 #include <cmath>            // for floor, round
 #include <cstdlib>          // for abs
 #include <exception>        // for exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for cout
 #include <memory>           // for shared_ptr, make_shared
 
@@ -22,6 +22,7 @@
 
 
 #include "GLONASS_L1_L2_CA.h"
+#include "dump_writer.h"
 #include "glonass_gnav_navigation_message.h"
 #include "gnss_satellite.h"
 #include "gnss_synchro.h"
@@ -30,7 +31,6 @@
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <array>
 #include <cstdint>
-#include <fstream>
 #include <string>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>  // for std::shared_ptr
@@ -114,7 +114,7 @@ private:
     int32_t d_channel;
     bool d_dump;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 };
 
 #endif  // GNSS_SDR_GLONASS_L2_CA_TELEMETRY_DECODER_GS_H
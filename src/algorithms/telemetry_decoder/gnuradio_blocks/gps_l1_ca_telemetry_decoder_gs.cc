@@ -29,6 +29,7 @@
 #include <cmath>            // for round
 #include <cstring>          // for memcpy
 #include <exception>        // for exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for cout
 #include <memory>           // for shared_ptr
 
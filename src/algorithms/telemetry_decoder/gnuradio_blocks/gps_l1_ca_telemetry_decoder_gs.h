@@ -21,6 +21,7 @@
 #define GNSS_SDR_GPS_L1_CA_TELEMETRY_DECODER_GS_H
 
 #include "GPS_L1_CA.h"
+#include "dump_writer.h"
 #include "gnss_satellite.h"
 #include "gnss_synchro.h"
 #include "gps_navigation_message.h"
@@ -29,7 +30,6 @@
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <array>             // for array
 #include <cstdint>           // for int32_t
-#include <fstream>           // for ofstream
 #include <string>            // for string
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>  // for std::shared_ptr
@@ -110,7 +110,7 @@ private:
     bool flag_TOW_set;
     bool d_dump;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 };
 
 #endif  // GNSS_SDR_GPS_L1_CA_TELEMETRY_DECODER_GS_H
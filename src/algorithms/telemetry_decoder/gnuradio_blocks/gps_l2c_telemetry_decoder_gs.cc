@@ -32,6 +32,7 @@
 #include <bitset>           // for bitset
 #include <cmath>            // for round
 #include <exception>        // for exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for cout
 #include <memory>           // for shared_ptr, make_shared
 
@@ -20,12 +20,12 @@
 #define GNSS_SDR_GPS_L2C_TELEMETRY_DECODER_GS_H
 
 
+#include "dump_writer.h"
 #include "gnss_satellite.h"
 #include "gps_cnav_navigation_message.h"
 #include <gnuradio/block.h>
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <cstdint>
-#include <fstream>
 #include <string>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>  // for std::shared_ptr
@@ -80,7 +80,7 @@ private:
     int32_t d_channel;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 
     cnav_msg_decoder_t d_cnav_decoder{};
 
@@ -31,6 +31,7 @@
 #include <bitset>           // for std::bitset
 #include <cstdlib>          // for std::llabs
 #include <exception>        // for std::exception
+#include <fstream>          // for ifstream
 #include <iostream>         // for std::cout
 #include <memory>           // for shared_ptr, make_shared
 
@@ -21,13 +21,13 @@
 
 
 #include "GPS_L5.h"                       // for GPS_L5I_NH_CODE_LENGTH
+#include "dump_writer.h"
 #include "gnss_satellite.h"               // for Gnss_Satellite
 #include "gps_cnav_navigation_message.h"  // for Gps_CNAV_Navigation_Message
 #include <boost/circular_buffer.hpp>
 #include <gnuradio/block.h>
 #include <gnuradio/types.h>  // for gr_vector_const_void_star
 #include <cstdint>
-#include <fstream>
 #include <string>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>  // for std::shared_ptr
@@ -79,7 +79,7 @@ private:
     int32_t d_channel;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 
     cnav_msg_decoder_t d_cnav_decoder{};
 
@@ -20,6 +20,7 @@
 #ifndef GNSS_SDR_SBAS_L1_TELEMETRY_DECODER_GS_H
 #define GNSS_SDR_SBAS_L1_TELEMETRY_DECODER_GS_H
 
+#include "dump_writer.h"
 #include "gnss_satellite.h"
 #include <boost/crc.hpp>  // for crc_optimal
 #include <gnuradio/block.h>
@@ -27,7 +28,6 @@
 #include <cstddef>           // for size_t
 #include <cstdint>
 #include <deque>
-#include <fstream>
 #include <memory>  // for std::shared_ptr
 #include <string>
 #include <utility>  // for pair
@@ -92,7 +92,7 @@ private:
     int32_t d_channel;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
 
     size_t d_block_size;               //!< number of samples which are processed during one invocation of the algorithms
     std::vector<double> d_sample_buf;  //!< input buffer holding the samples to be processed in one block
@@ -44,14 +44,16 @@
 #include "lock_detectors.h"
 #include "tracking_discriminators.h"
 #include <glog/logging.h>
+#include <gnuradio/block_detail.h>   // for block_detail
+#include <gnuradio/buffer.h>         // for buffer_reader
 #include <gnuradio/io_signature.h>   // for io_signature
 #include <gnuradio/thread/thread.h>  // for scoped_lock
 #include <gsl/gsl>
-#include <matio.h>          // for Mat_VarCreate
 #include <pmt/pmt_sugar.h>  // for mp
 #include <volk_gnsssdr/volk_gnsssdr.h>
-#include <algorithm>  // for fill_n
+#include <algorithm>  // for fill_n, min
 #include <array>
+#include <chrono>
 #include <cmath>      // for fmod, round, floor
 #include <exception>  // for exception
 #include <iostream>   // for cout, cerr
@@ -79,8 +81,9 @@ dll_pll_veml_tracking_sptr dll_pll_veml_make_tracking(const Dll_Pll_Conf &conf_)
 }
 
 
-dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::block("dll_pll_veml_tracking", gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                                                                              gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::block("dll_pll_veml_tracking", gr::io_signature::make(1, 1, conf_.item_type == "cshort" ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+                                                                              gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+                                                                          d_dump_file(conf_.dump_drop_records ? Dump_File::Backpressure::Drop : Dump_File::Backpressure::Block)
 {
     // prevent telemetry symbols accumulation in output buffers
     this->set_max_noutput_items(1);
@@ -97,6 +100,7 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
     d_dll_filt_history.set_capacity(1000);
     d_veml = false;
     d_cloop = true;
+    d_cshort = trk_parameters.item_type == "cshort";
     d_pull_in_transitory = true;
     d_code_chip_rate = 0.0;
     d_secondary_code_length = 0U;
@@ -360,10 +364,15 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
     // Initialize tracking  ==========================================
     d_code_loop_filter = Tracking_loop_filter(d_code_period, trk_parameters.dll_bw_hz, trk_parameters.dll_filter_order, false);
     d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_hz, trk_parameters.pll_filter_order);
+    d_kf_filter.set_params(trk_parameters.kf_dynamics_psd, trk_parameters.kf_code_psd);
 
     // Initialization of local code replica
     // Get space for a vector with the sinboc(1,1) replica sampled 2x/chip
     d_tracking_code.resize(2 * d_code_length_chips, 0.0);
+    if (d_cshort)
+        {
+            d_tracking_code_16i.resize(2 * d_code_length_chips, 0);
+        }
     // correlator outputs (scalar)
     if (d_veml)
         {
@@ -406,7 +415,25 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
             d_prompt_data_shift = &d_local_code_shift_chips[1];
         }
 
-    multicorrelator_cpu.init(2 * trk_parameters.vector_length, d_n_correlator_taps);
+    // 16-bit samples are correlated with 16-bit local code replicas
+    if (d_cshort)
+        {
+            multicorrelator_cpu_16sc.init(2 * trk_parameters.vector_length, d_n_correlator_taps, trk_parameters.accumulator_bits);
+        }
+    else
+        {
+            multicorrelator_cpu.init(2 * trk_parameters.vector_length, d_n_correlator_taps);
+        }
+    d_correlator_batch_active = false;
+    if (trk_parameters.batch_correlation and d_cshort)
+        {
+            LOG(WARNING) << "batch_correlation is not available for cshort samples. Disabled";
+            trk_parameters.batch_correlation = false;
+        }
+    if (trk_parameters.batch_correlation)
+        {
+            d_correlator_batch = Cpu_Multicorrelator_Batch::get_instance(trk_parameters.batch_tile_samples, trk_parameters.batch_max_wait_us);
+        }
 
     if (trk_parameters.extend_correlation_symbols > 1)
         {
@@ -417,19 +444,34 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
             d_enable_extended_integration = false;
             trk_parameters.extend_correlation_symbols = 1;
         }
+    if (trk_parameters.adaptive_integration and !d_enable_extended_integration)
+        {
+            LOG(WARNING) << "adaptive_integration requires extend_correlation_symbols bigger than 1. It has been disabled";
+            trk_parameters.adaptive_integration = false;
+        }
+    d_extend_correlation_symbols = trk_parameters.extend_correlation_symbols;
+    d_integration_scheduler.set_params(trk_parameters.adaptive_long_lock_th, trk_parameters.adaptive_short_lock_th, trk_parameters.adaptive_weak_cn0_db_hz, trk_parameters.adaptive_dwell_ms);
 
     // Enable Data component prompt correlator (slave to Pilot prompt) if tracking uses Pilot signal
     if (trk_parameters.track_pilot)
         {
             // Extra correlator for the data component
-            correlator_data_cpu.init(2 * trk_parameters.vector_length, 1);
-            correlator_data_cpu.set_high_dynamics_resampler(trk_parameters.high_dyn);
+            if (d_cshort)
+                {
+                    correlator_data_cpu_16sc.init(2 * trk_parameters.vector_length, 1, trk_parameters.accumulator_bits);
+                    d_data_code_16i.resize(2 * d_code_length_chips, 0);
+                }
+            else
+                {
+                    correlator_data_cpu.init(2 * trk_parameters.vector_length, 1);
+                    correlator_data_cpu.set_high_dynamics_resampler(trk_parameters.high_dyn);
+                }
             d_data_code.resize(2 * d_code_length_chips, 0.0);
         }
 
     // --- Initializations ---
-    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
     multicorrelator_cpu.set_high_dynamics_resampler(trk_parameters.high_dyn);
+    multicorrelator_cpu.set_integer_shift(trk_parameters.integer_shift_correlator, trk_parameters.integer_shift_max_error_samples);
     // Initial code frequency basis of NCO
     d_code_freq_chips = d_code_chip_rate;
     // Residual code phase (in chips)
@@ -466,6 +508,11 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
     d_carrier_lock_test_smoother.set_min_value(-1.0);
     d_carrier_lock_test_smoother.set_offset(0.0);
     d_carrier_lock_test_smoother.set_samples_for_initialization(trk_parameters.carrier_lock_test_smoother_samples);
+    d_lock_fault_forced = false;
+
+    // reacquisition
+    d_reacquisition.set_params(trk_parameters.fs_in, trk_parameters.reacquisition_time_ms, trk_parameters.reacquisition_doppler_bins, trk_parameters.reacquisition_doppler_step_hz,
+        trk_parameters.cn0_samples, static_cast<float>(trk_parameters.cn0_min), d_code_period);
 
     d_acquisition_gnss_synchro = nullptr;
     d_channel = 0;
@@ -475,12 +522,24 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
     d_acc_carrier_phase_rad = 0.0;
 
     d_extend_correlation_symbols_count = 0;
+    d_stats_loop_updates = 0ULL;
+    d_stats_loop_time_ns = 0.0;
+    d_stats_correlation_time_ns = 0.0;
+    d_integration_correlation_time_ns = 0.0;
+    d_last_correlation_time_ns = 0.0;
+    d_last_loop_time_ns = 0.0;
+    d_stats_long_integration_s = 0.0;
+    d_stats_short_integration_s = 0.0;
+    d_stats_carr_phase_error_sq = 0.0;
+    d_stats_code_error_sq = 0.0;
+    d_stats_integration_switches = 0ULL;
     d_code_phase_step_chips = 0.0;
     d_code_phase_rate_step_chips = 0.0;
     d_carrier_phase_step_rad = 0.0;
     d_carrier_phase_rate_step_rad = 0.0;
     d_rem_code_phase_chips = 0.0;
     d_state = 0;  // initial state: standby
+    d_dormant = true;
     clear_tracking_vars();
     if (trk_parameters.smoother_length > 0)
         {
@@ -528,6 +587,36 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
                     d_dump = false;
                 }
         }
+    if (d_dump_mat)
+        {
+            // Same names and types as the variables of the former end-of-run conversion
+            d_mat_writer.add_variable<float>("abs_VE");
+            d_mat_writer.add_variable<float>("abs_E");
+            d_mat_writer.add_variable<float>("abs_P");
+            d_mat_writer.add_variable<float>("abs_L");
+            d_mat_writer.add_variable<float>("abs_VL");
+            d_mat_writer.add_variable<float>("Prompt_I");
+            d_mat_writer.add_variable<float>("Prompt_Q");
+            d_mat_writer.add_variable<uint64_t>("PRN_start_sample_count");
+            d_mat_writer.add_variable<float>("acc_carrier_phase_rad");
+            d_mat_writer.add_variable<float>("carrier_doppler_hz");
+            d_mat_writer.add_variable<float>("carrier_doppler_rate_hz");
+            d_mat_writer.add_variable<float>("code_freq_chips");
+            d_mat_writer.add_variable<float>("code_freq_rate_chips");
+            d_mat_writer.add_variable<float>("carr_error_hz");
+            d_mat_writer.add_variable<float>("carr_error_filt_hz");
+            d_mat_writer.add_variable<float>("code_error_chips");
+            d_mat_writer.add_variable<float>("code_error_filt_chips");
+            d_mat_writer.add_variable<float>("CN0_SNV_dB_Hz");
+            d_mat_writer.add_variable<float>("carrier_lock_test");
+            d_mat_writer.add_variable<float>("aux1");
+            d_mat_writer.add_variable<double>("aux2");
+            d_mat_writer.add_variable<uint32_t>("PRN");
+            // Not in the binary record, whose layout is shared with the other tracking blocks
+            d_mat_writer.add_variable<float>("integration_time_s");
+            d_mat_writer.add_variable<float>("correlation_time_ns");
+            d_mat_writer.add_variable<float>("loop_time_ns");
+        }
     d_corrected_doppler = false;
     d_acc_carrier_phase_initialized = false;
 }
@@ -538,11 +627,27 @@ void dll_pll_veml_tracking::forecast(int noutput_items,
 {
     if (noutput_items != 0)
         {
-            ninput_items_required[0] = static_cast<int32_t>(trk_parameters.vector_length) * 2;
+            const bool standby = d_dormant;
+            const int32_t buffer_items = standby ? detail()->input(0)->max_possible_items_available() : 0;
+            ninput_items_required[0] = items_required(static_cast<int32_t>(trk_parameters.vector_length), standby, buffer_items);
         }
 }
 
 
+int32_t dll_pll_veml_tracking::items_required(int32_t vector_length, bool standby, int32_t buffer_items)
+{
+    const int32_t tracking_items = vector_length * 2;
+    if (!standby)
+        {
+            return tracking_items;
+        }
+    // A channel in standby only needs to keep up with the sample count, so it is
+    // not woken up for every block of samples. Its lag is bounded, because the
+    // buffer is shared with the other channels and the upstream writer.
+    return std::max(tracking_items, std::min(TRK_STANDBY_LAG_SAMPLES, buffer_items / 8));
+}
+
+
 void dll_pll_veml_tracking::msg_handler_telemetry_to_trk(const pmt::pmt_t &msg)
 {
     try
@@ -557,6 +662,7 @@ void dll_pll_veml_tracking::msg_handler_telemetry_to_trk(const pmt::pmt_t &msg)
                             DLOG(INFO) << "Telemetry fault received in ch " << this->d_channel;
                             gr::thread::scoped_lock lock(d_setlock);
                             d_carrier_lock_fail_counter = 200000;  // force loss-of-lock condition
+                            d_lock_fault_forced = true;
                         }
                 }
         }
@@ -661,7 +767,6 @@ void dll_pll_veml_tracking::start_tracking()
                     d_secondary_code_length = static_cast<uint32_t>(BEIDOU_B1I_GEO_PREAMBLE_LENGTH_SYMBOLS);
                     d_secondary_code_string = const_cast<std::string *>(&BEIDOU_B1I_GEO_PREAMBLE_SYMBOLS_STR);
                     d_data_secondary_code_length = 0;
-                    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
                 }
             else
                 {
@@ -675,7 +780,6 @@ void dll_pll_veml_tracking::start_tracking()
                     d_secondary_code_string = const_cast<std::string *>(&BEIDOU_B1I_SECONDARY_CODE_STR);
                     d_data_secondary_code_length = static_cast<uint32_t>(BEIDOU_B1I_SECONDARY_CODE_LENGTH);
                     d_data_secondary_code_string = const_cast<std::string *>(&BEIDOU_B1I_SECONDARY_CODE_STR);
-                    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
                 }
         }
 
@@ -694,7 +798,6 @@ void dll_pll_veml_tracking::start_tracking()
                     d_secondary_code_length = static_cast<uint32_t>(BEIDOU_B3I_GEO_PREAMBLE_LENGTH_SYMBOLS);
                     d_secondary_code_string = const_cast<std::string *>(&BEIDOU_B3I_GEO_PREAMBLE_SYMBOLS_STR);
                     d_data_secondary_code_length = 0;
-                    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
                 }
             else
                 {
@@ -708,11 +811,22 @@ void dll_pll_veml_tracking::start_tracking()
                     d_secondary_code_string = const_cast<std::string *>(&BEIDOU_B3I_SECONDARY_CODE_STR);
                     d_data_secondary_code_length = static_cast<uint32_t>(BEIDOU_B3I_SECONDARY_CODE_LENGTH);
                     d_data_secondary_code_string = const_cast<std::string *>(&BEIDOU_B3I_SECONDARY_CODE_STR);
-                    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
                 }
         }
 
     multicorrelator_cpu.set_local_code_and_taps(d_code_samples_per_chip * d_code_length_chips, d_tracking_code.data(), d_local_code_shift_chips.data());
+    if (d_cshort)
+        {
+            // The local codes take values +1 and -1
+            const uint32_t code_samples = d_code_samples_per_chip * d_code_length_chips;
+            std::transform(d_tracking_code.cbegin(), d_tracking_code.cbegin() + code_samples, d_tracking_code_16i.begin(), [](float chip) { return static_cast<int16_t>(std::lround(chip)); });
+            multicorrelator_cpu_16sc.set_local_code_and_taps(code_samples, d_tracking_code_16i.data(), d_local_code_shift_chips.data());
+            if (trk_parameters.track_pilot)
+                {
+                    std::transform(d_data_code.cbegin(), d_data_code.cbegin() + code_samples, d_data_code_16i.begin(), [](float chip) { return static_cast<int16_t>(std::lround(chip)); });
+                    correlator_data_cpu_16sc.set_local_code_and_taps(code_samples, d_data_code_16i.data(), d_prompt_data_shift);
+                }
+        }
     std::fill_n(d_correlator_outs.begin(), d_n_correlator_taps, gr_complex(0.0, 0.0));
 
     d_carrier_lock_fail_counter = 0;
@@ -725,28 +839,11 @@ void dll_pll_veml_tracking::start_tracking()
     d_carrier_lock_test = 1.0;
     d_CN0_SNV_dB_Hz = 0.0;
 
-    if (d_veml)
-        {
-            d_local_code_shift_chips[0] = -trk_parameters.very_early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-            d_local_code_shift_chips[1] = -trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-            d_local_code_shift_chips[3] = trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-            d_local_code_shift_chips[4] = trk_parameters.very_early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-        }
-    else
-        {
-            d_local_code_shift_chips[0] = -trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-            d_local_code_shift_chips[2] = trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
-        }
-
-    d_current_correlation_time_s = d_code_period;
+    d_lock_fault_forced = false;
+    d_reacquisition.reset(d_acq_carrier_doppler_hz, d_acq_sample_stamp);
 
     // Initialize tracking  ==========================================
-    d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_hz, trk_parameters.pll_filter_order);
-    d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_hz);
-    d_code_loop_filter.set_update_interval(d_code_period);
-    // DLL/PLL filter initialization
-    d_carrier_loop_filter.initialize(static_cast<float>(d_acq_carrier_doppler_hz));  // initialize the carrier filter
-    d_code_loop_filter.initialize();                                                 // initialize the code filter
+    set_wide_tracking(d_acq_carrier_doppler_hz, static_cast<double>(d_acquisition_gnss_synchro->Acq_doppler_step));
 
     // DEBUG OUTPUT
     std::cout << "Tracking of " << systemName << " " << signal_pretty_name << " signal started on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << std::endl;
@@ -754,9 +851,13 @@ void dll_pll_veml_tracking::start_tracking()
 
     // enable tracking pull-in
     d_state = 1;
+    d_dormant = false;
     d_cloop = true;
     d_pull_in_transitory = true;
-    d_Prompt_circular_buffer.clear();
+    if (d_secondary_code_string != nullptr)
+        {
+            d_secondary_code_correlator.set_code(d_secondary_code_string->substr(0, d_secondary_code_length));
+        }
     d_corrected_doppler = false;
     d_acc_carrier_phase_initialized = false;
 }
@@ -764,6 +865,20 @@ void dll_pll_veml_tracking::start_tracking()
 
 dll_pll_veml_tracking::~dll_pll_veml_tracking()
 {
+    if (trk_parameters.loop_statistics and d_stats_loop_updates > 0)
+        {
+            const double signal_s = d_stats_long_integration_s + d_stats_short_integration_s;
+            const double updates = static_cast<double>(d_stats_loop_updates);
+            LOG(INFO) << "Tracking loop statistics of channel " << d_channel << ": "
+                      << d_stats_loop_updates << " loop updates in " << signal_s << " s of narrow tracking ("
+                      << d_stats_long_integration_s << " s with long integration, "
+                      << d_stats_integration_switches << " integration changes), "
+                      << d_stats_correlation_time_ns / updates << " ns of correlation and "
+                      << d_stats_loop_time_ns / updates << " ns of loop update per integration, "
+                      << (d_stats_correlation_time_ns + d_stats_loop_time_ns) / signal_s << " ns per second of signal, "
+                      << "PLL discriminator RMS " << std::sqrt(d_stats_carr_phase_error_sq / updates) << " [cycles], "
+                      << "DLL discriminator RMS " << std::sqrt(d_stats_code_error_sq / updates) << " [chips]";
+        }
     if (d_dump_file.is_open())
         {
             try
@@ -775,24 +890,18 @@ dll_pll_veml_tracking::~dll_pll_veml_tracking()
                     LOG(WARNING) << "Exception in Tracking block destructor: " << ex.what();
                 }
         }
-    if (d_dump_mat)
-        {
-            try
-                {
-                    save_matfile();
-                }
-            catch (const std::exception &ex)
-                {
-                    LOG(WARNING) << "Error saving the .mat file: " << ex.what();
-                }
-        }
+    // Only the last chunk of epochs is left to be written
+    d_mat_writer.close();
     try
         {
+            leave_correlation_batch();
             if (trk_parameters.track_pilot)
                 {
                     correlator_data_cpu.free();
+                    correlator_data_cpu_16sc.free();
                 }
             multicorrelator_cpu.free();
+            multicorrelator_cpu_16sc.free();
         }
     catch (const std::exception &ex)
         {
@@ -804,39 +913,7 @@ dll_pll_veml_tracking::~dll_pll_veml_tracking()
 bool dll_pll_veml_tracking::acquire_secondary()
 {
     // ******* preamble correlation ********
-    int32_t corr_value = 0;
-    for (uint32_t i = 0; i < d_secondary_code_length; i++)
-        {
-            if (d_Prompt_circular_buffer[i].real() < 0.0)  // symbols clipping
-                {
-                    if (d_secondary_code_string->at(i) == '0')
-                        {
-                            corr_value++;
-                        }
-                    else
-                        {
-                            corr_value--;
-                        }
-                }
-            else
-                {
-                    if (d_secondary_code_string->at(i) == '0')
-                        {
-                            corr_value--;
-                        }
-                    else
-                        {
-                            corr_value++;
-                        }
-                }
-        }
-
-    if (abs(corr_value) == static_cast<int32_t>(d_secondary_code_length))
-        {
-            return true;
-        }
-
-    return false;
+    return d_secondary_code_correlator.locked();
 }
 
 
@@ -891,7 +968,6 @@ bool dll_pll_veml_tracking::cn0_and_tracking_lock_status(double coh_integration_
             LOG(INFO) << "Loss of lock in channel " << d_channel
                       << " (carrier_lock_fail_counter:" << d_carrier_lock_fail_counter
                       << " code_lock_fail_counter : " << d_code_lock_fail_counter << ")";
-            this->message_port_pub(pmt::mp("events"), pmt::from_long(3));  // 3 -> loss of lock
             d_carrier_lock_fail_counter = 0;
             d_code_lock_fail_counter = 0;
             return false;
@@ -910,6 +986,33 @@ void dll_pll_veml_tracking::do_correlation_step(const gr_complex *input_samples)
     // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
     // perform carrier wipe-off and compute Early, Prompt and Late correlation
     multicorrelator_cpu.set_input_output_vectors(d_correlator_outs.data(), input_samples);
+    if (trk_parameters.track_pilot)
+        {
+            correlator_data_cpu.set_input_output_vectors(d_Prompt_Data.data(), input_samples);
+        }
+    if (d_correlator_batch)
+        {
+            // Evaluate the correlators together with those of the other channels
+            if (!d_correlator_batch_active)
+                {
+                    d_correlator_batch->set_active(d_channel, true);
+                    d_correlator_batch_active = true;
+                }
+            const auto rem_code_phase_samples = static_cast<float>(d_rem_code_phase_chips) * static_cast<float>(d_code_samples_per_chip);
+            const auto code_phase_step_samples = static_cast<float>(d_code_phase_step_chips) * static_cast<float>(d_code_samples_per_chip);
+            const auto code_phase_rate_step_samples = static_cast<float>(d_code_phase_rate_step_chips) * static_cast<float>(d_code_samples_per_chip);
+            std::array<Cpu_Multicorrelator_Batch::Request, 2> requests{};
+            requests[0] = multicorrelator_cpu.batch_request(d_rem_carr_phase_rad, d_carrier_phase_step_rad, d_carrier_phase_rate_step_rad,
+                rem_code_phase_samples, code_phase_step_samples, code_phase_rate_step_samples, trk_parameters.vector_length);
+            if (trk_parameters.track_pilot)
+                {
+                    requests[1] = correlator_data_cpu.batch_request(d_rem_carr_phase_rad, d_carrier_phase_step_rad, d_carrier_phase_rate_step_rad,
+                        rem_code_phase_samples, code_phase_step_samples, code_phase_rate_step_samples, trk_parameters.vector_length);
+                }
+            d_correlator_batch->correlate(requests.data(), trk_parameters.track_pilot ? 2 : 1);
+            return;
+        }
+
     multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(
         d_rem_carr_phase_rad,
         d_carrier_phase_step_rad, d_carrier_phase_rate_step_rad,
@@ -921,7 +1024,6 @@ void dll_pll_veml_tracking::do_correlation_step(const gr_complex *input_samples)
     // DATA CORRELATOR (if tracking tracks the pilot signal)
     if (trk_parameters.track_pilot)
         {
-            correlator_data_cpu.set_input_output_vectors(d_Prompt_Data.data(), input_samples);
             correlator_data_cpu.Carrier_wipeoff_multicorrelator_resampler(
                 d_rem_carr_phase_rad,
                 d_carrier_phase_step_rad, d_carrier_phase_rate_step_rad,
@@ -933,6 +1035,59 @@ void dll_pll_veml_tracking::do_correlation_step(const gr_complex *input_samples)
 }
 
 
+void dll_pll_veml_tracking::do_correlation_step(const void *input_items)
+{
+    if (d_cshort)
+        {
+            do_correlation_step(static_cast<const lv_16sc_t *>(input_items));
+        }
+    else
+        {
+            do_correlation_step(static_cast<const gr_complex *>(input_items));
+        }
+}
+
+
+// 16-bit version of the correlation step. The step grows by the rate at every
+// sample, so the rates are applied as the mean steps over the integration window
+void dll_pll_veml_tracking::do_correlation_step(const lv_16sc_t *input_samples)
+{
+    const auto window_samples = static_cast<double>(trk_parameters.vector_length);
+    const auto carrier_phase_step_rad = static_cast<float>(d_carrier_phase_step_rad + 0.5 * d_carrier_phase_rate_step_rad * window_samples);
+    const auto code_phase_step_chips = static_cast<float>(d_code_phase_step_chips + 0.5 * d_code_phase_rate_step_chips * window_samples);
+    multicorrelator_cpu_16sc.set_input_output_vectors(d_correlator_outs.data(), input_samples);
+    multicorrelator_cpu_16sc.Carrier_wipeoff_multicorrelator_resampler(
+        d_rem_carr_phase_rad,
+        carrier_phase_step_rad,
+        static_cast<float>(d_rem_code_phase_chips) * static_cast<float>(d_code_samples_per_chip),
+        code_phase_step_chips * static_cast<float>(d_code_samples_per_chip),
+        trk_parameters.vector_length);
+
+    // DATA CORRELATOR (if tracking tracks the pilot signal)
+    if (trk_parameters.track_pilot)
+        {
+            correlator_data_cpu_16sc.set_input_output_vectors(d_Prompt_Data.data(), input_samples);
+            correlator_data_cpu_16sc.Carrier_wipeoff_multicorrelator_resampler(
+                d_rem_carr_phase_rad,
+                carrier_phase_step_rad,
+                static_cast<float>(d_rem_code_phase_chips) * static_cast<float>(d_code_samples_per_chip),
+                code_phase_step_chips * static_cast<float>(d_code_samples_per_chip),
+                trk_parameters.vector_length);
+        }
+}
+
+
+void dll_pll_veml_tracking::leave_correlation_batch()
+{
+    // Do not make the other channels wait for this one
+    if (d_correlator_batch_active)
+        {
+            d_correlator_batch->set_active(d_channel, false);
+            d_correlator_batch_active = false;
+        }
+}
+
+
 void dll_pll_veml_tracking::run_dll_pll()
 {
     // ################## PLL ##########################################################
@@ -948,6 +1103,22 @@ void dll_pll_veml_tracking::run_dll_pll()
             d_carr_phase_error_hz = pll_four_quadrant_atan(d_P_accu) / PI_2;
         }
 
+    // DLL discriminator
+    if (d_veml)
+        {
+            d_code_error_chips = dll_nc_vemlp_normalized(d_VE_accu, d_E_accu, d_L_accu, d_VL_accu);  // [chips/Ti]
+        }
+    else
+        {
+            d_code_error_chips = dll_nc_e_minus_l_normalized(d_E_accu, d_L_accu, trk_parameters.spc, trk_parameters.slope, trk_parameters.y_intercept);  // [chips/Ti]
+        }
+
+    if (trk_parameters.enable_kf_tracking)
+        {
+            run_kf();
+            return;
+        }
+
     if ((d_pull_in_transitory == true and trk_parameters.enable_fll_pull_in == true) or trk_parameters.enable_fll_steady_state)
         {
             // FLL discriminator
@@ -981,15 +1152,6 @@ void dll_pll_veml_tracking::run_dll_pll()
     //    std::cout << "d_CN0_SNV_dB_Hz: " << this->d_CN0_SNV_dB_Hz << std::endl;
 
     // ################## DLL ##########################################################
-    // DLL discriminator
-    if (d_veml)
-        {
-            d_code_error_chips = dll_nc_vemlp_normalized(d_VE_accu, d_E_accu, d_L_accu, d_VL_accu);  // [chips/Ti]
-        }
-    else
-        {
-            d_code_error_chips = dll_nc_e_minus_l_normalized(d_E_accu, d_L_accu, trk_parameters.spc, trk_parameters.slope, trk_parameters.y_intercept);  // [chips/Ti]
-        }
     // Code discriminator filter
     d_code_error_filt_chips = d_code_loop_filter.apply(d_code_error_chips);  // [chips/second]
     // New code Doppler frequency estimation
@@ -1023,6 +1185,34 @@ void dll_pll_veml_tracking::run_dll_pll()
 }
 
 
+// Both discriminators feed the Kalman filter, with variances derived from the
+// CN0 estimation, and the estimated phase errors are removed from the NCOs
+void dll_pll_veml_tracking::run_kf()
+{
+    const double cn0_db_hz = std::max(d_CN0_SNV_dB_Hz, static_cast<double>(trk_parameters.cn0_min));
+    const double cn0_T = std::pow(10.0, cn0_db_hz / 10.0) * d_current_correlation_time_s;
+    const double phase_sigma2 = 1.0 / (2.0 * cn0_T) * (1.0 + 1.0 / (2.0 * cn0_T)) / (PI_2 * PI_2);  // [cycles^2]
+    // Early-Late spacing [chips]
+    const int32_t early_index = d_veml ? 1 : 0;
+    const double el_spacing_chips = std::min(2.0 * std::fabs(static_cast<double>(d_local_code_shift_chips[early_index])) / static_cast<double>(d_code_samples_per_chip), 1.0);
+    const double code_sigma2 = el_spacing_chips / (4.0 * cn0_T) * (1.0 + 2.0 / ((2.0 - el_spacing_chips) * cn0_T));  // [chips^2]
+
+    d_kf_filter.update(d_carr_phase_error_hz, d_code_error_chips, phase_sigma2, code_sigma2, d_current_correlation_time_s, d_code_chip_rate / d_signal_carrier_freq);
+
+    const double phase_correction_rad = PI_2 * d_kf_filter.get_phase_correction_cycles();
+    d_rem_carr_phase_rad = static_cast<float>(fmod(static_cast<double>(d_rem_carr_phase_rad) + phase_correction_rad, PI_2));
+    d_acc_carrier_phase_rad -= phase_correction_rad;
+
+    // New carrier Doppler frequency estimation
+    d_carr_error_filt_hz = d_kf_filter.get_doppler_hz();
+    d_carrier_doppler_hz = d_carr_error_filt_hz;
+
+    // The code phase error is removed during the next integration, on top of the carrier aiding
+    d_code_error_filt_chips = d_kf_filter.get_code_correction_chips() / d_current_correlation_time_s;  // [chips/second]
+    d_code_freq_chips = d_code_chip_rate - d_code_error_filt_chips + d_carrier_doppler_hz * d_code_chip_rate / d_signal_carrier_freq;
+}
+
+
 void dll_pll_veml_tracking::check_carrier_phase_coherent_initialization()
 {
     if (d_acc_carrier_phase_initialized == false)
@@ -1049,7 +1239,7 @@ void dll_pll_veml_tracking::clear_tracking_vars()
     d_code_error_filt_chips = 0.0;
     d_current_symbol = 0;
     d_current_data_symbol = 0;
-    d_Prompt_circular_buffer.clear();
+    d_secondary_code_correlator.clear();
     d_carrier_phase_rate_step_rad = 0.0;
     d_code_phase_rate_step_chips = 0.0;
     d_carr_ph_history.clear();
@@ -1057,6 +1247,232 @@ void dll_pll_veml_tracking::clear_tracking_vars()
 }
 
 
+// Early-late spacing of the pull-in, also used by the reacquisition search
+void dll_pll_veml_tracking::set_wide_spacing()
+{
+    if (d_veml)
+        {
+            d_local_code_shift_chips[0] = -trk_parameters.very_early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+            d_local_code_shift_chips[1] = -trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+            d_local_code_shift_chips[3] = trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+            d_local_code_shift_chips[4] = trk_parameters.very_early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+        }
+    else
+        {
+            d_local_code_shift_chips[0] = -trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+            d_local_code_shift_chips[2] = trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
+        }
+    trk_parameters.spc = trk_parameters.early_late_space_chips;
+}
+
+
+// Wide correlator spacing and loop bandwidths of the pull-in, with the carrier filter
+// initialized at the given Doppler. The Doppler step of the search that found it
+// sets the initial uncertainty of the Kalman filter.
+void dll_pll_veml_tracking::set_wide_tracking(double carrier_doppler_hz, double doppler_step_hz)
+{
+    set_wide_spacing();
+    d_current_correlation_time_s = d_code_period;
+
+    d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_hz, trk_parameters.pll_filter_order);
+    d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_hz);
+    d_code_loop_filter.set_update_interval(d_code_period);
+    // DLL/PLL filter initialization
+    d_carrier_loop_filter.initialize(static_cast<float>(carrier_doppler_hz));  // initialize the carrier filter
+    d_code_loop_filter.initialize();                                           // initialize the code filter
+
+    if (trk_parameters.enable_kf_tracking)
+        {
+            if (doppler_step_hz <= 0.0)
+                {
+                    doppler_step_hz = 250.0;
+                }
+            const double code_step_chips = d_code_chip_rate / trk_parameters.fs_in;
+            d_kf_filter.initialize(carrier_doppler_hz,
+                1.0 / 12.0,
+                doppler_step_hz * doppler_step_hz / 12.0,
+                trk_parameters.kf_doppler_rate_sigma_hz_s * trk_parameters.kf_doppler_rate_sigma_hz_s,
+                code_step_chips * code_step_chips / 12.0);
+        }
+}
+
+
+// Integration of extend_correlation_symbols code periods, with the narrow loop bandwidths
+void dll_pll_veml_tracking::set_long_integration()
+{
+    d_extend_correlation_symbols = trk_parameters.extend_correlation_symbols;
+    d_extend_correlation_symbols_count = 0;
+    d_current_correlation_time_s = static_cast<float>(d_extend_correlation_symbols) * static_cast<float>(d_code_period);
+    d_code_loop_filter.set_update_interval(d_current_correlation_time_s);
+    d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_narrow_hz);
+    d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_narrow_hz, trk_parameters.pll_filter_order);
+}
+
+
+// Integration of a single code period, with the loop bandwidths of the wide tracking
+void dll_pll_veml_tracking::set_short_integration()
+{
+    d_extend_correlation_symbols = 1;
+    d_extend_correlation_symbols_count = 0;
+    d_current_correlation_time_s = d_code_period;
+    d_code_loop_filter.set_update_interval(d_current_correlation_time_s);
+    d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_hz);
+    d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_hz, trk_parameters.pll_filter_order);
+}
+
+
+// Adaptive integration, evaluated after each loop update of the narrow tracking
+void dll_pll_veml_tracking::schedule_integration()
+{
+    if (d_cn0_estimation_counter < trk_parameters.cn0_samples)
+        {
+            // the lock detectors are not updated yet
+            d_integration_scheduler.reset();
+            return;
+        }
+    const bool long_integration = d_extend_correlation_symbols > 1;
+    const bool bit_aligned = d_symbols_per_bit <= 1 or d_current_data_symbol % trk_parameters.extend_correlation_symbols == 0;
+    if (!d_integration_scheduler.update(long_integration, d_carrier_lock_test, d_CN0_SNV_dB_Hz, d_current_correlation_time_s, bit_aligned))
+        {
+            return;
+        }
+    if (long_integration)
+        {
+            set_short_integration();
+        }
+    else
+        {
+            set_long_integration();
+        }
+    DLOG(INFO) << "Channel " << d_channel << " switched to " << d_extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0)
+               << " ms integration (CN0 " << d_CN0_SNV_dB_Hz << " [dB-Hz], carrier lock test " << d_carrier_lock_test << ")";
+    // the CN0 estimation restarts, without prompts of the other integration time
+    d_cn0_estimation_counter = 0;
+    d_stats_integration_switches++;
+}
+
+
+// Cost of the correlation steps of the current integration
+void dll_pll_veml_tracking::measure_correlation_time(const std::chrono::steady_clock::time_point &correlation_start)
+{
+    d_integration_correlation_time_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - correlation_start).count();
+}
+
+
+// Cost of the correlations of the integration and of the lock detectors, loop
+// filters and NCO updates, and discriminator noise
+void dll_pll_veml_tracking::update_loop_statistics(const std::chrono::steady_clock::time_point &loop_start)
+{
+    d_last_loop_time_ns = static_cast<float>(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - loop_start).count());
+    d_last_correlation_time_ns = static_cast<float>(d_integration_correlation_time_ns);
+    d_integration_correlation_time_ns = 0.0;
+    d_stats_loop_time_ns += d_last_loop_time_ns;
+    d_stats_correlation_time_ns += d_last_correlation_time_ns;
+    d_stats_loop_updates++;
+    if (d_extend_correlation_symbols > 1)
+        {
+            d_stats_long_integration_s += d_current_correlation_time_s;
+        }
+    else
+        {
+            d_stats_short_integration_s += d_current_correlation_time_s;
+        }
+    d_stats_carr_phase_error_sq += d_carr_phase_error_hz * d_carr_phase_error_hz;
+    d_stats_code_error_sq += d_code_error_chips * d_code_error_chips;
+}
+
+
+// Keeps the Doppler and the noise power of the last epoch with both lock
+// detectors clear, to search the satellite if the lock is lost
+void dll_pll_veml_tracking::retain_tracking_state()
+{
+    if (d_carrier_lock_fail_counter != 0 or d_code_lock_fail_counter != 0)
+        {
+            return;
+        }
+    d_reacquisition.retain(d_carrier_doppler_hz, d_sample_counter, d_Prompt_buffer.data(), std::min(d_cn0_estimation_counter, trk_parameters.cn0_samples),
+        d_code_period * static_cast<double>(d_extend_correlation_symbols));
+}
+
+
+void dll_pll_veml_tracking::loss_of_lock()
+{
+    clear_tracking_vars();
+    // A satellite that was being tracked is searched again around the retained
+    // Doppler, instead of releasing the channel for a new acquisition
+    if (!d_lock_fault_forced and (d_state == 4 or d_reacquisition.active()))
+        {
+            if (d_reacquisition.start(d_sample_counter))
+                {
+                    LOG(INFO) << "Starting reacquisition of satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << " in channel " << d_channel;
+                    // The narrow spacing of the lost tracking would miss code phase errors
+                    set_wide_spacing();
+                    d_state = 5;
+                    set_reacquisition_bin();
+                    update_tracking_vars();
+                    // The symbols of the outage are lost, so the telemetry decoder
+                    // must drop its frame synchronization and its TOW
+                    this->message_port_pub(pmt::mp("events"), pmt::from_long(4));  // 4 -> telemetry resynchronization
+                    return;
+                }
+            if (d_reacquisition.active())
+                {
+                    LOG(INFO) << "Reacquisition time limit reached in channel " << d_channel;
+                }
+        }
+    d_lock_fault_forced = false;
+    d_reacquisition.stop();
+    leave_correlation_batch();
+    d_state = 0;  // loss-of-lock detected
+    d_dormant = true;
+    this->message_port_pub(pmt::mp("events"), pmt::from_long(3));  // 3 -> loss of lock
+}
+
+
+// Open-loop NCOs at the Doppler of the current bin of the search. The code NCO
+// follows the retained Doppler, carrier aided.
+void dll_pll_veml_tracking::set_reacquisition_bin()
+{
+    d_carrier_doppler_hz = d_reacquisition.doppler_hz(d_sample_counter);
+    d_code_freq_chips = d_code_chip_rate + d_reacquisition.retained_doppler_hz(d_sample_counter) * d_code_chip_rate / d_signal_carrier_freq;
+}
+
+
+// One code period of the search. A reacquired satellite resumes the wide
+// tracking, and the lock detectors of the pull-in confirm it.
+void dll_pll_veml_tracking::reacquisition_step()
+{
+    switch (d_reacquisition.step(*d_Prompt, d_sample_counter))
+        {
+        case Reacquisition_Search::Result::reacquired:
+            LOG(INFO) << "Satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << " reacquired in channel " << d_channel
+                      << " with Doppler " << d_carrier_doppler_hz << " [Hz] and CN0 " << d_reacquisition.cn0_db_hz() << " [dB-Hz], "
+                      << d_reacquisition.elapsed_ms(d_sample_counter) << " [ms] after the loss of lock";
+            set_wide_tracking(d_carrier_doppler_hz, static_cast<double>(trk_parameters.reacquisition_doppler_step_hz));
+            d_cloop = true;
+            d_cn0_estimation_counter = 0;
+            d_carrier_lock_fail_counter = 0;
+            d_code_lock_fail_counter = 0;
+            d_cn0_smoother.reset();
+            d_carrier_lock_test_smoother.reset();
+            // restart the bit synchronization time limit
+            d_acq_sample_stamp = d_sample_counter;
+            d_state = 2;
+            update_tracking_vars();
+            // Symbols queued from before the outage could have set the TOW again
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(4));  // 4 -> telemetry resynchronization
+            return;
+        case Reacquisition_Search::Result::expired:
+            loss_of_lock();
+            return;
+        default:
+            set_reacquisition_bin();
+            update_tracking_vars();
+            break;
+        }
+}
+
+
 void dll_pll_veml_tracking::update_tracking_vars()
 {
     T_chip_seconds = 1.0 / d_code_freq_chips;
@@ -1256,9 +1672,6 @@ void dll_pll_veml_tracking::log_data()
             float tmp_P;
             float tmp_L;
             float tmp_VL;
-            float tmp_float;
-            double tmp_double;
-            uint64_t tmp_long_int;
             if (trk_parameters.track_pilot)
                 {
                     prompt_I = d_Prompt_Data.data()->real();
@@ -1283,263 +1696,82 @@ void dll_pll_veml_tracking::log_data()
             tmp_P = std::abs<float>(d_P_accu);
             tmp_L = std::abs<float>(d_L_accu);
 
+            Trk_Dump_Record record{};
+            // Dump correlators output
+            record.VE = tmp_VE;
+            record.E = tmp_E;
+            record.P = tmp_P;
+            record.L = tmp_L;
+            record.VL = tmp_VL;
+            // PROMPT I and Q (to analyze navigation symbols)
+            record.prompt_I = prompt_I;
+            record.prompt_Q = prompt_Q;
+            // PRN start sample stamp
+            record.PRN_start_sample_count = d_sample_counter + static_cast<uint64_t>(d_current_prn_length_samples);
+            // accumulated carrier phase
+            record.acc_carrier_phase_rad = static_cast<float>(d_acc_carrier_phase_rad);
+            // carrier and code frequency
+            record.carrier_doppler_hz = static_cast<float>(d_carrier_doppler_hz);
+            // carrier phase rate [Hz/s]
+            record.carrier_doppler_rate_hz_s = static_cast<float>(d_carrier_phase_rate_step_rad * trk_parameters.fs_in * trk_parameters.fs_in / PI_2);
+            record.code_freq_chips = static_cast<float>(d_code_freq_chips);
+            // code phase rate [chips/s^2]
+            record.code_freq_rate_chips = static_cast<float>(d_code_phase_rate_step_chips * trk_parameters.fs_in * trk_parameters.fs_in);
+            // PLL commands
+            record.carr_error_hz = static_cast<float>(d_carr_phase_error_hz);
+            record.carr_error_filt_hz = static_cast<float>(d_carr_error_filt_hz);
+            // DLL commands
+            record.code_error_chips = static_cast<float>(d_code_error_chips);
+            record.code_error_filt_chips = static_cast<float>(d_code_error_filt_chips);
+            // CN0 and carrier lock test
+            record.CN0_SNV_dB_Hz = static_cast<float>(d_CN0_SNV_dB_Hz);
+            record.carrier_lock_test = static_cast<float>(d_carrier_lock_test);
+            // AUX vars (for debug purposes)
+            record.aux1 = static_cast<float>(d_rem_code_phase_samples);
+            record.aux2 = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
+            // PRN
+            record.PRN = d_acquisition_gnss_synchro->PRN;
             try
                 {
-                    // Dump correlators output
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_VE), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_E), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_P), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_L), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_VL), sizeof(float));
-                    // PROMPT I and Q (to analyze navigation symbols)
-                    d_dump_file.write(reinterpret_cast<char *>(&prompt_I), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char *>(&prompt_Q), sizeof(float));
-                    // PRN start sample stamp
-                    tmp_long_int = d_sample_counter + static_cast<uint64_t>(d_current_prn_length_samples);
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_long_int), sizeof(uint64_t));
-                    // accumulated carrier phase
-                    tmp_float = d_acc_carrier_phase_rad;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // carrier and code frequency
-                    tmp_float = d_carrier_doppler_hz;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // carrier phase rate [Hz/s]
-                    tmp_float = d_carrier_phase_rate_step_rad * trk_parameters.fs_in * trk_parameters.fs_in / PI_2;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    tmp_float = d_code_freq_chips;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // code phase rate [chips/s^2]
-                    tmp_float = d_code_phase_rate_step_chips * trk_parameters.fs_in * trk_parameters.fs_in;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // PLL commands
-                    tmp_float = d_carr_phase_error_hz;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    tmp_float = d_carr_error_filt_hz;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // DLL commands
-                    tmp_float = d_code_error_chips;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    tmp_float = d_code_error_filt_chips;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // CN0 and carrier lock test
-                    tmp_float = d_CN0_SNV_dB_Hz;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    tmp_float = d_carrier_lock_test;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    // AUX vars (for debug purposes)
-                    tmp_float = d_rem_code_phase_samples;
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_float), sizeof(float));
-                    tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
-                    d_dump_file.write(reinterpret_cast<char *>(&tmp_double), sizeof(double));
-                    // PRN
-                    uint32_t prn_ = d_acquisition_gnss_synchro->PRN;
-                    d_dump_file.write(reinterpret_cast<char *>(&prn_), sizeof(uint32_t));
+                    // One copy to the buffer of the background writer per epoch
+                    d_dump_file.write_record(record);
                 }
             catch (const std::ifstream::failure &e)
                 {
                     LOG(WARNING) << "Exception writing trk dump file " << e.what();
                 }
-        }
-}
-
-
-int32_t dll_pll_veml_tracking::save_matfile()
-{
-    // READ DUMP FILE
-    std::ifstream::pos_type size;
-    int32_t number_of_double_vars = 1;
-    int32_t number_of_float_vars = 19;
-    int32_t epoch_size_bytes = sizeof(uint64_t) + sizeof(double) * number_of_double_vars +
-                               sizeof(float) * number_of_float_vars + sizeof(uint32_t);
-    std::ifstream dump_file;
-    std::string dump_filename_ = d_dump_filename;
-    // add channel number to the filename
-    dump_filename_.append(std::to_string(d_channel));
-    // add extension
-    dump_filename_.append(".dat");
-    std::cout << "Generating .mat file for " << dump_filename_ << std::endl;
-    dump_file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-        {
-            dump_file.open(dump_filename_.c_str(), std::ios::binary | std::ios::ate);
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem opening dump file:" << e.what() << std::endl;
-            return 1;
-        }
-    // count number of epochs and rewind
-    int64_t num_epoch = 0;
-    if (dump_file.is_open())
-        {
-            size = dump_file.tellg();
-            num_epoch = static_cast<int64_t>(size) / static_cast<int64_t>(epoch_size_bytes);
-            dump_file.seekg(0, std::ios::beg);
-        }
-    else
-        {
-            return 1;
-        }
-    auto abs_VE = std::vector<float>(num_epoch);
-    auto abs_E = std::vector<float>(num_epoch);
-    auto abs_P = std::vector<float>(num_epoch);
-    auto abs_L = std::vector<float>(num_epoch);
-    auto abs_VL = std::vector<float>(num_epoch);
-    auto Prompt_I = std::vector<float>(num_epoch);
-    auto Prompt_Q = std::vector<float>(num_epoch);
-    auto PRN_start_sample_count = std::vector<uint64_t>(num_epoch);
-    auto acc_carrier_phase_rad = std::vector<float>(num_epoch);
-    auto carrier_doppler_hz = std::vector<float>(num_epoch);
-    auto carrier_doppler_rate_hz = std::vector<float>(num_epoch);
-    auto code_freq_chips = std::vector<float>(num_epoch);
-    auto code_freq_rate_chips = std::vector<float>(num_epoch);
-    auto carr_error_hz = std::vector<float>(num_epoch);
-    auto carr_error_filt_hz = std::vector<float>(num_epoch);
-    auto code_error_chips = std::vector<float>(num_epoch);
-    auto code_error_filt_chips = std::vector<float>(num_epoch);
-    auto CN0_SNV_dB_Hz = std::vector<float>(num_epoch);
-    auto carrier_lock_test = std::vector<float>(num_epoch);
-    auto aux1 = std::vector<float>(num_epoch);
-    auto aux2 = std::vector<double>(num_epoch);
-    auto PRN = std::vector<uint32_t>(num_epoch);
-    try
-        {
-            if (dump_file.is_open())
+            if (d_mat_writer.is_open())
                 {
-                    for (int64_t i = 0; i < num_epoch; i++)
-                        {
-                            dump_file.read(reinterpret_cast<char *>(&abs_VE[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&abs_E[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&abs_P[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&abs_L[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&abs_VL[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&Prompt_I[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&Prompt_Q[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&PRN_start_sample_count[i]), sizeof(uint64_t));
-                            dump_file.read(reinterpret_cast<char *>(&acc_carrier_phase_rad[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&carrier_doppler_hz[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&carrier_doppler_rate_hz[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&code_freq_chips[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&code_freq_rate_chips[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&carr_error_hz[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&carr_error_filt_hz[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&code_error_chips[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&code_error_filt_chips[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&CN0_SNV_dB_Hz[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&carrier_lock_test[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&aux1[i]), sizeof(float));
-                            dump_file.read(reinterpret_cast<char *>(&aux2[i]), sizeof(double));
-                            dump_file.read(reinterpret_cast<char *>(&PRN[i]), sizeof(uint32_t));
-                        }
+                    // Same variables as the binary record, in the same order
+                    size_t var = 0;
+                    d_mat_writer.append(var++, record.VE);
+                    d_mat_writer.append(var++, record.E);
+                    d_mat_writer.append(var++, record.P);
+                    d_mat_writer.append(var++, record.L);
+                    d_mat_writer.append(var++, record.VL);
+                    d_mat_writer.append(var++, record.prompt_I);
+                    d_mat_writer.append(var++, record.prompt_Q);
+                    d_mat_writer.append(var++, record.PRN_start_sample_count);
+                    d_mat_writer.append(var++, record.acc_carrier_phase_rad);
+                    d_mat_writer.append(var++, record.carrier_doppler_hz);
+                    d_mat_writer.append(var++, record.carrier_doppler_rate_hz_s);
+                    d_mat_writer.append(var++, record.code_freq_chips);
+                    d_mat_writer.append(var++, record.code_freq_rate_chips);
+                    d_mat_writer.append(var++, record.carr_error_hz);
+                    d_mat_writer.append(var++, record.carr_error_filt_hz);
+                    d_mat_writer.append(var++, record.code_error_chips);
+                    d_mat_writer.append(var++, record.code_error_filt_chips);
+                    d_mat_writer.append(var++, record.CN0_SNV_dB_Hz);
+                    d_mat_writer.append(var++, record.carrier_lock_test);
+                    d_mat_writer.append(var++, record.aux1);
+                    d_mat_writer.append(var++, record.aux2);
+                    d_mat_writer.append(var++, record.PRN);
+                    d_mat_writer.append(var++, static_cast<float>(d_current_correlation_time_s));
+                    d_mat_writer.append(var++, d_last_correlation_time_ns);
+                    d_mat_writer.append(var, d_last_loop_time_ns);
+                    d_mat_writer.end_epoch();
                 }
-            dump_file.close();
-        }
-    catch (const std::ifstream::failure &e)
-        {
-            std::cerr << "Problem reading dump file:" << e.what() << std::endl;
-            return 1;
-        }
-
-    // WRITE MAT FILE
-    mat_t *matfp;
-    matvar_t *matvar;
-    std::string filename = dump_filename_;
-    filename.erase(filename.length() - 4, 4);
-    filename.append(".mat");
-    matfp = Mat_CreateVer(filename.c_str(), nullptr, MAT_FT_MAT73);
-    if (reinterpret_cast<int64_t *>(matfp) != nullptr)
-        {
-            std::array<size_t, 2> dims{1, static_cast<size_t>(num_epoch)};
-            matvar = Mat_VarCreate("abs_VE", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), abs_VE.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("abs_E", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), abs_E.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("abs_P", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), abs_P.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("abs_L", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), abs_L.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("abs_VL", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), abs_VL.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Prompt_I", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), Prompt_I.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("Prompt_Q", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), Prompt_Q.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("PRN_start_sample_count", MAT_C_UINT64, MAT_T_UINT64, 2, dims.data(), PRN_start_sample_count.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("acc_carrier_phase_rad", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), acc_carrier_phase_rad.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("carrier_doppler_hz", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), carrier_doppler_hz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("carrier_doppler_rate_hz", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), carrier_doppler_rate_hz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("code_freq_chips", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), code_freq_chips.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("code_freq_rate_chips", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), code_freq_rate_chips.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("carr_error_hz", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), carr_error_hz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("carr_error_filt_hz", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), carr_error_filt_hz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("code_error_chips", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), code_error_chips.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("code_error_filt_chips", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), code_error_filt_chips.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("CN0_SNV_dB_Hz", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), CN0_SNV_dB_Hz.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("carrier_lock_test", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), carrier_lock_test.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("aux1", MAT_C_SINGLE, MAT_T_SINGLE, 2, dims.data(), aux1.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("aux2", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims.data(), aux2.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
-
-            matvar = Mat_VarCreate("PRN", MAT_C_UINT32, MAT_T_UINT32, 2, dims.data(), PRN.data(), 0);
-            Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_ZLIB);  // or MAT_COMPRESSION_NONE
-            Mat_VarFree(matvar);
         }
-    Mat_Close(matfp);
-    return 0;
 }
 
 
@@ -1570,6 +1802,12 @@ void dll_pll_veml_tracking::set_channel(uint32_t channel)
                             LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what();
                         }
                 }
+            if (d_dump_mat and !d_mat_writer.is_open())
+                {
+                    std::string mat_filename = dump_filename_;
+                    mat_filename.replace(mat_filename.length() - 4, 4, ".mat");
+                    d_mat_writer.open(mat_filename, trk_parameters.dump_mat_compression);
+                }
         }
 }
 
@@ -1585,6 +1823,8 @@ void dll_pll_veml_tracking::stop_tracking()
 {
     gr::thread::scoped_lock l(d_setlock);
     d_state = 0;
+    d_dormant = true;
+    leave_correlation_batch();
 }
 
 
@@ -1592,7 +1832,6 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
     gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
     gr::thread::scoped_lock l(d_setlock);
-    const auto *in = reinterpret_cast<const gr_complex *>(input_items[0]);
     auto **out = reinterpret_cast<Gnss_Synchro **>(&output_items[0]);
     Gnss_Synchro current_synchro_data = Gnss_Synchro();
     current_synchro_data.Flag_valid_symbol_output = false;
@@ -1610,6 +1849,8 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
         {
         case 0:  // Standby - Consume samples at full throttle, do nothing
             {
+                // Only the sample count is kept, so that the pull-in can align the
+                // local replica with the acquisition sample stamp when tracking starts
                 d_sample_counter += static_cast<uint64_t>(ninput_items[0]);
                 consume_each(ninput_items[0]);
                 return 0;
@@ -1648,7 +1889,7 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
             }
         case 2:  // Wide tracking and symbol synchronization
             {
-                do_correlation_step(in);
+                do_correlation_step(input_items[0]);
                 // Save single correlation step variables
                 if (d_veml)
                     {
@@ -1669,14 +1910,14 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                 if (trk_parameters.bit_synchronization_time_limit_s < (d_sample_counter - d_acq_sample_stamp) / static_cast<int>(trk_parameters.fs_in))
                     {
                         d_carrier_lock_fail_counter = 300000;  // force loss-of-lock condition
+                        d_lock_fault_forced = true;
                         LOG(INFO) << systemName << " " << signal_pretty_name << " tracking synchronization time limit reached in channel " << d_channel
                                   << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << std::endl;
                     }
                 // Check lock status
                 if (!cn0_and_tracking_lock_status(d_code_period))
                     {
-                        clear_tracking_vars();
-                        d_state = 0;  // loss-of-lock detected
+                        loss_of_lock();
                     }
                 else
                     {
@@ -1693,8 +1934,8 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                                 if (d_secondary)
                                     {
                                         // ####### SECONDARY CODE LOCK #####
-                                        d_Prompt_circular_buffer.push_back(*d_Prompt);
-                                        if (d_Prompt_circular_buffer.size() == d_secondary_code_length)
+                                        d_secondary_code_correlator.push_back(d_Prompt->real());
+                                        if (d_secondary_code_correlator.full())
                                             {
                                                 next_state = acquire_secondary();
                                                 if (next_state)
@@ -1709,8 +1950,8 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                                 else if (d_symbols_per_bit > 1)  // Signal does not have secondary code. Search a bit transition by sign change
                                     {
                                         // ******* preamble correlation ********
-                                        d_Prompt_circular_buffer.push_back(*d_Prompt);
-                                        if (d_Prompt_circular_buffer.size() == d_secondary_code_length)
+                                        d_secondary_code_correlator.push_back(d_Prompt->real());
+                                        if (d_secondary_code_correlator.full())
                                             {
                                                 next_state = acquire_secondary();
                                                 if (next_state)
@@ -1739,26 +1980,35 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                                 d_P_data_accu = gr_complex(0.0, 0.0);
                                 d_L_accu = gr_complex(0.0, 0.0);
                                 d_VL_accu = gr_complex(0.0, 0.0);
-                                d_Prompt_circular_buffer.clear();
+                                d_secondary_code_correlator.clear();
                                 d_current_symbol = 0;
                                 d_current_data_symbol = 0;
+                                d_reacquisition.stop();  // tracking resumed
 
                                 if (d_enable_extended_integration)
                                     {
-                                        // UPDATE INTEGRATION TIME
-                                        d_extend_correlation_symbols_count = 0;
-                                        d_current_correlation_time_s = static_cast<float>(trk_parameters.extend_correlation_symbols) * static_cast<float>(d_code_period);
-                                        d_state = 3;  // next state is the extended correlator integrator
-                                        LOG(INFO) << "Enabled " << trk_parameters.extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0) << " ms extended correlator in channel "
-                                                  << d_channel
-                                                  << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN);
-                                        std::cout << "Enabled " << trk_parameters.extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0) << " ms extended correlator in channel "
-                                                  << d_channel
-                                                  << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << std::endl;
+                                        if (trk_parameters.adaptive_integration)
+                                            {
+                                                // start with the short integration, the scheduler extends it once the loops are stable
+                                                set_short_integration();
+                                                d_state = 4;
+                                                LOG(INFO) << "Enabled adaptive integration up to " << trk_parameters.extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0) << " ms in channel "
+                                                          << d_channel
+                                                          << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN);
+                                            }
+                                        else
+                                            {
+                                                // UPDATE INTEGRATION TIME
+                                                set_long_integration();
+                                                d_state = 3;  // next state is the extended correlator integrator
+                                                LOG(INFO) << "Enabled " << trk_parameters.extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0) << " ms extended correlator in channel "
+                                                          << d_channel
+                                                          << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN);
+                                                std::cout << "Enabled " << trk_parameters.extend_correlation_symbols * static_cast<int32_t>(d_code_period * 1000.0) << " ms extended correlator in channel "
+                                                          << d_channel
+                                                          << " for satellite " << Gnss_Satellite(systemName, d_acquisition_gnss_synchro->PRN) << std::endl;
+                                            }
                                         // Set narrow taps delay values [chips]
-                                        d_code_loop_filter.set_update_interval(d_current_correlation_time_s);
-                                        d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_narrow_hz);
-                                        d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_narrow_hz, trk_parameters.pll_filter_order);
                                         if (d_veml)
                                             {
                                                 d_local_code_shift_chips[0] = -trk_parameters.very_early_late_space_narrow_chips * static_cast<float>(d_code_samples_per_chip);
@@ -1790,7 +2040,12 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
         case 3:  // coherent integration (correlation time extension)
             {
                 // perform a correlation step
-                do_correlation_step(in);
+                const auto correlation_start = trk_parameters.loop_statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                do_correlation_step(input_items[0]);
+                if (trk_parameters.loop_statistics)
+                    {
+                        measure_correlation_time(correlation_start);
+                    }
                 save_correlation_results();
                 update_tracking_vars();
                 if (d_current_data_symbol == 0)
@@ -1818,7 +2073,7 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                         d_P_data_accu = gr_complex(0.0, 0.0);
                     }
                 d_extend_correlation_symbols_count++;
-                if (d_extend_correlation_symbols_count == (trk_parameters.extend_correlation_symbols - 1))
+                if (d_extend_correlation_symbols_count == (d_extend_correlation_symbols - 1))
                     {
                         d_extend_correlation_symbols_count = 0;
                         d_state = 4;
@@ -1828,20 +2083,33 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
         case 4:  // narrow tracking
             {
                 // perform a correlation step
-                do_correlation_step(in);
+                const auto correlation_start = trk_parameters.loop_statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                do_correlation_step(input_items[0]);
+                if (trk_parameters.loop_statistics)
+                    {
+                        measure_correlation_time(correlation_start);
+                    }
                 save_correlation_results();
 
                 // check lock status
-                if (!cn0_and_tracking_lock_status(d_code_period * static_cast<double>(trk_parameters.extend_correlation_symbols)))
+                const auto loop_start = trk_parameters.loop_statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                if (!cn0_and_tracking_lock_status(d_code_period * static_cast<double>(d_extend_correlation_symbols)))
                     {
-                        clear_tracking_vars();
-                        d_state = 0;  // loss-of-lock detected
+                        d_integration_correlation_time_ns = 0.0;
+                        d_last_correlation_time_ns = 0.0;
+                        d_last_loop_time_ns = 0.0;
+                        loss_of_lock();
                     }
                 else
                     {
                         run_dll_pll();
+                        retain_tracking_state();
                         update_tracking_vars();
                         check_carrier_phase_coherent_initialization();
+                        if (trk_parameters.loop_statistics)
+                            {
+                                update_loop_statistics(loop_start);
+                            }
                         if (d_current_data_symbol == 0)
                             {
                                 // enable write dump file this cycle (valid DLL/PLL cycle)
@@ -1874,11 +2142,22 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                         d_P_accu = gr_complex(0.0, 0.0);
                         d_L_accu = gr_complex(0.0, 0.0);
                         d_VL_accu = gr_complex(0.0, 0.0);
-                        if (d_enable_extended_integration)
+                        if (trk_parameters.adaptive_integration)
+                            {
+                                schedule_integration();
+                            }
+                        if (d_extend_correlation_symbols > 1)
                             {
                                 d_state = 3;  // new coherent integration (correlation time extension) cycle
                             }
                     }
+                break;
+            }
+        case 5:  // reacquisition: narrow Doppler search around the retained tracking state
+            {
+                do_correlation_step(input_items[0]);
+                reacquisition_step();
+                break;
             }
         }
     consume_each(d_current_prn_length_samples);
@@ -21,10 +21,18 @@
 #ifndef GNSS_SDR_DLL_PLL_VEML_TRACKING_H
 #define GNSS_SDR_DLL_PLL_VEML_TRACKING_H
 
+#include "cpu_multicorrelator_batch.h"
 #include "cpu_multicorrelator_real_codes.h"
+#include "cpu_multicorrelator_real_codes_16sc.h"
 #include "dll_pll_conf.h"
+#include "dump_writer.h"
 #include "exponential_smoother.h"
+#include "integration_scheduler.h"
+#include "mat_stream_writer.h"
+#include "reacquisition_search.h"
+#include "secondary_code_correlator.h"
 #include "tracking_FLL_PLL_filter.h"  // for PLL/FLL filter
+#include "tracking_KF_filter.h"       // for joint carrier and code Kalman filter
 #include "tracking_loop_filter.h"     // for DLL filter
 #include <boost/circular_buffer.hpp>
 #include <gnuradio/block.h>                   // for block
@@ -32,8 +40,11 @@
 #include <gnuradio/types.h>                   // for gr_vector_int, gr_vector...
 #include <pmt/pmt.h>                          // for pmt_t
 #include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <atomic>                             // for atomic
+#include <chrono>                             // for steady_clock
 #include <cstdint>                            // for int32_t
 #include <fstream>                            // for string, ofstream
+#include <memory>                             // for shared_ptr
 #include <string>
 #include <utility>  // for pair
 #if GNURADIO_USES_STD_POINTERS
@@ -54,6 +65,9 @@ using dll_pll_veml_tracking_sptr = boost::shared_ptr<dll_pll_veml_tracking>;
 
 dll_pll_veml_tracking_sptr dll_pll_veml_make_tracking(const Dll_Pll_Conf &conf_);
 
+// Samples a channel in standby lets accumulate in its input buffer before it consumes them
+constexpr int32_t TRK_STANDBY_LAG_SAMPLES = 16384;
+
 /*!
  * \brief This class implements a code DLL + carrier PLL tracking block.
  */
@@ -72,21 +86,72 @@ public:
 
     void forecast(int noutput_items, gr_vector_int &ninput_items_required);
 
+    /*!
+     * \brief Input items required by forecast(). A channel in standby waits
+     * for TRK_STANDBY_LAG_SAMPLES, but never for more than an eighth of its
+     * input buffer, so it does not cut the headroom of the other readers.
+     */
+    static int32_t items_required(int32_t vector_length, bool standby, int32_t buffer_items);
+
 private:
+    // One epoch of the binary dump file, in the layout read by Tracking_Dump_Reader
+#pragma pack(push, 1)
+    struct Trk_Dump_Record
+    {
+        float VE;
+        float E;
+        float P;
+        float L;
+        float VL;
+        float prompt_I;
+        float prompt_Q;
+        uint64_t PRN_start_sample_count;
+        float acc_carrier_phase_rad;
+        float carrier_doppler_hz;
+        float carrier_doppler_rate_hz_s;
+        float code_freq_chips;
+        float code_freq_rate_chips;
+        float carr_error_hz;
+        float carr_error_filt_hz;
+        float code_error_chips;
+        float code_error_filt_chips;
+        float CN0_SNV_dB_Hz;
+        float carrier_lock_test;
+        float aux1;
+        double aux2;
+        uint32_t PRN;
+    };
+#pragma pack(pop)
+    static_assert(sizeof(Trk_Dump_Record) == 19 * sizeof(float) + sizeof(uint64_t) + sizeof(double) + sizeof(uint32_t), "Unexpected padding in the tracking dump record");
+
     friend dll_pll_veml_tracking_sptr dll_pll_veml_make_tracking(const Dll_Pll_Conf &conf_);
     void msg_handler_telemetry_to_trk(const pmt::pmt_t &msg);
     explicit dll_pll_veml_tracking(const Dll_Pll_Conf &conf_);
 
     bool cn0_and_tracking_lock_status(double coh_integration_time_s);
     bool acquire_secondary();
+    void do_correlation_step(const void *input_items);
     void do_correlation_step(const gr_complex *input_samples);
+    void do_correlation_step(const lv_16sc_t *input_samples);
+    void leave_correlation_batch();
     void run_dll_pll();
+    void run_kf();
     void check_carrier_phase_coherent_initialization();
     void update_tracking_vars();
     void clear_tracking_vars();
+    void set_wide_spacing();
+    void set_wide_tracking(double carrier_doppler_hz, double doppler_step_hz);
+    void set_long_integration();
+    void set_short_integration();
+    void schedule_integration();
+    void measure_correlation_time(const std::chrono::steady_clock::time_point &correlation_start);
+    void update_loop_statistics(const std::chrono::steady_clock::time_point &loop_start);
+    void retain_tracking_state();
+    void loss_of_lock();
+    void set_reacquisition_bin();
+    void reacquisition_step();
     void save_correlation_results();
     void log_data();
-    int32_t save_matfile();
 
     // tracking configuration vars
     Dll_Pll_Conf trk_parameters;
@@ -117,6 +182,7 @@ private:
     boost::circular_buffer<float> d_dll_filt_history;
     // tracking state machine
     int32_t d_state;
+    std::atomic<bool> d_dormant;  // standby, read by forecast() without the block lock
     bool d_acc_carrier_phase_initialized;
 
     // Integration period in samples
@@ -129,12 +195,22 @@ private:
     float *d_prompt_data_shift;
     Cpu_Multicorrelator_Real_Codes multicorrelator_cpu;
     Cpu_Multicorrelator_Real_Codes correlator_data_cpu;  // for data channel
+    // 16-bit correlators and local codes, used if item_type is cshort
+    bool d_cshort;
+    volk_gnsssdr::vector<int16_t> d_tracking_code_16i;
+    volk_gnsssdr::vector<int16_t> d_data_code_16i;
+    Cpu_Multicorrelator_Real_Codes_16sc multicorrelator_cpu_16sc;
+    Cpu_Multicorrelator_Real_Codes_16sc correlator_data_cpu_16sc;
 
     /*  TODO: currently the multicorrelator does not support adding extra correlator
         with different local code, thus we need extra multicorrelator instance.
         Implement this functionality inside multicorrelator class
         as an enhancement to increase the performance
      */
+    // Engine shared with the other channels if batch_correlation is enabled
+    std::shared_ptr<Cpu_Multicorrelator_Batch> d_correlator_batch;
+    bool d_correlator_batch_active;
+
     volk_gnsssdr::vector<gr_complex> d_correlator_outs;
     gr_complex *d_Very_Early;
     gr_complex *d_Early;
@@ -143,7 +219,9 @@ private:
     gr_complex *d_Very_Late;
 
     bool d_enable_extended_integration;
+    int32_t d_extend_correlation_symbols;  // of the current integration, 1 or extend_correlation_symbols
     int32_t d_extend_correlation_symbols_count;
+    Integration_Scheduler d_integration_scheduler;
     int32_t d_current_symbol;
     int32_t d_current_data_symbol;
 
@@ -170,6 +248,7 @@ private:
 
     Tracking_loop_filter d_code_loop_filter;
     Tracking_FLL_PLL_filter d_carrier_loop_filter;
+    Tracking_KF_filter d_kf_filter;
 
     // acquisition
     double d_acq_code_phase_samples;
@@ -206,12 +285,31 @@ private:
     double d_carrier_lock_test;
     double d_CN0_SNV_dB_Hz;
     double d_carrier_lock_threshold;
-    boost::circular_buffer<gr_complex> d_Prompt_circular_buffer;
+    Secondary_Code_Correlator d_secondary_code_correlator;
     volk_gnsssdr::vector<gr_complex> d_Prompt_buffer;
     Exponential_Smoother d_cn0_smoother;
     Exponential_Smoother d_carrier_lock_test_smoother;
+    bool d_lock_fault_forced;  // telemetry fault or synchronization time limit, no reacquisition
+
+    // reacquisition after a loss of lock, from the last state with the lock detectors clear
+    Reacquisition_Search d_reacquisition;
+
+    // loop statistics of the narrow tracking
+    uint64_t d_stats_loop_updates;
+    double d_stats_loop_time_ns;
+    double d_stats_correlation_time_ns;
+    double d_integration_correlation_time_ns;  // of the correlation steps of the current integration
+    float d_last_correlation_time_ns;          // of the last integration, for the dump
+    float d_last_loop_time_ns;
+    double d_stats_long_integration_s;
+    double d_stats_short_integration_s;
+    double d_stats_carr_phase_error_sq;
+    double d_stats_code_error_sq;
+    uint64_t d_stats_integration_switches;
+
     // file dump
-    std::ofstream d_dump_file;
+    Dump_File d_dump_file;
+    Mat_Stream_Writer d_mat_writer;
     std::string d_dump_filename;
     bool d_dump;
     bool d_dump_mat;
@@ -354,7 +354,6 @@ dll_pll_veml_tracking_fpga::dll_pll_veml_tracking_fpga(const Dll_Pll_Conf_Fpga &
         }
 
     // --- Initializations ---
-    d_Prompt_circular_buffer.set_capacity(d_secondary_code_length);
     // Initial code frequency basis of NCO
     d_code_freq_chips = d_code_chip_rate;
     // Residual code phase (in chips)
@@ -563,39 +562,7 @@ dll_pll_veml_tracking_fpga::~dll_pll_veml_tracking_fpga()
 bool dll_pll_veml_tracking_fpga::acquire_secondary()
 {
     // ******* preamble correlation ********
-    int32_t corr_value = 0;
-    for (uint32_t i = 0; i < d_secondary_code_length; i++)
-        {
-            if (d_Prompt_circular_buffer[i].real() < 0.0)  // symbols clipping
-                {
-                    if (d_secondary_code_string->at(i) == '0')
-                        {
-                            corr_value++;
-                        }
-                    else
-                        {
-                            corr_value--;
-                        }
-                }
-            else
-                {
-                    if (d_secondary_code_string->at(i) == '0')
-                        {
-                            corr_value--;
-                        }
-                    else
-                        {
-                            corr_value++;
-                        }
-                }
-        }
-
-    if (abs(corr_value) == static_cast<int32_t>(d_secondary_code_length))
-        {
-            return true;
-        }
-
-    return false;
+    return d_secondary_code_correlator.locked();
 }
 
 
@@ -795,7 +762,7 @@ void dll_pll_veml_tracking_fpga::clear_tracking_vars()
     d_code_error_filt_chips = 0.0;
     d_current_symbol = 0;
     d_current_data_symbol = 0;
-    d_Prompt_circular_buffer.clear();
+    d_secondary_code_correlator.clear();
     d_carrier_phase_rate_step_rad = 0.0;
     d_code_phase_rate_step_chips = 0.0;
     d_carr_ph_history.clear();
@@ -1462,7 +1429,10 @@ void dll_pll_veml_tracking_fpga::set_gnss_synchro(Gnss_Synchro *p_gnss_synchro)
 
             d_cloop = true;
 
-            d_Prompt_circular_buffer.clear();
+            if (d_secondary_code_string != nullptr)
+                {
+                    d_secondary_code_correlator.set_code(d_secondary_code_string->substr(0, d_secondary_code_length));
+                }
 
             T_chip_seconds = 1.0 / d_code_freq_chips;
             T_prn_seconds = T_chip_seconds * static_cast<double>(d_code_length_chips);
@@ -1521,7 +1491,7 @@ int dll_pll_veml_tracking_fpga::general_work(int noutput_items __attribute__((un
                                     d_pull_in_transitory = false;
                                     d_carrier_lock_fail_counter = 0;
                                     d_code_lock_fail_counter = 0;
-                                }
+                }
                         }
                 }
             switch (d_state)
@@ -1652,9 +1622,9 @@ int dll_pll_veml_tracking_fpga::general_work(int noutput_items __attribute__((un
                                         if (d_secondary)
                                             {
                                                 // ####### SECONDARY CODE LOCK #####
-                                                d_Prompt_circular_buffer.push_back(*d_Prompt);
+                                                d_secondary_code_correlator.push_back(d_Prompt->real());
 
-                                                if (d_Prompt_circular_buffer.size() == d_secondary_code_length)
+                                                if (d_secondary_code_correlator.full())
                                                     {
                                                         next_state = acquire_secondary();
 
@@ -1670,8 +1640,8 @@ int dll_pll_veml_tracking_fpga::general_work(int noutput_items __attribute__((un
                                         else if (d_symbols_per_bit > 1)  // Signal does not have secondary code. Search a bit transition by sign change
                                             {
                                                 // ******* preamble correlation ********
-                                                d_Prompt_circular_buffer.push_back(*d_Prompt);
-                                                if (d_Prompt_circular_buffer.size() == d_secondary_code_length)
+                                                d_secondary_code_correlator.push_back(d_Prompt->real());
+                                                if (d_secondary_code_correlator.full())
                                                     {
                                                         next_state = acquire_secondary();
                                                         if (next_state)
@@ -1701,7 +1671,7 @@ int dll_pll_veml_tracking_fpga::general_work(int noutput_items __attribute__((un
                                         d_P_data_accu = gr_complex(0.0, 0.0);
                                         d_L_accu = gr_complex(0.0, 0.0);
                                         d_VL_accu = gr_complex(0.0, 0.0);
-                                        d_Prompt_circular_buffer.clear();
+                                        d_secondary_code_correlator.clear();
                                         d_current_symbol = 0;
                                         d_current_data_symbol = 0;
 
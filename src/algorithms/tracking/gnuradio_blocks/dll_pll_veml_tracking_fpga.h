@@ -23,6 +23,7 @@
 
 #include "dll_pll_conf_fpga.h"
 #include "exponential_smoother.h"
+#include "secondary_code_correlator.h"
 #include "tracking_FLL_PLL_filter.h"  // for PLL/FLL filter
 #include "tracking_loop_filter.h"     // for DLL filter
 #include <boost/circular_buffer.hpp>
@@ -225,7 +226,7 @@ private:
     double d_carrier_lock_test;
     double d_CN0_SNV_dB_Hz;
     double d_carrier_lock_threshold;
-    boost::circular_buffer<gr_complex> d_Prompt_circular_buffer;
+    Secondary_Code_Correlator d_secondary_code_correlator;
     volk_gnsssdr::vector<gr_complex> d_Prompt_buffer;
     Exponential_Smoother d_cn0_smoother;
     Exponential_Smoother d_carrier_lock_test_smoother;
@@ -0,0 +1,353 @@
+/*!
+ * \file cpu_multicorrelator_batch.cc
+ * \brief Engine that evaluates the correlations of several tracking channels
+ * together, tile by tile over the shared input samples.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cpu_multicorrelator_batch.h"
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>
+#include <algorithm>
+#include <cmath>
+
+
+std::shared_ptr<Cpu_Multicorrelator_Batch> Cpu_Multicorrelator_Batch::get_instance(int tile_samples, int max_wait_us)
+{
+    static std::mutex instance_mutex;
+    static std::weak_ptr<Cpu_Multicorrelator_Batch> instance;
+
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    std::shared_ptr<Cpu_Multicorrelator_Batch> engine = instance.lock();
+    if (!engine)
+        {
+            engine = std::make_shared<Cpu_Multicorrelator_Batch>(tile_samples, max_wait_us);
+            instance = engine;
+        }
+    return engine;
+}
+
+
+Cpu_Multicorrelator_Batch::Cpu_Multicorrelator_Batch(int tile_samples, int max_wait_us) : d_tile_samples(std::max(tile_samples, 256)),
+                                                                                          d_max_wait(std::max(max_wait_us, 0)),
+                                                                                          d_batches(0ULL),
+                                                                                          d_requests(0ULL)
+{
+}
+
+
+void Cpu_Multicorrelator_Batch::set_active(uint32_t channel, bool active)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (active)
+        {
+            d_active_channels.insert(channel);
+        }
+    else
+        {
+            d_active_channels.erase(channel);
+            // The open batch may be waiting only for this channel
+            if (d_open_batch and d_open_batch->participants >= std::max<size_t>(d_active_channels.size(), 1))
+                {
+                    close(*d_open_batch);
+                }
+        }
+}
+
+
+size_t Cpu_Multicorrelator_Batch::active_channels() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_active_channels.size();
+}
+
+
+uint64_t Cpu_Multicorrelator_Batch::batches() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_batches;
+}
+
+
+double Cpu_Multicorrelator_Batch::mean_batch_requests() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (d_batches == 0)
+        {
+            return 0.0;
+        }
+    return static_cast<double>(d_requests) / static_cast<double>(d_batches);
+}
+
+
+void Cpu_Multicorrelator_Batch::correlate(const Request* requests, int num_requests)
+{
+    if (num_requests <= 0)
+        {
+            return;
+        }
+    std::unique_lock<std::mutex> lock(d_mutex);
+    if (!d_open_batch)
+        {
+            d_open_batch = std::make_shared<Batch>();
+        }
+    std::shared_ptr<Batch> batch = d_open_batch;
+    const size_t participant = batch->participants++;
+    for (int i = 0; i < num_requests; i++)
+        {
+            batch->requests.push_back(&requests[i]);
+            batch->owners.push_back(participant);
+        }
+
+    if (batch->participants >= std::max<size_t>(d_active_channels.size(), 1))
+        {
+            close(*batch);
+        }
+    else if (!d_condition.wait_until(lock, std::chrono::steady_clock::now() + d_max_wait, [&batch] { return batch->closed; }))
+        {
+            // Some channels did not arrive in time, go on without them
+            close(*batch);
+        }
+    lock.unlock();
+
+    run(*batch, participant);
+
+    lock.lock();
+    batch->finished++;
+    if (batch->finished == batch->participants)
+        {
+            d_condition.notify_all();
+        }
+    else
+        {
+            d_condition.wait(lock, [&batch] { return batch->finished == batch->participants; });
+        }
+    lock.unlock();
+
+    // Add up the partial sums of the correlators of this participant
+    for (size_t r = 0; r < batch->requests.size(); r++)
+        {
+            if (batch->owners[r] != participant)
+                {
+                    continue;
+                }
+            const Request& request = *batch->requests[r];
+            for (int n = 0; n < request.n_correlators; n++)
+                {
+                    std::complex<float> sum(0.0, 0.0);
+                    for (const auto& partial_sums : batch->partial_sums)
+                        {
+                            sum += partial_sums[batch->first_taps[r] + n];
+                        }
+                    request.corr_out[n] = sum;
+                }
+        }
+}
+
+
+void Cpu_Multicorrelator_Batch::evaluate(const std::vector<const Request*>& requests, int tile_samples)
+{
+    for (const auto* request : requests)
+        {
+            std::fill_n(request->corr_out, request->n_correlators, std::complex<float>(0.0, 0.0));
+        }
+    for (const auto& tile : plan(requests, std::max(tile_samples, 1)))
+        {
+            for (const auto& item : tile)
+                {
+                    const Request& request = *requests[item.request];
+                    correlate_item(request, item.first_sample, item.num_samples, request.corr_out);
+                }
+        }
+}
+
+
+void Cpu_Multicorrelator_Batch::close(Batch& batch)
+{
+    // Called with d_mutex held
+    if (batch.closed)
+        {
+            return;
+        }
+    size_t num_taps = 0;
+    batch.first_taps.resize(batch.requests.size());
+    for (size_t r = 0; r < batch.requests.size(); r++)
+        {
+            batch.first_taps[r] = num_taps;
+            num_taps += batch.requests[r]->n_correlators;
+        }
+    batch.partial_sums.assign(batch.participants, std::vector<std::complex<float>>(num_taps, std::complex<float>(0.0, 0.0)));
+    batch.tiles = plan(batch.requests, d_tile_samples);
+    batch.closed = true;
+    if (d_open_batch.get() == &batch)
+        {
+            d_open_batch.reset();
+        }
+    d_batches++;
+    d_requests += batch.requests.size();
+    d_condition.notify_all();
+}
+
+
+void Cpu_Multicorrelator_Batch::run(Batch& batch, size_t participant)
+{
+    std::vector<std::complex<float>>& sums = batch.partial_sums[participant];
+    size_t tile;
+    while ((tile = batch.next_tile.fetch_add(1)) < batch.tiles.size())
+        {
+            for (const auto& item : batch.tiles[tile])
+                {
+                    correlate_item(*batch.requests[item.request], item.first_sample, item.num_samples, &sums[batch.first_taps[item.request]]);
+                }
+        }
+}
+
+
+std::vector<std::vector<Cpu_Multicorrelator_Batch::Work_Item>> Cpu_Multicorrelator_Batch::plan(const std::vector<const Request*>& requests, int tile_samples)
+{
+    // Sort the input windows by address, and split each group of overlapping
+    // windows into tiles of tile_samples samples
+    struct Window
+    {
+        uintptr_t begin;
+        uintptr_t end;
+        size_t request;
+    };
+    const uintptr_t sample_bytes = sizeof(std::complex<float>);
+    std::vector<Window> windows;
+    windows.reserve(requests.size());
+    for (size_t r = 0; r < requests.size(); r++)
+        {
+            if (requests[r]->signal_length_samples > 0)
+                {
+                    const auto begin = reinterpret_cast<uintptr_t>(requests[r]->sig_in);
+                    windows.push_back({begin, begin + requests[r]->signal_length_samples * sample_bytes, r});
+                }
+        }
+    std::sort(windows.begin(), windows.end(), [](const Window& a, const Window& b) { return a.begin < b.begin; });
+
+    std::vector<std::vector<Work_Item>> tiles;
+    size_t first = 0;
+    while (first < windows.size())
+        {
+            const uintptr_t group_begin = windows[first].begin;
+            uintptr_t group_end = windows[first].end;
+            size_t last = first + 1;
+            while (last < windows.size() and windows[last].begin < group_end)
+                {
+                    group_end = std::max(group_end, windows[last].end);
+                    last++;
+                }
+            const size_t first_tile = tiles.size();
+            const auto group_samples = static_cast<int64_t>((group_end - group_begin) / sample_bytes);
+            tiles.resize(first_tile + static_cast<size_t>((group_samples + tile_samples - 1) / tile_samples + 1));
+            for (size_t w = first; w < last; w++)
+                {
+                    const auto start = static_cast<int64_t>((windows[w].begin - group_begin) / sample_bytes);
+                    const int64_t end = start + requests[windows[w].request]->signal_length_samples;
+                    for (int64_t t = start / tile_samples; t * tile_samples < end; t++)
+                        {
+                            const int64_t item_begin = std::max(t * tile_samples, start);
+                            const int64_t item_end = std::min((t + 1) * tile_samples, end);
+                            tiles[first_tile + t].push_back({windows[w].request, static_cast<int>(item_begin - start), static_cast<int>(item_end - item_begin)});
+                        }
+                }
+            first = last;
+        }
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(), [](const std::vector<Work_Item>& tile) { return tile.empty(); }), tiles.end());
+    return tiles;
+}
+
+
+void Cpu_Multicorrelator_Batch::correlate_item(const Request& request, int first_sample, int num_samples, std::complex<float>* sums)
+{
+    thread_local volk_gnsssdr::vector<float> resampled_code;
+    thread_local std::vector<float> shifts_chips;
+    thread_local std::vector<int> shifts_samples;
+    thread_local std::vector<float*> local_codes;
+    thread_local volk_gnsssdr::vector<lv_32fc_t> corr_out;
+
+    const int n_correlators = request.n_correlators;
+    shifts_chips.assign(request.shifts_chips, request.shifts_chips + n_correlators);
+    local_codes.resize(n_correlators);
+    corr_out.resize(n_correlators);
+    const double code_length_chips = request.code_length_chips;
+    const double n0 = first_sample;
+    const double code_phase_step = request.code_phase_step_chips;
+    const double code_phase_rate_step = request.code_phase_rate_step_chips;
+    const double phase_step = request.phase_step_rad;
+    const double phase_rate_step = request.phase_rate_step_rad;
+    lv_32fc_t phase_offset_as_complex[1];
+
+    if (request.high_dynamics)
+        {
+            // The high dynamics resampler builds the taps by shifting the first
+            // one a whole number of samples. Resample the first tap over the
+            // tile extended by those shifts, and point the taps into it.
+            shifts_samples.resize(n_correlators);
+            shifts_samples[0] = 0;
+            for (int n = 1; n < n_correlators; n++)
+                {
+                    shifts_samples[n] = shifts_samples[n - 1] + static_cast<int>(std::round((shifts_chips[n] - shifts_chips[n - 1]) / request.code_phase_step_chips));
+                }
+            const int min_shift = *std::min_element(shifts_samples.begin(), shifts_samples.end());
+            const int max_shift = *std::max_element(shifts_samples.begin(), shifts_samples.end());
+            const int num_code_samples = num_samples + max_shift - min_shift;
+            const double m0 = n0 + min_shift;
+            const auto rem_code_phase = static_cast<float>(std::fmod(request.rem_code_phase_chips - code_phase_step * m0 - code_phase_rate_step * m0 * m0, code_length_chips));
+            const auto code_phase_step_chips = static_cast<float>(code_phase_step + 2.0 * code_phase_rate_step * m0);
+            resampled_code.resize(num_code_samples);
+            float* first_tap = resampled_code.data();
+            volk_gnsssdr_32f_xn_high_dynamics_resampler_32f_xn(&first_tap, request.local_code_in, rem_code_phase, code_phase_step_chips, request.code_phase_rate_step_chips, shifts_chips.data(), request.code_length_chips, 1, num_code_samples);
+            for (int n = 0; n < n_correlators; n++)
+                {
+                    local_codes[n] = first_tap + shifts_samples[n] - min_shift;
+                }
+
+            // The rotator applies phase_inc^k * phase_inc_rate^((k - 1)^2) to the
+            // sample k > 0. Restate it for the first sample of the tile (the
+            // phase of the first sample itself is then off by phase_rate_step_rad).
+            double rem_carrier_phase = request.rem_carrier_phase_in_rad;
+            double carrier_phase_step = phase_step;
+            if (first_sample > 0)
+                {
+                    rem_carrier_phase += phase_step * n0 + phase_rate_step * ((n0 - 1.0) * (n0 - 1.0) - 1.0);
+                    carrier_phase_step += 2.0 * phase_rate_step * n0;
+                }
+            phase_offset_as_complex[0] = lv_cmake(static_cast<float>(std::cos(rem_carrier_phase)), static_cast<float>(-std::sin(rem_carrier_phase)));
+            volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn(corr_out.data(), request.sig_in + first_sample, std::exp(lv_32fc_t(0.0, static_cast<float>(-carrier_phase_step))), std::exp(lv_32fc_t(0.0, -request.phase_rate_step_rad)), phase_offset_as_complex, const_cast<const float**>(local_codes.data()), n_correlators, num_samples);
+        }
+    else
+        {
+            // Keep every tap aligned, as the resampler stores them with aligned instructions
+            const int stride = (num_samples + 15) / 16 * 16;
+            resampled_code.resize(static_cast<size_t>(stride) * n_correlators);
+            for (int n = 0; n < n_correlators; n++)
+                {
+                    local_codes[n] = resampled_code.data() + static_cast<size_t>(stride) * n;
+                }
+            const auto rem_code_phase = static_cast<float>(std::fmod(request.rem_code_phase_chips - code_phase_step * n0, code_length_chips));
+            volk_gnsssdr_32f_xn_resampler_32f_xn(local_codes.data(), request.local_code_in, rem_code_phase, request.code_phase_step_chips, shifts_chips.data(), request.code_length_chips, n_correlators, num_samples);
+
+            const double rem_carrier_phase = request.rem_carrier_phase_in_rad + phase_step * n0;
+            phase_offset_as_complex[0] = lv_cmake(static_cast<float>(std::cos(rem_carrier_phase)), static_cast<float>(-std::sin(rem_carrier_phase)));
+            volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(corr_out.data(), request.sig_in + first_sample, std::exp(lv_32fc_t(0.0, -request.phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(local_codes.data()), n_correlators, num_samples);
+        }
+
+    for (int n = 0; n < n_correlators; n++)
+        {
+            sums[n] += corr_out[n];
+        }
+}
@@ -0,0 +1,144 @@
+/*!
+ * \file cpu_multicorrelator_batch.h
+ * \brief Engine that evaluates the correlations of several tracking channels
+ * together, tile by tile over the shared input samples.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CPU_MULTICORRELATOR_BATCH_H
+#define GNSS_SDR_CPU_MULTICORRELATOR_BATCH_H
+
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/*! \brief
+ * Engine that evaluates the carrier wipe-off and multicorrelator requests of
+ * all the tracking channels in one pass over the input samples.
+ *
+ * All the tracking channels read the same signal conditioner output, but each
+ * one runs its own correlation over it, so every sample block is streamed
+ * through the cache once per channel. Here each channel submits the
+ * correlations of its integration window and waits at a rendezvous: when
+ * every active channel has submitted, or after a maximum waiting time, the
+ * batch is closed and split into tiles of the input address space. All the
+ * waiting channels then take tiles from a shared counter and, for each tile,
+ * evaluate every request overlapping it while its samples are hot in L1/L2.
+ * The work of the batch is spread over the threads of the channels taking
+ * part, and each one finally adds up the partial sums of its own correlators.
+ *
+ * The results match those of Cpu_Multicorrelator_Real_Codes up to the
+ * floating point rounding, except that the taps of the high dynamics
+ * resampler are evaluated without the circular shift at the end of the
+ * integration window.
+ */
+class Cpu_Multicorrelator_Batch
+{
+public:
+    /*!
+     * \brief Carrier wipe-off and multicorrelator over one integration window,
+     * with the same parameters as Cpu_Multicorrelator_Real_Codes.
+     */
+    struct Request
+    {
+        const std::complex<float>* sig_in{nullptr};
+        std::complex<float>* corr_out{nullptr};
+        const float* local_code_in{nullptr};
+        const float* shifts_chips{nullptr};
+        int code_length_chips{0};
+        int n_correlators{0};
+        int signal_length_samples{0};
+        float rem_carrier_phase_in_rad{0.0};
+        float phase_step_rad{0.0};
+        float phase_rate_step_rad{0.0};
+        float rem_code_phase_chips{0.0};
+        float code_phase_step_chips{0.0};
+        float code_phase_rate_step_chips{0.0};
+        bool high_dynamics{true};
+    };
+
+    /*!
+     * \brief Returns the engine shared by all the tracking channels, creating
+     * it with the given parameters if it does not exist.
+     */
+    static std::shared_ptr<Cpu_Multicorrelator_Batch> get_instance(int tile_samples, int max_wait_us);
+
+    Cpu_Multicorrelator_Batch(int tile_samples, int max_wait_us);
+    ~Cpu_Multicorrelator_Batch() = default;
+
+    /*!
+     * \brief Adds or removes a channel from the set of channels expected in each batch.
+     */
+    void set_active(uint32_t channel, bool active);
+
+    /*!
+     * \brief Evaluates the requests together with those of the other active
+     * channels. It blocks until the results are written.
+     */
+    void correlate(const Request* requests, int num_requests);
+
+    /*!
+     * \brief Evaluates a set of requests in the calling thread, tile by tile.
+     */
+    static void evaluate(const std::vector<const Request*>& requests, int tile_samples);
+
+    size_t active_channels() const;
+    uint64_t batches() const;            //!< Number of batches evaluated
+    double mean_batch_requests() const;  //!< Mean number of requests per batch
+
+private:
+    struct Work_Item
+    {
+        size_t request;
+        int first_sample;
+        int num_samples;
+    };
+
+    struct Batch
+    {
+        std::vector<const Request*> requests;
+        std::vector<size_t> owners;      // participant of each request
+        std::vector<size_t> first_taps;  // index of the first tap of each request in the partial sums
+        std::vector<std::vector<Work_Item>> tiles;
+        std::vector<std::vector<std::complex<float>>> partial_sums;  // one per participant
+        std::atomic<size_t> next_tile{0};
+        size_t participants{0};
+        size_t finished{0};
+        bool closed{false};
+    };
+
+    static std::vector<std::vector<Work_Item>> plan(const std::vector<const Request*>& requests, int tile_samples);
+    static void correlate_item(const Request& request, int first_sample, int num_samples, std::complex<float>* sums);
+    void close(Batch& batch);
+    void run(Batch& batch, size_t participant);
+
+    std::shared_ptr<Batch> d_open_batch;
+    std::set<uint32_t> d_active_channels;
+    mutable std::mutex d_mutex;
+    std::condition_variable d_condition;
+    int d_tile_samples;
+    std::chrono::microseconds d_max_wait;
+    uint64_t d_batches;
+    uint64_t d_requests;
+};
+
+#endif  // GNSS_SDR_CPU_MULTICORRELATOR_BATCH_H
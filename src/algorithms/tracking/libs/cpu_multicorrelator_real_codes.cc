@@ -24,7 +24,13 @@
 
 #include "cpu_multicorrelator_real_codes.h"
 #include <volk_gnsssdr/volk_gnsssdr.h>
+#include <algorithm>
 #include <cmath>
+#include <limits>
+
+// Largest distance between the earliest and the latest taps, in samples, that
+// fits the extended replica of the integer shift mode
+constexpr int INTEGER_SHIFT_MAX_SPAN_SAMPLES = 128;
 
 Cpu_Multicorrelator_Real_Codes::Cpu_Multicorrelator_Real_Codes()
 {
@@ -33,9 +39,15 @@ Cpu_Multicorrelator_Real_Codes::Cpu_Multicorrelator_Real_Codes()
     d_shifts_chips = nullptr;
     d_corr_out = nullptr;
     d_local_codes_resampled = nullptr;
+    d_local_code_extended = nullptr;
+    d_tap_codes = nullptr;
+    d_tap_offsets_samples = nullptr;
+    d_max_shift_error_samples = 0.01;
     d_code_length_chips = 0;
     d_n_correlators = 0;
     d_use_high_dynamics_resampler = true;
+    d_use_integer_shift = false;
+    d_integer_shift_active = false;
 }
 
 
@@ -60,6 +72,9 @@ bool Cpu_Multicorrelator_Real_Codes::init(
         {
             d_local_codes_resampled[n] = static_cast<float*>(volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
         }
+    d_local_code_extended = static_cast<float*>(volk_gnsssdr_malloc(size + INTEGER_SHIFT_MAX_SPAN_SAMPLES * sizeof(float), volk_gnsssdr_get_alignment()));
+    d_tap_codes = static_cast<const float**>(volk_gnsssdr_malloc(n_correlators * sizeof(float*), volk_gnsssdr_get_alignment()));
+    d_tap_offsets_samples = static_cast<int*>(volk_gnsssdr_malloc(n_correlators * sizeof(int), volk_gnsssdr_get_alignment()));
     d_n_correlators = n_correlators;
     return true;
 }
@@ -87,8 +102,69 @@ bool Cpu_Multicorrelator_Real_Codes::set_input_output_vectors(std::complex<float
 }
 
 
+bool Cpu_Multicorrelator_Real_Codes::update_local_code_integer_shift(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
+{
+    if (code_phase_step_chips <= 0.0)
+        {
+            return false;
+        }
+    // Offsets of the taps in samples, which must be integers
+    int min_offset = std::numeric_limits<int>::max();
+    int max_offset = std::numeric_limits<int>::min();
+    for (int n = 0; n < d_n_correlators; n++)
+        {
+            const float offset = d_shifts_chips[n] / code_phase_step_chips;
+            const float rounded_offset = std::round(offset);
+            if (std::fabs(offset - rounded_offset) > d_max_shift_error_samples or std::fabs(rounded_offset) > static_cast<float>(INTEGER_SHIFT_MAX_SPAN_SAMPLES))
+                {
+                    return false;
+                }
+            d_tap_offsets_samples[n] = static_cast<int>(rounded_offset);
+            min_offset = std::min(min_offset, d_tap_offsets_samples[n]);
+            max_offset = std::max(max_offset, d_tap_offsets_samples[n]);
+        }
+    if (max_offset - min_offset > INTEGER_SHIFT_MAX_SPAN_SAMPLES)
+        {
+            return false;
+        }
+
+    // A single replica from the earliest tap, extended to cover the latest one
+    float first_shift_chips = static_cast<float>(min_offset) * code_phase_step_chips;
+    volk_gnsssdr_32f_xn_resampler_32f_xn(&d_local_code_extended,
+        d_local_code_in,
+        rem_code_phase_chips,
+        code_phase_step_chips,
+        &first_shift_chips,
+        d_code_length_chips,
+        1,
+        correlator_length_samples + max_offset - min_offset);
+    for (int n = 0; n < d_n_correlators; n++)
+        {
+            d_tap_codes[n] = d_local_code_extended + (d_tap_offsets_samples[n] - min_offset);
+        }
+    return true;
+}
+
+
+const float** Cpu_Multicorrelator_Real_Codes::local_codes() const
+{
+    if (d_integer_shift_active)
+        {
+            return d_tap_codes;
+        }
+    return const_cast<const float**>(d_local_codes_resampled);
+}
+
+
 void Cpu_Multicorrelator_Real_Codes::update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips)
 {
+    // The code phase rate changes the distance between the taps along the integration
+    d_integer_shift_active = d_use_integer_shift and (code_phase_rate_step_chips == 0.0 or !d_use_high_dynamics_resampler) and
+                             update_local_code_integer_shift(correlator_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    if (d_integer_shift_active)
+        {
+            return;
+        }
     if (d_use_high_dynamics_resampler)
         {
             volk_gnsssdr_32f_xn_high_dynamics_resampler_32f_xn(d_local_codes_resampled,
@@ -131,11 +207,11 @@ bool Cpu_Multicorrelator_Real_Codes::Carrier_wipeoff_multicorrelator_resampler(
     // call VOLK_GNSSSDR kernel
     if (d_use_high_dynamics_resampler)
         {
-            volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), std::exp(lv_32fc_t(0.0, -phase_rate_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+            volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), std::exp(lv_32fc_t(0.0, -phase_rate_step_rad)), phase_offset_as_complex, local_codes(), d_n_correlators, signal_length_samples);
         }
     else
         {
-            volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+            volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, local_codes(), d_n_correlators, signal_length_samples);
         }
     return true;
 }
@@ -154,11 +230,40 @@ bool Cpu_Multicorrelator_Real_Codes::Carrier_wipeoff_multicorrelator_resampler(
     lv_32fc_t phase_offset_as_complex[1];
     phase_offset_as_complex[0] = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
     // call VOLK_GNSSSDR kernel
-    volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+    volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, local_codes(), d_n_correlators, signal_length_samples);
     return true;
 }
 
 
+Cpu_Multicorrelator_Batch::Request Cpu_Multicorrelator_Real_Codes::batch_request(
+    float rem_carrier_phase_in_rad,
+    float phase_step_rad,
+    float phase_rate_step_rad,
+    float rem_code_phase_chips,
+    float code_phase_step_chips,
+    float code_phase_rate_step_chips,
+    int signal_length_samples) const
+{
+    // Same correlation as Carrier_wipeoff_multicorrelator_resampler, to be evaluated by Cpu_Multicorrelator_Batch
+    Cpu_Multicorrelator_Batch::Request request;
+    request.sig_in = d_sig_in;
+    request.corr_out = d_corr_out;
+    request.local_code_in = d_local_code_in;
+    request.shifts_chips = d_shifts_chips;
+    request.code_length_chips = d_code_length_chips;
+    request.n_correlators = d_n_correlators;
+    request.signal_length_samples = signal_length_samples;
+    request.rem_carrier_phase_in_rad = rem_carrier_phase_in_rad;
+    request.phase_step_rad = phase_step_rad;
+    request.phase_rate_step_rad = phase_rate_step_rad;
+    request.rem_code_phase_chips = rem_code_phase_chips;
+    request.code_phase_step_chips = code_phase_step_chips;
+    request.code_phase_rate_step_chips = code_phase_rate_step_chips;
+    request.high_dynamics = d_use_high_dynamics_resampler;
+    return request;
+}
+
+
 bool Cpu_Multicorrelator_Real_Codes::free()
 {
     // Free memory
@@ -171,6 +276,16 @@ bool Cpu_Multicorrelator_Real_Codes::free()
             volk_gnsssdr_free(d_local_codes_resampled);
             d_local_codes_resampled = nullptr;
         }
+    if (d_local_code_extended != nullptr)
+        {
+            volk_gnsssdr_free(d_local_code_extended);
+            volk_gnsssdr_free(d_tap_codes);
+            volk_gnsssdr_free(d_tap_offsets_samples);
+            d_local_code_extended = nullptr;
+            d_tap_codes = nullptr;
+            d_tap_offsets_samples = nullptr;
+        }
+    d_integer_shift_active = false;
     return true;
 }
 
@@ -180,3 +295,12 @@ void Cpu_Multicorrelator_Real_Codes::set_high_dynamics_resampler(
 {
     d_use_high_dynamics_resampler = use_high_dynamics_resampler;
 }
+
+
+void Cpu_Multicorrelator_Real_Codes::set_integer_shift(
+    bool use_integer_shift,
+    float max_error_samples)
+{
+    d_use_integer_shift = use_integer_shift;
+    d_max_shift_error_samples = max_error_samples;
+}
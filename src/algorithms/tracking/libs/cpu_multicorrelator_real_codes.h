@@ -26,6 +26,7 @@
 #define GNSS_SDR_CPU_MULTICORRELATOR_REAL_CODES_H
 
 
+#include "cpu_multicorrelator_batch.h"
 #include <complex>
 
 /*!
@@ -36,6 +37,14 @@ class Cpu_Multicorrelator_Real_Codes
 public:
     Cpu_Multicorrelator_Real_Codes();
     void set_high_dynamics_resampler(bool use_high_dynamics_resampler);
+
+    /*!
+     * \brief When the tap spacings are integer multiples of the sample period,
+     * within max_error_samples, resamples a single replica per integration
+     * and reads the taps from it at integer offsets. Otherwise, or with a
+     * code phase rate, each tap is resampled as usual.
+     */
+    void set_integer_shift(bool use_integer_shift, float max_error_samples = 0.01);
     ~Cpu_Multicorrelator_Real_Codes();
     bool init(int max_signal_length_samples, int n_correlators);
     bool set_local_code_and_taps(int code_length_chips, const float *local_code_in, float *shifts_chips);
@@ -43,16 +52,31 @@ public:
     void update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips = 0.0);
     bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float phase_rate_step_rad, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips, int signal_length_samples);
     bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips, int signal_length_samples);
+    Cpu_Multicorrelator_Batch::Request batch_request(float rem_carrier_phase_in_rad, float phase_step_rad, float phase_rate_step_rad, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips, int signal_length_samples) const;
     bool free();
 
+    /*!
+     * \brief True if the last update of the local code used integer shifts.
+     */
+    inline bool integer_shift_active() const { return d_integer_shift_active; }
+
 private:
+    bool update_local_code_integer_shift(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
+    const float **local_codes() const;
+
     // Allocate the device input vectors
     const std::complex<float> *d_sig_in;
     float **d_local_codes_resampled;
     const float *d_local_code_in;
     std::complex<float> *d_corr_out;
     float *d_shifts_chips;
+    float *d_local_code_extended;
+    const float **d_tap_codes;
+    int *d_tap_offsets_samples;
+    float d_max_shift_error_samples;
     bool d_use_high_dynamics_resampler;
+    bool d_use_integer_shift;
+    bool d_integer_shift_active;
     int d_code_length_chips;
     int d_n_correlators;
 };
@@ -0,0 +1,148 @@
+/*!
+ * \file cpu_multicorrelator_real_codes_16sc.cc
+ * \brief CPU vector multiTAP correlator class for 16-bit complex samples
+ * using 16-bit real-valued local codes
+ *
+ * Class that implements a vector multiTAP correlator class for CPUs
+ * working on 16 bits integer samples and local code replicas.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cpu_multicorrelator_real_codes_16sc.h"
+#include <cmath>
+
+
+Cpu_Multicorrelator_Real_Codes_16sc::Cpu_Multicorrelator_Real_Codes_16sc()
+{
+    d_sig_in = nullptr;
+    d_local_code_in = nullptr;
+    d_shifts_chips = nullptr;
+    d_corr_out = nullptr;
+    d_local_codes_resampled = nullptr;
+    d_code_length_chips = 0;
+    d_n_correlators = 0;
+    d_accumulator_bits = 32;
+}
+
+
+Cpu_Multicorrelator_Real_Codes_16sc::~Cpu_Multicorrelator_Real_Codes_16sc()
+{
+    if (d_local_codes_resampled != nullptr)
+        {
+            Cpu_Multicorrelator_Real_Codes_16sc::free();
+        }
+}
+
+
+bool Cpu_Multicorrelator_Real_Codes_16sc::init(
+    int max_signal_length_samples,
+    int n_correlators,
+    int accumulator_bits)
+{
+    if (accumulator_bits != 16 and accumulator_bits != 32)
+        {
+            return false;
+        }
+    // ALLOCATE MEMORY FOR INTERNAL vectors
+    size_t size = max_signal_length_samples * sizeof(int16_t);
+
+    d_local_codes_resampled = static_cast<int16_t**>(volk_gnsssdr_malloc(n_correlators * sizeof(int16_t*), volk_gnsssdr_get_alignment()));
+    for (int n = 0; n < n_correlators; n++)
+        {
+            d_local_codes_resampled[n] = static_cast<int16_t*>(volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
+        }
+    d_n_correlators = n_correlators;
+    d_accumulator_bits = accumulator_bits;
+    d_corr_out_16sc.resize(n_correlators);
+    return true;
+}
+
+
+bool Cpu_Multicorrelator_Real_Codes_16sc::set_local_code_and_taps(
+    int code_length_chips,
+    const int16_t* local_code_in,
+    float* shifts_chips)
+{
+    d_local_code_in = local_code_in;
+    d_shifts_chips = shifts_chips;
+    d_code_length_chips = code_length_chips;
+    return true;
+}
+
+
+bool Cpu_Multicorrelator_Real_Codes_16sc::set_input_output_vectors(std::complex<float>* corr_out, const lv_16sc_t* sig_in)
+{
+    // Save CPU pointers
+    d_sig_in = sig_in;
+    d_corr_out = corr_out;
+    return true;
+}
+
+
+void Cpu_Multicorrelator_Real_Codes_16sc::update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
+{
+    volk_gnsssdr_16i_xn_resampler_16i_xn(d_local_codes_resampled,
+        d_local_code_in,
+        rem_code_phase_chips,
+        code_phase_step_chips,
+        d_shifts_chips,
+        d_code_length_chips,
+        d_n_correlators,
+        correlator_length_samples);
+}
+
+
+bool Cpu_Multicorrelator_Real_Codes_16sc::Carrier_wipeoff_multicorrelator_resampler(
+    float rem_carrier_phase_in_rad,
+    float phase_step_rad,
+    float rem_code_phase_chips,
+    float code_phase_step_chips,
+    int signal_length_samples)
+{
+    update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    // Regenerate phase at each call in order to avoid numerical issues
+    lv_32fc_t phase_offset_as_complex[1];
+    phase_offset_as_complex[0] = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
+    const lv_32fc_t phase_inc = std::exp(lv_32fc_t(0.0, -phase_step_rad));
+    if (d_accumulator_bits == 16)
+        {
+            // call VOLK_GNSSSDR kernel with 16-bit saturating accumulators
+            volk_gnsssdr_16ic_16i_rotator_dot_prod_16ic_xn(d_corr_out_16sc.data(), d_sig_in, phase_inc, phase_offset_as_complex, const_cast<const int16_t**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+            for (int n = 0; n < d_n_correlators; n++)
+                {
+                    d_corr_out[n] = std::complex<float>(static_cast<float>(d_corr_out_16sc[n].real()), static_cast<float>(d_corr_out_16sc[n].imag()));
+                }
+            return true;
+        }
+    // call VOLK_GNSSSDR kernel with 32-bit accumulators
+    volk_gnsssdr_16ic_16i_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, phase_inc, phase_offset_as_complex, const_cast<const int16_t**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+    return true;
+}
+
+
+bool Cpu_Multicorrelator_Real_Codes_16sc::free()
+{
+    // Free memory
+    if (d_local_codes_resampled != nullptr)
+        {
+            for (int n = 0; n < d_n_correlators; n++)
+                {
+                    volk_gnsssdr_free(d_local_codes_resampled[n]);
+                }
+            volk_gnsssdr_free(d_local_codes_resampled);
+            d_local_codes_resampled = nullptr;
+        }
+    return true;
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file cpu_multicorrelator_real_codes_16sc.h
+ * \brief CPU vector multiTAP correlator class for 16-bit complex samples
+ * using 16-bit real-valued local codes
+ *
+ * Class that implements a vector multiTAP correlator class for CPUs
+ * working on 16 bits integer samples and local code replicas.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CPU_MULTICORRELATOR_REAL_CODES_16SC_H
+#define GNSS_SDR_CPU_MULTICORRELATOR_REAL_CODES_16SC_H
+
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <complex>
+#include <cstdint>
+
+/*!
+ * \brief Class that implements carrier wipe-off and correlators over 16-bit
+ * complex samples with 16-bit real-valued local codes.
+ *
+ * With a 16-bit accumulator the products of each correlator are accumulated
+ * in 16-bit saturating integers, which can saturate with long integration
+ * times or strong inputs. With a 32-bit accumulator they are accumulated in
+ * 32-bit integers. Both accumulate the whole integration window in a single
+ * VOLK_GNSSSDR kernel call.
+ */
+class Cpu_Multicorrelator_Real_Codes_16sc
+{
+public:
+    Cpu_Multicorrelator_Real_Codes_16sc();
+    ~Cpu_Multicorrelator_Real_Codes_16sc();
+    bool init(int max_signal_length_samples, int n_correlators, int accumulator_bits = 32);
+    bool set_local_code_and_taps(int code_length_chips, const int16_t *local_code_in, float *shifts_chips);
+    bool set_input_output_vectors(std::complex<float> *corr_out, const lv_16sc_t *sig_in);
+    void update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
+    bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
+    bool free();
+
+private:
+    // Allocate the device input vectors
+    const lv_16sc_t *d_sig_in;
+    int16_t **d_local_codes_resampled;
+    const int16_t *d_local_code_in;
+    std::complex<float> *d_corr_out;
+    float *d_shifts_chips;
+    volk_gnsssdr::vector<lv_16sc_t> d_corr_out_16sc;
+    int d_code_length_chips;
+    int d_n_correlators;
+    int d_accumulator_bits;
+};
+
+
+#endif  // GNSS_SDR_CPU_MULTICORRELATOR_REAL_CODES_16SC_H
@@ -28,16 +28,25 @@ Dll_Pll_Conf::Dll_Pll_Conf()
 {
     /* DLL/PLL tracking configuration */
     high_dyn = false;
+    batch_correlation = false;
+    batch_tile_samples = 4096;
+    batch_max_wait_us = 100;
+    accumulator_bits = 32;
     smoother_length = 10;
     fs_in = 2000000.0;
     vector_length = 0U;
     dump = false;
     dump_mat = true;
+    dump_mat_compression = false;
+    dump_drop_records = false;
     dump_filename = std::string("./dll_pll_dump.dat");
     enable_fll_pull_in = false;
     enable_fll_steady_state = false;
     pull_in_time_s = 10;
     bit_synchronization_time_limit_s = pull_in_time_s + 60;
+    reacquisition_time_ms = 0;
+    reacquisition_doppler_bins = 5;
+    reacquisition_doppler_step_hz = 50.0;
     fll_filter_order = 1;
     pll_filter_order = 3;
     dll_filter_order = 2;
@@ -56,6 +65,10 @@ Dll_Pll_Conf::Dll_Pll_Conf()
     spc = 0.5;
     y_intercept = 1.0;
     carrier_aiding = true;
+    enable_kf_tracking = false;
+    kf_dynamics_psd = 20.0;
+    kf_code_psd = 1e-4;
+    kf_doppler_rate_sigma_hz_s = 10.0;
     extend_correlation_symbols = 1;
     cn0_samples = FLAGS_cn0_samples;
     cn0_smoother_samples = 200;
@@ -68,6 +81,14 @@ Dll_Pll_Conf::Dll_Pll_Conf()
     carrier_lock_th = FLAGS_carrier_lock_th;
     track_pilot = true;
     enable_doppler_correction = false;
+    adaptive_integration = false;
+    adaptive_long_lock_th = 0.9;
+    adaptive_short_lock_th = 0.8;
+    adaptive_weak_cn0_db_hz = 32.0;
+    adaptive_dwell_ms = 1000;
+    loop_statistics = false;
+    integer_shift_correlator = false;
+    integer_shift_max_error_samples = 0.01;
     system = 'G';
     signal[0] = '1';
     signal[1] = 'C';
@@ -85,13 +106,24 @@ void Dll_Pll_Conf::SetFromConfiguration(ConfigurationInterface *configuration,
             LOG(WARNING) << "Unknown item type: " + item_type << ". Set to gr_complex";
             item_type = "gr_complex";
         }
+    accumulator_bits = configuration->property(role + ".accumulator_bits", accumulator_bits);
+    if (accumulator_bits != 16 and accumulator_bits != 32)
+        {
+            LOG(WARNING) << "Invalid accumulator_bits: " << accumulator_bits << ". Set to 32";
+            accumulator_bits = 32;
+        }
 
     int fs_in_deprecated = configuration->property("GNSS-SDR.internal_fs_hz", fs_in);
     fs_in = configuration->property("GNSS-SDR.internal_fs_sps", fs_in_deprecated);
     high_dyn = configuration->property(role + ".high_dyn", high_dyn);
+    batch_correlation = configuration->property(role + ".batch_correlation", batch_correlation);
+    batch_tile_samples = configuration->property(role + ".batch_tile_samples", batch_tile_samples);
+    batch_max_wait_us = configuration->property(role + ".batch_max_wait_us", batch_max_wait_us);
     dump = configuration->property(role + ".dump", dump);
     dump_filename = configuration->property(role + ".dump_filename", dump_filename);
     dump_mat = configuration->property(role + ".dump_mat", dump_mat);
+    dump_mat_compression = configuration->property(role + ".dump_mat_compression", dump_mat_compression);
+    dump_drop_records = configuration->property(role + ".dump_drop_records", dump_drop_records);
     pll_bw_hz = configuration->property(role + ".pll_bw_hz", pll_bw_hz);
     if (FLAGS_pll_bw_hz != 0.0)
         {
@@ -142,6 +174,14 @@ void Dll_Pll_Conf::SetFromConfiguration(ConfigurationInterface *configuration,
     fll_bw_hz = configuration->property(role + ".fll_bw_hz", fll_bw_hz);
     pull_in_time_s = configuration->property(role + ".pull_in_time_s", pull_in_time_s);
     bit_synchronization_time_limit_s = pull_in_time_s + 60;
+    reacquisition_time_ms = configuration->property(role + ".reacquisition_time_ms", reacquisition_time_ms);
+    reacquisition_doppler_bins = configuration->property(role + ".reacquisition_doppler_bins", reacquisition_doppler_bins);
+    if (reacquisition_doppler_bins < 1)
+        {
+            reacquisition_doppler_bins = 1;
+            LOG(WARNING) << "reacquisition_doppler_bins must be bigger than 0. It has been set to 1";
+        }
+    reacquisition_doppler_step_hz = configuration->property(role + ".reacquisition_doppler_step_hz", reacquisition_doppler_step_hz);
     early_late_space_chips = configuration->property(role + ".early_late_space_chips", early_late_space_chips);
     early_late_space_narrow_chips = configuration->property(role + ".early_late_space_narrow_chips", early_late_space_narrow_chips);
     very_early_late_space_chips = configuration->property(role + ".very_early_late_space_chips", very_early_late_space_chips);
@@ -153,7 +193,24 @@ void Dll_Pll_Conf::SetFromConfiguration(ConfigurationInterface *configuration,
     max_code_lock_fail = configuration->property(role + ".max_lock_fail", max_code_lock_fail);
     max_carrier_lock_fail = configuration->property(role + ".max_carrier_lock_fail", max_carrier_lock_fail);
     carrier_lock_th = configuration->property(role + ".carrier_lock_th", carrier_lock_th);
+    adaptive_integration = configuration->property(role + ".adaptive_integration", adaptive_integration);
+    adaptive_long_lock_th = configuration->property(role + ".adaptive_long_lock_th", adaptive_long_lock_th);
+    adaptive_short_lock_th = configuration->property(role + ".adaptive_short_lock_th", adaptive_short_lock_th);
+    if (adaptive_short_lock_th > adaptive_long_lock_th)
+        {
+            adaptive_short_lock_th = adaptive_long_lock_th;
+            LOG(WARNING) << "adaptive_short_lock_th must not be bigger than adaptive_long_lock_th. It has been set to " << adaptive_long_lock_th;
+        }
+    adaptive_weak_cn0_db_hz = configuration->property(role + ".adaptive_weak_cn0_db_hz", adaptive_weak_cn0_db_hz);
+    adaptive_dwell_ms = configuration->property(role + ".adaptive_dwell_ms", adaptive_dwell_ms);
+    loop_statistics = configuration->property(role + ".loop_statistics", loop_statistics);
+    integer_shift_correlator = configuration->property(role + ".integer_shift_correlator", integer_shift_correlator);
+    integer_shift_max_error_samples = configuration->property(role + ".integer_shift_max_error_samples", integer_shift_max_error_samples);
     carrier_aiding = configuration->property(role + ".carrier_aiding", carrier_aiding);
+    enable_kf_tracking = configuration->property(role + ".enable_kf_tracking", enable_kf_tracking);
+    kf_dynamics_psd = configuration->property(role + ".kf_dynamics_psd", kf_dynamics_psd);
+    kf_code_psd = configuration->property(role + ".kf_code_psd", kf_code_psd);
+    kf_doppler_rate_sigma_hz_s = configuration->property(role + ".kf_doppler_rate_sigma_hz_s", kf_doppler_rate_sigma_hz_s);
 
     // tracking lock tests smoother parameters
     cn0_smoother_samples = configuration->property(role + ".cn0_smoother_samples", cn0_smoother_samples);
@@ -38,12 +38,17 @@ public:
     bool enable_fll_steady_state;
     uint32_t pull_in_time_s;
     uint32_t bit_synchronization_time_limit_s;
+    int32_t reacquisition_time_ms;
+    int32_t reacquisition_doppler_bins;
+    float reacquisition_doppler_step_hz;
     int32_t pll_filter_order;
     int32_t dll_filter_order;
     double fs_in;
     uint32_t vector_length;
     bool dump;
     bool dump_mat;
+    bool dump_mat_compression;
+    bool dump_drop_records;
     std::string dump_filename;
     float pll_pull_in_bw_hz;
     float dll_pull_in_bw_hz;
@@ -61,8 +66,16 @@ public:
     float y_intercept;
     int32_t extend_correlation_symbols;
     bool carrier_aiding;
+    bool enable_kf_tracking;
+    double kf_dynamics_psd;
+    double kf_code_psd;
+    double kf_doppler_rate_sigma_hz_s;
     bool high_dyn;
+    bool batch_correlation;
+    int32_t batch_tile_samples;
+    int32_t batch_max_wait_us;
     std::string item_type;
+    int32_t accumulator_bits;
     int32_t cn0_samples;
     int32_t cn0_smoother_samples;
     float cn0_smoother_alpha;
@@ -75,6 +88,14 @@ public:
     double carrier_lock_th;
     bool track_pilot;
     bool enable_doppler_correction;
+    bool adaptive_integration;
+    float adaptive_long_lock_th;
+    float adaptive_short_lock_th;
+    float adaptive_weak_cn0_db_hz;
+    int32_t adaptive_dwell_ms;
+    bool loop_statistics;
+    bool integer_shift_correlator;
+    float integer_shift_max_error_samples;
     char system;
     char signal[3]{};
 };
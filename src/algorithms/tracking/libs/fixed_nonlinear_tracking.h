@@ -0,0 +1,351 @@
+/*!
+ * \file fixed_nonlinear_tracking.h
+ * \brief Cubature and Unscented Kalman filters with dimensions fixed at
+ * compile time, which do not allocate memory in their prediction and
+ * update steps
+ *
+ * The filters follow the same rules as CubatureFilter and UnscentedFilter
+ * in nonlinear_tracking.h, but all their matrices and workspaces are
+ * members with sizes known at compile time, and the arithmetic is done
+ * element by element instead of with Armadillo expressions, whose
+ * temporaries are allocated on the heap when they have more than
+ * arma::arma_config::mat_prealloc elements. The model functions write their
+ * output in place.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FIXED_NONLINEAR_TRACKING_H
+#define GNSS_SDR_FIXED_NONLINEAR_TRACKING_H
+
+#if ARMA_NO_BOUND_CHECKING
+#define ARMA_NO_DEBUG 1
+#endif
+
+#include <armadillo>
+#include <cmath>
+
+// Abstract model function, which writes its output in place
+template <arma::uword N_IN, arma::uword N_OUT>
+class FixedModelFunction
+{
+public:
+    virtual void operator()(const arma::vec::fixed<N_IN>& input, arma::vec::fixed<N_OUT>& output) = 0;
+    virtual ~FixedModelFunction() = default;
+};
+
+
+/*!
+ * \brief Sigma point Kalman filter with a state of NX elements and NZ
+ * measurements. The points are the mean plus and minus the columns of the
+ * Cholesky factor of the covariance, scaled, plus the mean itself if its
+ * weights are not zero.
+ */
+template <arma::uword NX, arma::uword NZ>
+class FixedSigmaPointFilter
+{
+public:
+    using vec_x = arma::vec::fixed<NX>;
+    using vec_z = arma::vec::fixed<NZ>;
+    using mat_xx = arma::mat::fixed<NX, NX>;
+    using mat_zz = arma::mat::fixed<NZ, NZ>;
+
+    // Reinitialization function
+    void initialize(const vec_x& x_pred_0, const mat_xx& P_x_pred_0)
+    {
+        d_x_pred = x_pred_0;
+        d_P_x_pred = P_x_pred_0;
+        d_x_est = x_pred_0;
+        d_P_x_est = P_x_pred_0;
+    }
+
+    /*!
+     * \brief Prediction step. Returns false, and keeps the last prediction,
+     * if P_x_post is not positive definite.
+     */
+    bool predict_sequential(const vec_x& x_post, const mat_xx& P_x_post, FixedModelFunction<NX, NX>* transition_fcn, const mat_xx& noise_covariance)
+    {
+        if (!cholesky_lower(P_x_post, d_S))
+            {
+                return false;
+            }
+        for (arma::uword i = 0; i < num_points(); i++)
+            {
+                sigma_point(x_post, i, d_point);
+                (*transition_fcn)(d_point, d_x_point);
+                d_X.col(i) = d_x_point;
+            }
+        weighted_mean(d_X, d_x_pred);
+        weighted_covariance(d_X, d_x_pred, d_X, d_x_pred, d_P_x_pred);
+        for (arma::uword n = 0; n < NX * NX; n++)
+            {
+                d_P_x_pred(n) += noise_covariance(n);
+            }
+        return true;
+    }
+
+    /*!
+     * \brief Update step. Returns false, and keeps the last estimation, if
+     * P_x_pred or the covariance of the predicted measurement are not
+     * positive definite.
+     */
+    bool update_sequential(const vec_z& z_upd, const vec_x& x_pred, const mat_xx& P_x_pred, FixedModelFunction<NX, NZ>* measurement_fcn, const mat_zz& noise_covariance)
+    {
+        if (!cholesky_lower(P_x_pred, d_S))
+            {
+                return false;
+            }
+        for (arma::uword i = 0; i < num_points(); i++)
+            {
+                sigma_point(x_pred, i, d_point);
+                d_X.col(i) = d_point;
+                (*measurement_fcn)(d_point, d_z_point);
+                d_Z.col(i) = d_z_point;
+            }
+        weighted_mean(d_Z, d_z_pred);
+        weighted_covariance(d_Z, d_z_pred, d_Z, d_z_pred, d_P_zz);
+        for (arma::uword n = 0; n < NZ * NZ; n++)
+            {
+                d_P_zz(n) += noise_covariance(n);
+            }
+        weighted_covariance(d_X, x_pred, d_Z, d_z_pred, d_P_xz);
+        if (!cholesky_lower(d_P_zz, d_S_zz))
+            {
+                return false;
+            }
+
+        // Kalman gain W = P_xz * inv(P_zz), solving W * L * L^T = P_xz row by row
+        for (arma::uword r = 0; r < NX; r++)
+            {
+                for (arma::uword c = 0; c < NZ; c++)
+                    {
+                        double sum = d_P_xz(r, c);
+                        for (arma::uword k = 0; k < c; k++)
+                            {
+                                sum -= d_W(r, k) * d_S_zz(c, k);
+                            }
+                        d_W(r, c) = sum / d_S_zz(c, c);
+                    }
+                for (arma::uword c = NZ; c-- > 0;)
+                    {
+                        double sum = d_W(r, c);
+                        for (arma::uword k = c + 1; k < NZ; k++)
+                            {
+                                sum -= d_W(r, k) * d_S_zz(k, c);
+                            }
+                        d_W(r, c) = sum / d_S_zz(c, c);
+                    }
+            }
+
+        // x_est = x_pred + W * (z_upd - z_pred)
+        for (arma::uword r = 0; r < NX; r++)
+            {
+                double sum = x_pred(r);
+                for (arma::uword c = 0; c < NZ; c++)
+                    {
+                        sum += d_W(r, c) * (z_upd(c) - d_z_pred(c));
+                    }
+                d_x_est(r) = sum;
+            }
+        // P_est = P_pred - W * P_zz * W^T = P_pred - W * P_xz^T
+        for (arma::uword r = 0; r < NX; r++)
+            {
+                for (arma::uword c = 0; c < NX; c++)
+                    {
+                        double sum = P_x_pred(r, c);
+                        for (arma::uword k = 0; k < NZ; k++)
+                            {
+                                sum -= d_W(r, k) * d_P_xz(c, k);
+                            }
+                        d_P_x_est(r, c) = sum;
+                    }
+            }
+        return true;
+    }
+
+    // Getters
+    const vec_x& get_x_pred() const { return d_x_pred; }
+    const mat_xx& get_P_x_pred() const { return d_P_x_pred; }
+    const vec_x& get_x_est() const { return d_x_est; }
+    const mat_xx& get_P_x_est() const { return d_P_x_est; }
+
+protected:
+    static constexpr arma::uword NP = 2 * NX + 1;  // the mean is the last point, skipped if its weights are zero
+
+    FixedSigmaPointFilter(double scale, double w0_m, double w0_c, double wi)
+        : d_scale(scale), d_w0_m(w0_m), d_w0_c(w0_c), d_wi(wi)
+    {
+        d_x_pred.zeros();
+        d_P_x_pred.eye();
+        d_P_x_pred *= static_cast<double>(NX + 1);
+        d_x_est = d_x_pred;
+        d_P_x_est = d_P_x_pred;
+    }
+
+    ~FixedSigmaPointFilter() = default;
+
+private:
+    // Lower Cholesky factor of a symmetric matrix. Returns false if it is not positive definite.
+    template <arma::uword N>
+    static bool cholesky_lower(const arma::mat::fixed<N, N>& A, arma::mat::fixed<N, N>& L)
+    {
+        for (arma::uword c = 0; c < N; c++)
+            {
+                for (arma::uword r = 0; r < c; r++)
+                    {
+                        L(r, c) = 0.0;
+                    }
+                double diag = A(c, c);
+                for (arma::uword k = 0; k < c; k++)
+                    {
+                        diag -= L(c, k) * L(c, k);
+                    }
+                if (!(diag > 0.0))
+                    {
+                        return false;
+                    }
+                L(c, c) = std::sqrt(diag);
+                for (arma::uword r = c + 1; r < N; r++)
+                    {
+                        double sum = A(r, c);
+                        for (arma::uword k = 0; k < c; k++)
+                            {
+                                sum -= L(r, k) * L(c, k);
+                            }
+                        L(r, c) = sum / L(c, c);
+                    }
+            }
+        return true;
+    }
+
+    void sigma_point(const vec_x& mean, arma::uword i, vec_x& point) const
+    {
+        point = mean;
+        if (i == NP - 1)
+            {
+                return;
+            }
+        const double sign = i < NX ? d_scale : -d_scale;
+        const arma::uword col = i % NX;
+        for (arma::uword r = col; r < NX; r++)
+            {
+                point(r) += sign * d_S(r, col);
+            }
+    }
+
+    bool use_mean_point() const { return d_w0_m != 0.0 or d_w0_c != 0.0; }
+    arma::uword num_points() const { return use_mean_point() ? NP : NP - 1; }
+
+    template <arma::uword N>
+    void weighted_mean(const arma::mat::fixed<N, NP>& points, arma::vec::fixed<N>& mean) const
+    {
+        for (arma::uword r = 0; r < N; r++)
+            {
+                double sum = 0.0;
+                for (arma::uword i = 0; i < NP - 1; i++)
+                    {
+                        sum += points(r, i);
+                    }
+                mean(r) = d_wi * sum;
+                if (use_mean_point())
+                    {
+                        mean(r) += d_w0_m * points(r, NP - 1);
+                    }
+            }
+    }
+
+    template <arma::uword NA, arma::uword NB>
+    void weighted_covariance(const arma::mat::fixed<NA, NP>& a, const arma::vec::fixed<NA>& a_mean,
+        const arma::mat::fixed<NB, NP>& b, const arma::vec::fixed<NB>& b_mean,
+        arma::mat::fixed<NA, NB>& cov) const
+    {
+        for (arma::uword r = 0; r < NA; r++)
+            {
+                for (arma::uword c = 0; c < NB; c++)
+                    {
+                        double sum = 0.0;
+                        for (arma::uword i = 0; i < NP - 1; i++)
+                            {
+                                sum += (a(r, i) - a_mean(r)) * (b(c, i) - b_mean(c));
+                            }
+                        cov(r, c) = d_wi * sum;
+                        if (use_mean_point())
+                            {
+                                cov(r, c) += d_w0_c * (a(r, NP - 1) - a_mean(r)) * (b(c, NP - 1) - b_mean(c));
+                            }
+                    }
+            }
+    }
+
+    // Estimations
+    vec_x d_x_pred;
+    mat_xx d_P_x_pred;
+    vec_x d_x_est;
+    mat_xx d_P_x_est;
+
+    // Workspaces
+    mat_xx d_S;
+    mat_zz d_S_zz;
+    arma::mat::fixed<NX, NP> d_X;
+    arma::mat::fixed<NZ, NP> d_Z;
+    vec_x d_point;
+    vec_x d_x_point;
+    vec_z d_z_point;
+    vec_z d_z_pred;
+    mat_zz d_P_zz;
+    arma::mat::fixed<NX, NZ> d_P_xz;
+    arma::mat::fixed<NX, NZ> d_W;
+
+    // Sigma point rule
+    double d_scale;
+    double d_w0_m;
+    double d_w0_c;
+    double d_wi;
+};
+
+
+/*!
+ * \brief Cubature Kalman filter: 2 * NX points with equal weights
+ */
+template <arma::uword NX, arma::uword NZ>
+class FixedCubatureFilter : public FixedSigmaPointFilter<NX, NZ>
+{
+public:
+    FixedCubatureFilter() : FixedSigmaPointFilter<NX, NZ>(std::sqrt(static_cast<double>(NX)), 0.0, 0.0, 1.0 / static_cast<double>(2 * NX)) {}
+    ~FixedCubatureFilter() = default;
+};
+
+
+/*!
+ * \brief Unscented Kalman filter with the same parameters as UnscentedFilter
+ * (alpha = 0.001, beta = 2, kappa = 0)
+ */
+template <arma::uword NX, arma::uword NZ>
+class FixedUnscentedFilter : public FixedSigmaPointFilter<NX, NZ>
+{
+public:
+    FixedUnscentedFilter() : FixedSigmaPointFilter<NX, NZ>(std::sqrt(static_cast<double>(NX) + lambda()),
+                                 lambda() / (static_cast<double>(NX) + lambda()),
+                                 lambda() / (static_cast<double>(NX) + lambda()) + (1.0 - ALPHA * ALPHA + BETA),
+                                 1.0 / (2.0 * (static_cast<double>(NX) + lambda()))) {}
+    ~FixedUnscentedFilter() = default;
+
+private:
+    static constexpr double ALPHA = 0.001;
+    static constexpr double BETA = 2.0;
+    static constexpr double KAPPA = 0.0;
+    static constexpr double lambda() { return ALPHA * ALPHA * (static_cast<double>(NX) + KAPPA) - static_cast<double>(NX); }
+};
+
+#endif  // GNSS_SDR_FIXED_NONLINEAR_TRACKING_H
@@ -0,0 +1,69 @@
+/*!
+ * \file integration_scheduler.cc
+ * \brief Class that decides the coherent integration length of a tracking
+ * channel from its lock detectors
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "integration_scheduler.h"
+
+
+Integration_Scheduler::Integration_Scheduler()
+{
+    d_dwell_s = 0.0;
+    d_long_lock_th = 0.9;
+    d_short_lock_th = 0.8;
+    d_weak_cn0_db_hz = 32.0;
+    d_dwell_ms = 1000;
+}
+
+
+void Integration_Scheduler::set_params(float long_lock_th, float short_lock_th, float weak_cn0_db_hz, int32_t dwell_ms)
+{
+    d_long_lock_th = long_lock_th;
+    d_short_lock_th = short_lock_th;
+    d_weak_cn0_db_hz = weak_cn0_db_hz;
+    d_dwell_ms = dwell_ms;
+    reset();
+}
+
+
+void Integration_Scheduler::reset()
+{
+    d_dwell_s = 0.0;
+}
+
+
+bool Integration_Scheduler::update(bool long_integration, double carrier_lock_test, double cn0_db_hz, double integration_time_s, bool bit_aligned)
+{
+    const double lock_th = long_integration ? d_short_lock_th : d_long_lock_th;
+    const bool want_long = carrier_lock_test >= lock_th or cn0_db_hz < d_weak_cn0_db_hz;
+    if (want_long == long_integration)
+        {
+            d_dwell_s = 0.0;
+            return false;
+        }
+    d_dwell_s += integration_time_s;
+    if (d_dwell_s * 1000.0 < static_cast<double>(d_dwell_ms))
+        {
+            return false;
+        }
+    if (want_long and !bit_aligned)
+        {
+            return false;  // wait for the alignment with the bits
+        }
+    d_dwell_s = 0.0;
+    return true;
+}
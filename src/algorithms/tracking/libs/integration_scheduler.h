@@ -0,0 +1,62 @@
+/*!
+ * \file integration_scheduler.h
+ * \brief Class that decides the coherent integration length of a tracking
+ * channel from its lock detectors
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_INTEGRATION_SCHEDULER_H
+#define GNSS_SDR_INTEGRATION_SCHEDULER_H
+
+#include <cstdint>
+
+/*! \brief
+ * Class that decides, after each loop update, whether a tracking channel
+ * switches between the short and the long coherent integration.
+ *
+ * The long integration is wanted while the carrier lock test shows a stable
+ * loop, with a lower threshold to keep it than to start it, or while the CN0
+ * is too low for the short one. A change must be wanted during dwell_ms, and
+ * the long integration only starts aligned with the bits.
+ */
+class Integration_Scheduler
+{
+public:
+    Integration_Scheduler();  //!< Constructor
+    ~Integration_Scheduler() = default;
+
+    void set_params(float long_lock_th, float short_lock_th, float weak_cn0_db_hz, int32_t dwell_ms);
+
+    /*!
+     * \brief Forgets the time a change has been wanted
+     */
+    void reset();
+
+    /*!
+     * \brief Returns true if the channel must switch to the other integration
+     * after this loop update of integration_time_s seconds
+     */
+    bool update(bool long_integration, double carrier_lock_test, double cn0_db_hz, double integration_time_s, bool bit_aligned);
+
+private:
+    double d_dwell_s;
+    float d_long_lock_th;
+    float d_short_lock_th;
+    float d_weak_cn0_db_hz;
+    int32_t d_dwell_ms;
+};
+
+#endif  // GNSS_SDR_INTEGRATION_SCHEDULER_H
@@ -0,0 +1,195 @@
+/*!
+ * \file reacquisition_search.cc
+ * \brief Class that searches a lost satellite around the retained state of
+ * its tracking loops
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "reacquisition_search.h"
+#include <boost/math/special_functions/gamma.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+constexpr int32_t NOISE_EPOCHS = 1000;  // epochs of the noise power average
+
+
+Reacquisition_Search::Reacquisition_Search()
+{
+    d_fs_in = 1.0;
+    d_code_period_s = 0.001;
+    d_doppler_hz = 0.0;
+    d_doppler_rate_hz_s = 0.0;
+    d_rate_doppler_hz = 0.0;
+    d_noise_power = 0.0;
+    d_energy = 0.0;
+    d_threshold = 0.0;
+    d_sample_stamp = 0ULL;
+    d_rate_sample_stamp = 0ULL;
+    d_deadline = 0ULL;
+    d_start_sample = 0ULL;
+    d_doppler_step_hz = 50.0;
+    d_cn0_min_db_hz = 25.0;
+    d_cn0_db_hz = 0.0;
+    d_time_ms = 0;
+    d_doppler_bins = 5;
+    d_cn0_samples = 20;
+    d_bin = 0;
+    d_dwell_count = 0;
+    d_noise_count = 0;
+    d_rate_valid = false;
+}
+
+
+void Reacquisition_Search::set_params(double fs_in, int32_t time_ms, int32_t doppler_bins, float doppler_step_hz, int32_t cn0_samples, float cn0_min_db_hz, double code_period_s)
+{
+    d_fs_in = fs_in;
+    d_time_ms = time_ms;
+    d_doppler_bins = std::max(doppler_bins, 1);
+    d_doppler_step_hz = doppler_step_hz;
+    d_cn0_samples = std::max(cn0_samples, 1);
+    d_cn0_min_db_hz = cn0_min_db_hz;
+    d_code_period_s = code_period_s;
+    // Without signal, the energy of a bin normalized by the noise power
+    // follows a Gamma(cn0_samples, 1) distribution. A bin must also reach
+    // cn0_min, whose expected energy is cn0_samples * (1 + CN0 * T).
+    const double cn0_min = std::pow(10.0, static_cast<double>(d_cn0_min_db_hz) / 10.0);
+    d_threshold = std::max(boost::math::gamma_q_inv(static_cast<double>(d_cn0_samples), PFA),
+        static_cast<double>(d_cn0_samples) * (1.0 + cn0_min * d_code_period_s));
+}
+
+
+void Reacquisition_Search::reset(double doppler_hz, uint64_t sample_counter)
+{
+    d_doppler_hz = doppler_hz;
+    d_doppler_rate_hz_s = 0.0;
+    d_sample_stamp = sample_counter;
+    d_rate_sample_stamp = 0ULL;
+    d_rate_valid = false;
+    d_noise_power = 0.0;
+    d_noise_count = 0;
+    stop();
+}
+
+
+void Reacquisition_Search::retain(double doppler_hz, uint64_t sample_counter, const gr_complex* prompt_buffer, int32_t length, double integration_time_s)
+{
+    if (length > 0 and integration_time_s > 0.0)
+        {
+            // The signal lies in the in-phase component of a locked loop, so the
+            // quadrature component holds half of the noise power
+            double q_power = 0.0;
+            for (int32_t n = 0; n < length; n++)
+                {
+                    q_power += static_cast<double>(prompt_buffer[n].imag()) * static_cast<double>(prompt_buffer[n].imag());
+                }
+            const double noise_power = 2.0 * q_power / static_cast<double>(length) * d_code_period_s / integration_time_s;
+            // average of the epochs since the start of the tracking, then
+            // exponential with the same weight
+            d_noise_count = std::min(d_noise_count + 1, NOISE_EPOCHS);
+            d_noise_power += (noise_power - d_noise_power) / static_cast<double>(d_noise_count);
+        }
+    d_doppler_hz = doppler_hz;
+    d_sample_stamp = sample_counter;
+    if (!d_rate_valid)
+        {
+            d_rate_valid = true;
+            d_doppler_rate_hz_s = 0.0;
+            d_rate_doppler_hz = doppler_hz;
+            d_rate_sample_stamp = sample_counter;
+            return;
+        }
+    const double elapsed_s = static_cast<double>(sample_counter - d_rate_sample_stamp) / d_fs_in;
+    if (elapsed_s >= 1.0)
+        {
+            d_doppler_rate_hz_s = (doppler_hz - d_rate_doppler_hz) / elapsed_s;
+            d_rate_doppler_hz = doppler_hz;
+            d_rate_sample_stamp = sample_counter;
+        }
+}
+
+
+bool Reacquisition_Search::start(uint64_t sample_counter)
+{
+    if (d_time_ms <= 0 or d_noise_power <= 0.0)
+        {
+            return false;
+        }
+    if (d_deadline == 0ULL)
+        {
+            d_deadline = sample_counter + static_cast<uint64_t>(static_cast<double>(d_time_ms) * d_fs_in / 1000.0);
+            d_start_sample = sample_counter;
+        }
+    if (sample_counter >= d_deadline)
+        {
+            return false;
+        }
+    d_bin = 0;
+    d_dwell_count = 0;
+    d_energy = 0.0;
+    return true;
+}
+
+
+void Reacquisition_Search::stop()
+{
+    d_deadline = 0ULL;
+    d_start_sample = 0ULL;
+}
+
+
+Reacquisition_Search::Result Reacquisition_Search::step(const gr_complex& prompt, uint64_t sample_counter)
+{
+    d_energy += static_cast<double>(std::norm(prompt));
+    d_dwell_count++;
+    if (d_dwell_count == d_cn0_samples)
+        {
+            const double energy = d_energy / d_noise_power;
+            d_dwell_count = 0;
+            d_energy = 0.0;
+            const double snr = (energy / static_cast<double>(d_cn0_samples) - 1.0) / d_code_period_s;
+            d_cn0_db_hz = snr > 0.0 ? static_cast<float>(10.0 * std::log10(snr)) : 0.0F;
+            if (energy >= d_threshold)
+                {
+                    return Result::reacquired;
+                }
+            d_bin = (d_bin + 1) % d_doppler_bins;
+        }
+    if (sample_counter >= d_deadline)
+        {
+            return Result::expired;
+        }
+    return Result::searching;
+}
+
+
+double Reacquisition_Search::retained_doppler_hz(uint64_t sample_counter) const
+{
+    const double elapsed_s = (static_cast<double>(sample_counter) - static_cast<double>(d_sample_stamp)) / d_fs_in;
+    return d_doppler_hz + d_doppler_rate_hz_s * elapsed_s;
+}
+
+
+double Reacquisition_Search::doppler_hz(uint64_t sample_counter) const
+{
+    const int32_t bin_offset = (d_bin % 2 == 1) ? (d_bin + 1) / 2 : -(d_bin / 2);
+    return retained_doppler_hz(sample_counter) + static_cast<double>(bin_offset) * static_cast<double>(d_doppler_step_hz);
+}
+
+
+double Reacquisition_Search::elapsed_ms(uint64_t sample_counter) const
+{
+    return 1000.0 * static_cast<double>(sample_counter - d_start_sample) / d_fs_in;
+}
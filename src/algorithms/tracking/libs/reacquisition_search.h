@@ -0,0 +1,123 @@
+/*!
+ * \file reacquisition_search.h
+ * \brief Class that searches a lost satellite around the retained state of
+ * its tracking loops
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_REACQUISITION_SEARCH_H
+#define GNSS_SDR_REACQUISITION_SEARCH_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstdint>
+
+/*! \brief
+ * Class that searches a lost satellite around the retained state of its
+ * tracking loops.
+ *
+ * The tracking retains the Doppler of the last epoch with both lock detectors
+ * clear, a Doppler rate measured over intervals of at least one second, and
+ * the noise power of the prompt correlator, from its quadrature component.
+ * After a loss of lock, the Doppler is propagated with that rate and a few
+ * bins around it are visited from the center outwards: 0, +1, -1, +2, -2, ...
+ * Each bin is integrated noncoherently during cn0_samples code periods. The
+ * first one above the threshold for a probability of false alarm PFA, and
+ * with a CN0 estimate of at least cn0_min, reacquires the satellite. The
+ * search gives up time_ms after the first loss of lock, until stop() is
+ * called.
+ */
+class Reacquisition_Search
+{
+public:
+    enum class Result
+    {
+        searching,
+        reacquired,
+        expired
+    };
+
+    Reacquisition_Search();  //!< Constructor
+    ~Reacquisition_Search() = default;
+
+    void set_params(double fs_in, int32_t time_ms, int32_t doppler_bins, float doppler_step_hz, int32_t cn0_samples, float cn0_min_db_hz, double code_period_s);
+
+    /*!
+     * \brief Forgets the retained state, at the start of a new tracking with
+     * the Doppler of the acquisition
+     */
+    void reset(double doppler_hz, uint64_t sample_counter);
+
+    /*!
+     * \brief Retains the Doppler of an epoch with both lock detectors clear,
+     * and the noise power of the last length prompt correlator outputs, each
+     * integrated during integration_time_s seconds
+     */
+    void retain(double doppler_hz, uint64_t sample_counter, const gr_complex* prompt_buffer, int32_t length, double integration_time_s);
+
+    /*!
+     * \brief Starts the search from the center bin after a loss of lock.
+     * Returns false if the search is disabled, its time limit is reached or
+     * no noise power was retained
+     */
+    bool start(uint64_t sample_counter);
+
+    /*!
+     * \brief Ends the search: the tracking has resumed, or the satellite is
+     * released. The next loss of lock gets a new time limit
+     */
+    void stop();
+
+    /*!
+     * \brief Integrates the prompt correlator output of one code period
+     */
+    Result step(const gr_complex& prompt, uint64_t sample_counter);
+
+    bool active() const { return d_deadline != 0ULL; }          //!< A search started and was not stopped
+    double doppler_hz(uint64_t sample_counter) const;           //!< Doppler of the current bin
+    double retained_doppler_hz(uint64_t sample_counter) const;  //!< Retained Doppler, propagated with the Doppler rate
+    double elapsed_ms(uint64_t sample_counter) const;           //!< Time since the first loss of lock
+    int32_t bin() const { return d_bin; }                       //!< Index of the current bin
+    float cn0_db_hz() const { return d_cn0_db_hz; }             //!< CN0 estimate of the last complete bin
+    double noise_power() const { return d_noise_power; }        //!< Retained noise power of one code period
+
+    static constexpr double PFA = 1e-4;  //!< Probability of false alarm of each bin
+
+private:
+    double d_fs_in;
+    double d_code_period_s;
+    double d_doppler_hz;
+    double d_doppler_rate_hz_s;
+    double d_rate_doppler_hz;
+    double d_noise_power;
+    double d_energy;     // noncoherent sum of the current bin
+    double d_threshold;  // of d_energy normalized by the noise power
+    uint64_t d_sample_stamp;
+    uint64_t d_rate_sample_stamp;
+    uint64_t d_deadline;  // sample count at which the satellite is given up, 0 if not searching
+    uint64_t d_start_sample;
+    float d_doppler_step_hz;
+    float d_cn0_min_db_hz;
+    float d_cn0_db_hz;
+    int32_t d_time_ms;
+    int32_t d_doppler_bins;
+    int32_t d_cn0_samples;
+    int32_t d_bin;
+    int32_t d_dwell_count;
+    int32_t d_noise_count;
+    bool d_rate_valid;
+};
+
+#endif  // GNSS_SDR_REACQUISITION_SEARCH_H
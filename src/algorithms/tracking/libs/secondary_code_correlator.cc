@@ -0,0 +1,148 @@
+/*!
+ * \file secondary_code_correlator.cc
+ * \brief Class that correlates the signs of the prompt correlator outputs
+ * with a secondary code or preamble, using bit-packed words.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "secondary_code_correlator.h"
+#include <algorithm>
+#include <bitset>
+
+
+void Secondary_Code_Correlator::set_code(const std::string& code)
+{
+    code_string_ = code;
+    length_ = static_cast<uint32_t>(code.size());
+    words_ = (length_ + 63U) / 64U;
+    code_ = std::vector<uint64_t>(words_, 0ULL);
+    pack(code, 0U, code_.data());
+    shifts_.clear();
+    signs_ = std::vector<uint64_t>(words_, 0ULL);
+    size_ = 0U;
+}
+
+
+void Secondary_Code_Correlator::clear()
+{
+    std::fill(signs_.begin(), signs_.end(), 0ULL);
+    size_ = 0U;
+}
+
+
+void Secondary_Code_Correlator::push_back(float symbol)
+{
+    if (length_ == 0U)
+        {
+            return;
+        }
+    uint32_t position = size_;
+    if (size_ < length_)
+        {
+            size_++;
+        }
+    else
+        {
+            // Drop the oldest symbol by shifting the window one position
+            for (uint32_t w = 0; w + 1 < words_; w++)
+                {
+                    signs_[w] = (signs_[w] >> 1U) | (signs_[w + 1] << 63U);
+                }
+            signs_[words_ - 1] >>= 1U;
+            position = length_ - 1U;
+        }
+    if (symbol < 0.0)
+        {
+            signs_[position / 64U] |= (1ULL << (position % 64U));
+        }
+}
+
+
+int32_t Secondary_Code_Correlator::correlation() const
+{
+    return correlation(code_.data());
+}
+
+
+int32_t Secondary_Code_Correlator::correlation(uint32_t offset) const
+{
+    if (length_ == 0U)
+        {
+            return 0;
+        }
+    offset %= length_;
+    if (offset == 0U)
+        {
+            return correlation(code_.data());
+        }
+    if (shifts_.empty())
+        {
+            shifts_ = std::vector<uint64_t>(static_cast<size_t>(length_) * words_, 0ULL);
+            for (uint32_t k = 0; k < length_; k++)
+                {
+                    pack(code_string_, k, &shifts_[static_cast<size_t>(k) * words_]);
+                }
+        }
+    return correlation(&shifts_[static_cast<size_t>(offset) * words_]);
+}
+
+
+bool Secondary_Code_Correlator::find_offset(uint32_t& offset) const
+{
+    if (!full())
+        {
+            return false;
+        }
+    for (uint32_t k = 0; k < length_; k++)
+        {
+            if (static_cast<uint32_t>(std::abs(correlation(k))) == length_)
+                {
+                    offset = k;
+                    return true;
+                }
+        }
+    return false;
+}
+
+
+void Secondary_Code_Correlator::pack(const std::string& code, uint32_t offset, uint64_t* words) const
+{
+    for (uint32_t i = 0; i < length_; i++)
+        {
+            if (code[(i + offset) % length_] == '0')
+                {
+                    words[i / 64U] |= (1ULL << (i % 64U));
+                }
+        }
+}
+
+
+int32_t Secondary_Code_Correlator::correlation(const uint64_t* code_words) const
+{
+    // Only the symbols in the window contribute; a missing symbol is a zero
+    uint32_t mismatches = 0U;
+    uint32_t valid = size_;
+    for (uint32_t w = 0; w < words_ and valid > 0U; w++)
+        {
+            uint64_t mask = ~0ULL;
+            if (valid < 64U)
+                {
+                    mask = (1ULL << valid) - 1ULL;
+                }
+            mismatches += static_cast<uint32_t>(std::bitset<64>((signs_[w] ^ code_words[w]) & mask).count());
+            valid -= std::min(valid, 64U);
+        }
+    return static_cast<int32_t>(size_) - 2 * static_cast<int32_t>(mismatches);
+}
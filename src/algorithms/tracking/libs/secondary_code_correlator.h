@@ -0,0 +1,102 @@
+/*!
+ * \file secondary_code_correlator.h
+ * \brief Class that correlates the signs of the prompt correlator outputs
+ * with a secondary code or preamble, using bit-packed words.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SECONDARY_CODE_CORRELATOR_H
+#define GNSS_SDR_SECONDARY_CODE_CORRELATOR_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*! \brief
+ * Class that keeps the signs of the last symbols in a bit-packed shift
+ * register and correlates them with a secondary code or preamble.
+ *
+ * Each new symbol is shifted into the register in a few word operations, and
+ * the correlation with the code is computed with one XOR and one population
+ * count per 64 symbols, instead of one comparison per symbol. The same words
+ * give the correlation of the window with every cyclic shift of the code,
+ * which finds the code phase of the last symbols at once.
+ *
+ * A symbol with a negative real part matches a '0' of the code, following
+ * the convention of the secondary code strings.
+ */
+class Secondary_Code_Correlator
+{
+public:
+    Secondary_Code_Correlator() = default;
+    ~Secondary_Code_Correlator() = default;
+
+    /*!
+     * \brief Sets the code, given as a string of '0' and '1', and clears the symbols.
+     */
+    void set_code(const std::string& code);
+
+    /*!
+     * \brief Removes all the symbols.
+     */
+    void clear();
+
+    /*!
+     * \brief Adds the sign of a new symbol, dropping the oldest one if the window is full.
+     */
+    void push_back(float symbol);
+
+    inline uint32_t length() const { return length_; }            //!< Code length
+    inline uint32_t size() const { return size_; }                //!< Symbols in the window
+    inline bool full() const { return length_ > 0 and size_ == length_; }  //!< True if there are as many symbols as code chips
+
+    /*!
+     * \brief Correlation of the window with the code, aligning the oldest
+     * symbol with the first chip. It ranges from -length() to length().
+     */
+    int32_t correlation() const;
+
+    /*!
+     * \brief Correlation of the window with the code cyclically shifted by
+     * offset chips, so that the oldest symbol is aligned with chip offset.
+     */
+    int32_t correlation(uint32_t offset) const;
+
+    /*!
+     * \brief Returns true if the window matches the code or its inverse.
+     */
+    inline bool locked() const { return full() and static_cast<uint32_t>(std::abs(correlation())) == length_; }
+
+    /*!
+     * \brief Searches all the cyclic shifts of the code. Returns true if the
+     * window matches (or matches the inverse of) the code shifted by offset chips.
+     */
+    bool find_offset(uint32_t& offset) const;
+
+private:
+    void pack(const std::string& code, uint32_t offset, uint64_t* words) const;
+    int32_t correlation(const uint64_t* code_words) const;
+
+    std::vector<uint64_t> signs_;           // bit i is set if the i-th oldest symbol is negative
+    std::vector<uint64_t> code_;            // bit i is set if chip i is '0'
+    mutable std::vector<uint64_t> shifts_;  // code_ cyclically shifted by all the offsets, computed on first use
+    std::string code_string_;
+    uint32_t length_{0};
+    uint32_t size_{0};
+    uint32_t words_{0};
+};
+
+#endif  // GNSS_SDR_SECONDARY_CODE_CORRELATOR_H
@@ -0,0 +1,147 @@
+/*!
+ * \file tracking_KF_filter.cc
+ * \brief Implementation of a joint carrier and code Kalman filter for the
+ * tracking loops, with fixed-size matrices
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "tracking_KF_filter.h"
+
+// The products of 4x4 matrices must fit in the local memory of the temporaries
+static_assert(arma::arma_config::mat_prealloc >= 16, "Armadillo would allocate the temporaries of the Kalman filter");
+
+
+Tracking_KF_filter::Tracking_KF_filter() : d_dynamics_psd(20.0),
+                                           d_code_psd(1e-4),
+                                           d_phase_correction_cycles(0.0),
+                                           d_code_correction_chips(0.0)
+{
+    d_x.zeros();
+    d_P.zeros();
+    d_F.eye();
+    d_Q.zeros();
+    d_H.zeros();
+    d_H(0, 0) = 1.0;  // carrier phase discriminator
+    d_H(1, 3) = 1.0;  // code phase discriminator
+    d_S_inv.zeros();
+    d_K.zeros();
+    d_innovation.zeros();
+}
+
+
+void Tracking_KF_filter::set_params(double dynamics_psd, double code_psd)
+{
+    d_dynamics_psd = dynamics_psd;
+    d_code_psd = code_psd;
+}
+
+
+void Tracking_KF_filter::initialize(double doppler_hz, double phase_sigma2, double doppler_sigma2, double doppler_rate_sigma2, double code_sigma2)
+{
+    d_x.zeros();
+    d_x(1) = doppler_hz;
+    d_P.zeros();
+    d_P(0, 0) = phase_sigma2;
+    d_P(1, 1) = doppler_sigma2;
+    d_P(2, 2) = doppler_rate_sigma2;
+    d_P(3, 3) = code_sigma2;
+    d_phase_correction_cycles = 0.0;
+    d_code_correction_chips = 0.0;
+}
+
+
+void Tracking_KF_filter::update(double phase_error_cycles, double code_error_chips,
+    double phase_sigma2, double code_sigma2,
+    double T_s, double code_carrier_ratio)
+{
+    const double T2 = T_s * T_s;
+    const double T3 = T2 * T_s;
+
+    // Errors of the NCOs after an integration. The carrier NCO runs at the
+    // estimated Doppler, and the code NCO at the Doppler scaled to the code
+    // rate, so the errors grow with the errors of the Doppler and its rate.
+    d_F(0, 1) = T_s;
+    d_F(0, 2) = 0.5 * T2;
+    d_F(1, 2) = T_s;
+    d_F(3, 1) = -code_carrier_ratio * T_s;
+    d_F(3, 2) = -0.5 * code_carrier_ratio * T2;
+
+    // White noise in the Doppler rate changes, plus code noise
+    const double q = d_dynamics_psd;
+    d_Q(0, 0) = q * T3 * T2 / 20.0;
+    d_Q(0, 1) = q * T2 * T2 / 8.0;
+    d_Q(0, 2) = q * T3 / 6.0;
+    d_Q(1, 1) = q * T3 / 3.0;
+    d_Q(1, 2) = q * T2 / 2.0;
+    d_Q(2, 2) = q * T_s;
+    // The code phase follows the carrier phase, scaled and with opposite sign
+    d_Q(3, 0) = -code_carrier_ratio * d_Q(0, 0);
+    d_Q(3, 1) = -code_carrier_ratio * d_Q(0, 1);
+    d_Q(3, 2) = -code_carrier_ratio * d_Q(0, 2);
+    d_Q(3, 3) = code_carrier_ratio * code_carrier_ratio * d_Q(0, 0) + d_code_psd * T_s;
+    d_Q(1, 0) = d_Q(0, 1);
+    d_Q(2, 0) = d_Q(0, 2);
+    d_Q(2, 1) = d_Q(1, 2);
+    d_Q(0, 3) = d_Q(3, 0);
+    d_Q(1, 3) = d_Q(3, 1);
+    d_Q(2, 3) = d_Q(3, 2);
+
+    // Prediction. The phase errors were removed from the NCOs by the last update.
+    const double doppler_rate_hz_s = d_x(2);
+    d_x(0) = 0.5 * doppler_rate_hz_s * T2;
+    d_x(1) += doppler_rate_hz_s * T_s;
+    d_x(3) = -0.5 * code_carrier_ratio * doppler_rate_hz_s * T2;
+    d_P = d_F * d_P * d_F.t() + d_Q;
+
+    // Update with the two discriminators
+    const double s00 = d_P(0, 0) + phase_sigma2;
+    const double s01 = d_P(0, 3);
+    const double s11 = d_P(3, 3) + code_sigma2;
+    const double det = s00 * s11 - s01 * s01;
+    if (det <= 0.0)
+        {
+            // Degenerated covariance, keep the prediction
+            d_phase_correction_cycles = d_x(0);
+            d_code_correction_chips = d_x(3);
+            d_x(0) = 0.0;
+            d_x(3) = 0.0;
+            return;
+        }
+    d_S_inv(0, 0) = s11 / det;
+    d_S_inv(0, 1) = -s01 / det;
+    d_S_inv(1, 0) = -s01 / det;
+    d_S_inv(1, 1) = s00 / det;
+    d_K = d_P * d_H.t() * d_S_inv;
+    d_innovation(0) = phase_error_cycles - d_x(0);
+    d_innovation(1) = code_error_chips - d_x(3);
+    d_x += d_K * d_innovation;
+    d_P -= d_K * d_H * d_P;
+    // Keep the covariance symmetric against rounding errors
+    for (arma::uword i = 0; i < 4; i++)
+        {
+            for (arma::uword j = i + 1; j < 4; j++)
+                {
+                    const double p = 0.5 * (d_P(i, j) + d_P(j, i));
+                    d_P(i, j) = p;
+                    d_P(j, i) = p;
+                }
+        }
+
+    // The caller moves its NCOs by the estimated errors
+    d_phase_correction_cycles = d_x(0);
+    d_code_correction_chips = d_x(3);
+    d_x(0) = 0.0;
+    d_x(3) = 0.0;
+}
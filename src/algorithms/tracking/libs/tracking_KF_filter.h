@@ -0,0 +1,99 @@
+/*!
+ * \file tracking_KF_filter.h
+ * \brief Interface of a joint carrier and code Kalman filter for the
+ * tracking loops, with fixed-size matrices
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TRACKING_KF_FILTER_H
+#define GNSS_SDR_TRACKING_KF_FILTER_H
+
+#if ARMA_NO_BOUND_CHECKING
+#define ARMA_NO_DEBUG 1
+#endif
+
+#include <armadillo>
+
+/*!
+ * \brief Kalman filter that replaces the PLL and DLL loop filters.
+ *
+ * The state is the carrier phase error [cycles], the carrier Doppler [Hz],
+ * the carrier Doppler rate [Hz/s] and the code phase error [chips], where
+ * the errors are the ones of the NCOs driven by the filter. The
+ * measurements are the outputs of the PLL and DLL discriminators, with
+ * variances that the caller derives from the C/N0 estimation, so the
+ * bandwidth of the loop adapts to the signal quality. The code NCO is
+ * always aided by the carrier Doppler.
+ *
+ * All the matrices have a size fixed at compile time and small enough for
+ * Armadillo to keep the temporaries of the products in local memory, so
+ * update() does not allocate.
+ */
+class Tracking_KF_filter
+{
+public:
+    Tracking_KF_filter();
+    ~Tracking_KF_filter() = default;
+
+    /*!
+     * \brief Sets the power spectral densities of the Doppler rate changes
+     * [Hz^2/s^3] and of the code phase changes not explained by the carrier
+     * Doppler [chips^2/s].
+     */
+    void set_params(double dynamics_psd, double code_psd);
+
+    /*!
+     * \brief Starts from a Doppler estimation, with the given variances of
+     * the carrier phase [cycles^2], Doppler [Hz^2], Doppler rate [Hz^2/s^2]
+     * and code phase [chips^2].
+     */
+    void initialize(double doppler_hz, double phase_sigma2, double doppler_sigma2, double doppler_rate_sigma2, double code_sigma2);
+
+    /*!
+     * \brief Propagates the state over an integration of T_s seconds and
+     * updates it with the discriminator outputs and their variances.
+     * code_carrier_ratio is the ratio of the code chip rate to the carrier
+     * frequency.
+     */
+    void update(double phase_error_cycles, double code_error_chips,
+        double phase_sigma2, double code_sigma2,
+        double T_s, double code_carrier_ratio);
+
+    inline double get_doppler_hz() const { return d_x(1); }
+    inline double get_doppler_rate_hz_s() const { return d_x(2); }
+
+    /*!
+     * \brief Carrier phase [cycles] and code phase [chips] errors estimated
+     * by the last update, which the caller must remove from its NCOs.
+     */
+    inline double get_phase_correction_cycles() const { return d_phase_correction_cycles; }
+    inline double get_code_correction_chips() const { return d_code_correction_chips; }
+
+private:
+    arma::vec::fixed<4> d_x;
+    arma::mat::fixed<4, 4> d_P;
+    arma::mat::fixed<4, 4> d_F;
+    arma::mat::fixed<4, 4> d_Q;
+    arma::mat::fixed<2, 4> d_H;
+    arma::mat::fixed<2, 2> d_S_inv;
+    arma::mat::fixed<4, 2> d_K;
+    arma::vec::fixed<2> d_innovation;
+    double d_dynamics_psd;
+    double d_code_psd;
+    double d_phase_correction_cycles;
+    double d_code_correction_chips;
+};
+
+#endif
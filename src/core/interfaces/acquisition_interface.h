@@ -29,6 +29,7 @@
 
 #include "gnss_block_interface.h"
 #include "gnss_synchro.h"
+#include <cstdint>
 #include <memory>
 
 template <typename Data>
@@ -56,6 +57,17 @@ public:
     {
         return;
     }
+    virtual void set_doppler_window(unsigned int doppler_window __attribute__((unused)))
+    {
+        return;
+    }
+    virtual void set_code_phase_window(uint64_t sample_stamp __attribute__((unused)),
+        double code_delay_samples __attribute__((unused)),
+        double code_period_samples __attribute__((unused)),
+        unsigned int code_window __attribute__((unused)))
+    {
+        return;
+    }
     virtual void init() = 0;
     virtual void set_local_code() = 0;
     virtual void set_state(int state) = 0;
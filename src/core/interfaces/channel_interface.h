@@ -28,6 +28,7 @@
 
 #include "gnss_block_interface.h"
 #include "gnss_signal.h"
+#include <cstdint>
 
 /*!
  * \brief This abstract class represents an interface to a channel GNSS block.
@@ -47,6 +48,7 @@ public:
     virtual Gnss_Signal get_signal() const = 0;
     virtual void start_acquisition() = 0;
     virtual void assist_acquisition_doppler(double Carrier_Doppler_hz) = 0;
+    virtual void assist_acquisition_window(double doppler_window_hz, uint64_t sample_stamp, double code_delay_samples, double code_period_samples, double code_window_samples) = 0;
     virtual void stop_channel() = 0;
     virtual void set_signal(const Gnss_Signal&) = 0;
 };
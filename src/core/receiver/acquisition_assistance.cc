@@ -0,0 +1,209 @@
+/*!
+ * \file acquisition_assistance.cc
+ * \brief Prediction of the acquisition search windows from the stored
+ * ephemeris or almanac, the last receiver position and the receiver time.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_assistance.h"
+#include "MATH_CONSTANTS.h"    // for SPEED_OF_LIGHT, R2D
+#include "rtklib_ephemeris.h"  // for alm2pos, eph2pos
+#include "rtklib_rtkcmn.h"     // for ecef2pos, geodist, satazel, timeadd, timediff
+#include <cmath>
+
+// Typical errors of the orbits computed from an almanac of a few days
+const double ALMANAC_POSITION_ERROR_M = 3000.0;
+const double ALMANAC_RANGE_RATE_ERROR_M_S = 1.0;
+
+// Ephemeris older or newer than this are not used [s]
+const double EPHEMERIS_MAX_AGE_S = 4.0 * 3600.0;
+
+// Bound of the frequency error of the host clock that propagates the time
+const double HOST_CLOCK_DRIFT = 50e-6;
+
+
+AcquisitionAssistance::AcquisitionAssistance(const std::array<double, 3>& position_ecef_m,
+    double position_uncertainty_m,
+    double velocity_uncertainty_m_s,
+    const gtime_t& gps_time,
+    double time_uncertainty_s) : position_(position_ecef_m),
+                                 position_llh_{},
+                                 position_uncertainty_(position_uncertainty_m),
+                                 velocity_uncertainty_(velocity_uncertainty_m_s),
+                                 reference_time_(gps_time),
+                                 time_uncertainty_(time_uncertainty_s),
+                                 reference_instant_(std::chrono::steady_clock::now())
+{
+    ecef2pos(position_.data(), position_llh_.data());
+}
+
+
+void AcquisitionAssistance::add_ephemeris(char system, uint32_t prn, const eph_t& eph)
+{
+    ephemeris_[std::make_pair(system, prn)] = eph;
+}
+
+
+void AcquisitionAssistance::add_almanac(char system, uint32_t prn, const alm_t& alm)
+{
+    almanac_[std::make_pair(system, prn)] = alm;
+}
+
+
+bool AcquisitionAssistance::has_satellite(char system, uint32_t prn) const
+{
+    const auto key = std::make_pair(system, prn);
+    return (ephemeris_.count(key) > 0) or (almanac_.count(key) > 0);
+}
+
+
+double AcquisitionAssistance::elapsed_s() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - reference_instant_).count();
+}
+
+
+gtime_t AcquisitionAssistance::current_time() const
+{
+    return timeadd(reference_time_, elapsed_s());
+}
+
+
+double AcquisitionAssistance::time_uncertainty() const
+{
+    return time_uncertainty_ + HOST_CLOCK_DRIFT * elapsed_s();
+}
+
+
+double AcquisitionAssistance::position_uncertainty() const
+{
+    return position_uncertainty_ + velocity_uncertainty_ * elapsed_s();
+}
+
+
+gtime_t AcquisitionAssistance::time_of_week(double tow_s) const
+{
+    const gtime_t now = current_time();
+    double delta_s = tow_s - time2gpst(now, nullptr);
+    if (delta_s > 302400.0)
+        {
+            delta_s -= 604800.0;
+        }
+    else if (delta_s < -302400.0)
+        {
+            delta_s += 604800.0;
+        }
+    return timeadd(now, delta_s);
+}
+
+
+bool AcquisitionAssistance::satellite_position(char system, uint32_t prn, const gtime_t& time, std::array<double, 3>& position, double& clock_bias_s, bool& from_almanac) const
+{
+    const auto key = std::make_pair(system, prn);
+    const auto eph = ephemeris_.find(key);
+    if (eph != ephemeris_.end() and std::abs(timediff(time, eph->second.toe)) <= EPHEMERIS_MAX_AGE_S)
+        {
+            double variance_m2;
+            eph2pos(time, &eph->second, position.data(), &clock_bias_s, &variance_m2);
+            from_almanac = false;
+            return true;
+        }
+    const auto alm = almanac_.find(key);
+    if (alm != almanac_.end())
+        {
+            // The almanac reference time is stored as a time of week
+            const double tow_s = time2gpst(time, nullptr);
+            gtime_t tow_time;
+            tow_time.time = static_cast<time_t>(std::floor(tow_s));
+            tow_time.sec = tow_s - std::floor(tow_s);
+            alm2pos(tow_time, &alm->second, position.data(), &clock_bias_s);
+            from_almanac = true;
+            return true;
+        }
+    return false;
+}
+
+
+bool AcquisitionAssistance::pseudorange(char system, uint32_t prn, const gtime_t& rx_time, double& pseudorange_m, std::array<double, 3>& position, bool& from_almanac) const
+{
+    // The satellite position is taken at the transmission time, which depends on the range
+    double travel_time_s = 0.075;
+    double clock_bias_s = 0.0;
+    double range_m = 0.0;
+    std::array<double, 3> los{};
+    for (int i = 0; i < 2; i++)
+        {
+            if (!satellite_position(system, prn, timeadd(rx_time, -travel_time_s), position, clock_bias_s, from_almanac))
+                {
+                    return false;
+                }
+            range_m = geodist(position.data(), position_.data(), los.data());
+            if (range_m < 0.0)
+                {
+                    return false;
+                }
+            travel_time_s = range_m / SPEED_OF_LIGHT;
+        }
+    pseudorange_m = range_m - SPEED_OF_LIGHT * clock_bias_s;
+    return true;
+}
+
+
+bool AcquisitionAssistance::predict(char system, uint32_t prn, const gtime_t& rx_time, double time_uncertainty_s, Prediction& prediction) const
+{
+    double pr_m = 0.0;
+    double pr_before_m = 0.0;
+    double pr_after_m = 0.0;
+    std::array<double, 3> sat_position{};
+    std::array<double, 3> sat_position_before{};
+    std::array<double, 3> sat_position_after{};
+    bool from_almanac = false;
+    if (!pseudorange(system, prn, rx_time, pr_m, sat_position, from_almanac) or
+        !pseudorange(system, prn, timeadd(rx_time, -1.0), pr_before_m, sat_position_before, from_almanac) or
+        !pseudorange(system, prn, timeadd(rx_time, 1.0), pr_after_m, sat_position_after, from_almanac))
+        {
+            return false;
+        }
+
+    // Central differences over +/-1 s
+    const double range_rate_m_s = (pr_after_m - pr_before_m) / 2.0;
+    const double range_acceleration_m_s2 = pr_after_m - 2.0 * pr_m + pr_before_m;
+    std::array<double, 3> los{};
+    double sat_speed_m_s = 0.0;
+    for (int i = 0; i < 3; i++)
+        {
+            sat_speed_m_s += std::pow((sat_position_after[i] - sat_position_before[i]) / 2.0, 2);
+        }
+    sat_speed_m_s = std::sqrt(sat_speed_m_s);
+    const double range_m = geodist(sat_position.data(), position_.data(), los.data());
+    std::array<double, 2> azel{};
+    satazel(position_llh_.data(), los.data(), azel.data());
+
+    prediction.pseudorange_m = pr_m;
+    prediction.range_rate_m_s = range_rate_m_s;
+    prediction.elevation_deg = azel[1] * R2D;
+
+    // Bounds of the errors due to the uncertainty in the receiver position,
+    // velocity and time, and to the orbit model
+    const double position_uncertainty_m = position_uncertainty();
+    prediction.pseudorange_uncertainty_m = position_uncertainty_m + std::abs(range_rate_m_s) * time_uncertainty_s;
+    prediction.range_rate_uncertainty_m_s = velocity_uncertainty_ + sat_speed_m_s * position_uncertainty_m / range_m + std::abs(range_acceleration_m_s2) * time_uncertainty_s;
+    if (from_almanac)
+        {
+            prediction.pseudorange_uncertainty_m += ALMANAC_POSITION_ERROR_M;
+            prediction.range_rate_uncertainty_m_s += ALMANAC_RANGE_RATE_ERROR_M_S;
+        }
+    return true;
+}
@@ -0,0 +1,118 @@
+/*!
+ * \file acquisition_assistance.h
+ * \brief Prediction of the acquisition search windows from the stored
+ * ephemeris or almanac, the last receiver position and the receiver time.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQUISITION_ASSISTANCE_H
+#define GNSS_SDR_ACQUISITION_ASSISTANCE_H
+
+#include "rtklib.h"  // for alm_t, eph_t, gtime_t
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+/*!
+ * \brief Predicts the pseudorange and pseudorange rate of the satellites, and
+ * bounds their errors, for a receiver at a roughly known position and time.
+ *
+ * The receiver clock terms are not included in the predictions: they are
+ * common to all the satellites, so they can be obtained from a satellite
+ * already in track, or bounded by the oscillator tolerance otherwise.
+ */
+class AcquisitionAssistance
+{
+public:
+    /*!
+     * \brief Predicted observables of a satellite.
+     */
+    struct Prediction
+    {
+        double pseudorange_m{0.0};               //!< Geometric range minus the satellite clock bias [m]
+        double pseudorange_uncertainty_m{0.0};   //!< Bound of the pseudorange prediction error [m]
+        double range_rate_m_s{0.0};              //!< Pseudorange rate, without the receiver clock drift [m/s]
+        double range_rate_uncertainty_m_s{0.0};  //!< Bound of the pseudorange rate prediction error [m/s]
+        double elevation_deg{0.0};               //!< Satellite elevation [deg]
+    };
+
+    /*!
+     * \param position_ecef_m - Last known receiver position, ECEF [m].
+     * \param position_uncertainty_m - Bound of the receiver position error [m].
+     * \param velocity_uncertainty_m_s - Bound of the receiver speed [m/s].
+     * \param gps_time - Receiver GPS time at the moment of the call.
+     * \param time_uncertainty_s - Bound of the receiver time error [s].
+     */
+    AcquisitionAssistance(const std::array<double, 3>& position_ecef_m,
+        double position_uncertainty_m,
+        double velocity_uncertainty_m_s,
+        const gtime_t& gps_time,
+        double time_uncertainty_s);
+
+    void add_ephemeris(char system, uint32_t prn, const eph_t& eph);
+    void add_almanac(char system, uint32_t prn, const alm_t& alm);
+    bool has_satellite(char system, uint32_t prn) const;
+
+    /*!
+     * \brief Returns the receiver GPS time, propagated from the reference
+     * time with the steady clock of the host.
+     */
+    gtime_t current_time() const;
+
+    /*!
+     * \brief Returns the bound of the error of current_time() [s], which grows
+     * with the drift of the host clock since the reference time.
+     */
+    double time_uncertainty() const;
+
+    /*!
+     * \brief Returns the bound of the receiver position error [m], which grows
+     * with the receiver speed since the reference time.
+     */
+    double position_uncertainty() const;
+
+    /*!
+     * \brief Returns the GPS time with the given time of week which is
+     * closest to the current time.
+     */
+    gtime_t time_of_week(double tow_s) const;
+
+    /*!
+     * \brief Predicts the observables of a satellite received at a given GPS time.
+     * Ephemeris are used if available and within their fit interval, and
+     * almanac otherwise.
+     * \return false if there is neither a valid ephemeris nor almanac for the satellite.
+     */
+    bool predict(char system, uint32_t prn, const gtime_t& rx_time, double time_uncertainty_s, Prediction& prediction) const;
+
+private:
+    bool satellite_position(char system, uint32_t prn, const gtime_t& time, std::array<double, 3>& position, double& clock_bias_s, bool& from_almanac) const;
+    double elapsed_s() const;
+    bool pseudorange(char system, uint32_t prn, const gtime_t& rx_time, double& pseudorange_m, std::array<double, 3>& position, bool& from_almanac) const;
+
+    std::map<std::pair<char, uint32_t>, eph_t> ephemeris_;
+    std::map<std::pair<char, uint32_t>, alm_t> almanac_;
+    std::array<double, 3> position_;
+    std::array<double, 3> position_llh_;
+    double position_uncertainty_;
+    double velocity_uncertainty_;
+    gtime_t reference_time_;
+    double time_uncertainty_;
+    std::chrono::steady_clock::time_point reference_instant_;
+};
+
+#endif  // GNSS_SDR_ACQUISITION_ASSISTANCE_H
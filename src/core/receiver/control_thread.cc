@@ -26,6 +26,7 @@
 #endif
 
 #include "control_thread.h"
+#include "acquisition_assistance.h"
 #include "channel_event.h"
 #include "command_event.h"
 #include "concurrent_map.h"
@@ -831,6 +832,7 @@ void ControlThread::assist_GNSS()
                 }
 
             std::vector<std::pair<int, Gnss_Satellite>> visible_sats = get_visible_sats(ref_rx_utc_time, ref_LLH);
+            update_acquisition_assistance(ref_rx_utc_time, ref_LLH);
             // Set the receiver in Standby mode
             flowgraph_->apply_action(0, 10);
             // Give priority to visible satellites in the search list
@@ -874,6 +876,7 @@ void ControlThread::apply_action(unsigned int what)
         case 12:
             LOG(INFO) << "Receiver action HOTSTART";
             visible_satellites = get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
+            update_acquisition_assistance(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
             // reorder the satellite queue to acquire first those visible satellites
             flowgraph_->priorize_satellites(visible_satellites);
             // start again the satellite acquisitions
@@ -888,7 +891,8 @@ void ControlThread::apply_action(unsigned int what)
             read_assistance_from_XML();
             // call here the function that computes the set of visible satellites and its elevation
             // for the date and time specified by the warm start command and the assisted position
-            get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
+            visible_satellites = get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
+            update_acquisition_assistance(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
             // reorder the satellite queue to acquire first those visible satellites
             flowgraph_->priorize_satellites(visible_satellites);
             // start again the satellite acquisitions
@@ -1050,6 +1054,53 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
 }
 
 
+void ControlThread::update_acquisition_assistance(time_t rx_utc_time, const std::array<float, 3> &LLH)
+{
+    if (!configuration_->property("GNSS-SDR.acquisition_search_windows", false))
+        {
+            return;
+        }
+
+    // Rx ECEF position from LLH WGS84
+    arma::vec LLH_rad = arma::vec{degtorad(LLH[0]), degtorad(LLH[1]), LLH[2]};
+    arma::mat C_tmp = arma::zeros(3, 3);
+    arma::vec r_eb_e = arma::zeros(3, 1);
+    arma::vec v_eb_e = arma::zeros(3, 1);
+    Geo_to_ECEF(LLH_rad, arma::vec{0, 0, 0}, C_tmp, r_eb_e, v_eb_e, C_tmp);
+
+    gtime_t utc_gtime;
+    utc_gtime.time = rx_utc_time;
+    utc_gtime.sec = 0.0;
+
+    auto assistance = std::make_shared<AcquisitionAssistance>(std::array<double, 3>{r_eb_e(0), r_eb_e(1), r_eb_e(2)},
+        configuration_->property("GNSS-SDR.assist_position_uncertainty_m", 3000.0),
+        configuration_->property("GNSS-SDR.assist_velocity_uncertainty_m_s", 30.0),
+        utc2gpst(utc_gtime),
+        configuration_->property("GNSS-SDR.assist_time_uncertainty_s", 2.0));
+
+    std::shared_ptr<PvtInterface> pvt_ptr = flowgraph_->get_pvt();
+    for (auto &it : pvt_ptr->get_gps_ephemeris())
+        {
+            assistance->add_ephemeris('G', it.second.i_satellite_PRN, eph_to_rtklib(it.second, pre_2009_file_));
+        }
+    for (auto &it : pvt_ptr->get_galileo_ephemeris())
+        {
+            assistance->add_ephemeris('E', it.second.i_satellite_PRN, eph_to_rtklib(it.second));
+        }
+    for (auto &it : pvt_ptr->get_gps_almanac())
+        {
+            assistance->add_almanac('G', it.second.i_satellite_PRN, alm_to_rtklib(it.second));
+        }
+    for (auto &it : pvt_ptr->get_galileo_almanac())
+        {
+            assistance->add_almanac('E', it.second.i_satellite_PRN, alm_to_rtklib(it.second));
+        }
+
+    flowgraph_->set_acquisition_assistance(assistance);
+    LOG(INFO) << "Acquisition search windows predicted from the assistance data";
+}
+
+
 void ControlThread::gps_acq_assist_data_collector()
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
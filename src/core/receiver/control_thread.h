@@ -151,6 +151,13 @@ private:
      */
     std::vector<std::pair<int, Gnss_Satellite>> get_visible_sats(time_t rx_utc_time, const std::array<float, 3> &LLH);
 
+    /*
+     * Load the available ephemeris and almanac, the assisted position and time
+     * into the flowgraph, so the acquisition search windows of each satellite can
+     * be narrowed around its predicted Doppler and code delay
+     */
+    void update_acquisition_assistance(time_t rx_utc_time, const std::array<float, 3> &LLH);
+
     /*
      * Read initial GNSS assistance from SUPL server or local XML files
      */
@@ -27,6 +27,8 @@
 #include "GPS_L5.h"
 #include "Galileo_E1.h"
 #include "Galileo_E5a.h"
+#include "MATH_CONSTANTS.h"
+#include "acquisition_assistance.h"
 #include "channel.h"
 #include "channel_fsm.h"
 #include "channel_interface.h"
@@ -35,6 +37,7 @@
 #include "gnss_block_interface.h"
 #include "gnss_satellite.h"
 #include "gnss_synchro_monitor.h"
+#include "rtklib_rtkcmn.h"
 #include <boost/lexical_cast.hpp>    // for boost::lexical_cast
 #include <boost/tokenizer.hpp>       // for boost::tokenizer
 #include <glog/logging.h>            // for LOG
@@ -53,6 +56,7 @@
 #include <set>                       // for set
 #include <stdexcept>                 // for invalid_argument
 #include <thread>                    // for thread
+#include <utility>                   // for move
 #ifdef GR_GREATER_38
 #include <gnuradio/filter/fir_filter_blk.h>
 #else
@@ -1175,6 +1179,141 @@ double GNSSFlowgraph::project_doppler(const std::string& searched_signal, double
 }
 
 
+void GNSSFlowgraph::apply_acquisition_assistance(unsigned int who)
+{
+    // Without a prediction, the whole grid is searched around 0 Hz
+    double doppler_hz = 0.0;
+    double doppler_window_hz = 0.0;
+    uint64_t sample_stamp = 0ULL;
+    double code_delay_samples = 0.0;
+    double code_period_samples = 0.0;
+    double code_window_samples = 0.0;
+
+    const Gnss_Signal gs = channels_[who]->get_signal();
+    const std::string signal = gs.get_signal_str();
+    const uint32_t prn = gs.get_satellite().get_PRN();
+    char system = 0;
+    double carrier_freq_hz = 0.0;
+    double code_period_s = 0.0;
+    switch (mapStringValues_[signal])
+        {
+        case evGPS_1C:
+            system = 'G';
+            carrier_freq_hz = FREQ1;
+            code_period_s = GPS_L1_CA_CODE_PERIOD_S;
+            break;
+        case evGPS_2S:
+            system = 'G';
+            carrier_freq_hz = FREQ2;
+            code_period_s = GPS_L2_M_PERIOD_S;
+            break;
+        case evGPS_L5:
+            system = 'G';
+            carrier_freq_hz = FREQ5;
+            code_period_s = GPS_L5I_PERIOD_S;
+            break;
+        case evGAL_1B:
+            system = 'E';
+            carrier_freq_hz = FREQ1;
+            code_period_s = GALILEO_E1_CODE_PERIOD_S;
+            break;
+        case evGAL_5X:
+            system = 'E';
+            carrier_freq_hz = FREQ5;
+            code_period_s = GALILEO_E5A_CODE_PERIOD_S;
+            break;
+        default:
+            break;
+        }
+
+    // After some failed searches in the predicted windows, the prediction is
+    // not trusted anymore and the whole grid is searched until the satellite
+    // is acquired
+    const auto failures = assisted_acq_failures_.find(std::make_pair(signal, prn));
+    const bool full_grid = failures != assisted_acq_failures_.end() and
+                           failures->second >= configuration_->property("GNSS-SDR.assist_max_failed_searches", 2);
+    if (full_grid)
+        {
+            DLOG(INFO) << "Acquisition assistance for channel " << who << ", " << gs.get_satellite() << ", signal " << signal
+                       << ": full grid search after " << failures->second << " failed searches in the predicted windows";
+        }
+
+    if (acq_assistance_ and system != 0 and !full_grid and acq_assistance_->has_satellite(system, prn))
+        {
+            // Coarse receiver time and oscillator tolerance
+            gtime_t rx_time = acq_assistance_->current_time();
+            double time_uncertainty_s = acq_assistance_->time_uncertainty();
+            double clock_drift = configuration_->property("GNSS-SDR.assist_clock_drift_ppm", 0.0) * 1e-6;
+            double clock_drift_uncertainty = configuration_->property("GNSS-SDR.assist_clock_drift_uncertainty_ppm", 0.5) * 1e-6;
+            double fs = 0.0;
+
+            // If a satellite of the same signal is already in track, its decoded time of
+            // transmission plus its predicted travel time give the receiver time at a known
+            // sample, and its Doppler gives the receiver clock drift
+            AcquisitionAssistance::Prediction anchor;
+            std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
+            for (auto& current_status : current_channels_status)
+                {
+                    const Gnss_Synchro& synchro = *current_status.second;
+                    if (synchro.Flag_valid_word and synchro.fs > 0 and std::string(synchro.Signal, 2) == signal and synchro.PRN != prn)
+                        {
+                            const gtime_t tx_time = acq_assistance_->time_of_week(static_cast<double>(synchro.TOW_at_current_symbol_ms) / 1000.0);
+                            if (acq_assistance_->predict(system, synchro.PRN, timeadd(tx_time, 0.075), 0.03, anchor) and
+                                acq_assistance_->predict(system, synchro.PRN, timeadd(tx_time, anchor.pseudorange_m / SPEED_OF_LIGHT), 0.0, anchor))
+                                {
+                                    rx_time = timeadd(tx_time, anchor.pseudorange_m / SPEED_OF_LIGHT);
+                                    time_uncertainty_s = anchor.pseudorange_uncertainty_m / SPEED_OF_LIGHT;
+                                    clock_drift = -(synchro.Carrier_Doppler_hz / carrier_freq_hz + anchor.range_rate_m_s / SPEED_OF_LIGHT);
+                                    clock_drift_uncertainty = anchor.range_rate_uncertainty_m_s / SPEED_OF_LIGHT;
+                                    sample_stamp = synchro.Tracking_sample_counter + static_cast<uint64_t>(std::round(synchro.Code_phase_samples));
+                                    fs = static_cast<double>(synchro.fs);
+                                    break;
+                                }
+                        }
+                }
+
+            AcquisitionAssistance::Prediction prediction;
+            if (acq_assistance_->predict(system, prn, rx_time, time_uncertainty_s, prediction))
+                {
+                    doppler_hz = -(prediction.range_rate_m_s / SPEED_OF_LIGHT + clock_drift) * carrier_freq_hz;
+                    doppler_window_hz = (prediction.range_rate_uncertainty_m_s / SPEED_OF_LIGHT + clock_drift_uncertainty) * carrier_freq_hz;
+                    if (fs > 0.0)
+                        {
+                            // Time elapsed since the start of the code period received at the anchor sample
+                            const double code_rate = 1.0 + doppler_hz / carrier_freq_hz;
+                            double code_phase_s = std::fmod(time2gpst(rx_time, nullptr) - prediction.pseudorange_m / SPEED_OF_LIGHT, code_period_s);
+                            if (code_phase_s < 0.0)
+                                {
+                                    code_phase_s += code_period_s;
+                                }
+                            code_delay_samples = (code_period_s - code_phase_s) / code_rate * fs;
+                            code_period_samples = code_period_s / code_rate * fs;
+                            code_window_samples = (time_uncertainty_s + prediction.pseudorange_uncertainty_m / SPEED_OF_LIGHT) * fs;
+                            if (2.0 * code_window_samples >= code_period_samples)
+                                {
+                                    // The code delay is not constrained
+                                    code_window_samples = 0.0;
+                                }
+                        }
+                    DLOG(INFO) << "Acquisition assistance for channel " << who << ", " << gs.get_satellite() << ", signal " << signal
+                               << ": Doppler " << doppler_hz << " +/- " << doppler_window_hz << " [Hz], code delay " << code_delay_samples
+                               << " +/- " << code_window_samples << " [samples] at sample " << sample_stamp;
+                }
+        }
+
+    if (doppler_window_hz > 0.0 or code_window_samples > 0.0)
+        {
+            narrow_search_channels_.insert(who);
+        }
+    else
+        {
+            narrow_search_channels_.erase(who);
+        }
+    channels_[who]->assist_acquisition_doppler(doppler_hz);
+    channels_[who]->assist_acquisition_window(doppler_window_hz, sample_stamp, code_delay_samples, code_period_samples, code_window_samples);
+}
+
+
 void GNSSFlowgraph::acquisition_manager(unsigned int who)
 {
     unsigned int current_channel;
@@ -1226,11 +1365,12 @@ void GNSSFlowgraph::acquisition_manager(unsigned int who)
                             if (assistance_available == true and configuration_->property("GNSS-SDR.assist_dual_frequency_acq", multiband_))
                                 {
                                     channels_[current_channel]->assist_acquisition_doppler(project_doppler(channels_[current_channel]->get_signal().get_signal_str(), estimated_doppler));
+                                    channels_[current_channel]->assist_acquisition_window(0.0, 0ULL, 0.0, 0.0, 0.0);
                                 }
                             else
                                 {
-                                    // set Doppler center to 0 Hz
-                                    channels_[current_channel]->assist_acquisition_doppler(0);
+                                    // set the Doppler center and search windows predicted from the ephemeris, or 0 Hz and the whole grid
+                                    apply_acquisition_assistance(current_channel);
                                 }
 #ifndef ENABLE_FPGA
                             channels_[current_channel]->start_acquisition();
@@ -1299,6 +1439,10 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
         case 0:
             gs = channels_[who]->get_signal();
             DLOG(INFO) << "Channel " << who << " ACQ FAILED satellite " << gs.get_satellite() << ", Signal " << gs.get_signal_str();
+            if (narrow_search_channels_.erase(who) > 0)
+                {
+                    assisted_acq_failures_[std::make_pair(gs.get_signal_str(), gs.get_satellite().get_PRN())]++;
+                }
             channels_state_[who] = 0;
             if (acq_channels_count_ > 0)
                 {
@@ -1315,6 +1459,8 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
         case 1:
             gs = channels_[who]->get_signal();
             DLOG(INFO) << "Channel " << who << " ACQ SUCCESS satellite " << gs.get_satellite();
+            narrow_search_channels_.erase(who);
+            assisted_acq_failures_.erase(std::make_pair(gs.get_signal_str(), gs.get_satellite().get_PRN()));
             // If the satellite is in the list of available ones, remove it.
             remove_signal(gs);
 
@@ -1337,6 +1483,10 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
                     acq_channels_count_++;
                     DLOG(INFO) << "Channel " << who << " Starting acquisition " << gs.get_satellite() << ", Signal " << gs.get_signal_str();
                     channels_[who]->set_signal(channels_[who]->get_signal());
+                    if (acq_assistance_)
+                        {
+                            apply_acquisition_assistance(who);
+                        }
 #ifndef ENABLE_FPGA
                     channels_[who]->start_acquisition();
 #else
@@ -1376,6 +1526,13 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 }
 
 
+void GNSSFlowgraph::set_acquisition_assistance(std::shared_ptr<AcquisitionAssistance> assistance)
+{
+    std::lock_guard<std::mutex> lock(signal_list_mutex);
+    acq_assistance_ = std::move(assistance);
+}
+
+
 void GNSSFlowgraph::priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& visible_satellites)
 {
     size_t old_size;
@@ -34,10 +34,12 @@
 #include <gnuradio/blocks/null_sink.h>  // for null_sink
 #include <gnuradio/runtime_types.h>     // for basic_block_sptr, top_block_sptr
 #include <pmt/pmt.h>                    // for pmt_t
+#include <cstdint>                      // for uint32_t
 #include <list>                         // for list
 #include <map>                          // for map
 #include <memory>                       // for for shared_ptr, dynamic_pointer_cast
 #include <mutex>                        // for mutex
+#include <set>                          // for set
 #include <string>                       // for string
 #include <utility>                      // for pair
 #include <vector>                       // for vector
@@ -45,6 +47,7 @@
 #include "gnss_sdr_fpga_sample_counter.h"
 #endif
 
+class AcquisitionAssistance;
 class ChannelInterface;
 class ConfigurationInterface;
 class GNSSBlockInterface;
@@ -149,6 +152,12 @@ public:
      */
     void priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& visible_satellites);
 
+    /*!
+     * \brief Sets the predictor of the Doppler and code delay search windows
+     * used for the next acquisitions (hot and warm starts).
+     */
+    void set_acquisition_assistance(std::shared_ptr<AcquisitionAssistance> assistance);
+
 #ifdef ENABLE_FPGA
     void start_acquisition_helper();
 
@@ -171,6 +180,7 @@ private:
     void remove_signal(const Gnss_Signal& gs);
 
     double project_doppler(const std::string& searched_signal, double primary_freq_doppler_hz);
+    void apply_acquisition_assistance(unsigned int who);
     bool is_multiband() const;
     bool connected_;
     bool running_;
@@ -198,6 +208,9 @@ private:
 #endif
     gr::top_block_sptr top_block_;
     std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
+    std::shared_ptr<AcquisitionAssistance> acq_assistance_;
+    std::map<std::pair<std::string, uint32_t>, int> assisted_acq_failures_;  // failed searches in the predicted windows, by signal and PRN
+    std::set<unsigned int> narrow_search_channels_;                         // channels searching in predicted windows
 
     std::list<Gnss_Signal> available_GPS_1C_signals_;
     std::list<Gnss_Signal> available_GPS_2S_signals_;
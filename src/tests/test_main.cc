@@ -45,10 +45,13 @@ DECLARE_string(log_dir);
 #include "unit-tests/arithmetic/code_generation_test.cc"
 #include "unit-tests/arithmetic/complex_carrier_test.cc"
 #include "unit-tests/arithmetic/conjugate_test.cc"
+#include "unit-tests/arithmetic/doppler_wipeoff_test.cc"
 #include "unit-tests/arithmetic/fft_length_test.cc"
 #include "unit-tests/arithmetic/fft_speed_test.cc"
 #include "unit-tests/arithmetic/magnitude_squared_test.cc"
 #include "unit-tests/arithmetic/multiply_test.cc"
+#include "unit-tests/control-plane/acquisition_assistance_test.cc"
+#include "unit-tests/control-plane/channel_fsm_test.cc"
 #include "unit-tests/control-plane/control_thread_test.cc"
 #include "unit-tests/control-plane/file_configuration_test.cc"
 #include "unit-tests/control-plane/gnss_block_factory_test.cc"
@@ -56,6 +59,11 @@ DECLARE_string(log_dir);
 #include "unit-tests/control-plane/in_memory_configuration_test.cc"
 #include "unit-tests/control-plane/protobuf_test.cc"
 #include "unit-tests/control-plane/string_converter_test.cc"
+#include "unit-tests/signal-processing-blocks/acquisition/acq_code_spectra_cache_test.cc"
+#include "unit-tests/signal-processing-blocks/acquisition/acq_doppler_wipeoffs_test.cc"
+#include "unit-tests/signal-processing-blocks/acquisition/acq_executor_test.cc"
+#include "unit-tests/signal-processing-blocks/acquisition/acq_fft_planner_test.cc"
+#include "unit-tests/signal-processing-blocks/acquisition/acq_shared_spectra_test.cc"
 #include "unit-tests/signal-processing-blocks/acquisition/galileo_e1_pcps_8ms_ambiguous_acquisition_gsoc2013_test.cc"
 #include "unit-tests/signal-processing-blocks/acquisition/galileo_e1_pcps_ambiguous_acquisition_gsoc2013_test.cc"
 #include "unit-tests/signal-processing-blocks/acquisition/galileo_e1_pcps_ambiguous_acquisition_gsoc_test.cc"
@@ -79,9 +87,12 @@ DECLARE_string(log_dir);
 #include "unit-tests/signal-processing-blocks/resampler/mmse_resampler_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/file_signal_source_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/gnss_sdr_valve_test.cc"
+#include "unit-tests/signal-processing-blocks/sources/offline_replay_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/unpack_2bit_samples_test.cc"
 // #include "unit-tests/signal-processing-blocks/acquisition/glonass_l2_ca_pcps_acquisition_test.cc"
+#include "unit-tests/signal-processing-blocks/libs/dump_writer_test.cc"
 #include "unit-tests/signal-processing-blocks/libs/item_type_helpers_test.cc"
+#include "unit-tests/signal-processing-blocks/libs/mat_stream_writer_test.cc"
 
 #if OPENCL_BLOCKS_TEST
 #include "unit-tests/signal-processing-blocks/acquisition/gps_l1_ca_pcps_opencl_acquisition_gsoc2013_test.cc"
@@ -90,8 +101,11 @@ DECLARE_string(log_dir);
 #include "unit-tests/signal-processing-blocks/tracking/bayesian_estimation_test.cc"
 #if ARMADILLO_HAVE_MVNRND
 #include "unit-tests/signal-processing-blocks/tracking/cubature_filter_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/fixed_nonlinear_tracking_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/unscented_filter_test.cc"
 #endif
+#include "unit-tests/signal-processing-blocks/tracking/cpu_multicorrelator_batch_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/cpu_multicorrelator_real_codes_16sc_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/cpu_multicorrelator_real_codes_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/cpu_multicorrelator_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/discriminator_test.cc"
@@ -99,6 +113,10 @@ DECLARE_string(log_dir);
 #include "unit-tests/signal-processing-blocks/tracking/galileo_e5a_tracking_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/glonass_l1_ca_dll_pll_c_aid_tracking_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/glonass_l1_ca_dll_pll_tracking_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/integration_scheduler_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/reacquisition_search_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/secondary_code_correlator_test.cc"
+#include "unit-tests/signal-processing-blocks/tracking/tracking_kf_filter_test.cc"
 #include "unit-tests/signal-processing-blocks/tracking/tracking_loop_filter_test.cc"
 
 
@@ -0,0 +1,102 @@
+/*!
+ * \file doppler_wipeoff_test.cc
+ * \brief  This file implements timing tests for the Doppler wipeoff of 16-bit
+ * integer samples, comparing the floating point and the integer datapaths of
+ * the PCPS acquisition.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "GPS_L1_CA.h"
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+
+DEFINE_int32(size_doppler_wipeoff_test, 16384, "Size of the arrays used for Doppler wipeoff testing");
+DEFINE_int32(doppler_bins_wipeoff_test, 41, "Number of Doppler bins used for Doppler wipeoff testing");
+DEFINE_int32(input_bits_wipeoff_test, 4, "Bits per sample component used for Doppler wipeoff testing");
+
+
+TEST(DopplerWipeoffTest, FloatVsIntegerDatapath)
+{
+    const auto num_samples = static_cast<unsigned int>(FLAGS_size_doppler_wipeoff_test);
+    const auto num_bins = static_cast<unsigned int>(FLAGS_doppler_bins_wipeoff_test);
+    const int max_sample = (1 << (FLAGS_input_bits_wipeoff_test - 1)) - 1;
+    const float amplitude = std::floor(32767.0F / static_cast<float>(1 << FLAGS_input_bits_wipeoff_test));
+    const double fs = 4000000.0;
+
+    std::srand(1);
+    volk_gnsssdr::vector<lv_16sc_t> input(num_samples);
+    for (auto& sample : input)
+        {
+            sample = lv_16sc_t(static_cast<int16_t>(std::rand() % (2 * max_sample + 1) - max_sample), static_cast<int16_t>(std::rand() % (2 * max_sample + 1) - max_sample));
+        }
+
+    // Carriers as computed by pcps_acquisition for both datapaths
+    volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>> carriers(num_bins, volk_gnsssdr::vector<std::complex<float>>(num_samples));
+    volk_gnsssdr::vector<volk_gnsssdr::vector<lv_16sc_t>> carriers_sc(num_bins, volk_gnsssdr::vector<lv_16sc_t>(num_samples));
+    volk_gnsssdr::vector<std::complex<float>> scaled(num_samples);
+    for (unsigned int i = 0; i < num_bins; i++)
+        {
+            const auto phase_step_rad = static_cast<float>(GPS_TWO_PI * (-5000.0 + 250.0 * i) / fs);
+            std::array<float, 1> phase{};
+            volk_gnsssdr_s32f_sincos_32fc(carriers[i].data(), -phase_step_rad, phase.data(), num_samples);
+            volk_32f_s32f_multiply_32f(reinterpret_cast<float*>(scaled.data()), reinterpret_cast<const float*>(carriers[i].data()), amplitude, 2 * num_samples);
+            volk_gnsssdr_32fc_convert_16ic(carriers_sc[i].data(), scaled.data(), num_samples);
+        }
+
+    volk_gnsssdr::vector<std::complex<float>> input_float(num_samples);
+    volk_gnsssdr::vector<std::complex<float>> output_float(num_samples);
+    volk_gnsssdr::vector<std::complex<float>> output_integer(num_samples);
+    volk_gnsssdr::vector<lv_16sc_t> wipeoff_buffer(num_samples);
+
+    // Floating point datapath: widen the whole dwell, then wipe off each Doppler bin in float
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    volk_gnsssdr_16ic_convert_32fc(input_float.data(), input.data(), num_samples);
+    for (unsigned int i = 0; i < num_bins; i++)
+        {
+            volk_32fc_x2_multiply_32fc(output_float.data(), input_float.data(), carriers[i].data(), num_samples);
+        }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> elapsed_float = end - start;
+
+    // Integer datapath: wipe off each Doppler bin in 16 bits, widen only at the FFT input
+    start = std::chrono::system_clock::now();
+    for (unsigned int i = 0; i < num_bins; i++)
+        {
+            volk_gnsssdr_16ic_x2_multiply_16ic(wipeoff_buffer.data(), input.data(), carriers_sc[i].data(), num_samples);
+            volk_gnsssdr_16ic_convert_32fc(output_integer.data(), wipeoff_buffer.data(), num_samples);
+        }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> elapsed_integer = end - start;
+
+    std::cout << "Doppler wipeoff of " << num_bins << " bins of " << num_samples
+              << " cshort samples: floating point datapath finished in " << elapsed_float.count() * 1e6
+              << " microseconds, integer datapath finished in " << elapsed_integer.count() * 1e6
+              << " microseconds (" << (elapsed_float.count() / elapsed_integer.count()) << "x)" << std::endl;
+
+    // Both datapaths must produce the same wiped-off signal, up to the carrier quantization
+    const float tolerance = 2.0F * static_cast<float>(max_sample) / amplitude + 1e-3F;
+    for (unsigned int n = 0; n < num_samples; n++)
+        {
+            ASSERT_NEAR(output_float[n].real(), output_integer[n].real() / amplitude, tolerance);
+            ASSERT_NEAR(output_float[n].imag(), output_integer[n].imag() / amplitude, tolerance);
+        }
+}
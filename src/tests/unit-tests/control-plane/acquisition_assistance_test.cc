@@ -0,0 +1,153 @@
+/*!
+ * \file acquisition_assistance_test.cc
+ * \brief This file implements tests for the prediction of the acquisition
+ * search windows from the ephemeris.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "MATH_CONSTANTS.h"
+#include "acquisition_assistance.h"
+#include "rtklib_ephemeris.h"
+#include "rtklib_rtkcmn.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+
+class AcquisitionAssistanceTest : public ::testing::Test
+{
+protected:
+    AcquisitionAssistanceTest()
+    {
+        eph = eph_t{};
+        eph.sat = 1;  // GPS PRN 1
+        eph.A = 5153.6 * 5153.6;
+        eph.e = 0.01;
+        eph.i0 = 0.96;
+        eph.OMG0 = 1.0;
+        eph.omg = 0.5;
+        eph.M0 = 0.3;
+        eph.OMGd = -8e-9;
+        eph.week = 2100;
+        eph.toes = 345600.0;
+        eph.toe = gpst2time(eph.week, eph.toes);
+        eph.toc = eph.toe;
+        eph.f0 = 1e-5;
+        reference_time = timeadd(eph.toe, 600.0);
+
+        // Receiver on the ground, 20 degrees away from the sub-satellite point
+        std::array<double, 3> sat_position{};
+        double clock_bias_s;
+        double variance_m2;
+        eph2pos(reference_time, &eph, sat_position.data(), &clock_bias_s, &variance_m2);
+        std::array<double, 3> sat_llh{};
+        ecef2pos(sat_position.data(), sat_llh.data());
+        std::array<double, 3> rx_llh{sat_llh[0] + 20.0 / R2D, sat_llh[1], 100.0};
+        pos2ecef(rx_llh.data(), rx_position.data());
+    }
+
+    ~AcquisitionAssistanceTest() override = default;
+
+    // Pseudorange without receiver clock terms, received at rx_time by a receiver at rx_position
+    double true_pseudorange(const gtime_t& rx_time) const
+    {
+        std::array<double, 3> sat_position{};
+        std::array<double, 3> los{};
+        double clock_bias_s = 0.0;
+        double variance_m2;
+        double range_m = 0.0;
+        for (int i = 0; i < 5; i++)
+            {
+                eph2pos(timeadd(rx_time, -range_m / SPEED_OF_LIGHT), &eph, sat_position.data(), &clock_bias_s, &variance_m2);
+                range_m = geodist(sat_position.data(), rx_position.data(), los.data());
+            }
+        return range_m - SPEED_OF_LIGHT * clock_bias_s;
+    }
+
+    eph_t eph;
+    gtime_t reference_time;
+    std::array<double, 3> rx_position{};
+};
+
+
+TEST_F(AcquisitionAssistanceTest, PredictionBoundsContainTruth)
+{
+    const double position_uncertainty_m = 3000.0;
+    const double time_uncertainty_s = 2.0;
+    const std::array<double, 3> assisted_position{rx_position[0] + 1000.0, rx_position[1] - 1500.0, rx_position[2] + 500.0};
+    const gtime_t assisted_time = timeadd(reference_time, 1.5);
+
+    AcquisitionAssistance assistance(assisted_position, position_uncertainty_m, 0.0, assisted_time, time_uncertainty_s);
+    assistance.add_ephemeris('G', 1, eph);
+    EXPECT_TRUE(assistance.has_satellite('G', 1));
+    EXPECT_FALSE(assistance.has_satellite('G', 2));
+    EXPECT_FALSE(assistance.has_satellite('E', 1));
+
+    AcquisitionAssistance::Prediction prediction;
+    EXPECT_FALSE(assistance.predict('G', 2, assisted_time, time_uncertainty_s, prediction));
+    ASSERT_TRUE(assistance.predict('G', 1, assisted_time, time_uncertainty_s, prediction));
+
+    const double pseudorange_m = true_pseudorange(reference_time);
+    const double range_rate_m_s = (true_pseudorange(timeadd(reference_time, 0.5)) - true_pseudorange(timeadd(reference_time, -0.5)));
+    std::cout << "Predicted pseudorange " << prediction.pseudorange_m << " +/- " << prediction.pseudorange_uncertainty_m
+              << " [m] (true " << pseudorange_m << " [m]), range rate " << prediction.range_rate_m_s << " +/- "
+              << prediction.range_rate_uncertainty_m_s << " [m/s] (true " << range_rate_m_s << " [m/s])" << std::endl;
+
+    EXPECT_GT(prediction.elevation_deg, 0.0);
+    EXPECT_LE(std::abs(prediction.pseudorange_m - pseudorange_m), prediction.pseudorange_uncertainty_m);
+    EXPECT_LE(std::abs(prediction.range_rate_m_s - range_rate_m_s), prediction.range_rate_uncertainty_m_s);
+
+    // The Doppler window at L1 must be much narrower than a typical +/-5 kHz search
+    EXPECT_LT(prediction.range_rate_uncertainty_m_s / SPEED_OF_LIGHT * FREQ1, 500.0);
+}
+
+
+TEST_F(AcquisitionAssistanceTest, TimeOfWeek)
+{
+    AcquisitionAssistance assistance(rx_position, 0.0, 0.0, reference_time, 1.0);
+    const double tow_s = time2gpst(reference_time, nullptr);
+
+    EXPECT_NEAR(timediff(assistance.time_of_week(tow_s - 10.0), reference_time), -10.0, 1.0);
+    EXPECT_NEAR(timediff(assistance.time_of_week(tow_s + 10.0), reference_time), 10.0, 1.0);
+    // A time of week in the next week
+    EXPECT_NEAR(timediff(assistance.time_of_week(tow_s - 336200.0), reference_time), 604800.0 - 336200.0, 1.0);
+}
+
+
+TEST_F(AcquisitionAssistanceTest, StaleEphemeris)
+{
+    AcquisitionAssistance assistance(rx_position, 100.0, 0.0, reference_time, 1.0);
+    assistance.add_ephemeris('G', 1, eph);
+    AcquisitionAssistance::Prediction prediction;
+    EXPECT_TRUE(assistance.predict('G', 1, timeadd(eph.toe, 3.0 * 3600.0), 1.0, prediction));
+    // Out of the fit interval, the ephemeris are not used
+    EXPECT_FALSE(assistance.predict('G', 1, timeadd(eph.toe, 5.0 * 3600.0), 1.0, prediction));
+    EXPECT_FALSE(assistance.predict('G', 1, timeadd(eph.toe, -5.0 * 3600.0), 1.0, prediction));
+}
+
+
+TEST_F(AcquisitionAssistanceTest, UncertaintiesGrowWithTime)
+{
+    AcquisitionAssistance assistance(rx_position, 100.0, 30.0, reference_time, 1.0);
+    const double time_uncertainty_s = assistance.time_uncertainty();
+    const double position_uncertainty_m = assistance.position_uncertainty();
+    EXPECT_GE(time_uncertainty_s, 1.0);
+    EXPECT_GE(position_uncertainty_m, 100.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_GT(assistance.time_uncertainty(), time_uncertainty_s);
+    // The receiver may have moved 30 m/s * 0.2 s
+    EXPECT_GT(assistance.position_uncertainty(), position_uncertainty_m + 5.0);
+}
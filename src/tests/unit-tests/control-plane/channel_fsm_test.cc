@@ -0,0 +1,119 @@
+/*!
+ * \file channel_fsm_test.cc
+ * \brief This file implements tests for the channel state machine events
+ * raised by the tracking reacquisition.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_interface.h"
+#include "channel_event.h"
+#include "channel_fsm.h"
+#include "concurrent_queue.h"
+#include "telemetry_decoder_interface.h"
+#include "tracking_interface.h"
+#include <gtest/gtest.h>
+#include <pmt/pmt.h>
+#include <memory>
+#include <string>
+
+
+template <typename Interface>
+class ChannelFsmTestBlock : public Interface
+{
+public:
+    std::string role() override { return "Test"; }
+    std::string implementation() override { return "Test"; }
+    size_t item_size() override { return 0; }
+    void connect(gr::top_block_sptr top_block __attribute__((unused))) override {}
+    void disconnect(gr::top_block_sptr top_block __attribute__((unused))) override {}
+    gr::basic_block_sptr get_left_block() override { return nullptr; }
+    gr::basic_block_sptr get_right_block() override { return nullptr; }
+};
+
+
+class ChannelFsmTestAcquisition : public ChannelFsmTestBlock<AcquisitionInterface>
+{
+public:
+    void set_gnss_synchro(Gnss_Synchro* gnss_synchro __attribute__((unused))) override {}
+    void set_channel(unsigned int channel_id __attribute__((unused))) override {}
+    void set_channel_fsm(std::weak_ptr<ChannelFsm> channel_fsm __attribute__((unused))) override {}
+    void set_threshold(float threshold __attribute__((unused))) override {}
+    void set_doppler_max(unsigned int doppler_max __attribute__((unused))) override {}
+    void set_doppler_step(unsigned int doppler_step __attribute__((unused))) override {}
+    void init() override {}
+    void set_local_code() override {}
+    void set_state(int state __attribute__((unused))) override {}
+    signed int mag() override { return 0; }
+    void reset() override {}
+    void stop_acquisition() override {}
+    void set_resampler_latency(uint32_t latency_samples __attribute__((unused))) override {}
+};
+
+
+class ChannelFsmTestTracking : public ChannelFsmTestBlock<TrackingInterface>
+{
+public:
+    void start_tracking() override {}
+    void stop_tracking() override {}
+    void set_gnss_synchro(Gnss_Synchro* gnss_synchro __attribute__((unused))) override {}
+    void set_channel(unsigned int channel __attribute__((unused))) override {}
+};
+
+
+// Counts the resets of the telemetry decoder
+class ChannelFsmTestTelemetry : public ChannelFsmTestBlock<TelemetryDecoderInterface>
+{
+public:
+    void reset() override { resets++; }
+    void set_satellite(const Gnss_Satellite& sat __attribute__((unused))) override {}
+    void set_channel(int channel __attribute__((unused))) override {}
+
+    int resets = 0;
+};
+
+
+TEST(ChannelFsmTest, ReacquisitionResetsTelemetry)
+{
+    auto telemetry = std::make_shared<ChannelFsmTestTelemetry>();
+    auto queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    auto fsm = std::make_shared<ChannelFsm>(std::make_shared<ChannelFsmTestAcquisition>());
+    fsm->set_tracking(std::make_shared<ChannelFsmTestTracking>());
+    fsm->set_telemetry(telemetry);
+    fsm->set_queue(queue);
+
+    // No reacquisition outside of the tracking
+    EXPECT_FALSE(fsm->Event_tracking_reacquisition());
+    ASSERT_TRUE(fsm->Event_start_acquisition());
+    EXPECT_FALSE(fsm->Event_tracking_reacquisition());
+    ASSERT_TRUE(fsm->Event_valid_acquisition());
+    pmt::pmt_t msg;
+    ASSERT_TRUE(queue->try_pop(msg));  // tracking started
+    const int resets_before_outage = telemetry->resets;
+
+    // Loss of lock: the tracking enters the reacquisition and asks for a
+    // telemetry resynchronization
+    EXPECT_TRUE(fsm->Event_tracking_reacquisition());
+    EXPECT_EQ(telemetry->resets, resets_before_outage + 1);
+    // The satellite is reacquired: symbols queued from before the outage are
+    // dropped again
+    EXPECT_TRUE(fsm->Event_tracking_reacquisition());
+    EXPECT_EQ(telemetry->resets, resets_before_outage + 2);
+
+    // The channel kept the satellite, so it was not released
+    EXPECT_FALSE(queue->try_pop(msg));
+    EXPECT_TRUE(fsm->Event_failed_tracking_standby());
+    ASSERT_TRUE(queue->try_pop(msg));
+    EXPECT_EQ(boost::any_cast<channel_event_sptr>(pmt::any_ref(msg))->event_type, 2);
+}
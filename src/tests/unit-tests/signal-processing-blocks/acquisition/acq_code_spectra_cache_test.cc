@@ -0,0 +1,62 @@
+/*!
+ * \file acq_code_spectra_cache_test.cc
+ * \brief  This file implements unit tests for the Acq_Code_Spectra_Cache class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_code_spectra_cache.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+
+TEST(AcqCodeSpectraCacheTest, FindAndInsert)
+{
+    Acq_Code_Spectra_Cache& cache = Acq_Code_Spectra_Cache::instance();
+    const uint64_t misses = cache.misses();
+    const uint64_t hits = cache.hits();
+
+    EXPECT_EQ(cache.find("G1C_test_1_4000000_4000_4000"), nullptr);
+    EXPECT_EQ(cache.misses(), misses + 1);
+
+    auto spectrum = std::make_shared<const Acq_Code_Spectra_Cache::Spectrum>(4000, std::complex<float>(1.0, 0.0));
+    std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> cached = cache.insert("G1C_test_1_4000000_4000_4000", spectrum);
+    EXPECT_EQ(cached.get(), spectrum.get());
+
+    // Inserting again with the same key keeps the first spectrum
+    auto other = std::make_shared<const Acq_Code_Spectra_Cache::Spectrum>(4000, std::complex<float>(0.0, 1.0));
+    EXPECT_EQ(cache.insert("G1C_test_1_4000000_4000_4000", other).get(), spectrum.get());
+
+    EXPECT_EQ(cache.find("G1C_test_1_4000000_4000_4000").get(), spectrum.get());
+    EXPECT_EQ(cache.hits(), hits + 1);
+    EXPECT_EQ(cache.find("G1C_test_2_4000000_4000_4000"), nullptr);
+}
+
+
+TEST(AcqCodeSpectraCacheTest, ReleaseUnused)
+{
+    Acq_Code_Spectra_Cache& cache = Acq_Code_Spectra_Cache::instance();
+    cache.release_unused();
+    const size_t size = cache.size();
+
+    std::shared_ptr<const Acq_Code_Spectra_Cache::Spectrum> used = cache.insert("E1B_test_1_4000000_4000_4000",
+        std::make_shared<const Acq_Code_Spectra_Cache::Spectrum>(4000));
+    cache.insert("E1B_test_2_4000000_4000_4000", std::make_shared<const Acq_Code_Spectra_Cache::Spectrum>(4000));
+    EXPECT_EQ(cache.size(), size + 2);
+
+    cache.release_unused();
+    EXPECT_EQ(cache.size(), size + 1);
+    EXPECT_EQ(cache.find("E1B_test_1_4000000_4000_4000").get(), used.get());
+    EXPECT_EQ(cache.find("E1B_test_2_4000000_4000_4000"), nullptr);
+}
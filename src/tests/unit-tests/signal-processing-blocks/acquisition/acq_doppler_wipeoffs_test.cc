@@ -0,0 +1,63 @@
+/*!
+ * \file acq_doppler_wipeoffs_test.cc
+ * \brief  This file implements unit tests for the Acq_Doppler_Wipeoffs class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_doppler_wipeoffs.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+
+TEST(AcqDopplerWipeoffsTest, FindAndInsert)
+{
+    Acq_Doppler_Wipeoffs& store = Acq_Doppler_Wipeoffs::instance();
+    EXPECT_EQ(store.find("4000000_4000_-500"), nullptr);
+
+    auto carrier = std::make_shared<const Acq_Doppler_Wipeoffs::Carrier>(4000, std::complex<float>(1.0, 0.0));
+    EXPECT_EQ(store.insert("4000000_4000_-500", carrier).get(), carrier.get());
+
+    // Inserting again with the same key keeps the first carrier
+    auto other = std::make_shared<const Acq_Doppler_Wipeoffs::Carrier>(4000, std::complex<float>(0.0, 1.0));
+    EXPECT_EQ(store.insert("4000000_4000_-500", other).get(), carrier.get());
+    EXPECT_EQ(store.find("4000000_4000_-500").get(), carrier.get());
+
+    // Floating point and integer carriers do not share keys
+    EXPECT_EQ(store.find_sc("4000000_4000_-500"), nullptr);
+    auto carrier_sc = std::make_shared<const Acq_Doppler_Wipeoffs::Carrier_Sc>(4000, lv_16sc_t(1, 0));
+    EXPECT_EQ(store.insert_sc("4000000_4000_-500", carrier_sc).get(), carrier_sc.get());
+    EXPECT_EQ(store.find_sc("4000000_4000_-500").get(), carrier_sc.get());
+    EXPECT_EQ(store.find("4000000_4000_-500").get(), carrier.get());
+}
+
+
+TEST(AcqDopplerWipeoffsTest, ReleasedWithLastUser)
+{
+    Acq_Doppler_Wipeoffs& store = Acq_Doppler_Wipeoffs::instance();
+    const size_t size = store.size();
+
+    auto carrier = std::make_shared<const Acq_Doppler_Wipeoffs::Carrier>(4000);
+    store.insert("4000000_4000_250", carrier);
+    EXPECT_EQ(store.size(), size + 1);
+
+    // The store does not own the carriers
+    carrier.reset();
+    EXPECT_EQ(store.size(), size);
+    EXPECT_EQ(store.find("4000000_4000_250"), nullptr);
+
+    // An expired entry is replaced by a new carrier
+    auto replacement = std::make_shared<const Acq_Doppler_Wipeoffs::Carrier>(4000);
+    EXPECT_EQ(store.insert("4000000_4000_250", replacement).get(), replacement.get());
+}
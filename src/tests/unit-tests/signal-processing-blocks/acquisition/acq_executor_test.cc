@@ -0,0 +1,95 @@
+/*!
+ * \file acq_executor_test.cc
+ * \brief  This file implements unit tests for the Acq_Executor class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+
+TEST(AcqExecutorTest, RunsAllSubmittedJobs)
+{
+    std::atomic<int> counter{0};
+    {
+        Acq_Executor executor(4, 100, {});
+        EXPECT_EQ(executor.num_workers(), 4U);
+        for (int i = 0; i < 100; i++)
+            {
+                EXPECT_TRUE(executor.submit([&counter]() { counter++; }));
+            }
+        // the destructor waits for the queued jobs
+    }
+    EXPECT_EQ(counter, 100);
+}
+
+
+TEST(AcqExecutorTest, BoundedQueue)
+{
+    std::atomic<bool> release{false};
+    std::atomic<int> counter{0};
+    Acq_Executor executor(1, 2, {});
+    auto job = [&release, &counter]() {
+        while (!release)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        counter++;
+    };
+
+    // The first job keeps the only worker busy, so the next ones wait in the queue
+    EXPECT_TRUE(executor.submit(job));
+    while (executor.queue_depth() > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    EXPECT_TRUE(executor.submit(job));
+    EXPECT_TRUE(executor.submit(job));
+    EXPECT_FALSE(executor.submit(job));
+    EXPECT_EQ(executor.queue_depth(), 2U);
+    EXPECT_EQ(executor.max_queue_depth(), 2U);
+    EXPECT_EQ(executor.jobs_rejected(), 1ULL);
+
+    release = true;
+    while (executor.jobs_completed() < 3)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    EXPECT_EQ(counter, 3);
+    EXPECT_GT(executor.max_latency_us(), 0.0);
+    EXPECT_GE(executor.max_latency_us(), executor.mean_latency_us());
+}
+
+
+TEST(AcqExecutorTest, SurvivesThrowingJobs)
+{
+    std::atomic<int> counter{0};
+    {
+        Acq_Executor executor(1, 10, {});
+        EXPECT_TRUE(executor.submit([]() { throw std::runtime_error("dwell failed"); }));
+        EXPECT_TRUE(executor.submit([]() { throw 1; }));
+        EXPECT_TRUE(executor.submit([&counter]() { counter++; }));
+        while (executor.jobs_completed() < 3)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+    }
+    // The worker kept running after both exceptions
+    EXPECT_EQ(counter, 1);
+}
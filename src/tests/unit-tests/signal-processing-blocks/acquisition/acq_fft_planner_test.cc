@@ -0,0 +1,96 @@
+/*!
+ * \file acq_fft_planner_test.cc
+ * \brief  This file implements unit tests for the Acq_Fft_Planner class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_fft_planner.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+TEST(AcqFftPlannerTest, SmoothSizes)
+{
+    EXPECT_TRUE(Acq_Fft_Planner::is_smooth(1));
+    EXPECT_TRUE(Acq_Fft_Planner::is_smooth(4096));
+    EXPECT_TRUE(Acq_Fft_Planner::is_smooth(82320));    // 2^4 3 5 7^3
+    EXPECT_FALSE(Acq_Fft_Planner::is_smooth(81840));   // 2^4 3 5 11 31
+    EXPECT_FALSE(Acq_Fft_Planner::is_smooth(13000));   // 2^3 5^3 13
+    EXPECT_FALSE(Acq_Fft_Planner::is_smooth(0));
+
+    const std::vector<uint32_t> candidates = Acq_Fft_Planner::candidate_sizes(81840, 4);
+    ASSERT_EQ(candidates.size(), 6U);
+    EXPECT_EQ(candidates.front(), 81840U);
+    EXPECT_EQ(candidates.back(), 131072U);
+    for (size_t i = 1; i < candidates.size(); i++)
+        {
+            EXPECT_GT(candidates[i], candidates[i - 1]);
+            EXPECT_TRUE(Acq_Fft_Planner::is_smooth(candidates[i]));
+        }
+    EXPECT_EQ(candidates[1], 81920U);  // 2^14 5
+
+    // A power of two is its only candidate
+    EXPECT_EQ(Acq_Fft_Planner::candidate_sizes(8192, 4), std::vector<uint32_t>{8192});
+}
+
+
+TEST(AcqFftPlannerTest, FastestSizeIsStored)
+{
+    const std::string wisdom_file = "./acq_fft_planner_test_wisdom.txt";
+    std::remove(wisdom_file.c_str());
+
+    // Pretend that lengths with large prime factors are much slower
+    int timed = 0;
+    auto timer = [&timed](uint32_t fft_size) {
+        timed++;
+        return (Acq_Fft_Planner::is_smooth(fft_size) ? 1e-3 : 1e-2) * static_cast<double>(fft_size) / 13000.0;
+    };
+    Acq_Fft_Planner& planner = Acq_Fft_Planner::instance();
+    EXPECT_EQ(planner.fft_size(13000, wisdom_file, timer), 13122U);  // 2 3^8
+    EXPECT_GT(timed, 0);
+
+    // Already chosen in this process
+    timed = 0;
+    EXPECT_EQ(planner.fft_size(13000, wisdom_file, timer), 13122U);
+    EXPECT_EQ(timed, 0);
+
+    std::ifstream file(wisdom_file);
+    std::string line;
+    bool stored = false;
+    while (std::getline(file, line))
+        {
+            stored = stored or (line == "13000 13122");
+        }
+    EXPECT_TRUE(stored);
+    file.close();
+
+    // Choices found in a wisdom file are not timed again
+    const std::string other_wisdom_file = "./acq_fft_planner_test_wisdom_2.txt";
+    std::ofstream other_file(other_wisdom_file);
+    other_file << "# comment\n26001 26244\n26003 26003\n26005 26011\n";
+    other_file.close();
+    EXPECT_EQ(planner.fft_size(26001, other_wisdom_file, timer), 26244U);
+    EXPECT_EQ(planner.fft_size(26003, other_wisdom_file, timer), 26003U);
+    EXPECT_EQ(timed, 0);
+    // Invalid entries (26011 is prime) are timed again
+    planner.fft_size(26005, other_wisdom_file, timer);
+    EXPECT_GT(timed, 0);
+
+    std::remove(wisdom_file.c_str());
+    std::remove(other_wisdom_file.c_str());
+}
@@ -0,0 +1,68 @@
+/*!
+ * \file acq_shared_spectra_test.cc
+ * \brief  This file implements unit tests for the Acq_Shared_Spectra class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acq_shared_spectra.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+TEST(AcqSharedSpectraTest, SameKeySameInstance)
+{
+    std::shared_ptr<Acq_Shared_Spectra> a = Acq_Shared_Spectra::get_instance("1C_gr_complex_4000000_4000");
+    std::shared_ptr<Acq_Shared_Spectra> b = Acq_Shared_Spectra::get_instance("1C_gr_complex_4000000_4000");
+    std::shared_ptr<Acq_Shared_Spectra> c = Acq_Shared_Spectra::get_instance("1B_gr_complex_4000000_4000");
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_NE(a.get(), c.get());
+}
+
+
+TEST(AcqSharedSpectraTest, ComputedOncePerSampleStamp)
+{
+    Acq_Shared_Spectra server;
+    std::atomic<int> computations{0};
+    auto compute = [&computations](Acq_Shared_Spectra::Spectra& spectra) {
+        computations++;
+        spectra = Acq_Shared_Spectra::Spectra(3, volk_gnsssdr::vector<std::complex<float>>(16, std::complex<float>(1.0, 0.0)));
+    };
+
+    const int num_channels = 8;
+    std::vector<std::thread> channels;
+    std::vector<std::shared_ptr<const Acq_Shared_Spectra::Spectra>> results(num_channels);
+    for (int i = 0; i < num_channels; i++)
+        {
+            channels.emplace_back([&server, &compute, &results, i]() { results[i] = server.get_spectra(4000, compute); });
+        }
+    for (auto& channel : channels)
+        {
+            channel.join();
+        }
+
+    EXPECT_EQ(computations, 1);
+    EXPECT_EQ(server.misses(), 1ULL);
+    EXPECT_EQ(server.hits(), static_cast<uint64_t>(num_channels - 1));
+    for (int i = 0; i < num_channels; i++)
+        {
+            EXPECT_EQ(results[i].get(), results[0].get());
+            ASSERT_EQ(results[i]->size(), 3U);
+        }
+
+    server.get_spectra(8000, compute);
+    EXPECT_EQ(computations, 2);
+}
@@ -0,0 +1,399 @@
+/*!
+ * \file acq_throughput_test.cc
+ * \brief This file implements a throughput benchmark of the acquisition
+ * blocks. It sweeps the sampling rate, the coherent and non-coherent
+ * integration, the Doppler span and the item type, and reports dwells per
+ * second, nanoseconds per grid cell and peak memory in a CSV file.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_interface.h"
+#include "concurrent_queue.h"
+#include "gnss_block_factory.h"
+#include "gnss_block_interface.h"
+#include "gnss_synchro.h"
+#include "in_memory_configuration.h"
+#include <gnuradio/top_block.h>
+#include <pmt/pmt.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#endif
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+DEFINE_string(acq_throughput_implementations, std::string("all"), "Comma-separated list of acquisition implementations to benchmark, or all");
+DEFINE_string(acq_throughput_item_types, std::string("gr_complex,cshort"), "Comma-separated list of item types. Implementations not supporting an item type are skipped");
+DEFINE_string(acq_throughput_fs_sps, std::string("4000000"), "Comma-separated list of sampling rates, in samples per second");
+DEFINE_string(acq_throughput_coherent_periods, std::string("1"), "Comma-separated list of coherent integration times, in multiples of the minimum integration time of each implementation");
+DEFINE_string(acq_throughput_max_dwells, std::string("1"), "Comma-separated list of numbers of non-coherent integrations");
+DEFINE_string(acq_throughput_doppler_max, std::string("5000"), "Comma-separated list of maximum Doppler shifts, in Hz");
+DEFINE_int32(acq_throughput_doppler_step, 250, "Doppler step, in Hz");
+DEFINE_int32(acq_throughput_attempts, 10, "Number of measured acquisition attempts per configuration");
+DEFINE_string(acq_throughput_output, std::string("./acq_throughput.csv"), "File where the results are written in CSV format");
+
+
+// ######## GNURADIO BLOCK MESSAGE RECEVER #########
+class AcqThroughputTest_msg_rx;
+
+#if GNURADIO_USES_STD_POINTERS
+using AcqThroughputTest_msg_rx_sptr = std::shared_ptr<AcqThroughputTest_msg_rx>;
+#else
+using AcqThroughputTest_msg_rx_sptr = boost::shared_ptr<AcqThroughputTest_msg_rx>;
+#endif
+
+AcqThroughputTest_msg_rx_sptr AcqThroughputTest_msg_rx_make(Concurrent_Queue<int>& queue);
+
+class AcqThroughputTest_msg_rx : public gr::block
+{
+private:
+    friend AcqThroughputTest_msg_rx_sptr AcqThroughputTest_msg_rx_make(Concurrent_Queue<int>& queue);
+    void msg_handler_events(pmt::pmt_t msg);
+    explicit AcqThroughputTest_msg_rx(Concurrent_Queue<int>& queue);
+    Concurrent_Queue<int>& channel_internal_queue;
+
+public:
+    ~AcqThroughputTest_msg_rx();
+};
+
+
+AcqThroughputTest_msg_rx_sptr AcqThroughputTest_msg_rx_make(Concurrent_Queue<int>& queue)
+{
+    return AcqThroughputTest_msg_rx_sptr(new AcqThroughputTest_msg_rx(queue));
+}
+
+
+void AcqThroughputTest_msg_rx::msg_handler_events(pmt::pmt_t msg)
+{
+    try
+        {
+            int64_t message = pmt::to_long(std::move(msg));
+            channel_internal_queue.push(static_cast<int>(message));
+        }
+    catch (boost::bad_any_cast& e)
+        {
+            LOG(WARNING) << "msg_handler_telemetry Bad any cast!";
+        }
+}
+
+
+AcqThroughputTest_msg_rx::AcqThroughputTest_msg_rx(Concurrent_Queue<int>& queue) : gr::block("AcqThroughputTest_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)), channel_internal_queue(queue)
+{
+    this->message_port_register_in(pmt::mp("events"));
+    this->set_msg_handler(pmt::mp("events"), boost::bind(&AcqThroughputTest_msg_rx::msg_handler_events, this, _1));
+}
+
+
+AcqThroughputTest_msg_rx::~AcqThroughputTest_msg_rx() = default;
+
+// -----------------------------------------
+
+
+class AcquisitionThroughputTest : public ::testing::Test
+{
+protected:
+    struct Implementation
+    {
+        std::string name;
+        std::string signal;
+        char system;
+        unsigned int integration_unit_ms;  // minimum coherent integration time
+        bool supports_cshort;
+    };
+
+    struct Configuration
+    {
+        Implementation implementation;
+        std::string item_type;
+        double fs;
+        unsigned int coherent_ms;
+        unsigned int max_dwells;
+        unsigned int doppler_max;
+    };
+
+    AcquisitionThroughputTest()
+    {
+        // Every PCPS-based acquisition implementation that runs on a plain CPU
+        implementations = {
+            {"GPS_L1_CA_PCPS_Acquisition", "1C", 'G', 1, true},
+            {"GPS_L1_CA_PCPS_Acquisition_Fine_Doppler", "1C", 'G', 1, false},
+            {"GPS_L1_CA_PCPS_QuickSync_Acquisition", "1C", 'G', 4, false},
+            {"GPS_L1_CA_PCPS_Tong_Acquisition", "1C", 'G', 1, false},
+            {"GPS_L2_M_PCPS_Acquisition", "2S", 'G', 20, true},
+            {"GPS_L5i_PCPS_Acquisition", "L5", 'G', 1, true},
+            {"Galileo_E1_PCPS_Ambiguous_Acquisition", "1B", 'E', 4, true},
+            {"Galileo_E1_PCPS_8ms_Ambiguous_Acquisition", "1B", 'E', 4, false},
+            {"Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition", "1B", 'E', 8, false},
+            {"Galileo_E1_PCPS_Tong_Ambiguous_Acquisition", "1B", 'E', 4, false},
+            {"Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition", "1B", 'E', 4, false},
+            {"Galileo_E5a_Pcps_Acquisition", "5X", 'E', 1, true},
+            {"GLONASS_L1_CA_PCPS_Acquisition", "1G", 'R', 1, true},
+            {"GLONASS_L2_CA_PCPS_Acquisition", "2G", 'R', 1, true},
+            {"BEIDOU_B1I_PCPS_Acquisition", "B1", 'C', 1, true},
+            {"BEIDOU_B3I_PCPS_Acquisition", "B3", 'C', 1, true}};
+        doppler_step = static_cast<unsigned int>(FLAGS_acq_throughput_doppler_step);
+        attempts = FLAGS_acq_throughput_attempts;
+
+        // Noise only: no satellite is ever detected, so each attempt runs all its dwells
+        const size_t num_samples = 1U << 18U;
+        std::mt19937 generator(1);
+        std::normal_distribution<float> noise(0.0, 1.0);
+        samples_complex.resize(num_samples);
+        samples_short.resize(2 * num_samples);
+        for (size_t n = 0; n < num_samples; n++)
+            {
+                samples_complex[n] = gr_complex(noise(generator), noise(generator));
+                samples_short[2 * n] = static_cast<int16_t>(std::round(samples_complex[n].real() * 32.0F));
+                samples_short[2 * n + 1] = static_cast<int16_t>(std::round(samples_complex[n].imag() * 32.0F));
+            }
+    }
+
+    ~AcquisitionThroughputTest() override = default;
+
+    std::vector<std::string> split_list(const std::string& list) const;
+    std::vector<Configuration> configurations() const;
+    int64_t read_status_kb(const std::string& key) const;
+    void reset_peak_memory() const;
+    void measure(const Configuration& conf, std::ostream& output);
+
+    std::vector<Implementation> implementations;
+    std::vector<gr_complex> samples_complex;
+    std::vector<int16_t> samples_short;
+    unsigned int doppler_step;
+    int attempts;
+};
+
+
+std::vector<std::string> AcquisitionThroughputTest::split_list(const std::string& list) const
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        {
+            if (!item.empty())
+                {
+                    items.push_back(item);
+                }
+        }
+    return items;
+}
+
+
+std::vector<AcquisitionThroughputTest::Configuration> AcquisitionThroughputTest::configurations() const
+{
+    const std::vector<std::string> selected = split_list(FLAGS_acq_throughput_implementations);
+    const bool all = (selected.size() == 1) and (selected[0] == "all");
+    std::vector<Configuration> confs;
+    for (const auto& implementation : implementations)
+        {
+            if (!all and std::find(selected.begin(), selected.end(), implementation.name) == selected.end())
+                {
+                    continue;
+                }
+            for (const auto& item_type : split_list(FLAGS_acq_throughput_item_types))
+                {
+                    if (item_type == "cshort" and !implementation.supports_cshort)
+                        {
+                            continue;
+                        }
+                    for (const auto& fs : split_list(FLAGS_acq_throughput_fs_sps))
+                        {
+                            for (const auto& periods : split_list(FLAGS_acq_throughput_coherent_periods))
+                                {
+                                    for (const auto& max_dwells : split_list(FLAGS_acq_throughput_max_dwells))
+                                        {
+                                            for (const auto& doppler_max : split_list(FLAGS_acq_throughput_doppler_max))
+                                                {
+                                                    confs.push_back({implementation, item_type, std::stod(fs),
+                                                        implementation.integration_unit_ms * static_cast<unsigned int>(std::stoul(periods)),
+                                                        static_cast<unsigned int>(std::stoul(max_dwells)),
+                                                        static_cast<unsigned int>(std::stoul(doppler_max))});
+                                                }
+                                        }
+                                }
+                        }
+                }
+        }
+    return confs;
+}
+
+
+int64_t AcquisitionThroughputTest::read_status_kb(const std::string& key) const
+{
+    // Linux only. Returns -1 if the value is not available.
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+        {
+            if (line.compare(0, key.size() + 1, key + ":") == 0)
+                {
+                    std::istringstream value(line.substr(key.size() + 1));
+                    int64_t kb = -1;
+                    value >> kb;
+                    return kb;
+                }
+        }
+    return -1;
+}
+
+
+void AcquisitionThroughputTest::reset_peak_memory() const
+{
+    // Resets VmHWM to the current resident set size (Linux >= 4.0)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open())
+        {
+            clear_refs << "5";
+        }
+}
+
+
+void AcquisitionThroughputTest::measure(const Configuration& conf, std::ostream& output)
+{
+    const std::string role = "Acquisition_" + conf.implementation.signal;
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.internal_fs_sps", std::to_string(static_cast<int64_t>(conf.fs)));
+    config->set_property(role + ".implementation", conf.implementation.name);
+    config->set_property(role + ".item_type", conf.item_type);
+    config->set_property(role + ".coherent_integration_time_ms", std::to_string(conf.coherent_ms));
+    config->set_property(role + ".max_dwells", std::to_string(conf.max_dwells));
+    config->set_property(role + ".doppler_max", std::to_string(conf.doppler_max));
+    config->set_property(role + ".doppler_step", std::to_string(doppler_step));
+    config->set_property(role + ".pfa", "0.0");
+    config->set_property(role + ".threshold", "1e9");
+    config->set_property(role + ".blocking", "true");
+    config->set_property(role + ".bit_transition_flag", "false");
+    config->set_property(role + ".repeat_satellite", "false");
+    config->set_property(role + ".dump", "false");
+    // The Tong detector runs max_dwells dwells before declaring the satellite absent
+    config->set_property(role + ".tong_init_val", std::to_string(conf.max_dwells));
+    config->set_property(role + ".tong_max_val", std::to_string(conf.max_dwells + 1));
+    config->set_property(role + ".tong_max_dwells", std::to_string(conf.max_dwells));
+
+    reset_peak_memory();
+    const int64_t rss_before_kb = read_status_kb("VmRSS");
+
+    Concurrent_Queue<int> channel_internal_queue;
+    Gnss_Synchro gnss_synchro{};
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = conf.implementation.system;
+    conf.implementation.signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = 1;
+
+    std::shared_ptr<GNSSBlockFactory> factory = std::make_shared<GNSSBlockFactory>();
+    std::shared_ptr<GNSSBlockInterface> acq_ = factory->GetBlock(config, role, conf.implementation.name, 1, 0);
+    std::shared_ptr<AcquisitionInterface> acquisition = std::dynamic_pointer_cast<AcquisitionInterface>(acq_);
+    ASSERT_NE(acquisition, nullptr) << "Cannot instantiate " << conf.implementation.name;
+
+    gr::top_block_sptr top_block = gr::make_top_block("Acquisition throughput test");
+    AcqThroughputTest_msg_rx_sptr msg_rx = AcqThroughputTest_msg_rx_make(channel_internal_queue);
+    acquisition->set_channel(0);
+    acquisition->set_gnss_synchro(&gnss_synchro);
+    acquisition->set_threshold(1e9);
+    acquisition->set_doppler_max(conf.doppler_max);
+    acquisition->set_doppler_step(doppler_step);
+    acquisition->connect(top_block);
+    if (conf.item_type == "cshort")
+        {
+            gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(samples_short, true, 2);
+            top_block->connect(source, 0, acquisition->get_left_block(), 0);
+        }
+    else
+        {
+            gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples_complex, true);
+            top_block->connect(source, 0, acquisition->get_left_block(), 0);
+        }
+    top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    acquisition->set_local_code();
+    acquisition->init();
+    top_block->start();
+
+    // The first attempt allocates the buffers and plans the FFTs, so it is not measured
+    std::chrono::duration<double> elapsed_seconds(0.0);
+    int message = 0;
+    bool timeout = false;
+    for (int attempt = -1; attempt < attempts and !timeout; attempt++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            acquisition->reset();
+            timeout = !channel_internal_queue.timed_wait_and_pop(message, 60000);
+            if (attempt >= 0)
+                {
+                    elapsed_seconds += std::chrono::steady_clock::now() - start;
+                }
+        }
+    top_block->stop();
+    top_block->wait();
+    const int64_t peak_rss_kb = read_status_kb("VmHWM");
+    ASSERT_FALSE(timeout) << conf.implementation.name << " did not finish an acquisition attempt.";
+
+    // Cells of the equivalent PCPS search grid, also for the implementations that fold the code
+    const auto doppler_bins = static_cast<uint64_t>(std::ceil(2.0 * static_cast<double>(conf.doppler_max) / static_cast<double>(doppler_step))) + 1U;
+    const auto code_bins = static_cast<uint64_t>(std::round(conf.fs * static_cast<double>(conf.coherent_ms) / 1000.0));
+    const double dwells = static_cast<double>(attempts) * static_cast<double>(conf.max_dwells);
+    const double dwells_per_s = dwells / elapsed_seconds.count();
+    const double ns_per_cell = elapsed_seconds.count() * 1e9 / (dwells * static_cast<double>(doppler_bins * code_bins));
+    const double mean_attempt_us = elapsed_seconds.count() * 1e6 / static_cast<double>(attempts);
+    const int64_t block_rss_kb = (peak_rss_kb >= 0 and rss_before_kb >= 0) ? peak_rss_kb - rss_before_kb : -1;
+
+    output << conf.implementation.name << "," << conf.item_type << "," << static_cast<int64_t>(conf.fs) << "," << conf.coherent_ms << ","
+           << conf.max_dwells << "," << conf.doppler_max << "," << doppler_step << "," << doppler_bins << "," << code_bins << ","
+           << attempts << "," << dwells_per_s << "," << ns_per_cell << "," << mean_attempt_us << "," << peak_rss_kb << "," << block_rss_kb << std::endl;
+    std::cout << std::setw(50) << std::left << conf.implementation.name << std::right << std::setw(11) << conf.item_type
+              << std::setw(10) << conf.fs / 1e6 << std::setw(5) << conf.coherent_ms << std::setw(7) << conf.max_dwells
+              << std::setw(10) << conf.doppler_max << std::setw(11) << dwells_per_s << std::setw(10) << ns_per_cell
+              << std::setw(12) << block_rss_kb << std::endl;
+}
+
+
+TEST_F(AcquisitionThroughputTest, SweepConfigurations)
+{
+    ASSERT_GT(attempts, 0);
+    ASSERT_GT(doppler_step, 0U);
+    const std::vector<Configuration> confs = configurations();
+    ASSERT_FALSE(confs.empty()) << "No acquisition configuration selected.";
+
+    std::ofstream output(FLAGS_acq_throughput_output, std::ios::out | std::ios::trunc);
+    ASSERT_TRUE(output.is_open()) << "Cannot open " << FLAGS_acq_throughput_output;
+    output << "implementation,item_type,fs_sps,coherent_ms,max_dwells,doppler_max_hz,doppler_step_hz,"
+           << "doppler_bins,code_bins,attempts,dwells_per_s,ns_per_cell,mean_attempt_us,peak_rss_kb,block_rss_kb" << std::endl;
+
+    std::cout << std::setw(50) << std::left << "implementation" << std::right << std::setw(11) << "item_type"
+              << std::setw(10) << "fs [Msps]" << std::setw(5) << "Tc" << std::setw(7) << "dwells"
+              << std::setw(10) << "Dmax [Hz]" << std::setw(11) << "dwells/s" << std::setw(10) << "ns/cell"
+              << std::setw(12) << "block [kB]" << std::endl;
+    for (const auto& conf : confs)
+        {
+            measure(conf, output);
+        }
+    std::cout << "Results written to " << FLAGS_acq_throughput_output << std::endl;
+}
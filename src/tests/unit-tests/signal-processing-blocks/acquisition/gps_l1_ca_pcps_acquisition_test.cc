@@ -37,13 +37,21 @@
 #include <gnuradio/blocks/null_sink.h>
 #include <gnuradio/top_block.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #ifdef GR_GREATER_38
 #include <gnuradio/analog/sig_source.h>
+#include <gnuradio/blocks/vector_source.h>
 #else
 #include <gnuradio/analog/sig_source_c.h>
+#include <gnuradio/blocks/vector_source_b.h>
+#include <gnuradio/blocks/vector_source_s.h>
 #endif
 
 #if HAS_STD_FILESYSTEM
@@ -387,3 +395,497 @@ TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, ValidationOfResults /*unused*/)
             plot_grid();
         }
 }
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, ValidationOfResultsFrequencyDomainDoppler /*unused*/)
+{
+    std::chrono::time_point<std::chrono::system_clock> start;
+    std::chrono::time_point<std::chrono::system_clock> end;
+    std::chrono::duration<double> elapsed_seconds(0.0);
+    top_block = gr::make_top_block("Acquisition test");
+
+    double expected_delay_samples = 524;
+    double expected_doppler_hz = 1680;
+
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+    config->set_property("Acquisition_1C.frequency_domain_doppler", "true");
+
+#if GNURADIO_USES_STD_POINTERS
+    std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+    std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+    boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+    boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+    ASSERT_NO_THROW({
+        acquisition->set_channel(1);
+    }) << "Failure setting channel.";
+
+    ASSERT_NO_THROW({
+        acquisition->set_gnss_synchro(&gnss_synchro);
+    }) << "Failure setting gnss_synchro.";
+
+    ASSERT_NO_THROW({
+        acquisition->set_threshold(0.001);
+    }) << "Failure setting threshold.";
+
+    ASSERT_NO_THROW({
+        acquisition->set_doppler_max(doppler_max);
+    }) << "Failure setting doppler_max.";
+
+    ASSERT_NO_THROW({
+        acquisition->set_doppler_step(doppler_step);
+    }) << "Failure setting doppler_step.";
+
+    ASSERT_NO_THROW({
+        acquisition->connect(top_block);
+    }) << "Failure connecting acquisition to the top_block.";
+
+    ASSERT_NO_THROW({
+        std::string path = std::string(TEST_PATH);
+        std::string file = path + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        const char *file_name = file.c_str();
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file_name, false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test.";
+
+    acquisition->set_local_code();
+    acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+    acquisition->init();
+
+    EXPECT_NO_THROW({
+        start = std::chrono::system_clock::now();
+        top_block->run();  // Start threads and wait
+        end = std::chrono::system_clock::now();
+        elapsed_seconds = end - start;
+    }) << "Failure running the top_block.";
+
+    uint64_t nsamples = gnss_synchro.Acq_samplestamp_samples;
+    std::cout << "Acquired " << nsamples << " samples in " << elapsed_seconds.count() * 1e6 << " microseconds (frequency-domain Doppler search)" << std::endl;
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    double delay_error_samples = std::abs(expected_delay_samples - gnss_synchro.Acq_delay_samples);
+    auto delay_error_chips = static_cast<float>(delay_error_samples * 1023 / 4000);
+    double doppler_error_hz = std::abs(expected_doppler_hz - gnss_synchro.Acq_doppler_hz);
+
+    EXPECT_LE(doppler_error_hz, 666) << "Doppler error exceeds the expected value: 666 Hz = 2/(3*integration period)";
+    EXPECT_LT(delay_error_chips, 0.5) << "Delay error exceeds the expected value: 0.5 chips";
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, ParallelDopplerSearchMatchesSerial /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+
+    auto run_acquisition = [this](const std::string &doppler_bin_workers, Gnss_Synchro &synchro) {
+        config->set_property("Acquisition_1C.doppler_bin_workers", doppler_bin_workers);
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->init();
+        top_block->run();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro serial_synchro{};
+    Gnss_Synchro parallel_synchro{};
+    EXPECT_NO_THROW({
+        ASSERT_EQ(1, run_acquisition("1", serial_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("4", parallel_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+    }) << "Failure running the top_block.";
+
+    // The parallel search must produce exactly the same result as the serial one
+    EXPECT_EQ(serial_synchro.Acq_delay_samples, parallel_synchro.Acq_delay_samples);
+    EXPECT_EQ(serial_synchro.Acq_doppler_hz, parallel_synchro.Acq_doppler_hz);
+    EXPECT_EQ(serial_synchro.Acq_samplestamp_samples, parallel_synchro.Acq_samplestamp_samples);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, StreamingStatisticsMatchGrid /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+
+    auto run_acquisition = [this](const std::string &streaming_statistics, const std::string &doppler_bin_workers, Gnss_Synchro &synchro) {
+        config->set_property("Acquisition_1C.streaming_statistics", streaming_statistics);
+        config->set_property("Acquisition_1C.doppler_bin_workers", doppler_bin_workers);
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->init();
+        top_block->run();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro grid_synchro{};
+    Gnss_Synchro streaming_synchro{};
+    Gnss_Synchro parallel_streaming_synchro{};
+    EXPECT_NO_THROW({
+        ASSERT_EQ(1, run_acquisition("false", "1", grid_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("true", "1", streaming_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("true", "4", parallel_streaming_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+    }) << "Failure running the top_block.";
+
+    // Computing the statistics on the fly must not change the result
+    EXPECT_EQ(grid_synchro.Acq_delay_samples, streaming_synchro.Acq_delay_samples);
+    EXPECT_EQ(grid_synchro.Acq_doppler_hz, streaming_synchro.Acq_doppler_hz);
+    EXPECT_EQ(grid_synchro.Acq_delay_samples, parallel_streaming_synchro.Acq_delay_samples);
+    EXPECT_EQ(grid_synchro.Acq_doppler_hz, parallel_streaming_synchro.Acq_doppler_hz);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, StreamingStatisticsMatchGridWithSeveralDwells /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+    // Both dwells of the file are integrated, and the acquisition fails
+    config->set_property("Acquisition_1C.max_dwells", "2");
+
+    auto run_acquisition = [this](const std::string &streaming_statistics, const std::string &doppler_bin_workers, Gnss_Synchro &synchro) {
+        config->set_property("Acquisition_1C.streaming_statistics", streaming_statistics);
+        config->set_property("Acquisition_1C.doppler_bin_workers", doppler_bin_workers);
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(1000.0);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->init();
+        top_block->run();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro grid_synchro{};
+    Gnss_Synchro streaming_synchro{};
+    Gnss_Synchro parallel_streaming_synchro{};
+    EXPECT_NO_THROW({
+        ASSERT_EQ(2, run_acquisition("false", "1", grid_synchro)) << "Acquisition failure. Expected message: 2=ACQ FAIL.";
+        ASSERT_EQ(2, run_acquisition("true", "1", streaming_synchro)) << "Acquisition failure. Expected message: 2=ACQ FAIL.";
+        ASSERT_EQ(2, run_acquisition("true", "4", parallel_streaming_synchro)) << "Acquisition failure. Expected message: 2=ACQ FAIL.";
+    }) << "Failure running the top_block.";
+
+    // Correlating the bins again with the previous dwell must give the same
+    // non-coherent integration as the grid
+    EXPECT_EQ(grid_synchro.Acq_delay_samples, streaming_synchro.Acq_delay_samples);
+    EXPECT_EQ(grid_synchro.Acq_doppler_hz, streaming_synchro.Acq_doppler_hz);
+    EXPECT_EQ(grid_synchro.Acq_delay_samples, parallel_streaming_synchro.Acq_delay_samples);
+    EXPECT_EQ(grid_synchro.Acq_doppler_hz, parallel_streaming_synchro.Acq_doppler_hz);
+    EXPECT_EQ(grid_synchro.Acq_samplestamp_samples, streaming_synchro.Acq_samplestamp_samples);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, PipelinedDwellsKeepSampleStamps /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+
+    auto run_acquisition = [this](const std::string &blocking, const std::string &dwell_buffers, Gnss_Synchro &synchro) {
+        config->set_property("Acquisition_1C.blocking", blocking);
+        config->set_property("Acquisition_1C.dwell_buffers", dwell_buffers);
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        // The file is repeated, so the flowgraph keeps running until the (non-blocking) dwell is processed
+        std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), true);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->init();
+        top_block->start();
+        for (int i = 0; (i < 100) and (msg_rx->rx_message == 0); i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        top_block->stop();
+        top_block->wait();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro blocking_synchro{};
+    Gnss_Synchro pipelined_synchro{};
+    EXPECT_NO_THROW({
+        ASSERT_EQ(1, run_acquisition("true", "1", blocking_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("false", "3", pipelined_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+    }) << "Failure running the top_block.";
+
+    // The first dwell is captured from the first sample in both cases
+    EXPECT_EQ(blocking_synchro.Acq_samplestamp_samples, pipelined_synchro.Acq_samplestamp_samples);
+    EXPECT_EQ(blocking_synchro.Acq_delay_samples, pipelined_synchro.Acq_delay_samples);
+    EXPECT_EQ(blocking_synchro.Acq_doppler_hz, pipelined_synchro.Acq_doppler_hz);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, PipelinedDwellsVerifyWithFreshSamples /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+    config->set_property("Acquisition_1C.blocking", "false");
+    config->set_property("Acquisition_1C.dwell_buffers", "3");
+    config->set_property("Acquisition_1C.make_two_steps", "true");
+    config->set_property("Acquisition_1C.second_nbins", "4");
+    config->set_property("Acquisition_1C.second_doppler_step", "25");
+    const uint64_t samples_per_dwell = 4000;  // 1 ms at 4 Msps
+
+    Gnss_Synchro synchro = gnss_synchro;
+    top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+    std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+    std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+    boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+    boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+    acquisition->set_channel(1);
+    acquisition->set_gnss_synchro(&synchro);
+    acquisition->set_threshold(0.001);
+    acquisition->set_doppler_max(doppler_max);
+    acquisition->set_doppler_step(doppler_step);
+    acquisition->connect(top_block);
+    std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+    gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), true);
+    top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+    top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    acquisition->set_local_code();
+    acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+    acquisition->init();
+    EXPECT_NO_THROW({
+        top_block->start();
+        for (int i = 0; (i < 100) and (msg_rx->rx_message == 0); i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        top_block->stop();
+        top_block->wait();
+    }) << "Failure running the top_block.";
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    // The first step is positive on the first dwell. The dwells queued
+    // meanwhile are discarded, and the verification uses a dwell captured
+    // after the restart, which consumes some input
+    EXPECT_GT(synchro.Acq_samplestamp_samples, 2 * samples_per_dwell);
+    EXPECT_EQ(25U, synchro.Acq_doppler_step);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, IntegerWipeoffWithCbyteAndCshortSamples /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+
+    // The samples of the file quantized to 8 bits, interleaved as cbyte items
+    std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+    std::ifstream samples_file(file, std::ios::binary);
+    std::vector<gr_complex> samples;
+    gr_complex sample;
+    while (samples_file.read(reinterpret_cast<char *>(&sample), sizeof(gr_complex)))
+        {
+            samples.push_back(sample);
+        }
+    ASSERT_FALSE(samples.empty());
+    float max_component = 0.0;
+    for (const auto &s : samples)
+        {
+            max_component = std::max(max_component, std::max(std::abs(s.real()), std::abs(s.imag())));
+        }
+    std::vector<unsigned char> cbyte_samples;
+    // and to 12 bits as cshort items, wider than integer_input_bits
+    std::vector<int16_t> cshort_samples;
+    for (const auto &s : samples)
+        {
+            cbyte_samples.push_back(static_cast<unsigned char>(static_cast<int8_t>(std::round(127.0F * s.real() / max_component))));
+            cbyte_samples.push_back(static_cast<unsigned char>(static_cast<int8_t>(std::round(127.0F * s.imag() / max_component))));
+            cshort_samples.push_back(static_cast<int16_t>(std::round(2047.0F * s.real() / max_component)));
+            cshort_samples.push_back(static_cast<int16_t>(std::round(2047.0F * s.imag() / max_component)));
+        }
+
+    auto run_acquisition = [&, this](const std::string &item_type, Gnss_Synchro &synchro) {
+        config->set_property("Acquisition_1C.item_type", item_type);
+        config->set_property("Acquisition_1C.integer_doppler_wipeoff", item_type == "gr_complex" ? "false" : "true");
+        config->set_property("Acquisition_1C.integer_input_bits", "8");
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        if (item_type == "cbyte")
+            {
+                // The cbyte samples are fed to the acquisition block, without conversion
+                EXPECT_EQ(acquisition->get_left_block(), acquisition->get_right_block());
+                top_block->connect(gr::blocks::vector_source_b::make(cbyte_samples, false, 2), 0, acquisition->get_left_block(), 0);
+            }
+        else if (item_type == "cshort")
+            {
+                top_block->connect(gr::blocks::vector_source_s::make(cshort_samples, false, 2), 0, acquisition->get_left_block(), 0);
+            }
+        else
+            {
+                top_block->connect(gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false), 0, acquisition->get_left_block(), 0);
+            }
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->init();
+        top_block->run();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro float_synchro{};
+    Gnss_Synchro cbyte_synchro{};
+    Gnss_Synchro cshort_synchro{};
+    EXPECT_NO_THROW({
+        ASSERT_EQ(1, run_acquisition("gr_complex", float_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("cbyte", cbyte_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition("cshort", cshort_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+    }) << "Failure running the top_block.";
+
+    // The 8-bit quantization and the 16-bit wipeoff must not move the peak
+    EXPECT_EQ(float_synchro.Acq_delay_samples, cbyte_synchro.Acq_delay_samples);
+    EXPECT_EQ(float_synchro.Acq_doppler_hz, cbyte_synchro.Acq_doppler_hz);
+    EXPECT_EQ(float_synchro.Acq_samplestamp_samples, cbyte_synchro.Acq_samplestamp_samples);
+
+    // The 12-bit samples are clamped to 8 bits instead of wrapping around
+    // in the 16-bit wipeoff, which would hide the peak
+    EXPECT_EQ(float_synchro.Acq_delay_samples, cshort_synchro.Acq_delay_samples);
+    EXPECT_EQ(float_synchro.Acq_doppler_hz, cshort_synchro.Acq_doppler_hz);
+}
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest /*unused*/, NarrowSearchWindows /*unused*/)
+{
+    init();
+    config->set_property("Acquisition_1C.dump", "false");
+
+    auto run_acquisition = [this](int doppler_center, unsigned int doppler_window, double code_delay_samples, unsigned int code_window, Gnss_Synchro &synchro) {
+        synchro = gnss_synchro;
+        top_block = gr::make_top_block("Acquisition test");
+#if GNURADIO_USES_STD_POINTERS
+        std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        std::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#else
+        boost::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = boost::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0);
+        boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+#endif
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(doppler_max);
+        acquisition->set_doppler_step(doppler_step);
+        acquisition->connect(top_block);
+        std::string file = std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+        acquisition->set_local_code();
+        acquisition->set_state(1);  // Ensure that acquisition starts at the first sample
+        acquisition->set_doppler_center(doppler_center);
+        acquisition->set_doppler_window(doppler_window);
+        acquisition->set_code_phase_window(0, code_delay_samples, 4000.0, code_window);
+        acquisition->init();
+        top_block->run();
+        return msg_rx->rx_message;
+    };
+
+    Gnss_Synchro full_synchro{};
+    Gnss_Synchro narrow_synchro{};
+    Gnss_Synchro single_bin_synchro{};
+    Gnss_Synchro misplaced_synchro{};
+    int misplaced_message = 0;
+    EXPECT_NO_THROW({
+        ASSERT_EQ(1, run_acquisition(0, 0, 0.0, 0, full_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        ASSERT_EQ(1, run_acquisition(1500, 500, 524.0, 40, narrow_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        // With a few bins around the signal, the noise power is measured out of them
+        ASSERT_EQ(1, run_acquisition(static_cast<int>(full_synchro.Acq_doppler_hz), 1, 524.0, 40, single_bin_synchro)) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+        misplaced_message = run_acquisition(0, 0, 2000.0, 40, misplaced_synchro);
+    }) << "Failure running the top_block.";
+
+    // Windows containing the signal must find the same peak as the whole grid
+    EXPECT_EQ(full_synchro.Acq_delay_samples, narrow_synchro.Acq_delay_samples);
+    EXPECT_EQ(full_synchro.Acq_doppler_hz, narrow_synchro.Acq_doppler_hz);
+    EXPECT_LE(std::abs(narrow_synchro.Acq_doppler_hz - 1500.0), 500.0 + doppler_step);
+    EXPECT_EQ(full_synchro.Acq_delay_samples, single_bin_synchro.Acq_delay_samples);
+    EXPECT_EQ(full_synchro.Acq_doppler_hz, single_bin_synchro.Acq_doppler_hz);
+
+    // Code delays outside of the window are never reported
+    if (misplaced_message == 1)
+        {
+            EXPECT_LE(std::abs(misplaced_synchro.Acq_delay_samples - 2000.0), 42.0);
+        }
+}
@@ -0,0 +1,167 @@
+/*!
+ * \file dump_writer_test.cc
+ * \brief This file implements tests for the buffered dump files.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "dump_writer.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+class DumpWriterTest : public ::testing::Test
+{
+protected:
+#pragma pack(push, 1)
+    struct Record
+    {
+        uint32_t channel;
+        uint64_t index;
+        double value;
+    };
+#pragma pack(pop)
+
+    static const int NUM_RECORDS = 20000;
+
+    static void write_records(Dump_File& file, uint32_t channel)
+    {
+        for (int n = 0; n < NUM_RECORDS; n++)
+            {
+                Record record{channel, static_cast<uint64_t>(n), 0.5 * n};
+                file.write_record(record);
+            }
+    }
+
+    static std::vector<Record> read_records(const std::string& filename)
+    {
+        std::vector<Record> records;
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        Record record{};
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(Record)))
+            {
+                records.push_back(record);
+            }
+        return records;
+    }
+};
+
+
+TEST_F(DumpWriterTest, ConcurrentFilesKeepTheirRecords)
+{
+    const int num_files = 4;
+    std::vector<std::string> filenames;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_files; i++)
+        {
+            filenames.push_back("dump_writer_test_" + std::to_string(i) + ".dat");
+        }
+    for (int i = 0; i < num_files; i++)
+        {
+            threads.emplace_back([&filenames, i]() {
+                // Small blocks to exercise the wrap around of the ring
+                Dump_File file(Dump_File::Backpressure::Block, 1000, 4);
+                file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+                file.open(filenames[i], std::ios::out | std::ios::binary);
+                write_records(file, i);
+                EXPECT_EQ(file.tellp(), static_cast<std::streamoff>(NUM_RECORDS * sizeof(Record)));
+                file.close();
+                EXPECT_EQ(file.dropped_bytes(), 0U);
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    for (int i = 0; i < num_files; i++)
+        {
+            std::vector<Record> records = read_records(filenames[i]);
+            ASSERT_EQ(records.size(), static_cast<size_t>(NUM_RECORDS));
+            for (int n = 0; n < NUM_RECORDS; n++)
+                {
+                    ASSERT_EQ(records[n].channel, static_cast<uint32_t>(i));
+                    ASSERT_EQ(records[n].index, static_cast<uint64_t>(n));
+                    ASSERT_EQ(records[n].value, 0.5 * n);
+                }
+            std::remove(filenames[i].c_str());
+        }
+}
+
+
+TEST_F(DumpWriterTest, DropPolicyKeepsWholeRecords)
+{
+    const std::string filename("dump_writer_test_drop.dat");
+    Dump_File file(Dump_File::Backpressure::Drop, 1000, 2);
+    file.open(filename, std::ios::out | std::ios::binary);
+    write_records(file, 7);
+    file.close();
+
+    // Dropped records are missing as a whole, the rest keep their order
+    EXPECT_EQ(file.dropped_bytes() % sizeof(Record), 0U);
+    std::vector<Record> records = read_records(filename);
+    EXPECT_EQ(records.size() * sizeof(Record) + file.dropped_bytes(), NUM_RECORDS * sizeof(Record));
+    for (size_t n = 0; n < records.size(); n++)
+        {
+            ASSERT_EQ(records[n].channel, 7U);
+            ASSERT_EQ(records[n].value, 0.5 * records[n].index);
+            if (n > 0)
+                {
+                    ASSERT_GT(records[n].index, records[n - 1].index);
+                }
+        }
+    std::remove(filename.c_str());
+}
+
+
+TEST_F(DumpWriterTest, ReopenedFileKeepsRecords)
+{
+    // The ring is released by close() and allocated again by open()
+    Dump_File file(Dump_File::Backpressure::Block, 1000, 4);
+    for (int i = 0; i < 2; i++)
+        {
+            const std::string filename("dump_writer_test_reopen_" + std::to_string(i) + ".dat");
+            file.open(filename, std::ios::out | std::ios::binary);
+            ASSERT_TRUE(file.is_open());
+            write_records(file, i);
+            file.close();
+            std::vector<Record> records = read_records(filename);
+            ASSERT_EQ(records.size(), static_cast<size_t>(NUM_RECORDS));
+            for (int n = 0; n < NUM_RECORDS; n++)
+                {
+                    ASSERT_EQ(records[n].channel, static_cast<uint32_t>(i));
+                    ASSERT_EQ(records[n].index, static_cast<uint64_t>(n));
+                }
+            std::remove(filename.c_str());
+        }
+}
+
+
+TEST_F(DumpWriterTest, ClosedFileIgnoresWrites)
+{
+    Dump_File file;
+    EXPECT_FALSE(file.is_open());
+    Record record{};
+    file.write_record(record);
+    EXPECT_EQ(file.tellp(), 0);
+
+    file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    EXPECT_THROW(file.open("/nonexistent_directory/dump_writer_test.dat", std::ios::out | std::ios::binary), std::ios_base::failure);
+    EXPECT_THROW(file.write_record(record), std::ios_base::failure);
+}
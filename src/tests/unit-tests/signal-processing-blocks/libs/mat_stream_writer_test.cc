@@ -0,0 +1,209 @@
+/*!
+ * \file mat_stream_writer_test.cc
+ * \brief This file implements tests for the incremental MAT file writer.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mat_stream_writer.h"
+#include <gtest/gtest.h>
+#include <matio.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST(MatStreamWriterTest, AppendsChunks)
+{
+    const std::string filename("mat_stream_writer_test.mat");
+    const size_t rows = 3;
+    // Not a multiple of the chunk size, so the last chunk is written by close()
+    const size_t num_epochs = 2500;
+    {
+        Mat_Stream_Writer writer(1000);
+        const size_t time_var = writer.add_variable<double>("time");
+        const size_t count_var = writer.add_variable<uint32_t>("count", rows);
+        ASSERT_TRUE(writer.open(filename));
+        for (size_t n = 0; n < num_epochs; n++)
+            {
+                writer.append(time_var, 0.001 * n);
+                for (size_t r = 0; r < rows; r++)
+                    {
+                        writer.append(count_var, static_cast<uint32_t>(rows * n + r));
+                    }
+                writer.end_epoch();
+            }
+        EXPECT_EQ(writer.epochs(), num_epochs);
+    }
+
+    mat_t* matfp = Mat_Open(filename.c_str(), MAT_ACC_RDONLY);
+    ASSERT_TRUE(matfp != nullptr);
+    matvar_t* matvar = Mat_VarRead(matfp, "time");
+    ASSERT_TRUE(matvar != nullptr);
+    EXPECT_EQ(matvar->dims[0], 1U);
+    EXPECT_EQ(matvar->dims[1], num_epochs);
+    const auto* time = static_cast<const double*>(matvar->data);
+    for (size_t n = 0; n < num_epochs; n++)
+        {
+            EXPECT_DOUBLE_EQ(time[n], 0.001 * n);
+        }
+    Mat_VarFree(matvar);
+
+    matvar = Mat_VarRead(matfp, "count");
+    ASSERT_TRUE(matvar != nullptr);
+    EXPECT_EQ(matvar->class_type, MAT_C_UINT32);
+    EXPECT_EQ(matvar->dims[0], rows);
+    EXPECT_EQ(matvar->dims[1], num_epochs);
+    // Column-major, one column per epoch
+    const auto* count = static_cast<const uint32_t*>(matvar->data);
+    for (size_t k = 0; k < rows * num_epochs; k++)
+        {
+            EXPECT_EQ(count[k], k);
+        }
+    Mat_VarFree(matvar);
+    Mat_Close(matfp);
+    std::remove(filename.c_str());
+}
+
+
+TEST(MatStreamWriterTest, ConcurrentWriters)
+{
+    // One writer per channel, the chunks of all of them are written by the
+    // same background thread, with and without compression
+    const int num_writers = 4;
+    const size_t num_epochs = 3500;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_writers; i++)
+        {
+            threads.emplace_back([i]() {
+                Mat_Stream_Writer writer(100);
+                const size_t value_var = writer.add_variable<int32_t>("value");
+                writer.open("mat_stream_writer_test_" + std::to_string(i) + ".mat", i % 2 == 1);
+                for (size_t n = 0; n < num_epochs; n++)
+                    {
+                        writer.append(value_var, static_cast<int32_t>(i * num_epochs + n));
+                        writer.end_epoch();
+                    }
+                writer.close();
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    for (int i = 0; i < num_writers; i++)
+        {
+            const std::string filename("mat_stream_writer_test_" + std::to_string(i) + ".mat");
+            mat_t* matfp = Mat_Open(filename.c_str(), MAT_ACC_RDONLY);
+            ASSERT_TRUE(matfp != nullptr);
+            matvar_t* matvar = Mat_VarRead(matfp, "value");
+            ASSERT_TRUE(matvar != nullptr);
+            EXPECT_EQ(matvar->dims[1], num_epochs);
+            const auto* value = static_cast<const int32_t*>(matvar->data);
+            for (size_t n = 0; n < num_epochs; n++)
+                {
+                    ASSERT_EQ(value[n], static_cast<int32_t>(i * num_epochs + n));
+                }
+            Mat_VarFree(matvar);
+            Mat_Close(matfp);
+            std::remove(filename.c_str());
+        }
+}
+
+
+TEST(MatStreamWriterTest, EmptyFileIsRemoved)
+{
+    const std::string filename("mat_stream_writer_empty_test.mat");
+    Mat_Stream_Writer writer;
+    writer.add_variable<float>("value");
+    ASSERT_TRUE(writer.open(filename));
+    writer.close();
+    EXPECT_FALSE(writer.is_open());
+    std::ifstream file(filename);
+    EXPECT_FALSE(file.good());
+}
+
+
+TEST(MatStreamWriterTest, RejectsMismatchedTypes)
+{
+    const std::string filename("mat_stream_writer_mismatch_test.mat");
+    {
+        Mat_Stream_Writer writer(10);
+        const size_t value_var = writer.add_variable<double>("value");
+        ASSERT_TRUE(writer.open(filename));
+        // One chunk with the declared type is written
+        for (int n = 0; n < 10; n++)
+            {
+                EXPECT_TRUE(writer.append(value_var, static_cast<double>(n)));
+                writer.end_epoch();
+            }
+        // A float, of another size, and an int64_t, of the same size but of
+        // another class, are rejected, as well as an unknown variable
+        EXPECT_FALSE(writer.append(value_var, 1.0F));
+        EXPECT_FALSE(writer.append(value_var, static_cast<int64_t>(1)));
+        EXPECT_FALSE(writer.append(value_var + 1, 1.0));
+        writer.end_epoch();
+    }
+
+    // The epochs from the wrong one on are not written. With matio older
+    // than 1.5.13 the epochs are written by close(), so none is.
+    mat_t* matfp = Mat_Open(filename.c_str(), MAT_ACC_RDONLY);
+    ASSERT_TRUE(matfp != nullptr);
+    matvar_t* matvar = Mat_VarRead(matfp, "value");
+    if (matvar != nullptr)
+        {
+            EXPECT_EQ(matvar->dims[1], 10U);
+            Mat_VarFree(matvar);
+        }
+    Mat_Close(matfp);
+    std::remove(filename.c_str());
+}
+
+
+TEST(MatStreamWriterTest, RejectsMissingRows)
+{
+    const std::string filename("mat_stream_writer_rows_test.mat");
+    {
+        Mat_Stream_Writer writer(10);
+        const size_t value_var = writer.add_variable<int32_t>("value", 2);
+        ASSERT_TRUE(writer.open(filename));
+        for (int n = 0; n < 10; n++)
+            {
+                writer.append(value_var, static_cast<int32_t>(n));
+                writer.append(value_var, static_cast<int32_t>(n));
+                writer.end_epoch();
+            }
+        writer.append(value_var, 1);
+        writer.end_epoch();
+        // A complete epoch after the wrong one is not written either
+        writer.append(value_var, 1);
+        writer.append(value_var, 1);
+        writer.end_epoch();
+    }
+
+    mat_t* matfp = Mat_Open(filename.c_str(), MAT_ACC_RDONLY);
+    ASSERT_TRUE(matfp != nullptr);
+    matvar_t* matvar = Mat_VarRead(matfp, "value");
+    if (matvar != nullptr)
+        {
+            EXPECT_EQ(matvar->dims[1], 10U);
+            Mat_VarFree(matvar);
+        }
+    Mat_Close(matfp);
+    std::remove(filename.c_str());
+}
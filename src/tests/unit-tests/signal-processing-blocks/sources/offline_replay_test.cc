@@ -0,0 +1,171 @@
+/*!
+ * \file offline_replay_test.cc
+ * \brief This file implements tests for the blocks of the offline replay
+ * program.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_synchro.h"
+#include "mapped_file_source.h"
+#include "replay_channel_sink.h"
+#include "replay_merge_source.h"
+#include <gnuradio/blocks/message_debug.h>
+#include <gnuradio/top_block.h>
+#include <gtest/gtest.h>
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/blocks/vector_sink_b.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include <gnuradio/blocks/vector_source_b.h>
+#endif
+
+
+namespace
+{
+std::vector<uint8_t> to_bytes(const std::vector<Gnss_Synchro>& objects)
+{
+    std::vector<uint8_t> bytes(objects.size() * sizeof(Gnss_Synchro));
+    std::memcpy(bytes.data(), objects.data(), bytes.size());
+    return bytes;
+}
+
+
+std::vector<Gnss_Synchro> from_bytes(const std::vector<uint8_t>& bytes)
+{
+    std::vector<Gnss_Synchro> objects(bytes.size() / sizeof(Gnss_Synchro));
+    std::memcpy(objects.data(), bytes.data(), objects.size() * sizeof(Gnss_Synchro));
+    return objects;
+}
+}  // namespace
+
+
+TEST(OfflineReplayTest, MappedFileSourceReadsItsItems)
+{
+    const std::string filename("offline_replay_test_samples.dat");
+    {
+        std::ofstream file(filename, std::ios::out | std::ios::binary);
+        for (int16_t n = 0; n < 1000; n++)
+            {
+                file.write(reinterpret_cast<const char*>(&n), sizeof(int16_t));
+            }
+    }
+    auto file = std::make_shared<Mapped_File>();
+    ASSERT_TRUE(file->open(filename));
+
+    const auto source = mapped_file_source_make(file, sizeof(int16_t), 100, 300);
+    const auto sink = gr::blocks::vector_sink_s::make();
+    gr::top_block_sptr top_block = gr::make_top_block("OfflineReplayTest");
+    top_block->connect(source, 0, sink, 0);
+    top_block->run();
+
+    EXPECT_EQ(source->num_items(), 300U);
+    EXPECT_EQ(source->position(), 300U);
+    const std::vector<int16_t> data = sink->data();
+    ASSERT_EQ(data.size(), 300U);
+    for (size_t n = 0; n < data.size(); n++)
+        {
+            ASSERT_EQ(data[n], static_cast<int16_t>(100 + n));
+        }
+    std::remove(filename.c_str());
+}
+
+
+TEST(OfflineReplayTest, ChannelsAreMergedBySampleCounter)
+{
+    const double fs = 4e6;
+    const int32_t interval_ms = 20;
+    const uint64_t samples_per_output = 80000;
+    const int num_objects = 50;
+
+    // Two channels processed from different samples of the file, with one
+    // symbol every 20 ms. Only the objects with a valid word are kept.
+    const std::vector<uint64_t> offsets = {0, 30 * samples_per_output + 1000};
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < offsets.size(); i++)
+        {
+            std::vector<Gnss_Synchro> objects(num_objects, Gnss_Synchro());
+            for (int n = 0; n < num_objects; n++)
+                {
+                    objects[n].Flag_valid_word = n >= 5;
+                    objects[n].PRN = static_cast<uint32_t>(i + 1);
+                    objects[n].Tracking_sample_counter = n * samples_per_output + 500;
+                }
+            filenames.push_back("offline_replay_test_" + std::to_string(i) + ".dat");
+            const auto source = gr::blocks::vector_source_b::make(to_bytes(objects), false, sizeof(Gnss_Synchro));
+            const auto sink = replay_channel_sink_make(filenames[i], offsets[i]);
+            gr::top_block_sptr top_block = gr::make_top_block("OfflineReplayTest");
+            top_block->connect(source, 0, sink, 0);
+            top_block->run();
+            sink->close();
+            EXPECT_EQ(sink->items(), static_cast<uint64_t>(num_objects - 5));
+        }
+
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> messages;
+    messages.emplace_back(10 * samples_per_output, pmt::from_long(1));
+    messages.emplace_back(40 * samples_per_output, pmt::from_long(2));
+    const auto merge_source = replay_merge_source_make(filenames, std::move(messages), fs, interval_ms);
+    const auto telemetry = gr::blocks::message_debug::make();
+    std::vector<gr::blocks::vector_sink_b::sptr> sinks;
+    gr::top_block_sptr top_block = gr::make_top_block("OfflineReplayTest");
+    for (size_t i = 0; i <= offsets.size(); i++)
+        {
+            sinks.push_back(gr::blocks::vector_sink_b::make(sizeof(Gnss_Synchro)));
+            top_block->connect(merge_source, i, sinks[i], 0);
+        }
+    top_block->msg_connect(merge_source, pmt::mp("telemetry"), telemetry, pmt::mp("store"));
+    top_block->run();
+
+    // The sample counters of each channel are shifted by its offset
+    for (size_t i = 0; i < offsets.size(); i++)
+        {
+            const std::vector<Gnss_Synchro> objects = from_bytes(sinks[i]->data());
+            ASSERT_EQ(objects.size(), static_cast<size_t>(num_objects - 5));
+            for (size_t n = 0; n < objects.size(); n++)
+                {
+                    EXPECT_EQ(objects[n].Channel_ID, static_cast<int32_t>(i));
+                    EXPECT_EQ(objects[n].PRN, static_cast<uint32_t>(i + 1));
+                    EXPECT_EQ(objects[n].Tracking_sample_counter, (n + 5) * samples_per_output + 500 + offsets[i]);
+                }
+        }
+
+    // One pulse per interval, until one second after the last object
+    const std::vector<Gnss_Synchro> pulses = from_bytes(sinks[offsets.size()]->data());
+    ASSERT_FALSE(pulses.empty());
+    for (size_t n = 0; n < pulses.size(); n++)
+        {
+            EXPECT_EQ(pulses[n].Channel_ID, -1);
+            EXPECT_EQ(pulses[n].Tracking_sample_counter, (n + 1) * samples_per_output);
+        }
+    const uint64_t last_object = (num_objects - 1) * samples_per_output + 500 + offsets[1];
+    EXPECT_GT(pulses.back().Tracking_sample_counter, last_object);
+    EXPECT_EQ(pulses.size(), static_cast<size_t>(last_object / samples_per_output + 1 + 1000 / interval_ms));
+
+    EXPECT_EQ(telemetry->num_messages(), 2);
+    for (const auto& filename : filenames)
+        {
+            std::remove(filename.c_str());
+        }
+}
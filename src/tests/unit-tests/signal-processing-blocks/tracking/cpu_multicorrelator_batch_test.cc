@@ -0,0 +1,182 @@
+/*!
+ * \file cpu_multicorrelator_batch_test.cc
+ * \brief This file implements tests for the batched multi-channel correlator.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "GPS_L1_CA.h"
+#include "cpu_multicorrelator_batch.h"
+#include "cpu_multicorrelator_real_codes.h"
+#include "gps_sdr_signal_processing.h"
+#include <gtest/gtest.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+class CpuMulticorrelatorBatchTest : public ::testing::Test
+{
+protected:
+    CpuMulticorrelatorBatchTest() : input(input_length),
+                                    code(code_length),
+                                    shifts{-0.5, -0.25, 0.0, 0.25, 0.5}
+    {
+        gps_l1_ca_code_gen_float(code, 1, 0);
+        // Noise plus a code replica, read by the channels at different offsets
+        std::default_random_engine generator(7);
+        std::normal_distribution<float> noise(0.0, 1.0);
+        for (int n = 0; n < input_length; n++)
+            {
+                const double chips = 0.25 * n + 100.0;
+                const float chip = code[static_cast<int>(chips) % code_length];
+                input[n] = chip * std::exp(std::complex<float>(0.0, 0.05F * n)) + std::complex<float>(noise(generator), noise(generator));
+            }
+    }
+
+    ~CpuMulticorrelatorBatchTest() override = default;
+
+    // Parameters of the integration window of each channel
+    Cpu_Multicorrelator_Batch::Request channel_request(int channel, bool high_dynamics, std::complex<float>* corr_out) const
+    {
+        Cpu_Multicorrelator_Batch::Request request;
+        request.sig_in = input.data() + 1237 * channel;
+        request.corr_out = corr_out;
+        request.local_code_in = code.data();
+        request.shifts_chips = shifts.data();
+        request.code_length_chips = code_length;
+        request.n_correlators = NUM_TAPS;
+        request.signal_length_samples = SIGNAL_LENGTH;
+        request.rem_carrier_phase_in_rad = 0.3F * channel;
+        request.phase_step_rad = 0.05F + 0.001F * channel;
+        request.phase_rate_step_rad = high_dynamics ? 1e-8F : 0.0F;
+        request.rem_code_phase_chips = 10.0F * channel - 100.0F;
+        request.code_phase_step_chips = 0.25F + 1e-5F * channel;
+        request.code_phase_rate_step_chips = high_dynamics ? 1e-10F : 0.0F;
+        request.high_dynamics = high_dynamics;
+        return request;
+    }
+
+    // Same correlation computed by Cpu_Multicorrelator_Real_Codes
+    void reference(const Cpu_Multicorrelator_Batch::Request& request, std::complex<float>* corr_out)
+    {
+        Cpu_Multicorrelator_Real_Codes correlator;
+        correlator.init(SIGNAL_LENGTH, NUM_TAPS);
+        correlator.set_high_dynamics_resampler(request.high_dynamics);
+        correlator.set_local_code_and_taps(code_length, code.data(), shifts.data());
+        correlator.set_input_output_vectors(corr_out, request.sig_in);
+        correlator.Carrier_wipeoff_multicorrelator_resampler(request.rem_carrier_phase_in_rad, request.phase_step_rad, request.phase_rate_step_rad,
+            request.rem_code_phase_chips, request.code_phase_step_chips, request.code_phase_rate_step_chips, SIGNAL_LENGTH);
+        correlator.free();
+    }
+
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    static const int NUM_TAPS = 5;
+    static const int NUM_CHANNELS = 4;
+    static const int SIGNAL_LENGTH = 4092;
+    const int input_length = SIGNAL_LENGTH + 1237 * NUM_CHANNELS;
+    // Differences due to the rounding of the code phases and to the circular
+    // shift of the taps at the end of the window in the high dynamics resampler
+    const float tolerance = 0.001F * SIGNAL_LENGTH;
+    volk_gnsssdr::vector<std::complex<float>> input;
+    volk_gnsssdr::vector<float> code;
+    volk_gnsssdr::vector<float> shifts;
+};
+
+
+TEST_F(CpuMulticorrelatorBatchTest, TiledMatchesSingleChannel)
+{
+    for (bool high_dynamics : {false, true})
+        {
+            std::vector<volk_gnsssdr::vector<std::complex<float>>> outputs(NUM_CHANNELS, volk_gnsssdr::vector<std::complex<float>>(NUM_TAPS));
+            std::vector<Cpu_Multicorrelator_Batch::Request> requests;
+            for (int channel = 0; channel < NUM_CHANNELS; channel++)
+                {
+                    requests.push_back(channel_request(channel, high_dynamics, outputs[channel].data()));
+                }
+            std::vector<const Cpu_Multicorrelator_Batch::Request*> request_pointers;
+            for (const auto& request : requests)
+                {
+                    request_pointers.push_back(&request);
+                }
+            Cpu_Multicorrelator_Batch::evaluate(request_pointers, 1000);
+
+            volk_gnsssdr::vector<std::complex<float>> expected(NUM_TAPS);
+            for (int channel = 0; channel < NUM_CHANNELS; channel++)
+                {
+                    reference(requests[channel], expected.data());
+                    for (int n = 0; n < NUM_TAPS; n++)
+                        {
+                            EXPECT_LT(std::abs(outputs[channel][n] - expected[n]), tolerance) << "channel " << channel << " tap " << n << " high dynamics " << high_dynamics;
+                        }
+                }
+            // The replica is aligned with the prompt tap of the first channel
+            EXPECT_GT(std::abs(outputs[0][2]), 0.5F * SIGNAL_LENGTH);
+        }
+}
+
+
+TEST_F(CpuMulticorrelatorBatchTest, ConcurrentChannels)
+{
+    const int iterations = 20;
+    std::shared_ptr<Cpu_Multicorrelator_Batch> engine = Cpu_Multicorrelator_Batch::get_instance(512, 100000);
+    EXPECT_EQ(engine, Cpu_Multicorrelator_Batch::get_instance(1024, 0));
+
+    std::vector<volk_gnsssdr::vector<std::complex<float>>> expected(NUM_CHANNELS, volk_gnsssdr::vector<std::complex<float>>(NUM_TAPS));
+    for (int channel = 0; channel < NUM_CHANNELS; channel++)
+        {
+            reference(channel_request(channel, true, nullptr), expected[channel].data());
+            engine->set_active(channel, true);
+        }
+    EXPECT_EQ(engine->active_channels(), static_cast<size_t>(NUM_CHANNELS));
+
+    std::vector<int> errors(NUM_CHANNELS, 0);
+    std::vector<std::thread> threads;
+    for (int channel = 0; channel < NUM_CHANNELS; channel++)
+        {
+            threads.emplace_back([&, channel] {
+                volk_gnsssdr::vector<std::complex<float>> corr_out(NUM_TAPS);
+                for (int i = 0; i < iterations; i++)
+                    {
+                        const Cpu_Multicorrelator_Batch::Request request = channel_request(channel, true, corr_out.data());
+                        engine->correlate(&request, 1);
+                        for (int n = 0; n < NUM_TAPS; n++)
+                            {
+                                if (std::abs(corr_out[n] - expected[channel][n]) >= tolerance)
+                                    {
+                                        errors[channel]++;
+                                    }
+                            }
+                    }
+                // Do not make the other channels wait
+                engine->set_active(channel, false);
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+    for (int channel = 0; channel < NUM_CHANNELS; channel++)
+        {
+            EXPECT_EQ(errors[channel], 0) << "channel " << channel;
+        }
+    EXPECT_EQ(engine->active_channels(), 0U);
+    EXPECT_GE(engine->batches(), static_cast<uint64_t>(iterations));
+    EXPECT_GT(engine->mean_batch_requests(), 1.0);
+}
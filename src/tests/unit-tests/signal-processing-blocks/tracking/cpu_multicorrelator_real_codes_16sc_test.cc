@@ -0,0 +1,161 @@
+/*!
+ * \file cpu_multicorrelator_real_codes_16sc_test.cc
+ * \brief This file implements tests for the 16-bit correlator with real codes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "GPS_L1_CA.h"
+#include "cpu_multicorrelator_real_codes.h"
+#include "cpu_multicorrelator_real_codes_16sc.h"
+#include "gps_sdr_signal_processing.h"
+#include <gtest/gtest.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+
+
+class CpuMulticorrelatorRealCodes16scTest : public ::testing::Test
+{
+protected:
+    CpuMulticorrelatorRealCodes16scTest() : code(code_length),
+                                            code_16i(code_length),
+                                            shifts{-0.5, 0.0, 0.5},
+                                            input(SIGNAL_LENGTH),
+                                            input_16sc(SIGNAL_LENGTH)
+    {
+        gps_l1_ca_code_gen_float(code, 1, 0);
+        for (int n = 0; n < code_length; n++)
+            {
+                code_16i[n] = static_cast<int16_t>(code[n]);
+            }
+    }
+
+    ~CpuMulticorrelatorRealCodes16scTest() override = default;
+
+    // Code replica with amplitude A plus noise, quantized to 16 bits
+    void generate_input(float amplitude)
+    {
+        std::default_random_engine generator(5);
+        std::normal_distribution<float> noise(0.0, 0.5F * amplitude);
+        for (int n = 0; n < SIGNAL_LENGTH; n++)
+            {
+                const float chip = code[static_cast<int>(CODE_PHASE_STEP_CHIPS * n) % code_length];
+                const std::complex<float> sample = amplitude * chip * std::exp(std::complex<float>(0.0, PHASE_STEP_RAD * n)) + std::complex<float>(noise(generator), noise(generator));
+                input_16sc[n] = lv_16sc_t(static_cast<int16_t>(std::round(sample.real())), static_cast<int16_t>(std::round(sample.imag())));
+                input[n] = std::complex<float>(input_16sc[n].real(), input_16sc[n].imag());
+            }
+    }
+
+    void correlate_16sc(int accumulator_bits, std::complex<float>* corr_out)
+    {
+        Cpu_Multicorrelator_Real_Codes_16sc correlator;
+        EXPECT_TRUE(correlator.init(SIGNAL_LENGTH, NUM_TAPS, accumulator_bits));
+        correlator.set_local_code_and_taps(code_length, code_16i.data(), shifts.data());
+        correlator.set_input_output_vectors(corr_out, input_16sc.data());
+        correlator.Carrier_wipeoff_multicorrelator_resampler(0.0, PHASE_STEP_RAD, 0.0, CODE_PHASE_STEP_CHIPS, SIGNAL_LENGTH);
+        correlator.free();
+    }
+
+    void correlate_32fc(std::complex<float>* corr_out)
+    {
+        Cpu_Multicorrelator_Real_Codes correlator;
+        correlator.init(SIGNAL_LENGTH, NUM_TAPS);
+        correlator.set_high_dynamics_resampler(false);
+        correlator.set_local_code_and_taps(code_length, code.data(), shifts.data());
+        correlator.set_input_output_vectors(corr_out, input.data());
+        correlator.Carrier_wipeoff_multicorrelator_resampler(0.0, PHASE_STEP_RAD, 0.0, 0.0, CODE_PHASE_STEP_CHIPS, 0.0, SIGNAL_LENGTH);
+        correlator.free();
+    }
+
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    static const int NUM_TAPS = 3;
+    static const int SIGNAL_LENGTH = 4092;
+    static constexpr float PHASE_STEP_RAD = 0.05;
+    static constexpr float CODE_PHASE_STEP_CHIPS = 0.25;
+    volk_gnsssdr::vector<float> code;
+    volk_gnsssdr::vector<int16_t> code_16i;
+    volk_gnsssdr::vector<float> shifts;
+    volk_gnsssdr::vector<std::complex<float>> input;
+    volk_gnsssdr::vector<lv_16sc_t> input_16sc;
+};
+
+
+TEST_F(CpuMulticorrelatorRealCodes16scTest, MatchesFloatCorrelator)
+{
+    // Weak enough input for the 16-bit accumulator not to saturate
+    const float amplitude = 4.0;
+    generate_input(amplitude);
+    volk_gnsssdr::vector<std::complex<float>> expected(NUM_TAPS);
+    correlate_32fc(expected.data());
+    // Rounding of the rotated samples to 16 bits
+    const float tolerance = 0.01F * amplitude * SIGNAL_LENGTH;
+    for (int accumulator_bits : {16, 32})
+        {
+            volk_gnsssdr::vector<std::complex<float>> corr_out(NUM_TAPS);
+            correlate_16sc(accumulator_bits, corr_out.data());
+            for (int n = 0; n < NUM_TAPS; n++)
+                {
+                    EXPECT_LT(std::abs(corr_out[n] - expected[n]), tolerance) << "tap " << n << " accumulator bits " << accumulator_bits;
+                }
+        }
+    EXPECT_GT(expected[1].real(), 0.9F * amplitude * SIGNAL_LENGTH);
+}
+
+
+TEST_F(CpuMulticorrelatorRealCodes16scTest, WideAccumulatorDoesNotSaturate)
+{
+    // The prompt correlation exceeds the range of a 16 bits integer
+    const float amplitude = 40.0;
+    generate_input(amplitude);
+    volk_gnsssdr::vector<std::complex<float>> expected(NUM_TAPS);
+    correlate_32fc(expected.data());
+    ASSERT_GT(expected[1].real(), 32767.0);
+
+    volk_gnsssdr::vector<std::complex<float>> corr_out(NUM_TAPS);
+    correlate_16sc(32, corr_out.data());
+    const float tolerance = 0.01F * amplitude * SIGNAL_LENGTH;
+    for (int n = 0; n < NUM_TAPS; n++)
+        {
+            EXPECT_LT(std::abs(corr_out[n] - expected[n]), tolerance) << "tap " << n;
+        }
+
+    correlate_16sc(16, corr_out.data());
+    EXPECT_LE(corr_out[1].real(), 32767.0);
+
+    Cpu_Multicorrelator_Real_Codes_16sc correlator;
+    EXPECT_FALSE(correlator.init(SIGNAL_LENGTH, NUM_TAPS, 24));
+}
+
+
+TEST_F(CpuMulticorrelatorRealCodes16scTest, WideAccumulatorDoesNotSaturateWithStrongInputs)
+{
+    // Input close to the full scale of the 16 bits samples: a few samples
+    // already exceed the range of a 16 bits integer
+    const float amplitude = 8000.0;
+    generate_input(amplitude);
+    volk_gnsssdr::vector<std::complex<float>> expected(NUM_TAPS);
+    correlate_32fc(expected.data());
+
+    volk_gnsssdr::vector<std::complex<float>> corr_out(NUM_TAPS);
+    correlate_16sc(32, corr_out.data());
+    const float tolerance = 0.01F * amplitude * SIGNAL_LENGTH;
+    for (int n = 0; n < NUM_TAPS; n++)
+        {
+            EXPECT_LT(std::abs(corr_out[n] - expected[n]), tolerance) << "tap " << n;
+        }
+    EXPECT_GT(expected[1].real(), 0.9F * amplitude * SIGNAL_LENGTH);
+}
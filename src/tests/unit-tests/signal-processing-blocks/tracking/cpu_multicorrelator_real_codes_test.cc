@@ -255,3 +255,77 @@ TEST(CpuMulticorrelatorRealCodesTest, MeasureExecutionTimeAlloc)
             correlator_pool[n]->free();
         }
 }
+
+
+TEST(CpuMulticorrelatorRealCodesTest, IntegerShiftSpeedup)
+{
+    const int correlation_size = 8192;
+    // 4 samples per chip, so that spacings of 0.25 chips are one sample
+    const float code_phase_step_chips = 0.25;
+    const float rem_code_phase_chips = 0.4;
+    const float rem_carrier_phase_rad = 0.0;
+    const float carrier_phase_step_rad = 0.1;
+
+    volk_gnsssdr::vector<float> ca_code(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS));
+    gps_l1_ca_code_gen_float(ca_code, 1, 0);
+    volk_gnsssdr::vector<gr_complex> in_cpu(correlation_size);
+    std::default_random_engine e1(1);
+    std::uniform_real_distribution<float> uniform_dist(0, 1);
+    for (int n = 0; n < correlation_size; n++)
+        {
+            in_cpu[n] = std::complex<float>(uniform_dist(e1), uniform_dist(e1));
+        }
+
+    for (int n_taps : {3, 5, 7})
+        {
+            // Taps 0.5 chips apart, centered on the Prompt
+            volk_gnsssdr::vector<float> shifts_chips(n_taps);
+            for (int n = 0; n < n_taps; n++)
+                {
+                    shifts_chips[n] = 0.5F * static_cast<float>(n - n_taps / 2);
+                }
+            volk_gnsssdr::vector<gr_complex> outs(n_taps, gr_complex(0.0, 0.0));
+            volk_gnsssdr::vector<gr_complex> integer_shift_outs(n_taps, gr_complex(0.0, 0.0));
+
+            Cpu_Multicorrelator_Real_Codes correlator;
+            correlator.init(correlation_size, n_taps);
+            correlator.set_input_output_vectors(outs.data(), in_cpu.data());
+            correlator.set_local_code_and_taps(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), ca_code.data(), shifts_chips.data());
+            Cpu_Multicorrelator_Real_Codes integer_shift_correlator;
+            integer_shift_correlator.set_integer_shift(true);
+            integer_shift_correlator.init(correlation_size, n_taps);
+            integer_shift_correlator.set_input_output_vectors(integer_shift_outs.data(), in_cpu.data());
+            integer_shift_correlator.set_local_code_and_taps(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), ca_code.data(), shifts_chips.data());
+
+            const auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < FLAGS_cpu_multicorrelator_real_codes_iterations_test; k++)
+                {
+                    correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_rad, carrier_phase_step_rad, 0.0, rem_code_phase_chips, code_phase_step_chips, 0.0, correlation_size);
+                }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const auto integer_shift_start = std::chrono::steady_clock::now();
+            for (int k = 0; k < FLAGS_cpu_multicorrelator_real_codes_iterations_test; k++)
+                {
+                    integer_shift_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_rad, carrier_phase_step_rad, 0.0, rem_code_phase_chips, code_phase_step_chips, 0.0, correlation_size);
+                }
+            const std::chrono::duration<double> integer_shift_elapsed = std::chrono::steady_clock::now() - integer_shift_start;
+
+            EXPECT_TRUE(integer_shift_correlator.integer_shift_active());
+            EXPECT_FALSE(correlator.integer_shift_active());
+            for (int n = 0; n < n_taps; n++)
+                {
+                    EXPECT_NEAR(outs[n].real(), integer_shift_outs[n].real(), 1e-3 * std::abs(outs[n]) + 1e-3);
+                    EXPECT_NEAR(outs[n].imag(), integer_shift_outs[n].imag(), 1e-3 * std::abs(outs[n]) + 1e-3);
+                }
+            std::cout << n_taps << " taps: " << elapsed.count() / FLAGS_cpu_multicorrelator_real_codes_iterations_test
+                      << " [s] resampling each tap, " << integer_shift_elapsed.count() / FLAGS_cpu_multicorrelator_real_codes_iterations_test
+                      << " [s] with integer shifts, speedup " << elapsed.count() / integer_shift_elapsed.count() << std::endl;
+
+            // Spacings that are not integer multiples of the sample period resample each tap
+            integer_shift_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_rad, carrier_phase_step_rad, 0.0, rem_code_phase_chips, 0.3, 0.0, correlation_size);
+            EXPECT_FALSE(integer_shift_correlator.integer_shift_active());
+            // And so does a code phase rate
+            integer_shift_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_rad, carrier_phase_step_rad, 0.0, rem_code_phase_chips, code_phase_step_chips, 1e-5, correlation_size);
+            EXPECT_FALSE(integer_shift_correlator.integer_shift_active());
+        }
+}
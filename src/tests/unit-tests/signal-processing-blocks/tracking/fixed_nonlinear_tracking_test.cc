@@ -0,0 +1,180 @@
+/*!
+ * \file fixed_nonlinear_tracking_test.cc
+ * \brief This file implements tests for the Cubature and Unscented Kalman
+ * filters with fixed dimensions, and compares their speed with the ones of
+ * nonlinear_tracking.h
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fixed_nonlinear_tracking.h"
+#include "nonlinear_tracking.h"
+#include <armadillo>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#define FIXED_NONLINEAR_TEST_N_TRIALS 1000
+#define FIXED_NONLINEAR_TEST_TOLERANCE 0.01
+#define FIXED_NONLINEAR_TEST_N_UPDATES 100000
+
+template <arma::uword N_IN, arma::uword N_OUT>
+class FixedLinearModel : public FixedModelFunction<N_IN, N_OUT>
+{
+public:
+    explicit FixedLinearModel(const arma::mat& kf_F) : coeff_mat(kf_F){};
+    void operator()(const arma::vec::fixed<N_IN>& input, arma::vec::fixed<N_OUT>& output) override { output = coeff_mat * input; };
+
+private:
+    arma::mat::fixed<N_OUT, N_IN> coeff_mat;
+};
+
+class LinearModel : public ModelFunction
+{
+public:
+    explicit LinearModel(const arma::mat& kf_F) { coeff_mat = kf_F; };
+    arma::vec operator()(const arma::vec& input) override { return coeff_mat * input; };
+
+private:
+    arma::mat coeff_mat;
+};
+
+
+// With linear models, the filters must give the results of the Kalman filter
+template <typename Filter, arma::uword NX, arma::uword NZ>
+void check_against_kalman_filter()
+{
+    Filter filter;
+    for (int k = 0; k < FIXED_NONLINEAR_TEST_N_TRIALS; k++)
+        {
+            const arma::vec kf_x = arma::randn<arma::vec>(NX);
+            const arma::mat kf_P_x_post = 5.0 * arma::diagmat(arma::randu<arma::vec>(NX) + 0.1);
+            const arma::vec kf_x_post = kf_x + arma::sqrt(kf_P_x_post.diag()) % arma::randn<arma::vec>(NX);
+            const arma::vec::fixed<NX> x_post(kf_x_post);
+            const arma::mat::fixed<NX, NX> P_x_post(kf_P_x_post);
+            filter.initialize(x_post, P_x_post);
+
+            // Prediction Step
+            const arma::mat kf_F = arma::randu<arma::mat>(NX, NX);
+            const arma::mat kf_Q = arma::diagmat(arma::randu<arma::vec>(NX) + 0.1);
+            const arma::mat::fixed<NX, NX> Q(kf_Q);
+            FixedLinearModel<NX, NX> transition_function(kf_F);
+            ASSERT_TRUE(filter.predict_sequential(x_post, P_x_post, &transition_function, Q));
+
+            const arma::vec kf_x_pre = kf_F * kf_x_post;
+            const arma::mat kf_P_x_pre = kf_F * kf_P_x_post * kf_F.t() + kf_Q;
+            EXPECT_TRUE(arma::approx_equal(arma::vec(filter.get_x_pred()), kf_x_pre, "absdiff", FIXED_NONLINEAR_TEST_TOLERANCE));
+            EXPECT_TRUE(arma::approx_equal(arma::mat(filter.get_P_x_pred()), kf_P_x_pre, "absdiff", FIXED_NONLINEAR_TEST_TOLERANCE));
+
+            // Update Step
+            const arma::mat kf_H = arma::randu<arma::mat>(NZ, NX);
+            const arma::mat kf_R = arma::diagmat(arma::randu<arma::vec>(NZ) + 0.1);
+            const arma::vec kf_y = kf_H * kf_x_pre + arma::randn<arma::vec>(NZ);
+            const arma::vec::fixed<NZ> y(kf_y);
+            const arma::mat::fixed<NZ, NZ> R(kf_R);
+            FixedLinearModel<NX, NZ> measurement_function(kf_H);
+            ASSERT_TRUE(filter.update_sequential(y, filter.get_x_pred(), filter.get_P_x_pred(), &measurement_function, R));
+
+            const arma::mat kf_P_y = kf_H * kf_P_x_pre * kf_H.t() + kf_R;
+            const arma::mat kf_K = (kf_P_x_pre * kf_H.t()) * arma::inv(kf_P_y);
+            const arma::vec kf_x_est = kf_x_pre + kf_K * (kf_y - kf_H * kf_x_pre);
+            const arma::mat kf_P_x_est = (arma::eye(NX, NX) - kf_K * kf_H) * kf_P_x_pre;
+            EXPECT_TRUE(arma::approx_equal(arma::vec(filter.get_x_est()), kf_x_est, "absdiff", FIXED_NONLINEAR_TEST_TOLERANCE));
+            EXPECT_TRUE(arma::approx_equal(arma::mat(filter.get_P_x_est()), kf_P_x_est, "absdiff", FIXED_NONLINEAR_TEST_TOLERANCE));
+        }
+}
+
+
+// Prediction and update steps per second, with fixed and dynamic dimensions
+template <typename FixedFilter, typename Filter, arma::uword NX, arma::uword NZ>
+void compare_speed(const std::string& name)
+{
+    // Every iteration starts from the same state, so only the cost is measured
+    const arma::vec kf_x = arma::randn<arma::vec>(NX);
+    const arma::mat kf_P = arma::eye(NX, NX);
+    const arma::mat kf_F = arma::randu<arma::mat>(NX, NX);
+    const arma::mat kf_Q = 0.1 * arma::eye(NX, NX);
+    const arma::mat kf_H = arma::randu<arma::mat>(NZ, NX);
+    const arma::mat kf_R = arma::eye(NZ, NZ);
+    const arma::vec kf_y = arma::randn<arma::vec>(NZ);
+
+    FixedFilter fixed_filter;
+    FixedLinearModel<NX, NX> fixed_transition(kf_F);
+    FixedLinearModel<NX, NZ> fixed_measurement(kf_H);
+    const arma::vec::fixed<NX> x(kf_x);
+    const arma::mat::fixed<NX, NX> P(kf_P);
+    const arma::mat::fixed<NX, NX> Q(kf_Q);
+    const arma::mat::fixed<NZ, NZ> R(kf_R);
+    const arma::vec::fixed<NZ> y(kf_y);
+    const auto fixed_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FIXED_NONLINEAR_TEST_N_UPDATES; i++)
+        {
+            fixed_filter.predict_sequential(x, P, &fixed_transition, Q);
+            fixed_filter.update_sequential(y, fixed_filter.get_x_pred(), fixed_filter.get_P_x_pred(), &fixed_measurement, R);
+        }
+    const std::chrono::duration<double> fixed_elapsed = std::chrono::steady_clock::now() - fixed_start;
+
+    Filter filter(NX);
+    LinearModel transition(kf_F);
+    LinearModel measurement(kf_H);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FIXED_NONLINEAR_TEST_N_UPDATES; i++)
+        {
+            filter.predict_sequential(kf_x, kf_P, &transition, kf_Q);
+            filter.update_sequential(kf_y, filter.get_x_pred(), filter.get_P_x_pred(), &measurement, kf_R);
+        }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(fixed_filter.get_x_est().is_finite());
+    std::cout << name << " (" << NX << " states, " << NZ << " measurements): "
+              << FIXED_NONLINEAR_TEST_N_UPDATES / fixed_elapsed.count() << " updates/s with fixed dimensions, "
+              << FIXED_NONLINEAR_TEST_N_UPDATES / elapsed.count() << " updates/s with dynamic dimensions" << std::endl;
+}
+
+
+TEST(FixedNonlinearTrackingTest, CubatureFilterTest)
+{
+    check_against_kalman_filter<FixedCubatureFilter<1, 1>, 1, 1>();
+    check_against_kalman_filter<FixedCubatureFilter<3, 2>, 3, 2>();
+    check_against_kalman_filter<FixedCubatureFilter<5, 5>, 5, 5>();
+}
+
+
+TEST(FixedNonlinearTrackingTest, UnscentedFilterTest)
+{
+    check_against_kalman_filter<FixedUnscentedFilter<1, 1>, 1, 1>();
+    check_against_kalman_filter<FixedUnscentedFilter<3, 2>, 3, 2>();
+    check_against_kalman_filter<FixedUnscentedFilter<5, 5>, 5, 5>();
+}
+
+
+TEST(FixedNonlinearTrackingTest, NonPositiveDefiniteCovariance)
+{
+    FixedCubatureFilter<2, 1> filter;
+    const arma::vec::fixed<2> x = {1.0, 2.0};
+    const arma::mat::fixed<2, 2> P = {{1.0, 2.0}, {2.0, 1.0}};
+    const arma::mat::fixed<2, 2> Q(arma::fill::eye);
+    FixedLinearModel<2, 2> transition_function(arma::eye(2, 2));
+    filter.initialize(x, Q);
+    EXPECT_FALSE(filter.predict_sequential(x, P, &transition_function, Q));
+    EXPECT_TRUE(arma::approx_equal(arma::vec(filter.get_x_pred()), arma::vec(x), "absdiff", 0.0));
+}
+
+
+TEST(FixedNonlinearTrackingTest, UpdatesPerSecond)
+{
+    compare_speed<FixedCubatureFilter<4, 2>, CubatureFilter, 4, 2>("Cubature filter");
+    compare_speed<FixedUnscentedFilter<4, 2>, UnscentedFilter, 4, 2>("Unscented filter");
+}
@@ -20,6 +20,7 @@
  */
 
 #include "GPS_L1_CA.h"
+#include "dll_pll_veml_tracking.h"
 #include "gnss_block_factory.h"
 #include "gnuplot_i.h"
 #include "in_memory_configuration.h"
@@ -1180,3 +1181,26 @@ bool GpsL1CADllPllTrackingTest::save_mat_xy(std::vector<double>& x, std::vector<
             return false;
         }
 }
+
+
+TEST(GpsL1CADllPllTrackingStandbyTest, StandbyForecastIsBounded)
+{
+    const int32_t vector_length = 4000;  // 1 ms at 4 Msps
+
+    // While tracking, two integration windows
+    EXPECT_EQ(dll_pll_veml_tracking::items_required(vector_length, false, 1 << 20), 2 * vector_length);
+
+    // In standby, the lag does not grow with the input buffer
+    EXPECT_EQ(dll_pll_veml_tracking::items_required(vector_length, true, 1 << 20), TRK_STANDBY_LAG_SAMPLES);
+    EXPECT_EQ(dll_pll_veml_tracking::items_required(vector_length, true, 1 << 24), TRK_STANDBY_LAG_SAMPLES);
+
+    // and takes at most an eighth of a small buffer
+    EXPECT_EQ(dll_pll_veml_tracking::items_required(vector_length, true, 1 << 17), (1 << 17) / 8);
+    for (int32_t buffer_items = 1 << 16; buffer_items <= 1 << 24; buffer_items *= 2)
+        {
+            EXPECT_LE(dll_pll_veml_tracking::items_required(vector_length, true, buffer_items), buffer_items / 8);
+        }
+
+    // but never asks for less than the tracking itself
+    EXPECT_EQ(dll_pll_veml_tracking::items_required(vector_length, true, 1 << 15), 2 * vector_length);
+}
@@ -0,0 +1,114 @@
+/*!
+ * \file integration_scheduler_test.cc
+ * \brief This file implements tests for the adaptive integration scheduler
+ * of the tracking loops
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "integration_scheduler.h"
+#include <gtest/gtest.h>
+
+
+namespace
+{
+// Number of loop updates until the scheduler asks for a switch, or -1
+int updates_until_switch(Integration_Scheduler& scheduler, bool long_integration, double carrier_lock_test, double cn0_db_hz, int max_updates)
+{
+    const double integration_time_s = long_integration ? 0.020 : 0.001;
+    for (int n = 1; n <= max_updates; n++)
+        {
+            if (scheduler.update(long_integration, carrier_lock_test, cn0_db_hz, integration_time_s, true))
+                {
+                    return n;
+                }
+        }
+    return -1;
+}
+}  // namespace
+
+
+TEST(IntegrationSchedulerTest, SwitchesWithTheCn0Thresholds)
+{
+    Integration_Scheduler scheduler;
+    scheduler.set_params(0.9, 0.8, 32.0, 1000);
+
+    // Strong signal with a noisy carrier lock test: the short integration is kept
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.5, 45.0, 5000), -1);
+
+    // The CN0 falls below adaptive_weak_cn0_db_hz: the long integration starts
+    // after one second with 1 ms updates
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.5, 30.0, 5000), 1000);
+
+    // and is kept while the CN0 stays low
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.5, 30.0, 500), -1);
+
+    // The CN0 recovers: back to the short integration after one second with 20 ms updates
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.5, 40.0, 500), 50);
+}
+
+
+TEST(IntegrationSchedulerTest, CarrierLockHysteresis)
+{
+    Integration_Scheduler scheduler;
+    scheduler.set_params(0.9, 0.8, 32.0, 1000);
+
+    // Between both thresholds, each integration is kept
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.85, 45.0, 5000), -1);
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.85, 45.0, 500), -1);
+
+    // Above adaptive_long_lock_th the long integration starts
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.95, 45.0, 5000), 1000);
+
+    // Below adaptive_short_lock_th the short integration starts
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.7, 45.0, 500), 50);
+}
+
+
+TEST(IntegrationSchedulerTest, ChangeMustBeWantedDuringTheDwell)
+{
+    Integration_Scheduler scheduler;
+    scheduler.set_params(0.9, 0.8, 32.0, 1000);
+
+    // A fade shorter than adaptive_dwell_ms does not change the integration
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.5, 30.0, 999), -1);
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.5, 45.0, 1), -1);
+    EXPECT_EQ(updates_until_switch(scheduler, false, 0.5, 30.0, 5000), 1000);
+
+    // The dwell also restarts with reset()
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.5, 40.0, 49), -1);
+    scheduler.reset();
+    EXPECT_EQ(updates_until_switch(scheduler, true, 0.5, 40.0, 500), 50);
+}
+
+
+TEST(IntegrationSchedulerTest, LongIntegrationWaitsForTheBits)
+{
+    Integration_Scheduler scheduler;
+    scheduler.set_params(0.9, 0.8, 32.0, 10);
+
+    for (int n = 0; n < 10; n++)
+        {
+            EXPECT_FALSE(scheduler.update(false, 0.5, 30.0, 0.001, false));
+        }
+    EXPECT_FALSE(scheduler.update(false, 0.5, 30.0, 0.001, false));
+    EXPECT_TRUE(scheduler.update(false, 0.5, 30.0, 0.001, true));
+
+    // The short integration does not wait
+    for (int n = 0; n < 9; n++)
+        {
+            EXPECT_FALSE(scheduler.update(true, 0.5, 40.0, 0.001, false));
+        }
+    EXPECT_TRUE(scheduler.update(true, 0.5, 40.0, 0.001, false));
+}
@@ -0,0 +1,310 @@
+/*!
+ * \file reacquisition_search_test.cc
+ * \brief This file implements tests for the reacquisition search of the
+ * tracking loops after a loss of lock
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "reacquisition_search.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+const double FS_IN = 4.0e6;
+const double CODE_PERIOD_S = 0.001;
+const auto SAMPLES_PER_PERIOD = static_cast<uint64_t>(FS_IN * CODE_PERIOD_S);
+const int32_t CN0_SAMPLES = 20;
+const float CN0_MIN_DB_HZ = 25.0;
+
+uint64_t samples(double seconds)
+{
+    return static_cast<uint64_t>(seconds * FS_IN);
+}
+
+// Prompt correlator output of one code period, with unit noise power
+class Prompt_Model
+{
+public:
+    explicit Prompt_Model(unsigned int seed) : d_generator(seed), d_noise(0.0, std::sqrt(0.5)) {}
+
+    gr_complex prompt(double cn0_db_hz, double phase_rad)
+    {
+        const double amplitude = cn0_db_hz > 0.0 ? std::sqrt(std::pow(10.0, cn0_db_hz / 10.0) * CODE_PERIOD_S) : 0.0;
+        return gr_complex(static_cast<float>(amplitude * std::cos(phase_rad) + d_noise(d_generator)),
+            static_cast<float>(amplitude * std::sin(phase_rad) + d_noise(d_generator)));
+    }
+
+    std::mt19937 d_generator;
+    std::normal_distribution<double> d_noise;
+};
+
+
+// Epochs of a locked 40 dB-Hz signal with integration_periods code periods of
+// coherent integration, as retained by the tracking
+void retain_lock(Reacquisition_Search& search, Prompt_Model& model, double doppler_hz, uint64_t sample_counter, int integration_periods = 1)
+{
+    std::vector<gr_complex> prompt_buffer(CN0_SAMPLES);
+    for (int epoch = 0; epoch < 100; epoch++)
+        {
+            for (auto& prompt : prompt_buffer)
+                {
+                    prompt = gr_complex(0.0, 0.0);
+                    for (int n = 0; n < integration_periods; n++)
+                        {
+                            prompt += model.prompt(40.0, 0.0);
+                        }
+                }
+            search.retain(doppler_hz, sample_counter, prompt_buffer.data(), CN0_SAMPLES, CODE_PERIOD_S * integration_periods);
+        }
+}
+}  // namespace
+
+
+TEST(ReacquisitionSearchTest, DopplerPropagatedWithTheRetainedRate)
+{
+    Reacquisition_Search search;
+    search.set_params(FS_IN, 5000, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    search.reset(1000.0, 0);
+    Prompt_Model model(0);
+
+    // The rate is measured over intervals of at least one second
+    retain_lock(search, model, 1000.0, samples(0.0));
+    retain_lock(search, model, 1005.0, samples(0.5));
+    EXPECT_DOUBLE_EQ(search.retained_doppler_hz(samples(1.5)), 1005.0);
+    retain_lock(search, model, 1010.0, samples(1.0));
+    retain_lock(search, model, 1012.0, samples(1.2));
+
+    // Loss of lock at 1.5 s: 1012 Hz at 1.2 s, plus 10 Hz/s
+    ASSERT_TRUE(search.start(samples(1.5)));
+    EXPECT_EQ(search.bin(), 0);
+    EXPECT_NEAR(search.doppler_hz(samples(1.5)), 1015.0, 1e-6);
+    EXPECT_NEAR(search.doppler_hz(samples(2.7)), 1027.0, 1e-6);
+
+    // A new tracking forgets the rate, and the noise power
+    search.reset(-300.0, samples(3.0));
+    EXPECT_FALSE(search.active());
+    EXPECT_NEAR(search.retained_doppler_hz(samples(4.0)), -300.0, 1e-6);
+    EXPECT_FALSE(search.start(samples(4.0)));
+}
+
+
+TEST(ReacquisitionSearchTest, NoiseFloorFromTheRetainedLock)
+{
+    Reacquisition_Search search;
+    search.set_params(FS_IN, 100000, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    search.reset(1000.0, 0);
+    Prompt_Model model(5);
+
+    // No search without a retained noise power
+    EXPECT_FALSE(search.start(samples(1.0)));
+    EXPECT_FALSE(search.active());
+
+    // The noise power of one code period, from the 20 ms integrations of a
+    // locked loop
+    retain_lock(search, model, 1000.0, samples(1.0), 20);
+    EXPECT_NEAR(search.noise_power(), 1.0, 0.2);
+
+    // Noise only: the m2m4 estimate of 20 samples would exceed cn0_min in
+    // most dwells. Here, about PFA of them are false detections.
+    uint64_t sample_counter = samples(1.0);
+    ASSERT_TRUE(search.start(sample_counter));
+    const int dwells = 20000;
+    int false_detections = 0;
+    for (int dwell = 0; dwell < dwells; dwell++)
+        {
+            for (int n = 0; n < CN0_SAMPLES; n++)
+                {
+                    if (search.step(model.prompt(0.0, 0.0), sample_counter) == Reacquisition_Search::Result::reacquired)
+                        {
+                            false_detections++;
+                        }
+                    sample_counter += SAMPLES_PER_PERIOD;
+                }
+        }
+    EXPECT_LE(false_detections, 10);  // 2 expected
+}
+
+
+TEST(ReacquisitionSearchTest, BinsVisitedFromTheCenterOutwards)
+{
+    Reacquisition_Search search;
+    search.set_params(FS_IN, 5000, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    search.reset(1000.0, 0);
+    Prompt_Model model(1);
+    retain_lock(search, model, 1000.0, samples(0.5));
+
+    uint64_t sample_counter = samples(1.0);
+    ASSERT_TRUE(search.start(sample_counter));
+    const double expected_offsets_hz[] = {0.0, 50.0, -50.0, 100.0, -100.0, 0.0, 50.0};
+    for (double offset_hz : expected_offsets_hz)
+        {
+            EXPECT_NEAR(search.doppler_hz(sample_counter), 1000.0 + offset_hz, 1e-6);
+            // one dwell of noise only
+            for (int n = 0; n < CN0_SAMPLES; n++)
+                {
+                    EXPECT_EQ(search.step(model.prompt(0.0, 0.0), sample_counter), Reacquisition_Search::Result::searching);
+                    sample_counter += SAMPLES_PER_PERIOD;
+                }
+        }
+
+    // A new loss of lock starts again from the center bin
+    EXPECT_EQ(search.bin(), 2);
+    ASSERT_TRUE(search.start(sample_counter));
+    EXPECT_EQ(search.bin(), 0);
+}
+
+
+TEST(ReacquisitionSearchTest, TimeLimitExpires)
+{
+    Reacquisition_Search search;
+    search.set_params(FS_IN, 100, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    search.reset(1000.0, 0);
+    Prompt_Model model(2);
+    retain_lock(search, model, 1000.0, samples(1.0));
+
+    // Disabled search
+    Reacquisition_Search disabled;
+    disabled.set_params(FS_IN, 0, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    retain_lock(disabled, model, 1000.0, samples(1.0));
+    EXPECT_FALSE(disabled.start(0));
+    EXPECT_FALSE(disabled.active());
+
+    const uint64_t loss_of_lock = samples(2.0);
+    uint64_t sample_counter = loss_of_lock;
+    ASSERT_TRUE(search.start(sample_counter));
+    EXPECT_TRUE(search.active());
+    int periods = 0;
+    Reacquisition_Search::Result result = Reacquisition_Search::Result::searching;
+    while (result == Reacquisition_Search::Result::searching and periods < 1000)
+        {
+            result = search.step(model.prompt(0.0, 0.0), sample_counter);
+            sample_counter += SAMPLES_PER_PERIOD;
+            periods++;
+        }
+    EXPECT_EQ(result, Reacquisition_Search::Result::expired);
+    EXPECT_EQ(periods, 101);  // the period that starts at the time limit
+
+    // The time limit counts from the first loss of lock: a loss of lock of the
+    // pull-in that follows a reacquisition does not get a new one
+    EXPECT_FALSE(search.start(sample_counter));
+    EXPECT_TRUE(search.active());
+
+    // once the tracking has resumed, or the satellite is released, it does
+    search.stop();
+    EXPECT_FALSE(search.active());
+    EXPECT_TRUE(search.start(sample_counter));
+    EXPECT_NEAR(search.elapsed_ms(sample_counter + samples(0.05)), 50.0, 1e-6);
+}
+
+
+TEST(ReacquisitionSearchTest, ReacquiresWhenTheSignalReturns)
+{
+    Reacquisition_Search search;
+    search.set_params(FS_IN, 5000, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+    search.reset(1000.0, 0);
+    Prompt_Model model(3);
+    retain_lock(search, model, 1000.0, samples(0.0));
+    retain_lock(search, model, 1001.0, samples(1.0));
+
+    // 300 ms outage from the loss of lock, then a 40 dB-Hz signal with the
+    // residual Doppler of the current bin
+    const uint64_t loss_of_lock = samples(1.0);
+    const uint64_t signal_return = loss_of_lock + samples(0.3);
+    uint64_t sample_counter = loss_of_lock;
+    ASSERT_TRUE(search.start(sample_counter));
+    const double true_doppler_hz = 1001.0 + 30.0;
+    double phase_rad = 0.0;
+    Reacquisition_Search::Result result = Reacquisition_Search::Result::searching;
+    while (result == Reacquisition_Search::Result::searching)
+        {
+            const double cn0_db_hz = sample_counter >= signal_return ? 40.0 : 0.0;
+            phase_rad += 2.0 * M_PI * (true_doppler_hz - search.doppler_hz(sample_counter)) * CODE_PERIOD_S;
+            result = search.step(model.prompt(cn0_db_hz, phase_rad), sample_counter);
+            sample_counter += SAMPLES_PER_PERIOD;
+        }
+    ASSERT_EQ(result, Reacquisition_Search::Result::reacquired);
+    EXPECT_GE(sample_counter, signal_return);
+    // within two dwells of the return of the signal
+    EXPECT_LE(sample_counter - signal_return, 2 * CN0_SAMPLES * SAMPLES_PER_PERIOD);
+    EXPECT_GE(search.cn0_db_hz(), CN0_MIN_DB_HZ);
+    // the tracking resumes at the Doppler of the bin, and the search stays
+    // active until the narrow tracking is reached again
+    EXPECT_TRUE(search.active());
+    EXPECT_LE(std::abs(search.doppler_hz(sample_counter) - 1001.0), 100.0);
+}
+
+
+// Signal time from the return of the signal to its detection, against a cold
+// acquisition of the same signal with a 1 ms coherent dwell over 4000 code
+// delays and 41 Doppler bins, pfa = 0.01. The cold acquisition is modelled at
+// its best: only the cell of the signal is tested, it restarts without delay
+// after each failed dwell, and the time to release and reassign the channel
+// is ignored.
+TEST(ReacquisitionSearchTest, RelockLatencyAgainstColdAcquisition)
+{
+    const int trials = 200;
+    const double pfa = 0.01;
+    const double num_cells = 4000.0 * 41.0;
+    const double cold_threshold = -std::log(1.0 - std::pow(1.0 - pfa, 1.0 / num_cells));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (double cn0_db_hz : {35.0, 45.0})
+        {
+            Prompt_Model model(4);
+            double search_latency_ms = 0.0;
+            double cold_latency_ms = 0.0;
+            for (int trial = 0; trial < trials; trial++)
+                {
+                    Reacquisition_Search search;
+                    search.set_params(FS_IN, 5000, 5, 50.0, CN0_SAMPLES, CN0_MIN_DB_HZ, CODE_PERIOD_S);
+                    search.reset(1000.0, 0);
+                    retain_lock(search, model, 1000.0, samples(1.0));
+                    uint64_t sample_counter = samples(1.0);
+                    ASSERT_TRUE(search.start(sample_counter));
+                    // the signal returns at a random time of the dwell
+                    const uint64_t signal_return = sample_counter + samples(0.2) + static_cast<uint64_t>(uniform(model.d_generator) * CN0_SAMPLES) * SAMPLES_PER_PERIOD;
+                    Reacquisition_Search::Result result = Reacquisition_Search::Result::searching;
+                    while (result == Reacquisition_Search::Result::searching)
+                        {
+                            result = search.step(model.prompt(sample_counter >= signal_return ? cn0_db_hz : 0.0, 0.3), sample_counter);
+                            sample_counter += SAMPLES_PER_PERIOD;
+                        }
+                    ASSERT_EQ(result, Reacquisition_Search::Result::reacquired);
+                    ASSERT_GE(sample_counter, signal_return);
+                    search_latency_ms += 1000.0 * static_cast<double>(sample_counter - signal_return) / FS_IN;
+
+                    int dwells = 1;
+                    while (std::norm(model.prompt(cn0_db_hz, 0.3)) < cold_threshold and dwells < 100000)
+                        {
+                            dwells++;
+                        }
+                    cold_latency_ms += 1000.0 * CODE_PERIOD_S * dwells;
+                }
+            search_latency_ms /= trials;
+            cold_latency_ms /= trials;
+            std::cout << "CN0 " << cn0_db_hz << " dB-Hz: mean re-lock latency " << search_latency_ms
+                      << " ms, cold acquisition " << cold_latency_ms << " ms\n";
+            EXPECT_LE(search_latency_ms, 2.0 * CN0_SAMPLES * CODE_PERIOD_S * 1000.0);
+            if (cn0_db_hz < 40.0)
+                {
+                    EXPECT_LT(search_latency_ms, cold_latency_ms);
+                }
+        }
+}
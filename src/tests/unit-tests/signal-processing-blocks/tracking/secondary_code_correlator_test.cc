@@ -0,0 +1,103 @@
+/*!
+ * \file secondary_code_correlator_test.cc
+ * \brief  This file implements tests for the bit-packed secondary code correlator
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "GPS_L1_CA.h"
+#include "Galileo_E1.h"
+#include "secondary_code_correlator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+
+
+namespace
+{
+// Symbol by symbol correlation, as done by the tracking blocks before
+int32_t reference_correlation(const std::deque<float>& symbols, const std::string& code, uint32_t offset)
+{
+    int32_t corr_value = 0;
+    for (size_t i = 0; i < symbols.size(); i++)
+        {
+            const bool zero = (code[(i + offset) % code.size()] == '0');
+            corr_value += ((symbols[i] < 0.0) == zero ? 1 : -1);
+        }
+    return corr_value;
+}
+}  // namespace
+
+
+TEST(SecondaryCodeCorrelatorTest, MatchesSymbolBySymbolCorrelation)
+{
+    std::mt19937 generator(1234);
+    std::normal_distribution<float> noise(0.0, 1.0);
+    for (const std::string& code : {GALILEO_E1_C_SECONDARY_CODE, GPS_CA_PREAMBLE_SYMBOLS_STR})
+        {
+            Secondary_Code_Correlator correlator;
+            correlator.set_code(code);
+            EXPECT_EQ(correlator.length(), code.size());
+            std::deque<float> symbols;
+            for (uint32_t n = 0; n < 3 * code.size(); n++)
+                {
+                    const float symbol = noise(generator);
+                    correlator.push_back(symbol);
+                    symbols.push_back(symbol);
+                    if (symbols.size() > code.size())
+                        {
+                            symbols.pop_front();
+                        }
+                    EXPECT_EQ(correlator.full(), symbols.size() == code.size());
+                    EXPECT_EQ(correlator.correlation(), reference_correlation(symbols, code, 0));
+                    const uint32_t offset = n % code.size();
+                    EXPECT_EQ(correlator.correlation(offset), reference_correlation(symbols, code, offset));
+                }
+        }
+}
+
+
+TEST(SecondaryCodeCorrelatorTest, FindsCodePhase)
+{
+    const std::string& code = GALILEO_E1_C_SECONDARY_CODE;
+    const uint32_t length = code.size();
+    Secondary_Code_Correlator correlator;
+    correlator.set_code(code);
+    uint32_t offset = 0;
+    EXPECT_FALSE(correlator.find_offset(offset));
+
+    // Inverted symbols (data bit or Costas ambiguity) starting at chip 7
+    for (uint32_t n = 7; n < 7 + length; n++)
+        {
+            correlator.push_back(code[n % length] == '0' ? 1.0 : -1.0);
+        }
+    EXPECT_FALSE(correlator.locked());
+    ASSERT_TRUE(correlator.find_offset(offset));
+    EXPECT_EQ(offset, 7U);
+    EXPECT_EQ(correlator.correlation(offset), -static_cast<int32_t>(length));
+
+    // The window is aligned with the code after length - offset more symbols
+    for (uint32_t n = 7 + length; n < 2 * length; n++)
+        {
+            EXPECT_FALSE(correlator.locked());
+            correlator.push_back(code[n % length] == '0' ? 1.0 : -1.0);
+        }
+    EXPECT_TRUE(correlator.locked());
+
+    correlator.clear();
+    EXPECT_EQ(correlator.size(), 0U);
+    EXPECT_FALSE(correlator.locked());
+}
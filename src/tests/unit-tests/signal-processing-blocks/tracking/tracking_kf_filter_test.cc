@@ -0,0 +1,114 @@
+/*!
+ * \file tracking_kf_filter_test.cc
+ * \brief This file implements tests for the joint carrier and code Kalman
+ * filter of the tracking loops.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "GPS_L1_CA.h"
+#include "MATH_CONSTANTS.h"
+#include "tracking_FLL_PLL_filter.h"
+#include "tracking_KF_filter.h"
+#include "tracking_loop_filter.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+
+// Closed loop against a GPS L1 C/A signal with a constant Doppler rate, at
+// 45 dB-Hz and 1 ms of integration, starting 100 Hz away from the Doppler
+TEST(TrackingKfFilterTest, ConvergesWithDopplerRate)
+{
+    const double T = 0.001;
+    const double ratio = GPS_L1_CA_CODE_RATE_CPS / GPS_L1_FREQ_HZ;
+    const double cn0_T = std::pow(10.0, 4.5) * T;
+    const double phase_sigma2 = 1.0 / (2.0 * cn0_T) * (1.0 + 1.0 / (2.0 * cn0_T)) / (PI_2 * PI_2);
+    const double d = 0.5;
+    const double code_sigma2 = d / (4.0 * cn0_T) * (1.0 + 2.0 / ((2.0 - d) * cn0_T));
+    const double doppler_rate_hz_s = 3.0;
+    double doppler_hz = 1000.0;
+
+    Tracking_KF_filter filter;
+    filter.set_params(20.0, 1e-4);
+    filter.initialize(doppler_hz + 100.0, 1.0 / 12.0, 250.0 * 250.0 / 12.0, 100.0, 0.25 / 12.0);
+
+    std::default_random_engine generator(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    // Errors of the NCOs [cycles] and [chips], and the command of the code NCO
+    double phase_error = 0.1;
+    double code_error = 0.2;
+    double code_correction_rate = 0.0;
+    for (int epoch = 0; epoch < 3000; epoch++)
+        {
+            const double mean_doppler_hz = doppler_hz + 0.5 * doppler_rate_hz_s * T;
+            phase_error += (mean_doppler_hz - filter.get_doppler_hz()) * T;
+            code_error += (ratio * (filter.get_doppler_hz() - mean_doppler_hz) - code_correction_rate) * T;
+            doppler_hz += doppler_rate_hz_s * T;
+            filter.update(phase_error + std::sqrt(phase_sigma2) * noise(generator),
+                code_error + std::sqrt(code_sigma2) * noise(generator),
+                phase_sigma2, code_sigma2, T, ratio);
+            phase_error -= filter.get_phase_correction_cycles();
+            code_correction_rate = filter.get_code_correction_chips() / T;
+        }
+
+    EXPECT_NEAR(filter.get_doppler_hz(), doppler_hz, 0.5);
+    EXPECT_NEAR(filter.get_doppler_rate_hz_s(), doppler_rate_hz_s, 1.5);
+    EXPECT_LT(std::fabs(phase_error), 0.05);
+    EXPECT_LT(std::fabs(code_error), 0.05);
+}
+
+
+// Cost of an update, compared to the PLL and DLL loop filters it replaces
+TEST(TrackingKfFilterTest, UpdateCost)
+{
+    const int iterations = 1000000;
+    const double T = 0.001;
+    const double ratio = GPS_L1_CA_CODE_RATE_CPS / GPS_L1_FREQ_HZ;
+
+    Tracking_KF_filter filter;
+    filter.initialize(1000.0, 1.0 / 12.0, 250.0 * 250.0 / 12.0, 100.0, 0.25 / 12.0);
+    Tracking_FLL_PLL_filter carrier_filter;
+    carrier_filter.set_params(35.0, 35.0, 3);
+    carrier_filter.initialize(1000.0);
+    Tracking_loop_filter code_filter(static_cast<float>(T), 2.0, 2, false);
+    code_filter.initialize();
+
+    double kf_out = 0.0;
+    const auto kf_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        {
+            const double input = 1e-3 * static_cast<double>(i % 7 - 3);
+            filter.update(input, input, 0.01, 0.01, T, ratio);
+            kf_out += filter.get_phase_correction_cycles();
+        }
+    const std::chrono::duration<double, std::nano> kf_elapsed = std::chrono::steady_clock::now() - kf_start;
+
+    float loops_out = 0.0;
+    const auto loops_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        {
+            const float input = 1e-3F * static_cast<float>(i % 7 - 3);
+            loops_out += carrier_filter.get_carrier_error(0.0, input, static_cast<float>(T));
+            loops_out += code_filter.apply(input);
+        }
+    const std::chrono::duration<double, std::nano> loops_elapsed = std::chrono::steady_clock::now() - loops_start;
+
+    EXPECT_TRUE(std::isfinite(kf_out));
+    EXPECT_TRUE(std::isfinite(loops_out));
+    std::cout << "Kalman filter update: " << kf_elapsed.count() / iterations << " [ns]" << std::endl;
+    std::cout << "PLL and DLL loop filters: " << loops_elapsed.count() / iterations << " [ns]" << std::endl;
+}
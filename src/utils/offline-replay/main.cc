@@ -0,0 +1,81 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the offline replay program.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_VERSION
+#define GNSS_SDR_VERSION "0.0.12"
+#endif
+
+#include "concurrent_map.h"
+#include "concurrent_queue.h"
+#include "gnss_sdr_flags.h"
+#include "gps_acq_assist.h"
+#include "offline_replay.h"
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+
+DEFINE_int32(jobs, 0, "Number of satellites processed at the same time (0: one per CPU core).");
+DEFINE_double(acquisition_retry_s, 30.0, "Seconds of signal skipped before trying again a failed acquisition.");
+DEFINE_double(acquisition_window_s, 0.5, "Seconds of signal of each window searched for the satellites before tracking them.");
+DEFINE_string(replay_dir, "./offline_replay", "Directory for the intermediate files of each satellite.");
+
+Concurrent_Queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+Concurrent_Map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+        std::string("\nOffline replay processes a GNSS-SDR configuration that reads a recorded file,\n") +
+        "tracking each satellite in parallel on all the CPU cores.\n" +
+        "Copyright (C) 2010-2020 (see AUTHORS file for a list of contributors)\n" +
+        "This program comes with ABSOLUTELY NO WARRANTY;\n" +
+        "See COPYING file to see a copy of the General Public License\n \n");
+
+    google::SetUsageMessage(intro_help);
+    google::SetVersionString(GNSS_SDR_VERSION);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    const std::string config_file = FLAGS_c == "-" ? FLAGS_config_file : FLAGS_c;
+    int return_code = 0;
+    const auto start = std::chrono::system_clock::now();
+    try
+        {
+            Offline_Replay replay(config_file, static_cast<uint32_t>(std::max(FLAGS_jobs, 0)), FLAGS_acquisition_retry_s, FLAGS_acquisition_window_s, FLAGS_replay_dir);
+            if (!replay.run())
+                {
+                    return_code = 1;
+                }
+        }
+    catch (const std::exception& e)
+        {
+            std::cerr << "Offline replay failed: " << e.what() << std::endl;
+            return_code = 1;
+        }
+    const std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+    std::cout << "Total processing time: " << elapsed_seconds.count() << " [seconds]" << std::endl;
+
+    google::ShutDownCommandLineFlags();
+    return return_code;
+}
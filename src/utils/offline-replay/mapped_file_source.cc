@@ -0,0 +1,112 @@
+/*!
+ * \file mapped_file_source.cc
+ * \brief GNU Radio source that reads a section of a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mapped_file_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, madvise, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#include <algorithm>   // for min
+#include <cstring>     // for memcpy
+#include <utility>     // for move
+
+
+Mapped_File::~Mapped_File()
+{
+    if (d_data != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(d_data), d_size);
+        }
+}
+
+
+bool Mapped_File::open(const std::string& filename)
+{
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        {
+            LOG(WARNING) << "Unable to open the file " << filename;
+            return false;
+        }
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0 or file_status.st_size <= 0)
+        {
+            LOG(WARNING) << "Unable to get the size of the file " << filename;
+            ::close(fd);
+            return false;
+        }
+    const auto size = static_cast<size_t>(file_status.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file open
+    if (map == MAP_FAILED)
+        {
+            LOG(WARNING) << "Unable to map the file " << filename;
+            return false;
+        }
+    // Every reader goes through the file from the beginning to the end
+    madvise(map, size, MADV_SEQUENTIAL);
+    d_data = static_cast<const uint8_t*>(map);
+    d_size = size;
+    return true;
+}
+
+
+mapped_file_source_sptr mapped_file_source_make(
+    std::shared_ptr<const Mapped_File> file,
+    size_t item_size,
+    uint64_t first_item,
+    uint64_t num_items)
+{
+    mapped_file_source_sptr source_(new mapped_file_source(std::move(file), item_size, first_item, num_items));
+    return source_;
+}
+
+
+mapped_file_source::mapped_file_source(std::shared_ptr<const Mapped_File> file,
+    size_t item_size,
+    uint64_t first_item,
+    uint64_t num_items) : gr::sync_block("mapped_file_source",
+                              gr::io_signature::make(0, 0, 0),
+                              gr::io_signature::make(1, 1, item_size)),
+                          d_file(std::move(file)),
+                          d_item_size(item_size),
+                          d_position(0)
+{
+    const uint64_t file_items = d_file->size() / d_item_size;
+    first_item = std::min(first_item, file_items);
+    d_first = d_file->data() + first_item * d_item_size;
+    d_num_items = std::min(num_items, file_items - first_item);
+}
+
+
+int mapped_file_source::work(int noutput_items,
+    gr_vector_const_void_star& input_items __attribute__((unused)),
+    gr_vector_void_star& output_items)
+{
+    const uint64_t position = d_position.load();
+    if (position >= d_num_items)
+        {
+            return WORK_DONE;
+        }
+    const uint64_t n = std::min(static_cast<uint64_t>(noutput_items), d_num_items - position);
+    std::memcpy(output_items[0], d_first + position * d_item_size, n * d_item_size);
+    d_position.store(position + n);
+    return static_cast<int>(n);
+}
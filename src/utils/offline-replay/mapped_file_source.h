@@ -0,0 +1,108 @@
+/*!
+ * \file mapped_file_source.h
+ * \brief GNU Radio source that reads a section of a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MAPPED_FILE_SOURCE_H
+#define GNSS_SDR_MAPPED_FILE_SOURCE_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/types.h>  // for gr_vector_const_void_star
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#if !GNURADIO_USES_STD_POINTERS
+#include <boost/shared_ptr.hpp>
+#endif
+
+/*!
+ * \brief Read-only memory mapping of a whole file, shared by all the
+ * flowgraphs that read it. The pages are loaded once by the kernel, no
+ * matter how many readers there are.
+ */
+class Mapped_File
+{
+public:
+    Mapped_File() = default;
+    ~Mapped_File();
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    bool open(const std::string& filename);
+    inline const uint8_t* data() const { return d_data; }
+    inline size_t size() const { return d_size; }
+
+private:
+    const uint8_t* d_data = nullptr;
+    size_t d_size = 0;
+};
+
+
+class mapped_file_source;
+
+#if GNURADIO_USES_STD_POINTERS
+using mapped_file_source_sptr = std::shared_ptr<mapped_file_source>;
+#else
+using mapped_file_source_sptr = boost::shared_ptr<mapped_file_source>;
+#endif
+
+mapped_file_source_sptr mapped_file_source_make(
+    std::shared_ptr<const Mapped_File> file,
+    size_t item_size,
+    uint64_t first_item,
+    uint64_t num_items);
+
+/*!
+ * \brief Outputs num_items items of the mapped file, starting at first_item,
+ * and then finishes the flowgraph.
+ */
+class mapped_file_source : public gr::sync_block
+{
+public:
+    ~mapped_file_source() = default;
+
+    /*!
+     * \brief Items already output. It can be read from any thread.
+     */
+    inline uint64_t position() const { return d_position.load(); }
+    inline uint64_t num_items() const { return d_num_items; }
+
+    int work(int noutput_items,
+        gr_vector_const_void_star& input_items,
+        gr_vector_void_star& output_items);
+
+private:
+    friend mapped_file_source_sptr mapped_file_source_make(
+        std::shared_ptr<const Mapped_File> file,
+        size_t item_size,
+        uint64_t first_item,
+        uint64_t num_items);
+
+    mapped_file_source(std::shared_ptr<const Mapped_File> file,
+        size_t item_size,
+        uint64_t first_item,
+        uint64_t num_items);
+
+    std::shared_ptr<const Mapped_File> d_file;
+    const uint8_t* d_first;
+    size_t d_item_size;
+    uint64_t d_num_items;
+    std::atomic<uint64_t> d_position;
+};
+
+#endif  // GNSS_SDR_MAPPED_FILE_SOURCE_H
@@ -0,0 +1,635 @@
+/*!
+ * \file offline_replay.cc
+ * \brief Processes a recorded file with one flowgraph per satellite, in
+ * parallel, and then computes the observables and PVT from their outputs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "offline_replay.h"
+#include "channel_event.h"
+#include "channel_interface.h"
+#include "file_configuration.h"
+#include "gnss_block_factory.h"
+#include "gnss_block_interface.h"
+#include "gnss_satellite.h"
+#include "gnss_sdr_create_directory.h"
+#include "gnss_sdr_flags.h"
+#include "gnss_synchro.h"
+#include "mapped_file_source.h"
+#include "replay_channel_sink.h"
+#include "replay_merge_source.h"
+#include <boost/any.hpp>  // for any_cast
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+#include <glog/logging.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/gr_complex.h>  // for gr_complex
+#include <pmt/pmt_sugar.h>        // for mp
+#include <algorithm>              // for max, min, stable_sort, transform
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>   // for abs, ceil, round
+#include <cstdio>  // for remove
+#include <exception>
+#include <iostream>
+#include <iterator>  // for inserter
+#include <set>
+#include <thread>
+#include <typeinfo>  // for typeid
+
+namespace
+{
+// Channel types in the order used by GNSSBlockFactory::GetChannels, and their systems
+const std::array<std::pair<const char*, const char*>, 9> CHANNEL_TYPES = {{{"1C", "GPS"},
+    {"2S", "GPS"},
+    {"L5", "GPS"},
+    {"1B", "Galileo"},
+    {"5X", "Galileo"},
+    {"1G", "Glonass"},
+    {"2G", "Glonass"},
+    {"B1", "Beidou"},
+    {"B3", "Beidou"}}};
+
+
+// Same satellites as GNSSFlowgraph::set_signals_list()
+std::set<uint32_t> available_prns(ConfigurationInterface* configuration, const std::string& system)
+{
+    std::set<uint32_t> prns;
+    uint32_t max_prn = 32;
+    if (system == "Galileo")
+        {
+            max_prn = 36;
+        }
+    else if (system == "Beidou")
+        {
+            max_prn = 63;
+        }
+    if (system == "Glonass")
+        {
+            // Satellites sharing the same frequency number removed
+            prns = {1, 2, 3, 4, 9, 10, 11, 12, 18, 19, 20, 21, 24};
+        }
+    else
+        {
+            for (uint32_t prn = 1; prn <= max_prn; prn++)
+                {
+                    prns.insert(prn);
+                }
+        }
+
+    const std::string sv_list = configuration->property(system + ".prns", std::string(""));
+    if (sv_list.length() > 0)
+        {
+            std::set<uint32_t> tmp_set;
+            boost::tokenizer<> tok(sv_list);
+            std::transform(tok.begin(), tok.end(), std::inserter(tmp_set, tmp_set.begin()),
+                boost::lexical_cast<uint32_t, std::string>);
+            if (!tmp_set.empty())
+                {
+                    prns = tmp_set;
+                }
+        }
+    return prns;
+}
+}  // namespace
+
+
+Offline_Replay::Offline_Replay(std::string config_file,
+    uint32_t jobs,
+    double acquisition_retry_s,
+    double acquisition_window_s,
+    std::string work_directory) : d_config_file(std::move(config_file)),
+                                  d_work_directory(std::move(work_directory)),
+                                  d_acquisition_retry_s(acquisition_retry_s),
+                                  d_acquisition_window_s(acquisition_window_s),
+                                  d_items_per_second(0.0),
+                                  d_items_per_sample(0),
+                                  d_first_item(0),
+                                  d_num_items(0),
+                                  d_item_size(0),
+                                  d_num_threads(jobs)
+{
+    if (d_num_threads == 0)
+        {
+            d_num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+}
+
+
+bool Offline_Replay::run()
+{
+    if (!map_signal_source())
+        {
+            return false;
+        }
+    if (!gnss_sdr_create_directory(d_work_directory))
+        {
+            std::cerr << "Could not create the working directory " << d_work_directory << std::endl;
+            return false;
+        }
+    set_jobs();
+    if (d_jobs.empty())
+        {
+            std::cerr << "No channels configured" << std::endl;
+            return false;
+        }
+
+    std::cout << "Searching " << d_jobs.size() << " signals with " << d_num_threads << " threads" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Replay_Job*> jobs;
+    for (auto& job : d_jobs)
+        {
+            jobs.push_back(&job);
+        }
+    run_parallel(jobs, [this](Replay_Job& job) { survey(job); });
+    jobs.clear();
+    for (auto& job : d_jobs)
+        {
+            if (job.acquired)
+                {
+                    jobs.push_back(&job);
+                }
+        }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Acquired " << jobs.size() << " of " << d_jobs.size() << " signals in " << elapsed.count() << " s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    run_parallel(jobs, [this](Replay_Job& job) { process(job); });
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Tracked " << jobs.size() << " signals in " << elapsed.count() << " s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    const bool success = merge();
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Observables and PVT computed in " << elapsed.count() << " s" << std::endl;
+    for (const auto& job : d_jobs)
+        {
+            std::remove(job.filename.c_str());
+        }
+    return success;
+}
+
+
+bool Offline_Replay::map_signal_source()
+{
+    auto configuration = std::make_shared<FileConfiguration>(d_config_file);
+    const std::string role("SignalSource");
+    const std::string implementation = configuration->property(role + ".implementation", std::string(""));
+    if (implementation != "File_Signal_Source")
+        {
+            std::cerr << "Only the File_Signal_Source implementation can be replayed" << std::endl;
+            return false;
+        }
+    std::string filename = configuration->property(role + ".filename", std::string("./example_capture.dat"));
+    if (FLAGS_signal_source != "-")
+        {
+            filename = FLAGS_signal_source;
+        }
+    if (FLAGS_s != "-")
+        {
+            filename = FLAGS_s;
+        }
+
+    // Same item types and skipped samples as FileSignalSource
+    const std::string item_type = configuration->property(role + ".item_type", std::string("short"));
+    bool is_complex = false;
+    if (item_type == "gr_complex")
+        {
+            d_item_size = sizeof(gr_complex);
+        }
+    else if (item_type == "float")
+        {
+            d_item_size = sizeof(float);
+        }
+    else if (item_type == "short" or item_type == "ishort")
+        {
+            d_item_size = sizeof(int16_t);
+            is_complex = item_type == "ishort";
+        }
+    else if (item_type == "byte" or item_type == "ibyte")
+        {
+            d_item_size = sizeof(int8_t);
+            is_complex = item_type == "ibyte";
+        }
+    else
+        {
+            LOG(WARNING) << item_type << " unrecognized item type. Using gr_complex.";
+            d_item_size = sizeof(gr_complex);
+        }
+    const double sampling_frequency = configuration->property(role + ".sampling_frequency", 0.0);
+    d_items_per_second = is_complex ? 2.0 * sampling_frequency : sampling_frequency;
+    const double seconds_to_skip = configuration->property(role + ".seconds_to_skip", 0.0);
+    d_first_item = configuration->property(role + ".header_size", static_cast<uint64_t>(0));
+    if (seconds_to_skip > 0.0)
+        {
+            d_first_item += static_cast<uint64_t>(seconds_to_skip * d_items_per_second);
+        }
+
+    auto file = std::make_shared<Mapped_File>();
+    if (!file->open(filename))
+        {
+            std::cerr << "Unable to map the samples file " << filename << std::endl;
+            return false;
+        }
+    d_file = file;
+
+    // The tracking jobs can start later in the file, and shift their sample
+    // counters, only if each sample at the channel inputs comes from a whole
+    // number of items
+    const double internal_fs = configuration->property("GNSS-SDR.internal_fs_sps", sampling_frequency);
+    if (internal_fs > 0.0)
+        {
+            const double items_per_sample = d_items_per_second / internal_fs;
+            if (items_per_sample >= 1.0 and std::abs(items_per_sample - std::round(items_per_sample)) < 1e-6)
+                {
+                    d_items_per_sample = static_cast<uint64_t>(std::round(items_per_sample));
+                }
+        }
+
+    const uint64_t file_items = d_file->size() / d_item_size;
+    if (file_items <= d_first_item)
+        {
+            std::cerr << "The samples file " << filename << " is too short" << std::endl;
+            return false;
+        }
+    d_num_items = configuration->property(role + ".samples", static_cast<uint64_t>(0));
+    if (d_num_items == 0)
+        {
+            // As FileSignalSource, leave out the last 2 ms
+            const auto margin = static_cast<uint64_t>(std::ceil(0.002 * sampling_frequency));
+            d_num_items = file_items - d_first_item > margin ? file_items - d_first_item - margin : 0;
+        }
+    std::cout << "Processing file " << filename << ", " << d_num_items << " items" << std::endl;
+    return true;
+}
+
+
+void Offline_Replay::set_jobs()
+{
+    auto configuration = std::make_shared<FileConfiguration>(d_config_file);
+    for (const auto& channel_type : CHANNEL_TYPES)
+        {
+            const std::string type(channel_type.first);
+            if (configuration->property("Channels_" + type + ".count", 0) <= 0)
+                {
+                    continue;
+                }
+            const std::string system(channel_type.second);
+            for (const auto prn : available_prns(configuration.get(), system))
+                {
+                    Replay_Job job;
+                    job.channel_type = type;
+                    job.signal = Gnss_Signal(Gnss_Satellite(system, prn), type);
+                    job.filename = d_work_directory + "/replay_" + type + "_" + system + "_" + std::to_string(prn) + ".dat";
+                    d_jobs.push_back(std::move(job));
+                }
+        }
+}
+
+
+void Offline_Replay::run_parallel(const std::vector<Replay_Job*>& jobs, const std::function<void(Replay_Job&)>& task) const
+{
+    std::atomic<size_t> next_job(0);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < std::min<size_t>(d_num_threads, jobs.size()); i++)
+        {
+            threads.emplace_back([&jobs, &task, &next_job]() {
+                size_t job;
+                while ((job = next_job.fetch_add(1)) < jobs.size())
+                    {
+                        task(*jobs[job]);
+                    }
+            });
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+}
+
+
+// A receiver with a single channel of the type of the job
+bool Offline_Replay::make_channel(const Replay_Job& job,
+    const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue,
+    std::shared_ptr<GNSSBlockInterface>& conditioner,
+    std::shared_ptr<ChannelInterface>& channel)
+{
+    auto configuration = std::make_shared<FileConfiguration>(d_config_file);
+    for (const auto& channel_type : CHANNEL_TYPES)
+        {
+            const std::string type(channel_type.first);
+            configuration->set_property("Channels_" + type + ".count", type == job.channel_type ? "1" : "0");
+        }
+    // All the jobs use channel 0, so they would write the same dump files
+    configuration->set_property("Acquisition_" + job.channel_type + ".dump", "false");
+    configuration->set_property("Tracking_" + job.channel_type + ".dump", "false");
+    configuration->set_property("TelemetryDecoder_" + job.channel_type + ".dump", "false");
+
+    GNSSBlockFactory block_factory;
+    conditioner = block_factory.GetSignalConditioner(configuration);
+    try
+        {
+            auto channels = block_factory.GetChannels(configuration, queue);
+            if (channels->size() == 1)
+                {
+                    std::shared_ptr<GNSSBlockInterface> block = std::move(channels->at(0));
+                    channel = std::dynamic_pointer_cast<ChannelInterface>(block);
+                }
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << e.what();
+        }
+    if (!conditioner or !channel)
+        {
+            std::lock_guard<std::mutex> lock(d_cout_mutex);
+            std::cerr << "Unable to create the channel for " << job.signal << std::endl;
+            return false;
+        }
+    return true;
+}
+
+
+// Number of items closest to the given one that keeps the samples aligned
+uint64_t Offline_Replay::align(double items) const
+{
+    const uint64_t alignment = std::max<uint64_t>(d_items_per_sample, 1);
+    return std::max<uint64_t>(static_cast<uint64_t>(std::round(items / static_cast<double>(alignment))), 1) * alignment;
+}
+
+
+// Searches the satellite in short windows of the file, acquisition_retry_s
+// apart, until it is acquired. Nothing is tracked, so each window only costs
+// the signal conditioner and one acquisition.
+void Offline_Replay::survey(Replay_Job& job)
+{
+    const uint64_t window_items = align(d_acquisition_window_s * d_items_per_second);
+    const uint64_t retry_items = std::max(align(d_acquisition_retry_s * d_items_per_second), window_items);
+    for (uint64_t offset = 0; offset < d_num_items; offset += retry_items)
+        {
+            auto queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+            std::shared_ptr<GNSSBlockInterface> conditioner;
+            std::shared_ptr<ChannelInterface> channel;
+            if (!make_channel(job, queue, conditioner, channel))
+                {
+                    return;
+                }
+            const auto source = mapped_file_source_make(d_file, d_item_size, d_first_item + offset, std::min(window_items, d_num_items - offset));
+            const auto sink = gr::blocks::null_sink::make(sizeof(Gnss_Synchro));
+            gr::top_block_sptr top_block = gr::make_top_block("OfflineReplaySurvey");
+            try
+                {
+                    conditioner->connect(top_block);
+                    channel->connect(top_block);
+                    top_block->connect(source, 0, conditioner->get_left_block(), 0);
+                    top_block->connect(conditioner->get_right_block(), 0, channel->get_left_block_acq(), 0);
+                    top_block->connect(conditioner->get_right_block(), 0, channel->get_left_block_trk(), 0);
+                    top_block->connect(channel->get_right_block(), 0, sink, 0);
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(WARNING) << "Can't connect the flowgraph for " << job.signal << ": " << e.what();
+                    return;
+                }
+
+            channel->set_signal(job.signal);
+            channel->start_acquisition();
+            std::thread runner([&top_block, &queue]() {
+                top_block->run();
+                queue->push(pmt::PMT_EOF);
+            });
+            // The window ends with the first result of the acquisition
+            bool done = false;
+            while (true)
+                {
+                    pmt::pmt_t msg;
+                    queue->wait_and_pop(msg);
+                    if (!pmt::is_any(msg))
+                        {
+                            break;  // end of the window
+                        }
+                    if (!done and pmt::any_ref(msg).type() == typeid(channel_event_sptr))
+                        {
+                            const auto event = boost::any_cast<channel_event_sptr>(pmt::any_ref(msg));
+                            if (event->event_type == 0 or event->event_type == 1)
+                                {
+                                    job.acquired = event->event_type == 1;
+                                    done = true;
+                                    top_block->stop();
+                                }
+                        }
+                }
+            runner.join();
+            if (job.acquired)
+                {
+                    job.start_item = offset;
+                    std::lock_guard<std::mutex> lock(d_cout_mutex);
+                    std::cout << "Acquired " << job.signal << " at " << static_cast<double>(offset) / d_items_per_second << " s" << std::endl;
+                    return;
+                }
+        }
+}
+
+
+void Offline_Replay::process(Replay_Job& job)
+{
+    auto queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    std::shared_ptr<GNSSBlockInterface> conditioner;
+    std::shared_ptr<ChannelInterface> channel;
+    if (!make_channel(job, queue, conditioner, channel))
+        {
+            return;
+        }
+
+    // Skip the beginning of the file where the satellite was not found. If
+    // the samples of the channel cannot be aligned with the items of the
+    // file, process it from the beginning and acquire it later.
+    uint64_t start_item = 0;
+    uint64_t sample_counter_offset = 0;
+    if (d_items_per_sample > 0)
+        {
+            start_item = job.start_item;
+            sample_counter_offset = start_item / d_items_per_sample;
+        }
+    const auto source = mapped_file_source_make(d_file, d_item_size, d_first_item + start_item, d_num_items - start_item);
+    const auto sink = replay_channel_sink_make(job.filename, sample_counter_offset);
+    gr::top_block_sptr top_block = gr::make_top_block("OfflineReplay");
+    try
+        {
+            conditioner->connect(top_block);
+            channel->connect(top_block);
+            top_block->connect(source, 0, conditioner->get_left_block(), 0);
+            top_block->connect(conditioner->get_right_block(), 0, channel->get_left_block_acq(), 0);
+            top_block->connect(conditioner->get_right_block(), 0, channel->get_left_block_trk(), 0);
+            top_block->connect(channel->get_right_block(), 0, sink, 0);
+            top_block->msg_connect(channel->get_right_block(), pmt::mp("telemetry"), sink, pmt::mp("telemetry"));
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Can't connect the flowgraph for " << job.signal << ": " << e.what();
+            return;
+        }
+
+    channel->set_signal(job.signal);
+    const uint64_t acquisition_item = job.start_item - start_item;
+    if (acquisition_item == 0)
+        {
+            channel->start_acquisition();
+        }
+    std::thread events(&Offline_Replay::handle_events, this, channel, queue, source.get(), top_block, acquisition_item);
+    top_block->run();
+    queue->push(pmt::PMT_EOF);
+    events.join();
+    sink->close();
+
+    job.items = sink->items();
+    job.messages = sink->messages();
+    std::lock_guard<std::mutex> lock(d_cout_mutex);
+    std::cout << "Processed " << job.signal << ": " << job.items << " observations, "
+              << job.messages.size() << " navigation messages" << std::endl;
+}
+
+
+// Takes the actions of GNSSFlowgraph::apply_action(), keeping the channel on
+// its satellite. The acquisition starts at acquisition_item, if not started yet.
+void Offline_Replay::handle_events(const std::shared_ptr<ChannelInterface>& channel,
+    const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue,
+    const mapped_file_source* source,
+    const gr::top_block_sptr& top_block,
+    uint64_t acquisition_item)
+{
+    const auto retry_items = static_cast<uint64_t>(d_acquisition_retry_s * d_items_per_second);
+    bool retry_pending = acquisition_item > 0;
+    uint64_t retry_position = acquisition_item;
+    while (true)
+        {
+            pmt::pmt_t msg;
+            if (queue->timed_wait_and_pop(msg, 100))
+                {
+                    if (!pmt::is_any(msg))
+                        {
+                            break;  // end of the file
+                        }
+                    if (pmt::any_ref(msg).type() == typeid(channel_event_sptr))
+                        {
+                            const auto event = boost::any_cast<channel_event_sptr>(pmt::any_ref(msg));
+                            switch (event->event_type)
+                                {
+                                case 0:
+                                    // Acquisition failed, try again later in the file, if
+                                    // there is any file left
+                                    retry_position = source->position() + retry_items;
+                                    if (retry_position < source->num_items())
+                                        {
+                                            retry_pending = true;
+                                        }
+                                    else
+                                        {
+                                            top_block->stop();
+                                        }
+                                    break;
+                                case 1:
+                                    DLOG(INFO) << "ACQ SUCCESS satellite " << channel->get_signal().get_satellite();
+                                    break;
+                                case 2:
+                                    // Loss of lock, acquire the same satellite again
+                                    channel->set_signal(channel->get_signal());
+                                    channel->start_acquisition();
+                                    break;
+                                default:
+                                    break;
+                                }
+                        }
+                }
+            if (retry_pending and source->position() >= retry_position)
+                {
+                    retry_pending = false;
+                    channel->set_signal(channel->get_signal());
+                    channel->start_acquisition();
+                }
+        }
+}
+
+
+bool Offline_Replay::merge()
+{
+    auto configuration = std::make_shared<FileConfiguration>(d_config_file);
+    const double fs = configuration->property("GNSS-SDR.internal_fs_sps", 0.0);
+    if (fs == 0.0)
+        {
+            std::cerr << "Set GNSS-SDR.internal_fs_sps in the configuration file" << std::endl;
+            return false;
+        }
+    const int32_t observable_interval_ms = configuration->property("GNSS-SDR.observable_interval_ms", 20);
+
+    // The channels of the observables and PVT blocks, grouped by type as in the receiver
+    std::vector<std::string> filenames;
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> messages;
+    for (const auto& channel_type : CHANNEL_TYPES)
+        {
+            const std::string type(channel_type.first);
+            int32_t count = 0;
+            for (const auto& job : d_jobs)
+                {
+                    if (job.channel_type == type and job.items > 0)
+                        {
+                            filenames.push_back(job.filename);
+                            messages.insert(messages.end(), job.messages.cbegin(), job.messages.cend());
+                            count++;
+                        }
+                }
+            configuration->set_property("Channels_" + type + ".count", std::to_string(count));
+        }
+    if (filenames.empty())
+        {
+            std::cerr << "No satellite was tracked" << std::endl;
+            return false;
+        }
+    std::stable_sort(messages.begin(), messages.end(), [](const std::pair<uint64_t, pmt::pmt_t>& a, const std::pair<uint64_t, pmt::pmt_t>& b) { return a.first < b.first; });
+
+    GNSSBlockFactory block_factory;
+    std::shared_ptr<GNSSBlockInterface> observables = block_factory.GetObservables(configuration);
+    std::shared_ptr<GNSSBlockInterface> pvt = block_factory.GetPVT(configuration);
+    if (!observables or !pvt)
+        {
+            std::cerr << "Unable to create the observables and PVT blocks" << std::endl;
+            return false;
+        }
+    const auto nchannels = static_cast<int32_t>(filenames.size());
+    const auto merge_source = replay_merge_source_make(filenames, std::move(messages), fs, observable_interval_ms);
+    gr::top_block_sptr top_block = gr::make_top_block("OfflineReplayMerge");
+    try
+        {
+            observables->connect(top_block);
+            pvt->connect(top_block);
+            for (int32_t i = 0; i < nchannels; i++)
+                {
+                    top_block->connect(merge_source, i, observables->get_left_block(), i);
+                    top_block->connect(observables->get_right_block(), i, pvt->get_left_block(), i);
+                }
+            top_block->connect(merge_source, nchannels, observables->get_left_block(), nchannels);  // extra port for the sample counter pulse
+            top_block->msg_connect(merge_source, pmt::mp("telemetry"), pvt->get_left_block(), pmt::mp("telemetry"));
+            top_block->msg_connect(pvt->get_left_block(), pmt::mp("pvt_to_observables"), observables->get_right_block(), pmt::mp("pvt_to_observables"));
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Can't connect the observables and PVT blocks: " << e.what();
+            return false;
+        }
+    std::cout << "Computing the observables and PVT of " << nchannels << " satellites" << std::endl;
+    top_block->run();
+    return true;
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file offline_replay.h
+ * \brief Processes a recorded file with one flowgraph per satellite, in
+ * parallel, and then computes the observables and PVT from their outputs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OFFLINE_REPLAY_H
+#define GNSS_SDR_OFFLINE_REPLAY_H
+
+#include "concurrent_queue.h"
+#include "gnss_signal.h"
+#include <gnuradio/top_block.h>
+#include <pmt/pmt.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ChannelInterface;
+class ConfigurationInterface;
+class GNSSBlockInterface;
+class Mapped_File;
+class mapped_file_source;
+
+/*!
+ * \brief Offline post-processing of a file recorded with a single front-end.
+ *
+ * In a recorded file the channels do not need to wait for each other, so
+ * the receiver is split in three stages:
+ *
+ * 1. The file configured in the File_Signal_Source is memory-mapped once.
+ * 2. Each satellite of each configured signal is first searched in short
+ *    windows of the file, acquisition_retry_s apart, until it is acquired.
+ *    Then only the acquired satellites are processed by a flowgraph of their
+ *    own (signal conditioner, acquisition, tracking and telemetry decoder of
+ *    a single channel), from the window where they were found. The sample
+ *    counters of each channel are shifted by the samples it skipped, so all
+ *    of them share the same origin. Both kinds of jobs run on a pool of
+ *    threads. Failed acquisitions are retried later in the file, losses of
+ *    lock restart the acquisition at once, and a job stops when no retry is
+ *    left in the file. The outputs of each channel and its navigation
+ *    messages are kept in the working directory.
+ * 3. The outputs of all the satellites are merged by sample counter into
+ *    the observables and PVT blocks, which run as in the receiver.
+ */
+class Offline_Replay
+{
+public:
+    Offline_Replay(std::string config_file,
+        uint32_t jobs,
+        double acquisition_retry_s,
+        double acquisition_window_s,
+        std::string work_directory);
+
+    /*!
+     * \brief Runs the three stages. Returns false if the file could not be processed.
+     */
+    bool run();
+
+private:
+    struct Replay_Job
+    {
+        std::string channel_type;  // "1C", "1B", ...
+        Gnss_Signal signal;
+        std::string filename;
+        bool acquired = false;
+        uint64_t start_item = 0;  // window where it was acquired, from the first item
+        uint64_t items = 0;       // Gnss_Synchro objects with a valid word
+        std::vector<std::pair<uint64_t, pmt::pmt_t>> messages;
+    };
+
+    bool map_signal_source();
+    void set_jobs();
+    void run_parallel(const std::vector<Replay_Job*>& jobs, const std::function<void(Replay_Job&)>& task) const;
+    bool make_channel(const Replay_Job& job,
+        const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue,
+        std::shared_ptr<GNSSBlockInterface>& conditioner,
+        std::shared_ptr<ChannelInterface>& channel);
+    void survey(Replay_Job& job);
+    void process(Replay_Job& job);
+    void handle_events(const std::shared_ptr<ChannelInterface>& channel,
+        const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue,
+        const mapped_file_source* source,
+        const gr::top_block_sptr& top_block,
+        uint64_t acquisition_item);
+    uint64_t align(double items) const;
+    bool merge();
+
+    std::string d_config_file;
+    std::string d_work_directory;
+    std::shared_ptr<const Mapped_File> d_file;
+    std::vector<Replay_Job> d_jobs;
+    std::mutex d_cout_mutex;
+    double d_acquisition_retry_s;
+    double d_acquisition_window_s;
+    double d_items_per_second;
+    uint64_t d_items_per_sample;  // file items per sample at the channel inputs, 0 if not an integer
+    uint64_t d_first_item;
+    uint64_t d_num_items;
+    size_t d_item_size;
+    uint32_t d_num_threads;
+};
+
+#endif  // GNSS_SDR_OFFLINE_REPLAY_H
@@ -0,0 +1,113 @@
+/*!
+ * \file replay_channel_sink.cc
+ * \brief Stores the output of a channel processed by the offline replay
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "replay_channel_sink.h"
+#include "gnss_synchro.h"
+#include <boost/bind/bind.hpp>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt_sugar.h>  // for mp
+#include <exception>
+#include <fstream>
+
+
+replay_channel_sink_sptr replay_channel_sink_make(const std::string& filename, uint64_t sample_counter_offset)
+{
+    replay_channel_sink_sptr sink_(new replay_channel_sink(filename, sample_counter_offset));
+    return sink_;
+}
+
+
+replay_channel_sink::replay_channel_sink(const std::string& filename,
+    uint64_t sample_counter_offset) : gr::sync_block("replay_channel_sink",
+                                          gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
+                                          gr::io_signature::make(0, 0, 0)),
+                                      d_file(Dump_File::Backpressure::Block),
+                                      d_items(0),
+                                      d_last_sample_counter(sample_counter_offset),
+                                      d_sample_counter_offset(sample_counter_offset)
+{
+    this->message_port_register_in(pmt::mp("telemetry"));
+    this->set_msg_handler(pmt::mp("telemetry"), boost::bind(&replay_channel_sink::msg_handler_telemetry, this, _1));
+    try
+        {
+            d_file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+            d_file.open(filename, std::ios::out | std::ios::binary);
+        }
+    catch (const std::ofstream::failure& e)
+        {
+            LOG(WARNING) << "Exception opening the replay file " << filename << ": " << e.what();
+        }
+}
+
+
+replay_channel_sink::~replay_channel_sink()
+{
+    close();
+}
+
+
+void replay_channel_sink::close()
+{
+    if (d_file.is_open())
+        {
+            try
+                {
+                    d_file.close();
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(WARNING) << "Exception closing the replay file: " << e.what();
+                }
+        }
+}
+
+
+void replay_channel_sink::msg_handler_telemetry(const pmt::pmt_t& msg)
+{
+    d_messages.emplace_back(d_last_sample_counter, msg);
+}
+
+
+int replay_channel_sink::work(int noutput_items,
+    gr_vector_const_void_star& input_items,
+    gr_vector_void_star& output_items __attribute__((unused)))
+{
+    const auto* in = reinterpret_cast<const Gnss_Synchro*>(input_items[0]);
+    for (int32_t n = 0; n < noutput_items; n++)
+        {
+            const uint64_t sample_counter = in[n].Tracking_sample_counter + d_sample_counter_offset;
+            if (in[n].Flag_valid_word and d_file.is_open())
+                {
+                    try
+                        {
+                            Gnss_Synchro record = in[n];
+                            record.Tracking_sample_counter = sample_counter;
+                            d_file.write_record(record);
+                            d_items++;
+                        }
+                    catch (const std::ofstream::failure& e)
+                        {
+                            LOG(WARNING) << "Exception writing the replay file: " << e.what();
+                            d_file.close();
+                        }
+                }
+            d_last_sample_counter = sample_counter;
+        }
+    return noutput_items;
+}
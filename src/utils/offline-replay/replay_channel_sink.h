@@ -0,0 +1,82 @@
+/*!
+ * \file replay_channel_sink.h
+ * \brief Stores the output of a channel processed by the offline replay
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_REPLAY_CHANNEL_SINK_H
+#define GNSS_SDR_REPLAY_CHANNEL_SINK_H
+
+#include "dump_writer.h"
+#include <gnuradio/sync_block.h>
+#include <gnuradio/types.h>  // for gr_vector_const_void_star
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class replay_channel_sink;
+
+#if GNURADIO_USES_STD_POINTERS
+using replay_channel_sink_sptr = std::shared_ptr<replay_channel_sink>;
+#else
+using replay_channel_sink_sptr = boost::shared_ptr<replay_channel_sink>;
+#endif
+
+replay_channel_sink_sptr replay_channel_sink_make(const std::string& filename, uint64_t sample_counter_offset = 0);
+
+/*!
+ * \brief Writes the Gnss_Synchro objects with a valid word, the only ones
+ * used by the observables, to a binary file, and keeps the navigation
+ * messages received on the "telemetry" port along with the sample counter
+ * of the last object written before them, so both can be replayed in order.
+ * The sample counters are shifted by sample_counter_offset, the samples
+ * skipped at the beginning of the file by the flowgraph of the channel.
+ */
+class replay_channel_sink : public gr::sync_block
+{
+public:
+    ~replay_channel_sink();
+
+    inline uint64_t items() const { return d_items; }  //!< Objects written to the file
+    inline const std::vector<std::pair<uint64_t, pmt::pmt_t>>& messages() const { return d_messages; }
+
+    void close();
+
+    int work(int noutput_items,
+        gr_vector_const_void_star& input_items,
+        gr_vector_void_star& output_items);
+
+private:
+    friend replay_channel_sink_sptr replay_channel_sink_make(const std::string& filename, uint64_t sample_counter_offset);
+
+    replay_channel_sink(const std::string& filename, uint64_t sample_counter_offset);
+
+    void msg_handler_telemetry(const pmt::pmt_t& msg);
+
+    Dump_File d_file;
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> d_messages;
+    uint64_t d_items;
+    uint64_t d_last_sample_counter;
+    uint64_t d_sample_counter_offset;
+};
+
+#endif  // GNSS_SDR_REPLAY_CHANNEL_SINK_H
@@ -0,0 +1,132 @@
+/*!
+ * \file replay_merge_source.cc
+ * \brief Merges the channels processed by the offline replay into the
+ * inputs of the observables block
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "replay_merge_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt_sugar.h>  // for mp
+#include <algorithm>        // for all_of
+#include <cmath>            // for round
+
+
+replay_merge_source_sptr replay_merge_source_make(
+    const std::vector<std::string>& filenames,
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> messages,
+    double fs,
+    int32_t interval_ms)
+{
+    replay_merge_source_sptr source_(new replay_merge_source(filenames, std::move(messages), fs, interval_ms));
+    return source_;
+}
+
+
+replay_merge_source::replay_merge_source(const std::vector<std::string>& filenames,
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> messages,
+    double fs,
+    int32_t interval_ms) : gr::block("replay_merge_source",
+                               gr::io_signature::make(0, 0, 0),
+                               gr::io_signature::make(filenames.size() + 1, filenames.size() + 1, sizeof(Gnss_Synchro))),
+                           d_next(filenames.size()),
+                           d_pending(filenames.size(), false),
+                           d_messages(std::move(messages)),
+                           d_next_message(0),
+                           d_nchannels(filenames.size()),
+                           d_fs(fs),
+                           d_samples_per_output(static_cast<uint64_t>(std::round(fs * static_cast<double>(interval_ms) / 1e3))),
+                           d_sample_counter(0),
+                           d_ticks_after_end(0),
+                           d_max_ticks_after_end(1000 / std::max(interval_ms, 1))
+{
+    this->message_port_register_out(pmt::mp("telemetry"));
+    // The observables block consumes one pulse per call. Running ahead of it
+    // would only fill the buffers, so the pulses get a small buffer: when it
+    // is full, the scheduler puts this block to sleep until the observables
+    // block consumes a pulse. GNU Radio rounds the size up to a memory page.
+    this->set_max_output_buffer(d_nchannels, MAX_PULSES_AHEAD);
+    for (uint32_t i = 0; i < d_nchannels; i++)
+        {
+            d_files.emplace_back(new std::ifstream(filenames[i], std::ios::in | std::ios::binary));
+            if (!d_files[i]->is_open())
+                {
+                    LOG(WARNING) << "Unable to open the replay file " << filenames[i];
+                }
+            read_next(i);
+        }
+}
+
+
+void replay_merge_source::read_next(uint32_t channel)
+{
+    d_pending[channel] = static_cast<bool>(d_files[channel]->read(reinterpret_cast<char*>(&d_next[channel]), sizeof(Gnss_Synchro)));
+}
+
+
+int replay_merge_source::general_work(int noutput_items,
+    gr_vector_int& ninput_items __attribute__((unused)),
+    gr_vector_const_void_star& input_items __attribute__((unused)),
+    gr_vector_void_star& output_items)
+{
+    if (std::all_of(d_pending.cbegin(), d_pending.cend(), [](bool pending) { return !pending; }))
+        {
+            if (d_ticks_after_end >= d_max_ticks_after_end)
+                {
+                    return WORK_DONE;
+                }
+            d_ticks_after_end++;
+        }
+
+    auto** out = reinterpret_cast<Gnss_Synchro**>(&output_items[0]);
+    const uint64_t next_sample_counter = d_sample_counter + d_samples_per_output;
+    bool epoch_complete = true;
+    for (uint32_t i = 0; i < d_nchannels; i++)
+        {
+            int32_t n = 0;
+            while (d_pending[i] and d_next[i].Tracking_sample_counter <= next_sample_counter and n < noutput_items)
+                {
+                    out[i][n] = d_next[i];
+                    out[i][n].Channel_ID = static_cast<int32_t>(i);
+                    n++;
+                    read_next(i);
+                }
+            if (d_pending[i] and d_next[i].Tracking_sample_counter <= next_sample_counter)
+                {
+                    // No room left, the pulse goes out in the next call
+                    epoch_complete = false;
+                }
+            produce(i, n);
+        }
+
+    if (epoch_complete)
+        {
+            while (d_next_message < d_messages.size() and d_messages[d_next_message].first <= next_sample_counter)
+                {
+                    this->message_port_pub(pmt::mp("telemetry"), d_messages[d_next_message].second);
+                    d_next_message++;
+                }
+            out[d_nchannels][0] = Gnss_Synchro();
+            out[d_nchannels][0].Flag_valid_symbol_output = false;
+            out[d_nchannels][0].Flag_valid_word = false;
+            out[d_nchannels][0].Channel_ID = -1;
+            out[d_nchannels][0].fs = d_fs;
+            out[d_nchannels][0].Tracking_sample_counter = next_sample_counter;
+            d_sample_counter = next_sample_counter;
+            produce(d_nchannels, 1);
+        }
+    return WORK_CALLED_PRODUCE;
+}
@@ -0,0 +1,102 @@
+/*!
+ * \file replay_merge_source.h
+ * \brief Merges the channels processed by the offline replay into the
+ * inputs of the observables block
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_REPLAY_MERGE_SOURCE_H
+#define GNSS_SDR_REPLAY_MERGE_SOURCE_H
+
+#include "gnss_synchro.h"
+#include <gnuradio/block.h>
+#include <gnuradio/types.h>  // for gr_vector_int
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#if !GNURADIO_USES_STD_POINTERS
+#include <boost/shared_ptr.hpp>
+#endif
+
+class replay_merge_source;
+
+#if GNURADIO_USES_STD_POINTERS
+using replay_merge_source_sptr = std::shared_ptr<replay_merge_source>;
+#else
+using replay_merge_source_sptr = boost::shared_ptr<replay_merge_source>;
+#endif
+
+replay_merge_source_sptr replay_merge_source_make(
+    const std::vector<std::string>& filenames,
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> messages,
+    double fs,
+    int32_t interval_ms);
+
+/*!
+ * \brief Replays the files written by replay_channel_sink as if the channels
+ * were running in the same flowgraph.
+ *
+ * Output i carries the objects of the i-th file, with Channel_ID set to i,
+ * and the last output carries the receiver clock pulse that the
+ * gnss_sdr_sample_counter block would produce. Before each pulse, every
+ * object with a sample counter not later than the pulse is output, and the
+ * navigation messages (sorted by sample counter) up to the pulse are
+ * published on the "telemetry" port. The buffer of the pulses is kept small,
+ * so they stay only a few epochs ahead of the block reading them, and they
+ * continue for one second after the end of the files so the observables
+ * block can flush its buffer.
+ */
+class replay_merge_source : public gr::block
+{
+public:
+    ~replay_merge_source() = default;
+
+    int general_work(int noutput_items, gr_vector_int& ninput_items,
+        gr_vector_const_void_star& input_items, gr_vector_void_star& output_items);
+
+private:
+    friend replay_merge_source_sptr replay_merge_source_make(
+        const std::vector<std::string>& filenames,
+        std::vector<std::pair<uint64_t, pmt::pmt_t>> messages,
+        double fs,
+        int32_t interval_ms);
+
+    replay_merge_source(const std::vector<std::string>& filenames,
+        std::vector<std::pair<uint64_t, pmt::pmt_t>> messages,
+        double fs,
+        int32_t interval_ms);
+
+    void read_next(uint32_t channel);
+
+    static const int32_t MAX_PULSES_AHEAD = 4;
+
+    std::vector<std::unique_ptr<std::ifstream>> d_files;
+    std::vector<Gnss_Synchro> d_next;
+    std::vector<bool> d_pending;
+    std::vector<std::pair<uint64_t, pmt::pmt_t>> d_messages;
+    size_t d_next_message;
+    uint32_t d_nchannels;
+    double d_fs;
+    uint64_t d_samples_per_output;
+    uint64_t d_sample_counter;
+    int32_t d_ticks_after_end;
+    int32_t d_max_ticks_after_end;
+};
+
+#endif  // GNSS_SDR_REPLAY_MERGE_SOURCE_H